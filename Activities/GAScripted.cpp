@@ -251,7 +251,10 @@ void GAScripted::EnteredOrbit(Actor *orbitedCraft) {
     GameActivity::EnteredOrbit(orbitedCraft);
 
     if (orbitedCraft && g_MovableMan.IsActor(orbitedCraft)) {
-        g_LuaMan.RunScriptedFunction(m_LuaClassName + ".CraftEnteredOrbit", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".CraftEnteredOrbit"}, {orbitedCraft});
+        {
+            LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "CraftEnteredOrbit");
+            g_LuaMan.RunScriptedFunction(m_LuaClassName + ".CraftEnteredOrbit", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".CraftEnteredOrbit"}, {orbitedCraft});
+        }
         for (GlobalScript *globalScript : m_GlobalScriptsList) {
             if (globalScript->IsActive()) { globalScript->EnteredOrbit(orbitedCraft); }
         }
@@ -264,7 +267,10 @@ void GAScripted::OnPieMenu(Actor *pieMenuActor) {
 	if (pieMenuActor && g_MovableMan.IsActor(pieMenuActor)) {
         pieMenuActor->OnPieMenu(pieMenuActor);
 		g_MovableMan.OnPieMenu(pieMenuActor);
-        g_LuaMan.RunScriptedFunction(m_LuaClassName + ".OnPieMenu", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".OnPieMenu"}, {pieMenuActor});
+        {
+            LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "OnPieMenu");
+            g_LuaMan.RunScriptedFunction(m_LuaClassName + ".OnPieMenu", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".OnPieMenu"}, {pieMenuActor});
+        }
         for (GlobalScript *globalScript : m_GlobalScriptsList) {
             if (globalScript->IsActive()) { globalScript->OnPieMenu(pieMenuActor); }
         }
@@ -411,8 +417,11 @@ void GAScripted::Update()
     // If the game didn't end, keep updating activity
     if (m_ActivityState != ActivityState::Over)
     {   
-        // Call the defined function, but only after first checking if it exists
-        g_LuaMan.RunScriptString("if " + m_LuaClassName + ".UpdateActivity then " + m_LuaClassName + ":UpdateActivity(); end");
+        {
+            LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "UpdateActivity");
+            // Call the defined function, but only after first checking if it exists
+            g_LuaMan.RunScriptString("if " + m_LuaClassName + ".UpdateActivity then " + m_LuaClassName + ":UpdateActivity(); end");
+        }
 
         UpdateGlobalScripts(false);
     }
@@ -527,11 +527,11 @@ void GibEditor::Update()
                     m_pEditedObject->Update();
 
                     // Make proxy copies of the loaded objects' gib reference instances and place them in the list to be edited
-                    list<Gib> *pLoadedGibList = m_pEditedObject->GetGibList();
+                    vector<Gib> *pLoadedGibList = m_pEditedObject->GetGibList();
                     list<MovableObject *> *pEditedGibList = m_pEditorGUI->GetPlacedGibs();
                     MovableObject *pGibCopy = 0;
 
-                    for (list<Gib>::iterator gItr = pLoadedGibList->begin(); gItr != pLoadedGibList->end(); ++gItr)
+                    for (vector<Gib>::iterator gItr = pLoadedGibList->begin(); gItr != pLoadedGibList->end(); ++gItr)
                     {
                         pGibCopy = dynamic_cast<MovableObject *>((*gItr).GetParticlePreset()->Clone());
                         if (pGibCopy)
@@ -823,7 +823,7 @@ void GibEditor::StuffEditedGibs(MOSRotating *pEditedObject)
         return;
 
     // Replace the gibs of the object with the proxies that have been edited in the gui
-    list<Gib> *pObjectGibList = pEditedObject->GetGibList();
+    vector<Gib> *pObjectGibList = pEditedObject->GetGibList();
     pObjectGibList->clear();
 
     // Take each proxy object and stuff it into a Gib instance which then gets stuffed into the object to be saved
@@ -921,9 +921,8 @@ bool ACrab::Look(float FOVSpread, float range)
 
     // TODO: generate an alarm event if we spot an enemy actor?
 
-    Vector ignored;
-    // Cast the seeing ray, adjusting the skip to match the resolution of the unseen map
-    return g_SceneMan.CastSeeRay(m_Team, aimPos, lookVector, ignored, 25, (int)g_SceneMan.GetUnseenResolution(m_Team).GetSmallest() / 2);
+    // Cast the seeing ray through the perception cache, which adjusts the skip to match the resolution of the unseen map
+    return g_MovableMan.GetPerceptionCache().Look(this, aimPos, lookVector);
 }
 
 
@@ -936,7 +935,6 @@ bool ACrab::Look(float FOVSpread, float range)
 
 MovableObject * ACrab::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
 {
-    MovableObject *pSeenMO = 0;
     Vector aimPos = m_Pos;
     float aimDistance = m_AimDistance + g_FrameMan.GetPlayerScreenWidth() * 0.51;   // Set the length of the look vector
 
@@ -959,15 +957,9 @@ MovableObject * ACrab::LookForMOs(float FOVSpread, unsigned char ignoreMaterial,
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
-    // Add the spread
-    lookVector.DegRotate(FOVSpread * RandomNormalNum());
-
-    MOID seenMOID = g_SceneMan.CastMORay(aimPos, lookVector, m_MOID, IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5);
-    pSeenMO = g_MovableMan.GetMOFromID(seenMOID);
-    if (pSeenMO)
-        return pSeenMO->GetRootParent();
 
-    return pSeenMO;
+    // The spread gets added by the perception cache if it actually casts a ray, otherwise it answers with what this or a teammate close by saw recently in that direction
+    return g_MovableMan.GetPerceptionCache().LookForMOs(this, aimPos, lookVector, FOVSpread, ignoreMaterial, ignoreAllTerrain);
 }
 
 
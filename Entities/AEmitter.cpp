@@ -529,13 +529,13 @@ void AEmitter::Update()
 						pParticle->SetPos(m_Pos + RotateOffset((*eItr)->GetOffset()));
 					}
     // TODO: Optimize making the random angles!")
-                    emitVel.SetXY(velMin + RandomNum(0.0F, velRange), 0.0F);
-					emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * RandomNormalNum());
+                    emitVel.SetXY(velMin + m_RandomStream.RandomNum(0.0F, velRange), 0.0F);
+					emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * m_RandomStream.RandomNormalNum());
                     emitVel = RotateOffset(emitVel);
                     pParticle->SetVel(parentVel + emitVel);
 
                     if (pParticle->GetLifetime() != 0)
-                        pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr)->GetLifeVariation() * RandomNormalNum())));
+                        pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr)->GetLifeVariation() * m_RandomStream.RandomNormalNum())));
                     pParticle->SetTeam(m_Team);
                     pParticle->SetIgnoresTeamHits(true);
 
@@ -653,7 +653,7 @@ void AEmitter::Draw(BITMAP *pTargetBitmap,
         emitPos.RadRotate(m_HFlipped ? c_PI + m_Rotation.GetRadAngle() - m_EmitAngle.GetRadAngle() : m_Rotation.GetRadAngle() + m_EmitAngle.GetRadAngle());
         emitPos = m_Pos + RotateOffset(m_EmissionOffset) + emitPos;
         if(!g_SceneMan.ObscuredPoint(emitPos))
-            g_PostProcessMan.RegisterPostEffect(emitPos, m_pFlash->GetScreenEffect(), m_pFlash->GetScreenEffectHash(), 55.0F + RandomNum(0.0F, 200.0F), m_pFlash->GetEffectRotAngle());
+            g_PostProcessMan.RegisterPostEffect(emitPos, m_pFlash->GetScreenEffect(), m_pFlash->GetScreenEffectHash(), 55.0F + g_DrawRNG.RandomNum(0.0F, 200.0F), m_pFlash->GetEffectRotAngle());
 //            g_SceneMan.RegisterPostEffect(emitPos, m_pFlash->GetScreenEffect(), 55 + (200 * RandomNum() * ((float)1 - ((float)m_AgeTimer.GetElapsedSimTimeMS() / (float)m_Lifetime))));
     }
 }
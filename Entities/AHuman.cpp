@@ -1582,9 +1582,8 @@ bool AHuman::Look(float FOVSpread, float range)
 
     // TODO: generate an alarm event if we spot an enemy actor?
 
-	Vector ignored;
-    // Cast the seeing ray, adjusting the skip to match the resolution of the unseen map
-    return g_SceneMan.CastSeeRay(m_Team, aimPos, lookVector, ignored, 25, (int)g_SceneMan.GetUnseenResolution(m_Team).GetSmallest() / 2);
+    // Cast the seeing ray through the perception cache, which adjusts the skip to match the resolution of the unseen map
+    return g_MovableMan.GetPerceptionCache().Look(this, aimPos, lookVector);
 }
 
 
@@ -1598,7 +1597,7 @@ bool AHuman::LookForGold(float FOVSpread, float range, Vector &foundLocation)
     Vector ray(m_HFlipped ? -range : range, 0);
 	ray.DegRotate(FOVSpread * RandomNormalNum());
 
-    return g_SceneMan.CastMaterialRay(m_Pos, ray, g_MaterialGold, foundLocation, 4);
+    return g_MovableMan.GetPerceptionCache().LookForGold(this, m_Pos, ray, foundLocation);
 }
 
 
@@ -1611,7 +1610,6 @@ bool AHuman::LookForGold(float FOVSpread, float range, Vector &foundLocation)
 
 MovableObject * AHuman::LookForMOs(float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain)
 {
-    MovableObject *pSeenMO = 0;
     Vector aimPos = m_Pos;
     float aimDistance = m_AimDistance + g_FrameMan.GetPlayerScreenWidth() * 0.51;   // Set the length of the look vector
 
@@ -1633,15 +1631,9 @@ MovableObject * AHuman::LookForMOs(float FOVSpread, unsigned char ignoreMaterial
     Matrix aimMatrix(m_HFlipped ? -m_AimAngle : m_AimAngle);
     aimMatrix.SetXFlipped(m_HFlipped);
     lookVector *= aimMatrix;
-    // Add the spread
-    lookVector.DegRotate(FOVSpread * RandomNormalNum());
-
-    MOID seenMOID = g_SceneMan.CastMORay(aimPos, lookVector, m_MOID, IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5);
-    pSeenMO = g_MovableMan.GetMOFromID(seenMOID);
-    if (pSeenMO)
-        return pSeenMO->GetRootParent();
 
-    return pSeenMO;
+    // The spread gets added by the perception cache if it actually casts a ray, otherwise it answers with what this or a teammate close by saw recently in that direction
+    return g_MovableMan.GetPerceptionCache().LookForMOs(this, aimPos, lookVector, FOVSpread, ignoreMaterial, ignoreAllTerrain);
 }
 
 
@@ -3956,7 +3948,10 @@ void AHuman::Update()
             m_Paths[FGROUND][CRAWL].Terminate();
             m_Paths[BGROUND][CRAWL].Terminate();
 
-            if (m_pFGLeg)
+            // While dormant this doesn't travel in between its full updates, so there's nothing for the legs to hold up until then
+            bool pushLegs = !IsPhysicsPausedByLOD();
+
+            if (m_pFGLeg && pushLegs)
                 m_pFGFootGroup->PushAsLimb(m_Pos.GetFloored() + m_pFGLeg->GetParentOffset().GetXFlipped(m_HFlipped),
                                       m_Vel,
                                       Matrix(),
@@ -3966,7 +3961,7 @@ void AHuman::Update()
                                       0,
                                       false);
 
-            if (m_pBGLeg)
+            if (m_pBGLeg && pushLegs)
                 m_pBGFootGroup->PushAsLimb(m_Pos.GetFloored() + m_pBGLeg->GetParentOffset().GetXFlipped(m_HFlipped),
                                       m_Vel,
                                       Matrix(),
@@ -4468,7 +4463,7 @@ void AHuman::DrawThrowingReticule(BITMAP *pTargetBitmap, const Vector &targetPos
             points[i] += m_pFGArm->GetParentOffset();
 
         // Put the flickering glows on the reticule dots, in absolute scene coordinates
-		g_PostProcessMan.RegisterGlowDotEffect(points[i], YellowDot, 55.0F + RandomNum(0.0F, 100.0F));
+		g_PostProcessMan.RegisterGlowDotEffect(points[i], YellowDot, 55.0F + g_DrawRNG.RandomNum(0.0F, 100.0F));
 
         putpixel(pTargetBitmap, points[i].m_X - targetPos.m_X, points[i].m_Y - targetPos.m_Y, g_YellowGlowColor);
     }
@@ -115,6 +115,8 @@ void Actor::Clear()
     m_PassengerSlots = 1;
 
     m_ScriptedAIUpdate = false;
+    m_AIUpdatedInParallel = false;
+    m_ParallelAIDisabled = false;
     m_AIMode = AIMODE_NONE;
     m_Waypoints.clear();
     m_DrawWaypoints = false;
@@ -482,6 +484,8 @@ int Actor::Save(Writer &writer) const
 
 void Actor::Destroy(bool notInherited)
 {
+    g_LuaMan.ReleaseParallelAIActor(m_UniqueID);
+
     for (deque<MovableObject *>::const_iterator itr = m_Inventory.begin(); itr != m_Inventory.end(); ++itr)
         delete (*itr);
 
@@ -501,6 +505,10 @@ int Actor::LoadScript(std::string const &scriptPath, bool loadAsEnabledScript) {
     // If UpdateAI existed it'll be in the lua global namespace, so we can check that to know whether or not to use Lua AI
     m_ScriptedAIUpdate = m_ScriptedAIUpdate || g_LuaMan.GlobalIsDefined("UpdateAI");
 
+    // Scripts mark their UpdateAI as safe to run on a worker thread by defining ThreadSafeAI = true. Clear it right away so it doesn't carry over to the next script loaded.
+    if (g_LuaMan.GlobalIsDefined("UpdateAI") && g_LuaMan.ExpressionIsTrue("ThreadSafeAI", false)) { g_LuaMan.AddThreadSafeAIScript(scriptPath); }
+    g_LuaMan.RunScriptString("ThreadSafeAI = nil;");
+
     return status;
 }
 
@@ -708,8 +716,7 @@ bool Actor::Look(float FOVSpread, float range)
         lookVector.DegRotate(FOVSpread * RandomNormalNum());
     }
 
-	Vector ignored;
-    return g_SceneMan.CastSeeRay(m_Team, aimPos, lookVector, ignored, 25, g_SceneMan.GetUnseenResolution(m_Team).GetSmallest() / 2);
+    return g_MovableMan.GetPerceptionCache().Look(this, aimPos, lookVector);
 }
 
 
@@ -1207,6 +1214,9 @@ bool Actor::UpdateMovePath()
 {
     // TODO: Do throttling of calls for this function over time??
 
+    // Pathfinding changes the doors and the pathfinder shared by everyone, so if asked for by AI scripts running in parallel, it's done once they're all finished
+    if (g_MovableMan.DeferParallelAIMovePathUpdate(this))
+        return false;
 
     // Remove the material representation of all doors of this guy's team so he can navigate through them (they'll open for him)
     g_MovableMan.OverrideMaterialDoors(true, m_Team);
@@ -1215,7 +1225,7 @@ bool Actor::UpdateMovePath()
 
     // If we're following someone/thing, then never advance waypoints until that thing disappears
     if (g_MovableMan.ValidMO(m_pMOMoveTarget))
-        g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_pMOMoveTarget->GetPos(), m_MovePath, m_DigStrength);
+        g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_pMOMoveTarget->GetPos(), m_MovePath, m_DigStrength, m_Team);
     else
     {
         // Do we currently have a path to a static target we would like to still pursue?
@@ -1225,7 +1235,7 @@ bool Actor::UpdateMovePath()
             if (!m_Waypoints.empty())
             {
                 // Make sure the path starts from the ground and not somewhere up in the air if/when dropped out of ship
-                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_Waypoints.front().first, m_MovePath, m_DigStrength);
+                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_Waypoints.front().first, m_MovePath, m_DigStrength, m_Team);
                 // If the waypoint was tied to an MO to pursue, then load it into the current MO target
                 if (g_MovableMan.ValidMO(m_Waypoints.front().second))
                     m_pMOMoveTarget = m_Waypoints.front().second;
@@ -1236,11 +1246,11 @@ bool Actor::UpdateMovePath()
             }
             // Just try to get to the last Move Target
             else
-                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_MoveTarget, m_MovePath, m_DigStrength);
+                g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), m_MoveTarget, m_MovePath, m_DigStrength, m_Team);
         }
         // We had a path before trying to update, so use its last point as the final destination
         else
-            g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), Vector(m_MovePath.back()), m_MovePath, m_DigStrength);
+            g_SceneMan.GetScene()->CalculatePath(g_SceneMan.MovePointToGround(m_Pos, m_CharHeight*0.2, 10), Vector(m_MovePath.back()), m_MovePath, m_DigStrength, m_Team);
     }
 
     // Place back the material representation of all doors of this guy's team so they are as we found them
@@ -1283,6 +1293,24 @@ bool Actor::UpdateMovePath()
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool Actor::CanUpdateAIInParallel() const {
+    if (!m_ScriptedAIUpdate || m_ParallelAIDisabled || !ObjectScriptsInitialized() || m_FunctionsAndScripts.find("UpdateAI") == m_FunctionsAndScripts.end()) {
+        return false;
+    }
+    bool anyEnabledScript = false;
+    for (const std::pair<std::string, bool> *scriptEntry : m_FunctionsAndScripts.at("UpdateAI")) {
+        if (scriptEntry->second) {
+            if (!g_LuaMan.IsThreadSafeAIScript(scriptEntry->first)) {
+                return false;
+            }
+            anyEnabledScript = true;
+        }
+    }
+    return anyEnabledScript;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool Actor::UpdateAIScripted() {
     if (!m_ScriptedAIUpdate || m_AllLoadedScripts.empty() || m_ScriptPresetName.empty()) {
         return false;
@@ -1495,7 +1523,7 @@ void Actor::Update()
     /////////////////////////////////////
     // Detract damage caused by wounds from health
 
-    for (list<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
+    for (vector<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
         m_Health -= (*itr)->CollectDamage() * m_DamageMultiplier; //Actors must apply DamageMultiplier effects to their main MO by themselves
 
     /////////////////////////////////////////////
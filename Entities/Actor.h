@@ -990,6 +990,16 @@ ClassInfoGetters
     void DrawWaypoints(bool drawWaypoints = true) { m_DrawWaypoints = drawWaypoints; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDrawWaypoints
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this Actor draws its waypoints and path in its HUD.
+// Arguments:       None.
+// Return value:    Whether waypoints are drawn.
+
+    bool GetDrawWaypoints() const { return m_DrawWaypoints; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  GibThis
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1085,7 +1095,9 @@ ClassInfoGetters
 //                  current waypoint, if any. CAVEAT: this only actually updates if a queue
 //                  index number passed in is sufficiently close to 0 to allow this to
 //                  compute, based on an internal global assessment of how often this very
-//                  expensive computation is allowed to run.
+//                  expensive computation is allowed to run. When asked for by AI scripts
+//                  running on a parallel AI worker, the update is done once all the workers
+//                  are finished instead, and this returns false.
 // Arguments:       The queue number this was given the last time
 // Return value:    Whether the update was performed, or if it should be tried again next
 //                  frame.
@@ -1104,6 +1116,62 @@ ClassInfoGetters
 	bool UpdateAIScripted();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CanUpdateAIInParallel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this' scripted AI can be updated on a parallel AI worker,
+//                  which requires all of its enabled UpdateAI scripts to be marked as
+//                  thread-safe.
+// Arguments:       None.
+// Return value:    Whether this' AI can be updated in parallel.
+
+	bool CanUpdateAIInParallel() const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUpdateAIScripts
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the scripts of this that define an UpdateAI function. Only valid
+//                  if CanUpdateAIInParallel is true.
+// Arguments:       None.
+// Return value:    The paths of the scripts and whether each is enabled.
+
+	const std::vector<std::pair<std::string, bool> *> & GetUpdateAIScripts() const { return m_FunctionsAndScripts.at("UpdateAI"); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AIUpdatedInParallel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this' scripted AI was already updated on a parallel AI
+//                  worker this update.
+// Arguments:       None.
+// Return value:    Whether this' AI was updated in parallel.
+
+	bool AIUpdatedInParallel() const { return m_AIUpdatedInParallel; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetAIUpdatedInParallel
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets whether this' scripted AI was already updated on a parallel AI
+//                  worker this update.
+// Arguments:       Whether this' AI was updated in parallel.
+// Return value:    None.
+
+	void SetAIUpdatedInParallel(bool updatedInParallel) { m_AIUpdatedInParallel = updatedInParallel; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DisableParallelAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Makes this' scripted AI only run on the master Lua state from now on,
+//                  used when it failed to run on a parallel AI worker.
+// Arguments:       None.
+// Return value:    None.
+
+	void DisableParallelAI() { m_ParallelAIDisabled = true; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  UpdateAI
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1455,6 +1523,10 @@ protected:
     static bool m_sIconsLoaded;
     // Whether a Lua update AI function was provided in this' script file
     bool m_ScriptedAIUpdate;
+    // Whether this' scripted AI was already updated on a parallel AI worker this update, so the Controller shouldn't run it again
+    bool m_AIUpdatedInParallel;
+    // Whether this' scripted AI failed to run on a parallel AI worker, so it should only run on the master Lua state from now on
+    bool m_ParallelAIDisabled;
     // The current mode the AI is set to perform as
     AIMode m_AIMode;
     // The list of waypoints remaining between which the paths are made. If this is empty, the last path is in teh MovePath
@@ -104,21 +104,11 @@ int AtomGroup::Create(const AtomGroup &reference, bool onlyCopyOwnerAtoms)
 			pAtomCopy->SetIgnoreMOIDsByGroup(&m_IgnoreMOIDs);
 
 			m_Atoms.push_back(pAtomCopy);
-
-			// Add to the appropriate spot in the subgroup map
-			long int subID = pAtomCopy->GetSubID();
-			if (subID != 0)
-			{
-				// Make a new list for the subgroup ID if there isn't one already
-				if (m_SubGroups.find(subID) == m_SubGroups.end())
-				{
-					m_SubGroups.insert(pair<long int, list<Atom *>>(subID, list<Atom *>()));
-				}
-				// Add Atom to the list of that group
-				m_SubGroups.find(subID)->second.push_back(pAtomCopy);
-			}
 		}
 	}
+	// When every Atom is copied they're in the same order as the reference's, so the subgroups take up the same ranges. Otherwise none of the subgroups' Atoms were copied
+	if (!onlyCopyOwnerAtoms)
+		m_SubGroups = reference.m_SubGroups;
 
 	// Copy ignored MOIDs list
 	for (const MOID  moidToIgnore : reference.m_IgnoreMOIDs)
@@ -561,7 +551,7 @@ int AtomGroup::Save(Writer &writer) const
 
 void AtomGroup::Destroy(bool notInherited)
 {
-	for (list<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
+	for (vector<Atom *>::const_iterator itr = m_Atoms.begin(); itr != m_Atoms.end(); ++itr)
 		delete *itr;
 
     if (!notInherited)
@@ -672,26 +662,48 @@ void AtomGroup::SetOwner(MOSRotating *newOwner)
 // Description:     Adds a list of new Atom:s to the internal list that makes up this group.
 //                  Ownership of all Atom:s in the list IS NOT transferred!
 
-void AtomGroup::AddAtoms(const std::list<Atom *> &atomList, long int subID, const Vector &offset, const Matrix &offsetRotation)
+void AtomGroup::AddAtoms(const vector<Atom *> &atomList, long int subID, const Vector &offset, const Matrix &offsetRotation)
 {
-    Atom *pAtom;
-
-    // Make a new list for the subgroup ID if there isn't one already
-	if (m_SubGroups.count(subID) == 0)
-	{
-		m_SubGroups.insert(pair<long int, list<Atom *> >(subID, list<Atom *>()));
-	}
+    vector<Atom *> atomCopies;
+    atomCopies.reserve(atomList.size());
     for (const Atom * atom : atomList)
     {
-        pAtom = new Atom(*atom);
+        Atom *pAtom = new Atom(*atom);
         pAtom->SetSubID(subID);
         pAtom->SetOffset(offset + (pAtom->GetOriginalOffset() * offsetRotation));
         pAtom->SetOwner(m_pOwnerMO);
-        // Put ownership here
-        m_Atoms.push_back(pAtom);
+        atomCopies.push_back(pAtom);
+    }
+    // Put ownership here, next to the rest of the subgroup
+    InsertSubGroupAtoms(subID, atomCopies);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InsertSubGroupAtoms
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Inserts Atom:s right after the last Atom of a subgroup, or at the end
+//                  if there's no such subgroup yet, and moves the ranges of the subgroups
+//                  after it along, so every subgroup's Atoms stay next to each other.
+
+void AtomGroup::InsertSubGroupAtoms(long int subID, const vector<Atom *> &atomList)
+{
+    if (atomList.empty())
+        return;
 
-        // Add the atom to the subgroup in the SubGroups map, not transferring ownership
-        m_SubGroups.at(subID).push_back(pAtom);
+    std::unordered_map<long int, SubGroupRange>::iterator subGroupItr = m_SubGroups.find(subID);
+    if (subGroupItr == m_SubGroups.end())
+        subGroupItr = m_SubGroups.insert(pair<long int, SubGroupRange>(subID, { m_Atoms.size(), 0 })).first;
+
+    size_t insertIndex = subGroupItr->second.Start + subGroupItr->second.Count;
+    m_Atoms.insert(m_Atoms.begin() + insertIndex, atomList.begin(), atomList.end());
+    subGroupItr->second.Count += atomList.size();
+
+    // Only subgroups added after this one can be past the insertion point
+    for (pair<const long int, SubGroupRange> &subGroup : m_SubGroups)
+    {
+        if (subGroup.first != subID && subGroup.second.Start >= insertIndex)
+            subGroup.second.Start += atomList.size();
     }
 }
 
@@ -706,16 +718,17 @@ void AtomGroup::AddAtoms(const std::list<Atom *> &atomList, long int subID, cons
 bool AtomGroup::UpdateSubAtoms(long int subID, const Vector &newOffset, const Matrix &newOffsetRotation)
 {
 	// Try to find existing subgroup with that ID to update
-	if (m_SubGroups.count(subID) == 0)
+	std::unordered_map<long int, SubGroupRange>::const_iterator subGroupItr = m_SubGroups.find(subID);
+	if (subGroupItr == m_SubGroups.end())
 	{
 		return false;
 	}
-	RTEAssert(!m_SubGroups.at(subID).empty(), "Found empty atom subgroup list!?");
+	RTEAssert(subGroupItr->second.Count > 0, "Found empty atom subgroup list!?");
 
-	for (Atom *subGroupAtom : m_SubGroups.at(subID))
+	size_t subGroupEnd = subGroupItr->second.Start + subGroupItr->second.Count;
+	for (size_t atomIndex = subGroupItr->second.Start; atomIndex < subGroupEnd; ++atomIndex)
 	{
-		subGroupAtom->SetSubID(subID); // Re-set ID just to make sure - TODO I don't think we need this?!
-		subGroupAtom->SetOffset(newOffset + (subGroupAtom->GetOriginalOffset() * newOffsetRotation));
+		m_Atoms[atomIndex]->SetOffset(newOffset + (m_Atoms[atomIndex]->GetOriginalOffset() * newOffsetRotation));
 	}
 
 	return true;
@@ -729,28 +742,24 @@ bool AtomGroup::UpdateSubAtoms(long int subID, const Vector &newOffset, const Ma
 
 bool AtomGroup::RemoveAtoms(long int removeID)
 {
-    bool removedAny = false;
-    list<Atom *>::iterator eraseItr;
+    // Every Atom with a subgroup ID is in its subgroup's range, so nothing else has to be looked through
+    std::unordered_map<long int, SubGroupRange>::iterator subGroupItr = m_SubGroups.find(removeID);
+    if (subGroupItr == m_SubGroups.end())
+        return false;
+
+    SubGroupRange removedRange = subGroupItr->second;
+    m_SubGroups.erase(subGroupItr);
+    for (size_t atomIndex = removedRange.Start; atomIndex < removedRange.Start + removedRange.Count; ++atomIndex)
+        delete m_Atoms[atomIndex];
+    m_Atoms.erase(m_Atoms.begin() + removedRange.Start, m_Atoms.begin() + removedRange.Start + removedRange.Count);
 
-    for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end();)
+    for (pair<const long int, SubGroupRange> &subGroup : m_SubGroups)
     {
-        if ((*aItr)->GetSubID() == removeID)
-        {
-            // This hanky panky necessary to not invalidate the aItr iterator
-            delete (*aItr);
-            eraseItr = aItr;
-            aItr++;
-            m_Atoms.erase(eraseItr);
-            removedAny = true;
-        }
-        else
-            aItr++;
+        if (subGroup.second.Start > removedRange.Start)
+            subGroup.second.Start -= removedRange.Count;
     }
 
-    // Try to erase the group from the subgroup map
-    m_SubGroups.erase(removeID);
-
-    return removedAny;
+    return removedRange.Count > 0;
 }
 
 
@@ -762,7 +771,7 @@ bool AtomGroup::RemoveAtoms(long int removeID)
 
 void AtomGroup::AddMOIDToIgnore(MOID ignore)
 {
-    /*for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    /*for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
         (*aItr)->AddMOIDToIgnore(ignore);*/
 	// m_IgnoreMOIDs is passed to every atom which belongs to this group to avoid messing with every single atom
 	// when adding or removing ignored MOs
@@ -780,7 +789,7 @@ void AtomGroup::AddMOIDToIgnore(MOID ignore)
 
 void AtomGroup::ClearMOIDIgnoreList()
 {
-    /*for (list<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
+    /*for (vector<Atom *>::iterator aItr = m_Atoms.begin(); aItr != m_Atoms.end(); ++aItr)
         (*aItr)->ClearMOIDIgnoreList();*/
 	// m_IgnoreMOIDs is passed to every atom which belongs to this group to avoid messing with every single atom
 	// when adding or removing ignored MOs
@@ -958,10 +967,22 @@ float AtomGroup::Travel(Vector &position,
 	bool halted = false;
 	bool hitMOs = m_pOwnerMO->m_HitsMOs;
     Atom *pFastestAtom = 0;
-    map<MOID, list<Atom *> > hitMOAtoms;
-    list<Atom *> hitTerrAtoms;
-    list<Atom *> penetratingAtoms;
-    list<Atom *> hitResponseAtoms;
+    map<MOID, vector<Atom *> > hitMOAtoms;
+    vector<Atom *> hitTerrAtoms;
+    vector<Atom *> penetratingAtoms;
+    vector<Atom *> hitResponseAtoms;
+    // Cleared but never shrunk between segments, so they only allocate on the first hits
+    hitTerrAtoms.reserve(m_Atoms.size());
+    penetratingAtoms.reserve(m_Atoms.size());
+    hitResponseAtoms.reserve(m_Atoms.size());
+    // The Atoms that took a step, with their new positions and what's there, in structure of arrays form so the lookups run through the positions in one tight loop.
+    // Kept between calls so they only ever grow
+    static thread_local vector<Atom *> steppedAtoms;
+    static thread_local vector<int> steppedAtomXs;
+    static thread_local vector<int> steppedAtomYs;
+    static thread_local vector<unsigned char> steppedAtomTerrMatters;
+    static thread_local vector<MOID> steppedAtomMOIDs;
+    int steppedAtomCount = 0;
 	Vector linSegTraj;
 	Vector startOff;
 	Vector targetOff;
@@ -1118,10 +1139,36 @@ float AtomGroup::Travel(Vector &position,
             // SCENE COLLISION DETECTION //////////////////////////////////////////////////////
             ///////////////////////////////////////////////////////////////////////////////////
 
+            if (steppedAtoms.size() < m_Atoms.size())
+            {
+                steppedAtoms.resize(m_Atoms.size());
+                steppedAtomXs.resize(m_Atoms.size());
+                steppedAtomYs.resize(m_Atoms.size());
+                steppedAtomTerrMatters.resize(m_Atoms.size());
+                steppedAtomMOIDs.resize(m_Atoms.size());
+            }
+
+            // Take one step with every Atom first, then look up what's at all the new positions at once.
+            // Nothing that's looked up changes until the hits are responded to, so checking the hits afterwards in the same order gives the same results as stepping the Atoms one by one.
+            steppedAtomCount = 0;
             for (Atom *atom : m_Atoms)
             {
-                // Take one step, and check if the atom hit anything
-                if (atom->StepForward())
+                if (atom->AdvanceStep())
+                {
+                    steppedAtoms[steppedAtomCount] = atom;
+                    steppedAtomXs[steppedAtomCount] = atom->GetCurrentIntPosX();
+                    steppedAtomYs[steppedAtomCount] = atom->GetCurrentIntPosY();
+                    ++steppedAtomCount;
+                }
+            }
+            if (steppedAtomCount > 0)
+                g_SceneMan.GetTerrMattersAndMOIDs(steppedAtomCount, steppedAtomXs.data(), steppedAtomYs.data(), steppedAtomTerrMatters.data(), steppedAtomMOIDs.data());
+
+            for (int steppedAtom = 0; steppedAtom < steppedAtomCount; ++steppedAtom)
+            {
+                Atom *atom = steppedAtoms[steppedAtom];
+                // Check if the step the atom took hit anything
+                if (atom->ResolveStepHits(steppedAtomTerrMatters[steppedAtom], steppedAtomMOIDs[steppedAtom]))
                 {
                     //  So something was hit, first check for terrain hit.
                     if (atom->HitWhatTerrMaterial())
@@ -1147,9 +1194,9 @@ float AtomGroup::Travel(Vector &position,
 							// and insert into the map of MO-hitting Atom:s.
 							if (!(hitMOAtoms.count(tempMOID)))
 							{
-								list<Atom *> newDeque;
+								vector<Atom *> newDeque;
 								newDeque.push_back(atom);
-								hitMOAtoms.insert(pair<MOID, list<Atom *> >(tempMOID, newDeque));
+								hitMOAtoms.insert(pair<MOID, vector<Atom *> >(tempMOID, newDeque));
 							}
 							// If another Atom of this group has already hit this same MO
 							// during this step, go ahead and add the new atom to the
@@ -1222,7 +1269,7 @@ float AtomGroup::Travel(Vector &position,
                 distMass = mass / static_cast<float>(hitTerrAtoms.size() * (m_Resolution ? m_Resolution : 1));
                 distMI = m_MomInertia / static_cast<float>(hitTerrAtoms.size() * (m_Resolution ? m_Resolution : 1));
 
-				for (std::list<Atom*>::iterator aItr = hitTerrAtoms.begin(); aItr != hitTerrAtoms.end(); )
+				for (vector<Atom*>::iterator aItr = hitTerrAtoms.begin(); aItr != hitTerrAtoms.end(); )
                 {
                     // Calc and store the accurate hit radius of the Atom in relation to the CoM
                     tempVec = (*aItr)->GetOffset().GetXFlipped(hFlipped);
@@ -1376,7 +1423,7 @@ float AtomGroup::Travel(Vector &position,
 				hitData.MomInertia[HITOR] = m_MomInertia;
 				hitData.ImpulseFactor[HITOR] = 1.0F / static_cast<float>(atomsHitMOsCount);
 
-				for (const map<MOID, std::list<Atom *>>::value_type &MOAtomMapEntry : hitMOAtoms)
+				for (const map<MOID, vector<Atom *>>::value_type &MOAtomMapEntry : hitMOAtoms)
                 {
 					// The denominator that the MovableObject being hit should
                     // divide its mass with for each atom of this AtomGroup that is
@@ -2346,7 +2393,7 @@ bool AtomGroup::ResolveTerrainIntersection(Vector &position, Matrix &rotation, u
 	Vector exitDirection;
 	Vector atomExitVector;
 	Vector totalExitVector;
-    list<Atom *> intersectingAtoms;
+    vector<Atom *> intersectingAtoms;
     MOID hitMaterial = g_MaterialAir;
     float strengthThreshold = strongerThan != g_MaterialAir ? g_SceneMan.GetMaterialFromID(strongerThan)->GetIntegrity() : 0.0F;
     bool rayHit = false;
@@ -2457,7 +2504,7 @@ bool AtomGroup::ResolveMOSIntersection(Vector &position, Matrix &rotation)
 	Vector exitDirection;
 	Vector atomExitVector;
 	Vector totalExitVector;
-    list<Atom *> intersectingAtoms;
+    vector<Atom *> intersectingAtoms;
 	MOID hitMOID = g_NoMOID;
 	MOID currentMOID = g_NoMOID;
     MovableObject *pIntersectedMO = 0;
@@ -223,7 +223,7 @@ ClassInfoGetters
 // Arguments:       None.
 // Return value:    A reference to the list.
 
-    const std::list<Atom *> & GetAtomList() const { return m_Atoms; }
+    const std::vector<Atom *> & GetAtomList() const { return m_Atoms; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -372,7 +372,7 @@ ClassInfoGetters
 //                  The subgroup ID that the new atom will have within the group.
 // Return value:    None.
 
-    void AddAtom(Atom *newAtom, int atomID = 0) { newAtom->SetSubID(atomID); m_Atoms.push_back(newAtom); }
+    void AddAtom(Atom *newAtom, int atomID = 0) { newAtom->SetSubID(atomID); if (atomID == 0) { m_Atoms.push_back(newAtom); } else { InsertSubGroupAtoms(atomID, std::vector<Atom *>(1, newAtom)); } }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -387,7 +387,7 @@ ClassInfoGetters
 //                  The rotation of the placed atoms around the above offset.
 // Return value:    None.
 
-    void AddAtoms(const std::list<Atom *> &atomList, long int subID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
+    void AddAtoms(const std::vector<Atom *> &atomList, long int subID = 0, const Vector &offset = Vector(), const Matrix &offsetRotation = Matrix());
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -624,6 +624,26 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          InsertSubGroupAtoms
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Inserts Atom:s right after the last Atom of a subgroup, or at the end
+//                  if there's no such subgroup yet, and moves the ranges of the subgroups
+//                  after it along, so every subgroup's Atoms stay next to each other.
+// Arguments:       The subgroup ID of the Atom:s.
+//                  The Atom:s to insert. Ownership IS transferred!
+// Return value:    None.
+
+    void InsertSubGroupAtoms(long int subID, const std::vector<Atom *> &atomList);
+
+
+    // Where the Atoms of a subgroup are in m_Atoms. The Atoms of each subgroup are kept next to each other
+    struct SubGroupRange
+    {
+        size_t Start;
+        size_t Count;
+    };
+
     static Entity::ClassInfo m_sClass;
 
     // Whether or not the Atom:s were automatically generated based on a sprite, or manually defined
@@ -636,10 +656,10 @@ private:
     // Depth, or how deep into the bitmap of the owning MO's graphical representation
     // the Atom:s of this AtomGroup are located, in pixels.
     int m_Depth;
-    // List of Atoms that constitute the group. Owned by this
-    std::list<Atom *> m_Atoms;
-    // Sub groupings of atoms, not owned in here. Point to atoms owned in m_Atoms.
-	std::unordered_map<long int, std::list<Atom *> > m_SubGroups;
+    // The Atoms that constitute the group, kept contiguous since every Travel step walks all of them. Owned by this
+    std::vector<Atom *> m_Atoms;
+    // Sub groupings of atoms, as the ranges of m_Atoms they take up. Updating a subgroup walks its Atoms in order, and removing it is a single erase.
+	std::unordered_map<long int, SubGroupRange> m_SubGroups;
     // Moment of Inertia for this AtomGroup
     float m_MomInertia;
     // The owner of this AtomGroup. The owner is obviously not owned by this AtomGroup.
@@ -650,7 +670,7 @@ private:
     // origin when used as a limb.
     Vector m_JointOffset;
 	// ignore hits with MOs of these IDs
-	std::list<MOID> m_IgnoreMOIDs;
+	std::vector<MOID> m_IgnoreMOIDs;
 
 // TODO: REMOVE THIS")
     Vector m_TestPos;
@@ -128,6 +128,7 @@ int GlobalScript::ReloadScripts()
 
 void GlobalScript::EnteredOrbit(Actor *orbitedActor) {
     if (orbitedActor && g_MovableMan.IsActor(orbitedActor)) {
+        LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "CraftEnteredOrbit");
         g_LuaMan.RunScriptedFunction(m_LuaClassName + ".CraftEnteredOrbit", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".CraftEnteredOrbit"}, {orbitedActor});
     }
 }
@@ -136,6 +137,7 @@ void GlobalScript::EnteredOrbit(Actor *orbitedActor) {
 
 void GlobalScript::OnPieMenu(Actor *pieMenuActor) {
 	if (pieMenuActor && g_MovableMan.IsActor(pieMenuActor)) {
+        LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "OnPieMenu");
         g_LuaMan.RunScriptedFunction(m_LuaClassName + ".OnPieMenu", m_LuaClassName, {m_LuaClassName, m_LuaClassName + ".OnPieMenu"}, {pieMenuActor});
 	}
 }
@@ -209,8 +211,12 @@ void GlobalScript::End()
 
 void GlobalScript::Update()
 {
-    // Call the defined function, but only after first checking if it exists
-    int error = g_LuaMan.RunScriptString("if " + m_LuaClassName + ".UpdateScript then " + m_LuaClassName + ":UpdateScript(); end");
+    int error;
+    {
+        LuaMan::ProfiledScriptScope profiledScript(m_ScriptPath, "UpdateScript");
+        // Call the defined function, but only after first checking if it exists
+        error = g_LuaMan.RunScriptString("if " + m_LuaClassName + ".UpdateScript then " + m_LuaClassName + ":UpdateScript(); end");
+    }
 	// Kill script on any error to avoid spamming the console with error messages
 	if (error)
 		Deactivate();
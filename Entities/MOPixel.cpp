@@ -26,7 +26,7 @@ namespace RTE {
 		}
 		if (!m_Atom) { m_Atom = new Atom; }
 
-		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= RandomNum(m_MinLethalRange, m_MaxLethalRange); }
+		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= m_RandomStream.RandomNum(m_MinLethalRange, m_MaxLethalRange); }
 		m_LethalSharpness = m_Sharpness * 0.5F;
 
 		return 0;
@@ -39,10 +39,14 @@ namespace RTE {
 		m_Atom = atom;
 		m_Atom->SetOwner(this);
 
-		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= RandomNum(m_MinLethalRange, m_MaxLethalRange); }
+		// The random stream is keyed by the unique ID, so it has to be assigned before the lethal range is randomized
+		if (MovableObject::Create(mass, position, velocity, lifetime) < 0) {
+			return -1;
+		}
+		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= m_RandomStream.RandomNum(m_MinLethalRange, m_MaxLethalRange); }
 		m_LethalSharpness = m_Sharpness * 0.5F;
 
-		return MovableObject::Create(mass, position, velocity, lifetime);
+		return 0;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -126,7 +130,7 @@ namespace RTE {
 
 	void MOPixel::SetLethalRange(float range) {
 		m_LethalRange = range;
-		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= RandomNum(m_MinLethalRange, m_MaxLethalRange); }
+		if (m_MinLethalRange < m_MaxLethalRange) { m_LethalRange *= m_RandomStream.RandomNum(m_MinLethalRange, m_MaxLethalRange); }
 
 		// convert to meters
 		m_LethalRange /= c_PPM;
@@ -235,12 +239,15 @@ namespace RTE {
 				break;
 		}
 
+		int pixelX = static_cast<int>(m_Pos.GetFloorIntX() - targetPos.m_X);
+		int pixelY = static_cast<int>(m_Pos.GetFloorIntY() - targetPos.m_Y);
+
 		acquire_bitmap(targetBitmap);
-		putpixel(targetBitmap, m_Pos.GetFloorIntX() - targetPos.m_X, m_Pos.GetFloorIntY() - targetPos.m_Y, drawColor);
+		putpixel(targetBitmap, pixelX, pixelY, drawColor);
 		release_bitmap(targetBitmap);
 
 		if (mode == g_DrawMOID) {
-			g_SceneMan.RegisterMOIDDrawing(m_Pos - targetPos, 1);
+			g_SceneMan.RegisterMOIDDrawing(pixelX, pixelY, pixelX, pixelY);
 		} else if (mode == g_DrawColor && m_pScreenEffect && !onlyPhysical) {
 			SetPostScreenEffectToDraw();
 		}
@@ -125,7 +125,7 @@ namespace RTE {
 		if (m_SpriteAnimMode == ONCOLLIDE) {
 			// Change angular velocity after collision.
 			if (hitCount >= 1) {
-				m_AngularVel *= 0.5F * velMag * RandomNormalNum();
+				m_AngularVel *= 0.5F * velMag * m_RandomStream.RandomNormalNum();
 				m_AngularVel = -m_AngularVel;
 			}
 
@@ -166,7 +166,7 @@ namespace RTE {
 				spriteX = spritePos.GetFloorIntX();
 				spriteY = spritePos.GetFloorIntY();
 				draw_character_ex(targetBitmap, m_aSprite[m_Frame], spriteX, spriteY, m_MOID, -1);
-				g_SceneMan.RegisterMOIDDrawing(spriteX, spriteY, spriteX + m_aSprite[m_Frame]->w, spriteY + m_aSprite[m_Frame]->h);
+				g_SceneMan.RegisterMOIDDrawing(spriteX, spriteY, spriteX + m_aSprite[m_Frame]->w - 1, spriteY + m_aSprite[m_Frame]->h - 1);
 				break;
 			case g_DrawNoMOID:
 				draw_character_ex(targetBitmap, m_aSprite[m_Frame], spritePos.GetFloorIntX(), spritePos.GetFloorIntY(), g_NoMOID, -1);
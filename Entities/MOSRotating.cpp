@@ -19,6 +19,7 @@
 #include "MOSParticle.h"
 #include "AEmitter.h"
 #include "Attachable.h"
+#include "FrameMan.h"
 
 #include "RTEError.h"
 
@@ -239,7 +240,7 @@ int MOSRotating::Create(const MOSRotating &reference)
 
 	// Wound emitter copies
     AEmitter *pWound = 0;
-    for (list<AEmitter *>::const_iterator itr = reference.m_Wounds.begin(); itr != reference.m_Wounds.end(); ++itr)
+    for (vector<AEmitter *>::const_iterator itr = reference.m_Wounds.begin(); itr != reference.m_Wounds.end(); ++itr)
     {
 		pWound = dynamic_cast<AEmitter *>((*itr)->Clone());
 		AddWound(pWound, pWound->GetParentOffset());
@@ -249,7 +250,7 @@ int MOSRotating::Create(const MOSRotating &reference)
 	// Attachable copies
     m_AllAttachables.clear();
     Attachable *pAttachable = 0;
-    for (list<Attachable *>::const_iterator aItr = reference.m_Attachables.begin(); aItr != reference.m_Attachables.end(); ++aItr)
+    for (vector<Attachable *>::const_iterator aItr = reference.m_Attachables.begin(); aItr != reference.m_Attachables.end(); ++aItr)
     {
         pAttachable = dynamic_cast<Attachable *>((*aItr)->Clone());
         AddAttachable(pAttachable, pAttachable->GetParentOffset());
@@ -257,7 +258,7 @@ int MOSRotating::Create(const MOSRotating &reference)
     }
 
 	// Gib copies
-    for (list<Gib>::const_iterator gItr = reference.m_Gibs.begin(); gItr != reference.m_Gibs.end(); ++gItr)
+    for (vector<Gib>::const_iterator gItr = reference.m_Gibs.begin(); gItr != reference.m_Gibs.end(); ++gItr)
     {
         m_Gibs.push_back(*gItr);
     }
@@ -397,18 +398,18 @@ int MOSRotating::Save(Writer &writer) const
     writer.NewProperty("OrientToVel");
     writer << m_OrientToVel;
 
-    for (list<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
+    for (vector<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
     {
         writer.NewProperty("AddEmitter");
         writer << (*itr);
     }
-    for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+    for (vector<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
     {
         writer.NewProperty("AddAttachable");
         writer << (*aItr);
     }
 */
-    for (list<Gib>::const_iterator gItr = m_Gibs.begin(); gItr != m_Gibs.end(); ++gItr)
+    for (vector<Gib>::const_iterator gItr = m_Gibs.begin(); gItr != m_Gibs.end(); ++gItr)
     {
         writer.NewProperty("AddGib");
         writer << (*gItr);
@@ -464,7 +465,7 @@ int MOSRotating::RemoveWounds(int amount)
 	int deleted = 0;
 	float damage = 0;
 
-    for (list<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end();)
+    for (vector<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end();)
 	{
 		damage += (*itr)->GetBurstDamage();
         delete (*itr);
@@ -489,9 +490,9 @@ void MOSRotating::Destroy(bool notInherited)
     delete m_pAtomGroup;
     delete m_pDeepGroup;
 
-    for (list<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
+    for (vector<AEmitter *>::iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
         delete (*itr);
-    for (list<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+    for (vector<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
         delete (*aItr);
 
     destroy_bitmap(m_pFlipBitmap);
@@ -516,7 +517,7 @@ float MOSRotating::GetMass() const
 {
     float totalMass = MOSprite::GetMass();
 
-    for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+    for (vector<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
         totalMass += (*aItr)->GetMass();
 
     return totalMass;
@@ -920,7 +921,7 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
     MovableObject *pGib = 0;
     float velMin, velRange, spread, angularVel;
     Vector gibROffset, gibVel;
-    for (list<Gib>::iterator gItr = m_Gibs.begin(); gItr != m_Gibs.end(); ++gItr)
+    for (vector<Gib>::iterator gItr = m_Gibs.begin(); gItr != m_Gibs.end(); ++gItr)
     {
 		// Throwing out gibs
         for (int i = 0; i < (*gItr).GetCount(); ++i)
@@ -948,12 +949,12 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
             gibROffset = RotateOffset((*gItr).GetOffset());
             // Put variation on the lifetime, if it's not set to be endless
             if (pGib->GetLifetime() != 0)
-                pGib->SetLifetime(pGib->GetLifetime() * (1.0F + ((*gItr).GetLifeVariation() * RandomNormalNum())));
+                pGib->SetLifetime(pGib->GetLifetime() * (1.0F + ((*gItr).GetLifeVariation() * m_RandomStream.RandomNormalNum())));
             // Set up its position and velocity according to the parameters of this AEmitter.
             pGib->SetPos(m_Pos + gibROffset/*Vector(m_Pos.m_X + 5 * NormalRand(), m_Pos.m_Y + 5 * NormalRand())*/);
             pGib->SetRotAngle(m_Rotation.GetRadAngle() + pGib->GetRotMatrix().GetRadAngle());
             // Rotational angle
-            pGib->SetAngularVel((pGib->GetAngularVel() * 0.35F) + (pGib->GetAngularVel() * 0.65F / pGib->GetMass()) * RandomNum());
+            pGib->SetAngularVel((pGib->GetAngularVel() * 0.35F) + (pGib->GetAngularVel() * 0.65F / pGib->GetMass()) * m_RandomStream.RandomNum());
             // Make it rotate away in the appropriate direction depending on which side of the object it is on
             // If the object is far to the relft or right of the center, make it always rotate outwards to some degree
             if (gibROffset.m_X > m_aSprite[0]->w / 3)
@@ -966,7 +967,7 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
             // Gib is too close to center to always make it rotate in one direction, so give it a baseline rotation and then randomize
             else
             {
-                pGib->SetAngularVel((pGib->GetAngularVel() * 0.5F + pGib->GetAngularVel() * RandomNum()) * (RandomNormalNum() > 0.0F ? 1.0F : -1.0F));
+                pGib->SetAngularVel((pGib->GetAngularVel() * 0.5F + pGib->GetAngularVel() * m_RandomStream.RandomNum()) * (m_RandomStream.RandomNormalNum() > 0.0F ? 1.0F : -1.0F));
             }
 
 // TODO: Optimize making the random angles!")
@@ -974,10 +975,10 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
 				// Pretty much always zero
                 gibVel = gibROffset;
 				if (gibVel.IsZero())
-					gibVel.SetXY(velMin + RandomNum(0.0F, velRange), 0);
+					gibVel.SetXY(velMin + m_RandomStream.RandomNum(0.0F, velRange), 0);
 				else
-					gibVel.SetMagnitude(velMin + RandomNum(0.0F, velRange));
-				gibVel.RadRotate(impactImpulse.GetAbsRadAngle() + spread * RandomNormalNum());
+					gibVel.SetMagnitude(velMin + m_RandomStream.RandomNum(0.0F, velRange));
+				gibVel.RadRotate(impactImpulse.GetAbsRadAngle() + spread * m_RandomStream.RandomNormalNum());
 // Don't! the offset was already rotated!
 //                gibVel = RotateOffset(gibVel);
                 // Distribute any impact implse out over all the gibs
@@ -1002,14 +1003,12 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
 
     // Throw out all the attachables
     Attachable *pAttachable = 0;
-    for (list<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ) //NOTE: No increment to handle RemoveAttachable removing the object
+    while (!m_Attachables.empty()) //NOTE: RemoveAttachable removes the front object each time around
     {
-        RTEAssert((*aItr), "Broken Attachable!");
-        if (!(*aItr))
-            continue;
+        RTEAssert(m_Attachables.front(), "Broken Attachable!");
 
         // Get handy handle to the object we're putting
-        pAttachable = *aItr;
+        pAttachable = m_Attachables.front();
 
 		// TODO: Rework this whole system
         // Generate the velocities procedurally
@@ -1017,7 +1016,7 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
         velRange = 10.0f;
 
         // Rotational angle velocity
-        pAttachable->SetAngularVel((pAttachable->GetAngularVel() * 0.35F) + (pAttachable->GetAngularVel() * 0.65F / pAttachable->GetMass()) * RandomNum());
+        pAttachable->SetAngularVel((pAttachable->GetAngularVel() * 0.35F) + (pAttachable->GetAngularVel() * 0.65F / pAttachable->GetMass()) * m_RandomStream.RandomNum());
         // Make it rotate away in the appropriate direction depending on which side of the object it is on
         // If the object is far to the relft or right of the center, make it always rotate outwards to some degree
         if (pAttachable->GetParentOffset().m_X > m_aSprite[0]->w / 3)
@@ -1030,15 +1029,15 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
         // Gib is too close to center to always make it rotate in one direction, so give it a baseline rotation and then randomize
         else
         {
-            pAttachable->SetAngularVel((pAttachable->GetAngularVel() * 0.5F + pAttachable->GetAngularVel() * RandomNum()) * (RandomNormalNum() > 0.0F ? 1.0F : -1.0F));
+            pAttachable->SetAngularVel((pAttachable->GetAngularVel() * 0.5F + pAttachable->GetAngularVel() * m_RandomStream.RandomNum()) * (m_RandomStream.RandomNormalNum() > 0.0F ? 1.0F : -1.0F));
         }
 
 // TODO: Optimize making the random angles!")
         gibVel = pAttachable->GetParentOffset();
         if (gibVel.IsZero())
-            gibVel.SetXY(velMin + RandomNum(0.0F, velRange), 0);
+            gibVel.SetXY(velMin + m_RandomStream.RandomNum(0.0F, velRange), 0);
         else
-            gibVel.SetMagnitude(velMin + RandomNum(0.0F, velRange));
+            gibVel.SetMagnitude(velMin + m_RandomStream.RandomNum(0.0F, velRange));
         gibVel.RadRotate(impactImpulse.GetAbsRadAngle());
         pAttachable->SetVel(m_Vel + gibVel);
 
@@ -1047,7 +1046,6 @@ void MOSRotating::GibThis(Vector impactImpulse, float internalBlast, MovableObje
             pAttachable->SetWhichMOToNotHit(pIgnoreMO);
 
         // Safely remove attachable and add it to the scene
-        ++aItr;
         RemoveAttachable(pAttachable);
         g_MovableMan.AddParticle(pAttachable);
         pAttachable = 0;
@@ -1155,10 +1153,10 @@ void MOSRotating::ResetAllTimers()
 {
     MovableObject::ResetAllTimers();
 
-    for (list<AEmitter *>::iterator emitter = m_Wounds.begin(); emitter != m_Wounds.end(); ++emitter)
+    for (vector<AEmitter *>::iterator emitter = m_Wounds.begin(); emitter != m_Wounds.end(); ++emitter)
         (*emitter)->ResetAllTimers();
 
-    for (list<Attachable *>::iterator attachable = m_Attachables.begin(); attachable != m_Attachables.end(); ++attachable)
+    for (vector<Attachable *>::iterator attachable = m_Attachables.begin(); attachable != m_Attachables.end(); ++attachable)
         (*attachable)->ResetAllTimers();
 }
 
@@ -1275,7 +1273,7 @@ bool MOSRotating::IsOnScenePoint(Vector &scenePoint) const
     }
 
     // Check the attachables too, backward since the latter ones tend to be larger, and therefore more likeyl to be on the point
-    for (list<Attachable *>::const_reverse_iterator aItr = m_Attachables.rbegin(); aItr != m_Attachables.rend(); ++aItr)
+    for (vector<Attachable *>::const_reverse_iterator aItr = m_Attachables.rbegin(); aItr != m_Attachables.rend(); ++aItr)
     {
         if ((*aItr)->IsOnScenePoint(scenePoint))
             return true;
@@ -1369,7 +1367,7 @@ bool MOSRotating::DeepCheck(bool makeMOPs, int skipMOP, int maxMOPs)
                 {
                     tally -= 1.0;
                     (*itr)->SetPos((*itr)->GetPos() - m_Vel.GetNormalized() * depth);
-					(*itr)->SetVel(Vector(velMag * RandomNum(0.0F, splashDir), -RandomNum(0.0F, velMag)));
+					(*itr)->SetVel(Vector(velMag * m_RandomStream.RandomNum(0.0F, splashDir), -m_RandomStream.RandomNum(0.0F, velMag)));
                     m_DeepHardness += (*itr)->GetMaterial()->GetIntegrity() * (*itr)->GetMaterial()->GetPixelDensity();
                     g_MovableMan.AddParticle(*itr);
                     *itr = 0;
@@ -1523,17 +1521,17 @@ void MOSRotating::Update()
         m_Rotation += (radsToGo * m_OrientToVel * velInfluence);
     }
 
-    // Update all the attached wound emitters
-    for (list<AEmitter *>::iterator itr = m_Wounds.begin();
-        itr != m_Wounds.end(); ++itr)
+    // Update all the attached wound emitters. Indexed since an update could add wounds, which may reallocate the vector
+    for (size_t woundIndex = 0; woundIndex < m_Wounds.size(); ++woundIndex)
     {
-        if ((*itr))
+        AEmitter *pWound = m_Wounds[woundIndex];
+        if (pWound)
         {
-            (*itr)->SetJointPos(m_Pos + RotateOffset((*itr)->GetParentOffset()));
-			if ((*itr)->InheritsRotAngle())
-				(*itr)->SetRotAngle(m_Rotation.GetRadAngle());
-//            (*itr)->SetEmitAngle(m_Rotation);
-            (*itr)->Update();
+            pWound->SetJointPos(m_Pos + RotateOffset(pWound->GetParentOffset()));
+			if (pWound->InheritsRotAngle())
+				pWound->SetRotAngle(m_Rotation.GetRadAngle());
+//            pWound->SetEmitAngle(m_Rotation);
+            pWound->Update();
         }
         else
             RTEAbort("Broken emitter!!");
@@ -1541,14 +1539,11 @@ void MOSRotating::Update()
 
     // Update all the attachables
     Attachable *pAttachable = 0;
-    for (list<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ) // NOTE NO INCCREMENT!
+    for (size_t attachableIndex = 0; attachableIndex < m_Attachables.size(); ) // NOTE: Only incremented below, since updating can remove Attachables
     {
-        RTEAssert((*aItr), "Broken Attachable!");
-        if (!(*aItr))
-            continue;
+        RTEAssert(m_Attachables[attachableIndex], "Broken Attachable!");
 
-        pAttachable = *aItr;
-        ++aItr;
+        pAttachable = m_Attachables[attachableIndex];
 
         pAttachable->SetHFlipped(m_HFlipped);
         pAttachable->SetJointPos(m_Pos + RotateOffset((pAttachable)->GetParentOffset()));
@@ -1559,6 +1554,10 @@ void MOSRotating::Update()
         pAttachable->Update();
 
         ApplyAttachableForces(pAttachable);
+
+        // If the Attachable removed itself or any before it while updating, the next one to update got shifted into its place or is already there
+        if (attachableIndex < m_Attachables.size() && m_Attachables[attachableIndex] == pAttachable)
+            ++attachableIndex;
     }
 
     // Create intermediate flipping bitmap if there isn't one yet
@@ -1612,7 +1611,7 @@ void MOSRotating::UpdateChildMOIDs(vector<MovableObject *> &MOIDIndex,
                                   bool makeNewMOID)
 {
     // Register all the eligible attachables
-    for (list<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+    for (vector<Attachable *>::iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
     {
 // TODO: Which should it be, don't register at all, or register as same as parent??
         if ((*aItr)->GetsHitByMOs())
@@ -1714,10 +1713,10 @@ bool MOSRotating::RemoveAttachable(long attachableUniqueId)
 bool MOSRotating::RemoveAttachable(Attachable *pAttachable) {
 	if (pAttachable) {
 		if (m_Attachables.size() > 0) {
-			m_Attachables.remove(pAttachable);
+			m_Attachables.erase(std::remove(m_Attachables.begin(), m_Attachables.end(), pAttachable), m_Attachables.end());
 		}
 		if (m_AllAttachables.size() > 0) {
-			m_AllAttachables.remove(pAttachable);
+			m_AllAttachables.erase(std::remove(m_AllAttachables.begin(), m_AllAttachables.end(), pAttachable), m_AllAttachables.end());
 		}
 		pAttachable->ToDeleteWithParent() ? pAttachable->SetToDelete() : pAttachable->Detach();
 		return true;
@@ -1732,7 +1731,7 @@ bool MOSRotating::RemoveAttachable(Attachable *pAttachable) {
 /// <param name="destroy">Whether to detach or delete the attachables. Setting this to true deletes them, setting it to false detaches them</param>
 void MOSRotating::DetachOrDestroyAll(bool destroy)
 {
-	for (list<Attachable *>::const_iterator aItr = m_AllAttachables.begin(); aItr != m_AllAttachables.end(); ++aItr)
+	for (vector<Attachable *>::const_iterator aItr = m_AllAttachables.begin(); aItr != m_AllAttachables.end(); ++aItr)
 	{
 		if (destroy)
 			delete (*aItr);
@@ -1754,7 +1753,7 @@ void MOSRotating::DetachOrDestroyAll(bool destroy)
 void MOSRotating::GetMOIDs(std::vector<MOID> &MOIDs) const
 {
 	// Get MOIDs all the eligible attachables
-	for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+	for (vector<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
 		(*aItr)->GetMOIDs(MOIDs);
 
 	// Get self MOID
@@ -1797,34 +1796,6 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
     if (m_Recoiled)
         spritePos += m_RecoilOffset;
 
-    // If we're drawing a material silhouette, then create an intermediate material bitmap as well
-    if (mode != g_DrawColor && mode != g_DrawTrans)
-    {
-        clear_to_color(pTempBitmap, keyColor);
-
-// TODO: Fix that MaterialAir and KeyColor don't work at all because they're drawing 0 to a field of 0's
-        // Draw the requested material sihouette on the material bitmap
-        if (mode == g_DrawMaterial)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, m_SettleMaterialDisabled ? GetMaterial()->GetIndex() : GetMaterial()->GetSettleMaterial(), -1);
-        else if (mode == g_DrawAir)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, g_MaterialAir, -1);
-        else if (mode == g_DrawMask)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, keyColor, -1);
-        else if (mode == g_DrawWhite)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, g_WhiteColor, -1);
-        else if (mode == g_DrawMOID)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, m_MOID, -1);
-        else if (mode == g_DrawNoMOID)
-            draw_character_ex(pTempBitmap, m_aSprite[m_Frame], 0, 0, g_NoMOID, -1);
-        else if (mode == g_DrawRedTrans)
-            draw_trans_sprite(pTempBitmap, m_aSprite[m_Frame], 0, 0);
-        else
-        {
-//            return;
-//            RTEAbort("Unknown draw mode selected in MOSRotating::Draw()!");
-        }
-    }
-
     // Take care of wrapping situations
     Vector aDrawPos[4];
     int passes = 1;
@@ -1873,7 +1844,7 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
 	// Only draw attachables and emitters which are not drawn after parent, so we draw them before
 	if (mode == g_DrawColor || (!onlyPhysical && mode == g_DrawMaterial))
 	{
-		for (list<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
+		for (vector<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
 		{
 			if (!(*itr)->IsDrawnAfterParent())
 				(*itr)->Draw(pTargetBitmap, targetPos, mode, onlyPhysical);
@@ -1881,122 +1852,70 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
 	}
 
 	// Draw all the attached attachables
-	for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+	for (vector<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
 	{
 		if (!(*aItr)->IsDrawnAfterParent())
 			(*aItr)->Draw(pTargetBitmap, targetPos, mode, onlyPhysical);
 	}
 
 
-    //////////////////
-    // FLIPPED
-    if (m_HFlipped && pFlipBitmap)
-    {
-        // Don't size the intermediate bitmaps to the m_Scale, because the scaling happens after they are done
-        clear_to_color(pFlipBitmap, keyColor);
-        // Draw eitehr the source color bitmap or the intermediate material bitmap onto the intermediate flipping bitmap
-        if (mode == g_DrawColor || mode == g_DrawTrans)
-            draw_sprite_h_flip(pFlipBitmap, m_aSprite[m_Frame], 0, 0);
-        // If using the temp bitmap (which is always larger than the sprite) make sure the flipped image ends up in the upper right corner as if it was just as small as the sprite bitmap
-        else
-            draw_sprite_h_flip(pFlipBitmap, pTempBitmap, -(pTempBitmap->w - m_aSprite[m_Frame]->w), 0);
+    // Every mode draws the rotated frame from the cache. Identical frames of every instance of this preset share the same rotated bitmaps, whichever mode they're drawn in
+    bool flipped = m_HFlipped && pFlipBitmap;
+    int rotatedPivotX = 0;
+    int rotatedPivotY = 0;
+    BITMAP *pRotatedBitmap = g_FrameMan.GetRotatedSpriteCache().GetRotatedSprite(m_aSprite[m_Frame],
+                                                                                flipped,
+                                                                                flipped ? static_cast<int>(m_aSprite[m_Frame]->w + m_SpriteOffset.m_X) : static_cast<int>(-(m_SpriteOffset.m_X)),
+                                                                                static_cast<int>(-(m_SpriteOffset.m_Y)),
+                                                                                m_Rotation.GetAllegroAngle(),
+                                                                                m_Scale,
+                                                                                rotatedPivotX,
+                                                                                rotatedPivotY);
 
-        // Transparent mode
-        if (mode == g_DrawTrans)
-        {
-            clear_to_color(pTempBitmap, keyColor);
-            // Draw the rotated thing onto the intermediate bitmap so its COM position aligns with the middle of the temp bitmap.
-            // The temp bitmap should be able to hold the full size since it is larger than the max diameter.
-            // Take into account the h-flipped pivot point
-            pivot_scaled_sprite(pTempBitmap,
-                                pFlipBitmap,
-                                pTempBitmap->w / 2,
-                                pTempBitmap->h / 2,
-                                pFlipBitmap->w + m_SpriteOffset.m_X,
-                                -(m_SpriteOffset.m_Y),
-                                ftofix(m_Rotation.GetAllegroAngle()),
-                                ftofix(m_Scale));
-
-            // Draw the now rotated object's temporary bitmap onto the final drawing bitmap with transperency
-            // Do the passes loop in here so the intermediate drawing doesn't get done multiple times
-            for (int i = 0; i < passes; ++i)
-                draw_trans_sprite(pTargetBitmap, pTempBitmap, aDrawPos[i].GetFloorIntX() - (pTempBitmap->w / 2), aDrawPos[i].GetFloorIntY() - (pTempBitmap->h / 2));
-        }
-        // Non-transparent mode
-        else
-        {
-            // Do the passes loop in here so the flipping operation doesn't get done multiple times
-            for (int i = 0; i < passes; ++i)
-            {
-                // Take into account the h-flipped pivot point
-                pivot_scaled_sprite(pTargetBitmap,
-                                    pFlipBitmap,
-                                    aDrawPos[i].GetFloorIntX(),
-                                    aDrawPos[i].GetFloorIntY(),
-                                    pFlipBitmap->w + m_SpriteOffset.m_X,
-                                    -(m_SpriteOffset.m_Y),
-                                    ftofix(m_Rotation.GetAllegroAngle()),
-                                    ftofix(m_Scale));
-
-                // Register potential MOID drawing
-                if (mode == g_DrawMOID)
-                    g_SceneMan.RegisterMOIDDrawing(aDrawPos[i].GetFloored(), m_MaxRadius + 2);
-            }
-        }
+// TODO: Fix that MaterialAir and KeyColor don't work at all because they're drawing 0 to a field of 0's
+    // The color to draw the requested silhouette in, or the key color if nothing should be drawn
+    int silhouetteColor = keyColor;
+    if (mode == g_DrawMaterial)
+        silhouetteColor = m_SettleMaterialDisabled ? GetMaterial()->GetIndex() : GetMaterial()->GetSettleMaterial();
+    else if (mode == g_DrawAir)
+        silhouetteColor = g_MaterialAir;
+    else if (mode == g_DrawWhite)
+        silhouetteColor = g_WhiteColor;
+    else if (mode == g_DrawMOID)
+        silhouetteColor = m_MOID;
+    else if (mode == g_DrawNoMOID)
+        silhouetteColor = g_NoMOID;
+
+    // The red transparent mode draws the frame blended against the key color, opaquely, so blend it once on the intermediate bitmap
+    if (pRotatedBitmap && mode == g_DrawRedTrans)
+    {
+        clear_to_color(pTempBitmap, keyColor);
+        draw_trans_sprite(pTempBitmap, pRotatedBitmap, 0, 0);
     }
-    /////////////////
-    // NON-FLIPPED
-    else
+
+    // The rotated frame is cropped to what gets drawn, so nothing to draw means it's null
+    for (int i = 0; pRotatedBitmap && i < passes; ++i)
     {
-//        spritePos += m_SpriteOffset;
-//        spritePos += (m_SpriteCenter * m_Rotation - m_SpriteCenter);
+        int rotatedX = aDrawPos[i].GetFloorIntX() - rotatedPivotX;
+        int rotatedY = aDrawPos[i].GetFloorIntY() - rotatedPivotY;
+        if (mode == g_DrawColor)
+            draw_sprite(pTargetBitmap, pRotatedBitmap, rotatedX, rotatedY);
+        else if (mode == g_DrawTrans)
+            draw_trans_sprite(pTargetBitmap, pRotatedBitmap, rotatedX, rotatedY);
+        else if (mode == g_DrawRedTrans)
+            draw_sprite(pTargetBitmap, pTempBitmap, rotatedX, rotatedY);
+        else if (silhouetteColor != keyColor)
+            draw_character_ex(pTargetBitmap, pRotatedBitmap, rotatedX, rotatedY, silhouetteColor, -1);
 
-        // Transparent mode
-        if (mode == g_DrawTrans)
-        {
-            clear_to_color(pTempBitmap, keyColor);
-            // Draw the rotated thing onto the intermediate bitmap so its COM position aligns with the middle of the temp bitmap.
-            // The temp bitmap should be able to hold the full size since it is larger than the max diameter.
-            // Take into account the h-flipped pivot point
-            pivot_scaled_sprite(pTempBitmap,
-                                m_aSprite[m_Frame],
-                                pTempBitmap->w / 2,
-                                pTempBitmap->h / 2,
-                                -(m_SpriteOffset.m_X),
-                                -(m_SpriteOffset.m_Y),
-                                ftofix(m_Rotation.GetAllegroAngle()),
-                                ftofix(m_Scale));
-
-            // Draw the now rotated object's temporary bitmap onto the final drawing bitmap with transperency
-            // Do the passes loop in here so the intermediate drawing doesn't get done multiple times
-            for (int i = 0; i < passes; ++i)
-                draw_trans_sprite(pTargetBitmap, pTempBitmap, aDrawPos[i].GetFloorIntX() - (pTempBitmap->w / 2), aDrawPos[i].GetFloorIntY() - (pTempBitmap->h / 2));
-        }
-        // Non-transparent mode
-        else
-        {
-            for (int i = 0; i < passes; ++i)
-            {
-                pivot_scaled_sprite(pTargetBitmap,
-                                    mode == g_DrawColor ? m_aSprite[m_Frame] : pTempBitmap,
-                                    aDrawPos[i].GetFloorIntX(),
-                                    aDrawPos[i].GetFloorIntY(),
-                                    -(m_SpriteOffset.m_X),
-                                    -(m_SpriteOffset.m_Y),
-                                    ftofix(m_Rotation.GetAllegroAngle()),
-                                    ftofix(m_Scale));
-
-                // Register potential MOID drawing
-                if (mode == g_DrawMOID)
-                    g_SceneMan.RegisterMOIDDrawing(aDrawPos[i].GetFloored(), m_MaxRadius + 2);
-            }
-        }
+        // Register the MOID drawing, which is only as big as the cropped frame
+        if (mode == g_DrawMOID)
+            g_SceneMan.RegisterMOIDDrawing(rotatedX, rotatedY, rotatedX + pRotatedBitmap->w - 1, rotatedY + pRotatedBitmap->h - 1);
     }
 
     // Draw all the attached wound emitters, and only if the mode is g_DrawColor and not onlyphysical
     if (mode == g_DrawColor || (!onlyPhysical && mode == g_DrawMaterial))
     {
-		for (list<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
+		for (vector<AEmitter *>::const_iterator itr = m_Wounds.begin(); itr != m_Wounds.end(); ++itr)
 		{
 			if ((*itr)->IsDrawnAfterParent())
 				(*itr)->Draw(pTargetBitmap, targetPos, mode, onlyPhysical);
@@ -2004,7 +1923,7 @@ void MOSRotating::Draw(BITMAP *pTargetBitmap,
     }
 
     // Draw all the attached attachables
-	for (list<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
+	for (vector<Attachable *>::const_iterator aItr = m_Attachables.begin(); aItr != m_Attachables.end(); ++aItr)
 	{
 		if ((*aItr)->IsDrawnAfterParent())
 			(*aItr)->Draw(pTargetBitmap, targetPos, mode, onlyPhysical);
@@ -208,7 +208,7 @@ ClassInfoGetters
 // Arguments:       None.
 // Return value:    A pointer to the list of gibs. Ownership is NOT transferred!
 
-    std::list<Gib> * GetGibList() { return &m_Gibs; }
+    std::vector<Gib> * GetGibList() { return &m_Gibs; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -814,13 +814,13 @@ protected:
     // The vector that the recoil offsets the sprite when m_Recoiled is true.
     Vector m_RecoilOffset;
     // The list of wound AEmitters currently attached to this MOSRotating, and owned here as well
-    std::list<AEmitter *> m_Wounds;
+    std::vector<AEmitter *> m_Wounds;
     // The list of general Attachables currently attached and Owned by this.
-    std::list<Attachable *> m_Attachables;
+    std::vector<Attachable *> m_Attachables;
     // The list of all Attachables, including both hardcoded attachables and those added through ini or lua
-    std::list<Attachable *> m_AllAttachables;
+    std::vector<Attachable *> m_AllAttachables;
     // The list of Gib:s this will create when gibbed
-    std::list<Gib> m_Gibs;
+    std::vector<Gib> m_Gibs;
     // The amount of impulse force required to gib this, in kg * (m/s). 0 means no limit
     float m_GibImpulseLimit;
     // The number of wound emitters allowed before this gets gibbed. 0 means this can't get gibbed
@@ -491,7 +491,7 @@ void MOSprite::Update() {
 			    break;
 		    case ALWAYSRANDOM:
 			    while (m_Frame == prevFrame) {
-					m_Frame = RandomNum<int>(0, m_FrameCount - 1);
+					m_Frame = m_RandomStream.RandomNum<int>(0, m_FrameCount - 1);
 			    }
                 m_SpriteAnimTimer.Reset();
 			    break;
@@ -592,7 +592,7 @@ void MOSprite::Draw(BITMAP *pTargetBitmap,
             int spriteX = aDrawPos[i].GetFloorIntX();
             int spriteY = aDrawPos[i].GetFloorIntY();
             draw_character_ex(pTargetBitmap, m_aSprite[m_Frame], spriteX, spriteY, m_MOID, -1);
-            g_SceneMan.RegisterMOIDDrawing(spriteX, spriteY, spriteX + m_aSprite[m_Frame]->w, spriteY + m_aSprite[m_Frame]->h);
+            g_SceneMan.RegisterMOIDDrawing(spriteX, spriteY, spriteX + m_aSprite[m_Frame]->w - 1, spriteY + m_aSprite[m_Frame]->h - 1);
 		}
         else if (mode == g_DrawNoMOID)
             draw_character_ex(pTargetBitmap, m_aSprite[m_Frame], aDrawPos[i].GetFloorIntX(), aDrawPos[i].GetFloorIntY(), g_NoMOID, -1);
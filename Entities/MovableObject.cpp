@@ -24,7 +24,7 @@ namespace RTE {
 
 AbstractClassInfo(MovableObject, SceneObject)
 
-unsigned long int MovableObject::m_UniqueIDCounter = 1;
+std::atomic<unsigned long int> MovableObject::m_UniqueIDCounter = 1;
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Clear
@@ -49,6 +49,9 @@ void MovableObject::Clear()
     m_ImpulseForces.clear();
     m_AgeTimer.Reset();
     m_RestTimer.Reset();
+    m_UpdateLODTier = LOD_FULL;
+    m_UpdateDue = true;
+    m_LODIdleFrames = 0;
     m_Lifetime = 0;
     m_Sharpness = 1.0;
 //    m_MaterialId = 0;
@@ -124,6 +127,7 @@ int MovableObject::Create()
         m_EffectStopTime = m_Lifetime;
 
 	m_UniqueID = MovableObject::GetNextUniqueID();
+	m_RandomStream.Create(m_UniqueID);
 
 	m_MOIDHit = g_NoMOID;
 	m_TerrainMatHit = g_MaterialAir;
@@ -157,14 +161,12 @@ int MovableObject::Create(const float mass,
     m_HitsMOs = hitMOs;
     m_GetsHitByMOs = getHitByMOs;
 
-	m_UniqueID = MovableObject::GetNextUniqueID();
+	AssignUniqueID();
 
 	m_MOIDHit = g_NoMOID;
 	m_TerrainMatHit = g_MaterialAir;
 	m_ParticleUniqueIDHit = 0;
 
-	g_MovableMan.RegisterObject(this);
-
     return 0;
 }
 
@@ -225,9 +227,6 @@ int MovableObject::Create(const MovableObject &reference)
 	m_RandomizeEffectRotAngle = reference.m_RandomizeEffectRotAngle;
 	m_RandomizeEffectRotAngleEveryFrame = reference.m_RandomizeEffectRotAngleEveryFrame;
 
-	if (m_RandomizeEffectRotAngle)
-		m_EffectRotAngle = c_PI * RandomNum(-2.0F, 2.0F);
-
 	m_ScreenEffectHash = reference.m_ScreenEffectHash;
     m_EffectStartTime = reference.m_EffectStartTime;
     m_EffectStopTime = reference.m_EffectStopTime;
@@ -246,8 +245,10 @@ int MovableObject::Create(const MovableObject &reference)
 	m_TerrainMatHit = reference.m_TerrainMatHit;
 	m_ParticleUniqueIDHit = reference.m_ParticleUniqueIDHit;
 
-	m_UniqueID = MovableObject::GetNextUniqueID();
-	g_MovableMan.RegisterObject(this);
+	AssignUniqueID();
+
+	if (m_RandomizeEffectRotAngle)
+		m_EffectRotAngle = c_PI * m_RandomStream.RandomNum(-2.0F, 2.0F);
 
 	m_ProvidesPieMenuContext = reference.m_ProvidesPieMenuContext;
 
@@ -453,6 +454,16 @@ int MovableObject::Save(Writer &writer) const
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void MovableObject::AssignUniqueID() {
+	// The order the parallel AI workers would get IDs in depends on the thread timing, so MOs they create wait for theirs
+	long int temporaryID = g_MovableMan.DeferParallelAIUniqueID(this);
+	m_UniqueID = (temporaryID != 0) ? temporaryID : static_cast<long int>(MovableObject::GetNextUniqueID());
+	m_RandomStream.Create(m_UniqueID);
+	if (temporaryID == 0) { g_MovableMan.RegisterObject(this); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void MovableObject::Destroy(bool notInherited) {
     if (ObjectScriptsInitialized()) {
         RunScriptedFunctionInAppropriateScripts("Destroy");
@@ -658,7 +669,11 @@ int MovableObject::RunScriptedFunction(const std::string &scriptPath, const std:
     std::string presetAndFunctionName = m_ScriptPresetName + "." + functionName;
     std::string fullFunctionName = presetAndFunctionName + "[\"" + scriptPath + "\"]";
     
-    int status = g_LuaMan.RunScriptedFunction(fullFunctionName, m_ScriptObjectName, {presetAndFunctionName, m_ScriptObjectName, fullFunctionName}, functionEntityArguments, functionLiteralArguments);
+    int status;
+    {
+        LuaMan::ProfiledScriptScope profiledScript(scriptPath, functionName);
+        status = g_LuaMan.RunScriptedFunction(fullFunctionName, m_ScriptObjectName, {presetAndFunctionName, m_ScriptObjectName, fullFunctionName}, functionEntityArguments, functionLiteralArguments);
+    }
     functionEntityArguments.clear();
     functionLiteralArguments.clear();
     
@@ -984,7 +999,7 @@ int MovableObject::OnPieMenu(Actor *pieMenuActor) {
 void MovableObject::Update()
 {
 	if (m_RandomizeEffectRotAngleEveryFrame)
-		m_EffectRotAngle = c_PI * 2.0F * RandomNormalNum();
+		m_EffectRotAngle = c_PI * 2.0F * m_RandomStream.RandomNormalNum();
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 #include "Matrix.h"
 #include "Timer.h"
 #include "Material.h"
+#include "RandomStream.h"
 #include "MovableMan.h"
 #include "FrameMan.h"
 
@@ -73,6 +74,16 @@ enum MOType
     TypeThrownDevice
 };
 
+// How often MovableMan updates this, depending on how far it is from the players' views and whether it's idle
+enum UpdateLODTier
+{
+    LOD_FULL = 0,
+    LOD_REDUCED,
+    LOD_LOW,
+    LOD_DORMANT,
+    LOD_TIERCOUNT
+};
+
 friend class Atom;
 
 
@@ -700,6 +711,16 @@ friend class Atom;
     void SetPrevPos(const Vector &newPrevPos) {m_PrevPos = newPrevPos; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPrevPos
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the position at the start of the sim update.
+// Arguments:       None.
+// Return value:    A Vector describing the 'prev' pos.
+
+    const Vector & GetPrevPos() const { return m_PrevPos; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          SetVel
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1599,6 +1620,18 @@ friend class Atom;
 
 	static unsigned long int GetNextUniqueID() { return ++m_UniqueIDCounter; }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          AssignUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gives this MO the next unique ID, keys its random number stream with it
+//                  and registers it so it can be found by it. When created by AI scripts
+//                  on a parallel AI worker, it gets a temporary ID instead, and MovableMan
+//                  calls this again once the workers are done.
+// Arguments:       None.
+// Return value:    None.
+
+	void AssignUniqueID();
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Static method:  GetUniqueID
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1609,6 +1642,84 @@ friend class Atom;
 	unsigned long int const GetUniqueID() const { return m_UniqueID; }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetRandomStream
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the random number stream of this MO, keyed by its unique ID. The
+//                  numbers drawn from it don't depend on what other MOs drew or on which
+//                  thread this gets updated.
+// Arguments:       None.
+// Return value:    A reference to the random number stream of this MO.
+
+	RandomStream & GetRandomStream() { return m_RandomStream; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUpdateLODTier
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the level of detail tier MovableMan updates this at.
+// Arguments:       None.
+// Return value:    The UpdateLODTier of this.
+
+	int GetUpdateLODTier() const { return m_UpdateLODTier; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsUpdateDue
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this gets its full update this sim update, as opposed to
+//                  only the parts its level of detail tier doesn't skip. Always true at
+//                  LOD_FULL.
+// Arguments:       None.
+// Return value:    Whether this is due for its full update.
+
+	bool IsUpdateDue() const { return m_UpdateDue; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          IsPhysicsPausedByLOD
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells whether this is dormant and not due this sim update, so MovableMan
+//                  skips its travel and it should skip anything that only keeps it in
+//                  place, like standing limb paths.
+// Arguments:       None.
+// Return value:    Whether this' physics are paused this sim update.
+
+	bool IsPhysicsPausedByLOD() const { return m_UpdateLODTier == LOD_DORMANT && !m_UpdateDue; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetUpdateLOD
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the level of detail tier of this for the current sim update, and
+//                  whether this is due for its full update. Done by MovableMan.
+// Arguments:       The UpdateLODTier of this.
+//                  Whether this is due for its full update this sim update.
+// Return value:    None.
+
+	void SetUpdateLOD(int tier, bool updateDue) { m_UpdateLODTier = tier; m_UpdateDue = updateDue; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetLODIdleFrames
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets for how many sim updates in a row MovableMan has found this idle.
+// Arguments:       None.
+// Return value:    The number of sim updates this has been idle for.
+
+	int GetLODIdleFrames() const { return m_LODIdleFrames; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetLODIdleFrames
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets for how many sim updates in a row MovableMan has found this idle.
+// Arguments:       The number of sim updates this has been idle for.
+// Return value:    None.
+
+	void SetLODIdleFrames(int idleFrames) { m_LODIdleFrames = idleFrames; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  DamageOnCollision
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1805,7 +1916,7 @@ protected:
     // Member variables
     static Entity::ClassInfo m_sClass;
 	// Global counter with unique ID's
-	static unsigned long int m_UniqueIDCounter;
+	static std::atomic<unsigned long int> m_UniqueIDCounter;
     // The type of MO this is, either Actor, Item, or Particle
     int m_MOType;
     float m_Mass; // In metric kilograms (kg).
@@ -1831,6 +1942,11 @@ protected:
     std::deque<std::pair<Vector, Vector> > m_ImpulseForces; // First in kg * m/s, second vector in meters.
     Timer m_AgeTimer;
     Timer m_RestTimer;
+    // The level of detail tier MovableMan updates this at, and whether this is due for its full update this sim update
+    int m_UpdateLODTier;
+    bool m_UpdateDue;
+    // For how many sim updates in a row this has been found idle, for deciding whether it's settled enough to go dormant
+    int m_LODIdleFrames;
 
     unsigned long m_Lifetime;
     // The sharpness factor that gets added to single pixel hit impulses in
@@ -1924,6 +2040,8 @@ protected:
 
 	// This object's unique persistent ID
 	long int m_UniqueID;
+	// The random number stream this draws from, keyed by the unique ID so the draws are reproducible no matter the update order or thread
+	RandomStream m_RandomStream;
 	// In which radis should we look to remove orphaned terrain on terrain penetration, 
 	// must not be greater than SceneMan::ORPHANSIZE, or will be truncated
 	int m_RemoveOrphanTerrainRadius;
@@ -472,13 +472,13 @@ namespace RTE {
 						else
 							pParticle->SetPos(m_Pos + RotateOffset(m_EmissionOffset));
 						// TODO: Optimize making the random angles!")
-						emitVel.SetXY(velMin + RandomNum(0.0F, velRange), 0);
-						emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * RandomNormalNum());
+						emitVel.SetXY(velMin + m_RandomStream.RandomNum(0.0F, velRange), 0);
+						emitVel.RadRotate(m_EmitAngle.GetRadAngle() + spread * m_RandomStream.RandomNormalNum());
 						emitVel = RotateOffset(emitVel);
 						pParticle->SetVel(parentVel + emitVel);
 
 						if (pParticle->GetLifetime() != 0)
-							pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr).GetLifeVariation() * RandomNormalNum())));
+							pParticle->SetLifetime(pParticle->GetLifetime() * (1.0F + ((*eItr).GetLifeVariation() * m_RandomStream.RandomNormalNum())));
 						pParticle->SetTeam(m_Team);
 						pParticle->SetIgnoresTeamHits(true);
 
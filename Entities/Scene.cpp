@@ -37,6 +37,7 @@ namespace RTE {
 
 ConcreteClassInfo(Scene, Entity, 0)
 const string Scene::Area::m_sClassName = "Area";
+unsigned long long Scene::s_LayerDataGenerationCounter = 0;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -440,8 +441,7 @@ void Scene::Clear()
     {
         m_UnseenPixelSize[team].Reset();
         m_apUnseenLayer[team] = 0;
-        m_SeenPixels[team].clear();
-        m_CleanedPixels[team].clear();
+        m_VisibilityGrids[team].Reset();
         m_ScanScheduled[team] = false;
     }
 	m_AreaList.clear();
@@ -453,6 +453,7 @@ void Scene::Clear()
 	m_pPreviewBitmap = 0;
 	m_MetasceneParent.clear();
 	m_IsMetagameInternal = false;
+    m_LayerDataGeneration = ++s_LayerDataGenerationCounter;
 }
 
 /*
@@ -527,7 +528,10 @@ int Scene::Create(const Scene &reference)
     {
         // If the Unseen layers are loaded, then copy them. If not, then copy the procedural param that is responsible for creating them
         if (reference.m_apUnseenLayer[team])
+        {
             m_apUnseenLayer[team] = dynamic_cast<SceneLayer *>(reference.m_apUnseenLayer[team]->Clone());
+            m_VisibilityGrids[team].Create(reference.m_VisibilityGrids[team]);
+        }
         else
             m_UnseenPixelSize[team] = reference.m_UnseenPixelSize[team];
 
@@ -567,11 +571,30 @@ int Scene::Create(const Scene &reference)
 //                  to be done before using this SceneLayer.
 
 int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
+{
+    int error = LoadLayerData(initPathfinding);
+    if (error < 0)
+        return error;
+
+    return PlaceLoadedObjects(placeObjects, initPathfinding, placeUnits);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadLayerData
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads the bitmap data of the terrain, unseen and background layers
+//                  into memory. Doesn't allocate any Entities or touch any of the
+//                  managers' state, so it can be done on a worker thread.
+
+int Scene::LoadLayerData(bool loadBackgroundLayers, const std::function<void(const std::string &)> &reportProgress)
 {
     RTEAssert(m_pTerrain, "Terrain not instantiated before trying to load its data!");
 
     ///////////////////////////////////
     // Load Terrain's data
+    if (reportProgress)
+        reportProgress("Loading terrain of " + GetPresetName());
     if (m_pTerrain->LoadData() < 0)
     {
         RTEAbort("Loading Terrain " + m_pTerrain->GetPresetName() + "\'s data failed!");
@@ -579,8 +602,51 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
     }
     
     ///////////////////////////////////
-    // Load Unseen layers before applying objects to the scene,
-    // so we can reveal around stuff that is getting placed for the appropriate team
+    // Load custom Unseen layers' data. The dynamically generated ones are created by CreateUnseenLayers on the main thread, as they're new SceneLayers
+    if (reportProgress)
+        reportProgress("Loading unseen layers of " + GetPresetName());
+    for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
+    {
+        if (m_UnseenPixelSize[team].IsZero() && m_apUnseenLayer[team])
+        {
+            // Load unseen layer data from file
+            if (m_apUnseenLayer[team]->LoadData() < 0)
+            {
+                g_ConsoleMan.PrintString("ERROR: Loading unseen layer " + m_apUnseenLayer[team]->GetPresetName() + "\'s data failed!");
+                return -1;
+            }
+        }
+    }
+
+    ///////////////////////////////////
+    // Load Background layers' data
+    if (loadBackgroundLayers)
+    {
+        if (reportProgress)
+            reportProgress("Loading background layers of " + GetPresetName());
+        for (list<SceneLayer *>::iterator slItr = m_BackLayerList.begin(); slItr != m_BackLayerList.end(); ++slItr)
+        {
+            RTEAssert((*slItr), "Background layer not instantiated before trying to load its data!");
+            if ((*slItr)->LoadData() < 0)
+            {
+                g_ConsoleMan.PrintString("ERROR: Loading background layer " + (*slItr)->GetPresetName() + "\'s data failed!");
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CreateUnseenLayers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Creates the dynamically generated unseen layers and reads what each
+//                  team has seen already into its visibility grid.
+
+void Scene::CreateUnseenLayers()
+{
     for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
     {
         // Specified to dynamically create the unseen layer?
@@ -595,17 +661,23 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
             m_apUnseenLayer[team]->Create(pUnseenBitmap, true, Vector(), WrapsX(), WrapsY(), Vector(1.0, 1.0));
             m_apUnseenLayer[team]->SetScaleFactor(m_UnseenPixelSize[team]);
         }
-        // If not dynamically generated, was it custom loaded?
-        else if (m_apUnseenLayer[team])
-        {
-            // Load unseen layer data from file
-            if (m_apUnseenLayer[team]->LoadData() < 0)
-            {
-                g_ConsoleMan.PrintString("ERROR: Loading unseen layer " + m_apUnseenLayer[team]->GetPresetName() + "\'s data failed!");
-                return -1;
-            }
-        }
+        // Read what has been seen already into the team's visibility grid, which is what gets revealed and restored from now on
+        if (m_apUnseenLayer[team] && m_apUnseenLayer[team]->GetBitmap())
+            m_VisibilityGrids[team].Create(m_apUnseenLayer[team]->GetBitmap(), WrapsX(), WrapsY());
     }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PlaceLoadedObjects
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Places the SceneObjects set to be placed on load and sets up the
+//                  pathfinding, once the layer data has been loaded.
+
+int Scene::PlaceLoadedObjects(bool placeObjects, bool initPathfinding, bool placeUnits)
+{
+    // Unseen layers have to be ready before applying objects to the scene, so we can reveal around stuff that is getting placed for the appropriate team
+    CreateUnseenLayers();
 
 	m_SelectedAssemblies.clear();
     m_AssembliesCounts.clear();
@@ -835,7 +907,7 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
                                 int scaledW = ceilf(pTO->GetFGColorBitmap()->w * scale.m_X);
                                 int scaledH = ceilf(pTO->GetFGColorBitmap()->h * scale.m_Y);
                                 // Fill the box with key color for the owner ownerTeam, revealing the area that this thing is on
-                                rectfill(m_apUnseenLayer[ownerTeam]->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_MaskColor);
+                                m_VisibilityGrids[ownerTeam].SetBox(scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, true);
                                 // Expand the box a little so the whole placed object is going to be hidden
                                 scaledX -= 1;
                                 scaledY -= 1;
@@ -845,7 +917,7 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
                                 for (int t = Activity::TeamOne; t < Activity::MaxTeamCount; ++t)
                                 {
                                     if (t != ownerTeam && m_apUnseenLayer[t] && m_apUnseenLayer[t]->GetBitmap())
-                                        rectfill(m_apUnseenLayer[t]->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_BlackColor);
+                                        m_VisibilityGrids[t].SetBox(scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, false);
                                 }
                             }
                         }
@@ -903,15 +975,11 @@ int Scene::LoadData(bool placeObjects, bool initPathfinding, bool placeUnits)
         // Update all the pathfinding data
         m_pPathFinder->RecalculateAllCosts();
 
-        // Load Background layers' data
+        // The split screen setup may have changed since the background layers were loaded, if that was done ahead of time on a worker thread
         for (list<SceneLayer *>::iterator slItr = m_BackLayerList.begin(); slItr != m_BackLayerList.end(); ++slItr)
         {
-            RTEAssert((*slItr), "Background layer not instantiated before trying to load its data!");
-            if ((*slItr)->LoadData() < 0)
-            {
-                g_ConsoleMan.PrintString("ERROR: Loading background layer " + (*slItr)->GetPresetName() + "\'s data failed!");
-                return -1;
-            }
+            if ((*slItr)->GetBitmap())
+                (*slItr)->InitScrollRatios();
         }
     }
 
@@ -1022,7 +1090,8 @@ int Scene::SaveData(string pathBase)
 
     // Don't bother saving background layers to disk, as they are never altered
 
-    // Save unseen layers' data
+    // Save unseen layers' data, with everything seen so far drawn onto them
+    DrawUnseenLayerChanges(false);
     char str[64];
     for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
     {
@@ -1038,6 +1107,9 @@ int Scene::SaveData(string pathBase)
         }
     }
 
+    // Any clone made before this no longer has the same layer data
+    m_LayerDataGeneration = ++s_LayerDataGenerationCounter;
+
     return 0;
 }
 
@@ -1247,6 +1319,7 @@ int Scene::ClearData()
                 return -1;
             }
         }
+        m_VisibilityGrids[team].Reset();
     }
 
     return 0;
@@ -1798,6 +1871,7 @@ void Scene::FillUnseenLayer(Vector pixelSize, int team, bool createNow)
         m_apUnseenLayer[team]->Create(pUnseenBitmap, true, Vector(), WrapsX(), WrapsY(), Vector(1.0, 1.0));
         // Calculate how many times smaller the unseen map is compared to the entire terrain's dimensions, and set it as the scale factor on the Unseen layer
         m_apUnseenLayer[team]->SetScaleFactor(Vector((float)GetTerrain()->GetBitmap()->w / (float)m_apUnseenLayer[team]->GetBitmap()->w, (float)GetTerrain()->GetBitmap()->h / (float)m_apUnseenLayer[team]->GetBitmap()->h));
+        m_VisibilityGrids[team].Create(m_apUnseenLayer[team]->GetBitmap(), WrapsX(), WrapsY());
     }
 }
 
@@ -1817,137 +1891,37 @@ void Scene::SetUnseenLayer(SceneLayer *pNewLayer, int team)
     m_apUnseenLayer[team] = pNewLayer;
     // Calculate how many times smaller the unseen map is compared to the entire terrain's dimensions, and set it as the scale factor on the Unseen layer
     m_apUnseenLayer[team]->SetScaleFactor(Vector((float)GetTerrain()->GetBitmap()->w / (float)m_apUnseenLayer[team]->GetBitmap()->w, (float)GetTerrain()->GetBitmap()->h / (float)m_apUnseenLayer[team]->GetBitmap()->h));
+    m_VisibilityGrids[team].Create(m_apUnseenLayer[team]->GetBitmap(), WrapsX(), WrapsY());
 }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearSeenPixels
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Clears the pixels that have been seen on a team's unseen layer.
+// Description:     Cleans up the unseen pixels left orphaned around the ones that have
+//                  just been seen on a team's unseen layer.
 
 void Scene::ClearSeenPixels(int team)
 {
-    if (team != Activity::NoTeam)
-    {
-        // Clear all the pixels off the map, set them to key color
-        if (m_apUnseenLayer[team])
-        {
-            for (list<Vector>::iterator itr = m_SeenPixels[team].begin(); itr != m_SeenPixels[team].end(); ++itr)
-            {
-                putpixel(m_apUnseenLayer[team]->GetBitmap(), (*itr).m_X, (*itr).m_Y, g_MaskColor);
-
-                // Clean up around the removed pixels too
-                CleanOrphanPixel((*itr).m_X + 1, (*itr).m_Y, W, team);
-                CleanOrphanPixel((*itr).m_X - 1, (*itr).m_Y, E, team);
-                CleanOrphanPixel((*itr).m_X, (*itr).m_Y + 1, N, team);
-                CleanOrphanPixel((*itr).m_X, (*itr).m_Y - 1, S, team);
-                CleanOrphanPixel((*itr).m_X + 1, (*itr).m_Y + 1, NW, team);
-                CleanOrphanPixel((*itr).m_X - 1, (*itr).m_Y + 1, NE, team);
-                CleanOrphanPixel((*itr).m_X - 1, (*itr).m_Y - 1, SE, team);
-                CleanOrphanPixel((*itr).m_X + 1, (*itr).m_Y - 1, SW, team);
-            }
-        }
-
-        // Now actually clear the list too
-        m_SeenPixels[team].clear();
-
-        // Transfer all cleaned pixels from orphans to the seen pixels for next frame
-        for (list<Vector>::iterator itr = m_CleanedPixels[team].begin(); itr != m_CleanedPixels[team].end(); ++itr)
-            m_SeenPixels[team].push_back(*itr);
-
-        // We have moved the cleaned pixels to the seen pixels list, now clean up the list for next frame
-        m_CleanedPixels[team].clear();
-    }
+    // The cleaned up pixels become the just seen ones, so the cleanup spreads out a little every frame
+    if (team != Activity::NoTeam && m_apUnseenLayer[team])
+        m_VisibilityGrids[team].CleanOrphans();
 }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CleanOrphanPixel
+// Method:          DrawUnseenLayerChanges
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Checks a specific unseen pixel for only having two or less unseen
-//                  neighbors, and if so, makes it seen.
+// Description:     Draws what changed in the visibility grids onto the bitmaps of the
+//                  unseen layers, only going through the changed rows.
 
-bool Scene::CleanOrphanPixel(int posX, int posY, NeighborDirection checkingFrom, int team)
+void Scene::DrawUnseenLayerChanges(bool highlightSeenPixels)
 {
-    if (team == Activity::NoTeam || !m_apUnseenLayer[team])
-        return false;
-
-    // Do any necessary wrapping
-    m_apUnseenLayer[team]->WrapPosition(posX, posY, false);
-
-    // First check the actual position of the checked pixel, it may already been seen.
-    if (getpixel(m_apUnseenLayer[team]->GetBitmap(), posX, posY) == g_MaskColor)
-        return false;
-
-    // Ok, not seen, so check surrounding pixels for 'support', ie unseen ones that will keep this also unseen
-    float support = 0;
-    int testPosX, testPosY;
-    if (checkingFrom != E)
-    {
-        testPosX = posX + 1;
-        testPosY = posY;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 1 : 0;
-    }
-    if (checkingFrom != W)
-    {
-        testPosX = posX - 1;
-        testPosY = posY;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 1 : 0;
-    }
-    if (checkingFrom != S)
-    {
-        testPosX = posX;
-        testPosY = posY + 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 1 : 0;
-    }
-    if (checkingFrom != N)
-    {
-        testPosX = posX;
-        testPosY = posY - 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 1 : 0;
-    }
-    if (checkingFrom != SE)
-    {
-        testPosX = posX + 1;
-        testPosY = posY + 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 0.5f : 0;
-    }
-    if (checkingFrom != SW)
-    {
-        testPosX = posX - 1;
-        testPosY = posY + 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 0.5f : 0;
-    }
-    if (checkingFrom != NW)
-    {
-        testPosX = posX - 1;
-        testPosY = posY - 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 0.5f : 0;
-    }
-    if (checkingFrom != NE)
+    for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
     {
-        testPosX = posX + 1;
-        testPosY = posY - 1;
-        m_apUnseenLayer[team]->WrapPosition(testPosX, testPosY, false);
-        support += getpixel(m_apUnseenLayer[team]->GetBitmap(), testPosX, testPosY) != g_MaskColor ? 0.5f : 0;
+        if (m_apUnseenLayer[team] && m_apUnseenLayer[team]->GetBitmap())
+            m_VisibilityGrids[team].DrawChanges(m_apUnseenLayer[team]->GetBitmap(), highlightSeenPixels);
     }
-
-    // Orphaned enough to remove?
-    if (support <= 2.5)
-    {
-        putpixel(m_apUnseenLayer[team]->GetBitmap(), posX, posY, g_MaskColor);
-        m_CleanedPixels[team].push_back(Vector(posX, posY));
-        return true;
-    }    
-
-    return false;
 }
 
 
@@ -2002,6 +1976,9 @@ bool Scene::WrapsY() const { return m_pTerrain ? m_pTerrain->WrapsY() : false; }
 
 bool Scene::PlaceResidentBrain(int player, Activity &newActivity)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::PlaceResidentBrain"))
+        return false;
+
     if (m_ResidentBrains[player])
     {
         RTEAssert(m_ResidentBrains[player]->GetTeam() == newActivity.GetTeamOfPlayer(player), "Resident Brain is of the wrong team!!");
@@ -2034,6 +2011,9 @@ bool Scene::PlaceResidentBrain(int player, Activity &newActivity)
 
 int Scene::PlaceResidentBrains(Activity &newActivity)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::PlaceResidentBrains"))
+        return 0;
+
     int found = 0;
 
     for (int player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player)
@@ -2055,6 +2035,9 @@ int Scene::PlaceResidentBrains(Activity &newActivity)
 
 int Scene::RetrieveResidentBrains(Activity &oldActivity)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::RetrieveResidentBrains"))
+        return 0;
+
     int found = 0;
 
     for (int player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player)
@@ -2260,6 +2243,9 @@ void Scene::UpdatePlacedObjects(int whichSet)
 
 int Scene::ClearPlacedObjectSet(int whichSet)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::ClearPlacedObjectSet"))
+        return 0;
+
     int count = 0;
     for (list<SceneObject *>::iterator itr = m_PlacedObjects[whichSet].begin(); itr != m_PlacedObjects[whichSet].end(); ++itr)
     {
@@ -2299,6 +2285,9 @@ SceneObject * Scene::GetResidentBrain(int player) const
 
 void Scene::SetResidentBrain(int player, SceneObject *pNewBrain)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::SetResidentBrain"))
+        return;
+
     delete m_ResidentBrains[player];
     m_ResidentBrains[player] = pNewBrain;
 }
@@ -2328,6 +2317,9 @@ int Scene::GetResidentBrainCount() const
 
 bool Scene::SetArea(Area &newArea)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::SetArea"))
+        return false;
+
     for (list<Area>::iterator aItr = m_AreaList.begin(); aItr != m_AreaList.end(); ++aItr)
     {
         // Try to find an existing area of the same name
@@ -2974,6 +2966,9 @@ int Scene::SetOwnerOfAllDoors(int team, int player)
 
 void Scene::ResetPathFinding()
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::ResetPathFinding"))
+        return;
+
     if (m_pPathFinder)
         m_pPathFinder->RecalculateAllCosts();
 }
@@ -2987,6 +2982,9 @@ void Scene::ResetPathFinding()
 
 void Scene::UpdatePathFinding()
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::UpdatePathFinding"))
+        return;
+
     m_pPathFinder->RecalculateAreaCosts(m_pTerrain->GetUpdatedMaterialAreas());
     m_pTerrain->ClearUpdatedAreas();
     m_PartialPathUpdateTimer.Reset();
@@ -3000,12 +2998,15 @@ void Scene::UpdatePathFinding()
 // Description:     Calculates and returns the least difficult path between two points on
 //                  the current scene. Takes both distance and materials into account.
 
-float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght)
+float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght, int team)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::CalculatePath"))
+        return -1;
+
     float totalCostResult = -1;
     if (m_pPathFinder)
     {
-        int result = m_pPathFinder->CalculatePath(start, end, pathResult, totalCostResult, digStrenght);
+        int result = m_pPathFinder->CalculatePath(start, end, pathResult, totalCostResult, digStrenght, team);
 
         // It's ok if start and end nodes happen to be the same, the exact pixel locations are added at the front and end of the result regardless
         return (result == micropather::MicroPather::SOLVED || result == micropather::MicroPather::START_END_SAME) ? totalCostResult : -1;
@@ -3025,6 +3026,9 @@ float Scene::CalculatePath(const Vector &start, const Vector &end, std::list<Vec
 
 int Scene::CalculateScenePath(const Vector start, const Vector end, bool movePathToGround, float digStrength)
 {
+    if (g_MovableMan.RefuseInParallelAI("Scene::CalculateScenePath"))
+        return -1;
+
     int pathSize = -1;
     if (m_pPathFinder)
     {
@@ -3098,28 +3102,17 @@ void Scene::Update()
 {
     m_PathfindingUpdated = false;
 
-	if (g_SettingsMan.BlipOnRevealUnseen())
-	{
-		// Highlight the pixels that have been revealed on the unseen maps
-		for (int team = Activity::TeamOne; team < Activity::MaxTeamCount; ++team)
-		{
-			if (m_apUnseenLayer[team])
-			{
-				for (list<Vector>::iterator itr = m_SeenPixels[team].begin(); itr != m_SeenPixels[team].end(); ++itr)
-				{
-					putpixel(m_apUnseenLayer[team]->GetBitmap(), (*itr).m_X, (*itr).m_Y, g_WhiteColor);
-				}
-			}
-		}
-	}
+	// Bring the unseen maps up to date with what was seen and hidden since last frame, highlighting the pixels that have just been revealed
+	DrawUnseenLayerChanges(g_SettingsMan.BlipOnRevealUnseen());
 
-    // Do full update every two minutes
+    // Do full update every two minutes, in the background so it doesn't hitch the game. The new costs get swapped in a fixed sim time later, so it's the same every run
     if (m_FullPathUpdateTimer.IsPastSimMS(120000))
     {
-        m_pPathFinder->RecalculateAllCosts();
+        m_pPathFinder->StartBackgroundRecalculation();
         m_FullPathUpdateTimer.Reset();
-        m_PathfindingUpdated = true;
     }
+    if (m_pPathFinder->UpdateBackgroundRecalculation())
+        m_PathfindingUpdated = true;
 
     // Do partial update every 10 seconds
     if (m_PartialPathUpdateTimer.IsPastRealMS(10000))
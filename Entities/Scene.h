@@ -19,6 +19,7 @@
 #include "ActivityMan.h"
 #include "Box.h"
 #include "BunkerAssembly.h"
+#include "VisibilityGrid.h"
 
 namespace RTE
 {
@@ -292,19 +293,6 @@ friend class AreaPickerGUI;
 
 #define METABASE_AREA_NAME "MetabaseServiceArea"
 
-enum NeighborDirection
-{
-    NODIR = -1,
-    E = 0,
-    SE,
-    S,
-    SW,
-    W,
-    NW,
-    N,
-    NE
-};
-
 // Concrete allocation and cloning definitions
 EntityAllocation(Scene)
 
@@ -368,6 +356,41 @@ EntityAllocation(Scene)
 	int LoadData(bool placeObjects = true, bool initPathfinding = true, bool placeUnits = true);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          LoadLayerData
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Loads the bitmap data of the terrain, unseen and background layers
+//                  into memory. This is the first stage of LoadData, and doesn't
+//                  allocate any Entities or touch any of the managers' state, so it
+//                  can be done on a worker thread.
+// Arguments:       Whether to load the background layers too, which are only needed
+//                  when the Scene is going to be played or edited.
+//                  Function to call with a description of each step as it starts. Is
+//                  called on the thread doing the loading. Can be empty.
+// Return value:    An error return value signaling sucess or any particular failure.
+//                  Anything below 0 is an error signal.
+
+	int LoadLayerData(bool loadBackgroundLayers, const std::function<void(const std::string &)> &reportProgress = nullptr);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PlaceLoadedObjects
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Creates the dynamically generated unseen layers, places the
+//                  SceneObjects set to be placed on load and sets up the pathfinding.
+//                  This is the second stage of LoadData, and has to be done on the
+//                  main thread after LoadLayerData.
+// Arguments:       Whetehr to actually place out all the sceneobjects associated with the
+//                  Scene's definition. If not, they still remain in the internal placed
+//                  objects list. This avoids messing with the MovableMan at all.
+//                  Whether to do pathfinding init.
+//					Whether to place actors and deployments (doors not affected).
+// Return value:    An error return value signaling sucess or any particular failure.
+//                  Anything below 0 is an error signal.
+
+	int PlaceLoadedObjects(bool placeObjects = true, bool initPathfinding = true, bool placeUnits = true);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  ExpandAIPlanAssemblySchemes
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -663,19 +686,22 @@ EntityAllocation(Scene)
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          GetSeenPixels
+// Method:          GetVisibilityGrid
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Gets the list of pixels that have been seen on a team's unseen layer.
-// Arguments:       Which team to get the unseen layer for.
-// Return value:    The list of pixel coordinates in the unseen layer's scale.
+// Description:     Gets the packed grid of what a team has seen, which is what reveals
+//                  and restores of the team's unseen layer actually change.
+// Arguments:       Which team to get the visibility grid for.
+// Return value:    The visibility grid, or 0 if the team has no unseen layer loaded.
+//                  Ownership is NOT transferred!
 
-    std::list<Vector> & GetSeenPixels(int team = Activity::TeamOne) { return m_SeenPixels[team]; }
+    VisibilityGrid * GetVisibilityGrid(int team = Activity::TeamOne) { return (team != Activity::NoTeam && m_apUnseenLayer[team] && !m_VisibilityGrids[team].IsEmpty()) ? &m_VisibilityGrids[team] : 0; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          ClearSeenPixels
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Clears the pixels that have been seen on a team's unseen layer.
+// Description:     Cleans up the unseen pixels left orphaned around the ones that have
+//                  just been seen on a team's unseen layer.
 // Arguments:       Which team to get the unseen layer for.
 // Return value:    None.
 
@@ -683,17 +709,14 @@ EntityAllocation(Scene)
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
-// Method:          CleanOrphanPixel
+// Method:          DrawUnseenLayerChanges
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Checks a specific unseen pixel for only having two or less unseen
-//                  neighbors, and if so, makes it seen.
-// Arguments:       Coordinates to the pixel to check for orphaness.
-//                  The direction we might be checking 'from', ie the neighbor we can
-//                  already assume is seen without poking at the unseen map.
-//                  Which team's unseen layer to check the pixel on.
-// Return value:    Whether the pixel was deemed to be orphan and thus cleaned up.
+// Description:     Draws what changed in the visibility grids onto the bitmaps of the
+//                  unseen layers, only going through the changed rows.
+// Arguments:       Whether to highlight the pixels that have just been seen in white.
+// Return value:    None.
 
-    bool CleanOrphanPixel(int posX, int posY, NeighborDirection checkingFrom = NODIR, int team = Activity::TeamOne);
+    void DrawUnseenLayerChanges(bool highlightSeenPixels);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1202,10 +1225,14 @@ const SceneObject * PickPlacedActorInRange(int whichSet, Vector &scenePoint, int
 //                  the current scene. Takes both distance and materials into account.
 // Arguments:       Start and end positions on the scene to find the path between.
 //                  A list which will be filled out with waypoints between the start and end.
+//                  The maximum material strength any actor traveling along the path can
+//                  dig through.
+//                  The team the path is for. Found paths are shared between searches for
+//                  the same team and goal.
 // Return value:    The total minimum difficulty cost calculated between the two points on
 //                  the scene.
 
-    float CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght = 1);
+    float CalculatePath(const Vector &start, const Vector &end, std::list<Vector> &pathResult, float digStrenght = 1, int team = Activity::NoTeam);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1313,6 +1340,18 @@ const SceneObject * PickPlacedActorInRange(int whichSet, Vector &scenePoint, int
 
 	BITMAP * GetPreviewBitmap() const { return m_pPreviewBitmap; };
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetLayerDataGeneration
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number telling this Scene instance and the layer data it was
+//                  last saved with apart from any other, including deleted Scenes whose
+//                  memory this one may be reusing.
+// Arguments:       None.
+// Return value:    The layer data generation of this Scene.
+
+	unsigned long long GetLayerDataGeneration() const { return m_LayerDataGeneration; }
+
     // Holds the path calculated by CalculateScenePath
     std::list<Vector> m_ScenePath;
 
@@ -1364,10 +1403,8 @@ protected:
     Vector m_UnseenPixelSize[Activity::MaxTeamCount];
     // Layers representing the unknown areas for each team
     SceneLayer *m_apUnseenLayer[Activity::MaxTeamCount];
-    // Which pixels of the unseen map have just been revealed this frame, in the coordinates of the unseen map
-    std::list<Vector> m_SeenPixels[Activity::MaxTeamCount];
-    // Pixels on the unseen map deemed to be orphans and cleaned up, will be moved to seen pixels next update
-    std::list<Vector> m_CleanedPixels[Activity::MaxTeamCount];
+    // What each team has seen, one bit per pixel of its unseen layer. The unseen layers' bitmaps only show this
+    VisibilityGrid m_VisibilityGrids[Activity::MaxTeamCount];
     // Whether this Scene is scheduled to be orbitally scanned by any team
     bool m_ScanScheduled[Activity::MaxTeamCount];
 
@@ -1391,6 +1428,10 @@ protected:
 	string m_MetasceneParent;
 	// Whether this scene must be shown anywhere in UIs
 	bool m_IsMetagameInternal;
+	// Unique number of this instance and the layer data it was last saved with, to tell whether a preloaded clone of it is still current
+	unsigned long long m_LayerDataGeneration;
+	// The last layer data generation handed out to any Scene
+	static unsigned long long s_LayerDataGenerationCounter;
 
 	std::list<Deployment *>m_Deployments;
 
@@ -1410,6 +1451,18 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CreateUnseenLayers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Creates the dynamically generated unseen layers and reads what each
+//                  team has seen already into its visibility grid. Has to be done on
+//                  the main thread, after LoadLayerData.
+// Arguments:       None.
+// Return value:    None.
+
+    void CreateUnseenLayers();
+
+
     // Disallow the use of some implicit methods.
     Scene(const Scene &reference) {}
     void operator=(const Scene &rhs) {}
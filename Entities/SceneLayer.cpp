@@ -13,6 +13,9 @@
 
 #include "SceneLayer.h"
 #include "ContentFile.h"
+#include "SceneLayerCodec.h"
+#include "SettingsMan.h"
+#include "MetaMan.h"
 
 namespace RTE {
 
@@ -28,6 +31,7 @@ ConcreteClassInfo(SceneLayer, Entity, 0)
 void SceneLayer::Clear()
 {
     m_BitmapFile.Reset();
+    m_BaseBitmapPath.clear();
     m_pMainBitmap = 0;
     m_MainBitmapOwned = false;
     m_DrawTrans = true;
@@ -161,6 +165,7 @@ int SceneLayer::Create(const SceneLayer &reference)
     Entity::Create(reference);
 
     m_BitmapFile = reference.m_BitmapFile;
+    m_BaseBitmapPath = reference.m_BaseBitmapPath;
 
     // Deep copy the bitmap
     if (reference.m_pMainBitmap)
@@ -224,7 +229,14 @@ int SceneLayer::LoadData()
     blit(pCopyFrom, m_pMainBitmap, 0, 0, 0, 0, pCopyFrom->w, pCopyFrom->h);
 */
     // Re-load directly from disk each time; don't do any caching of these bitmaps
-    m_pMainBitmap = m_BitmapFile.LoadAndReleaseBitmap();
+    if (SceneLayerCodec::IsLayerFile(m_BitmapFile.GetDataPath()))
+    {
+        m_pMainBitmap = SceneLayerCodec::LoadLayer(m_BitmapFile.GetDataPath(), m_BaseBitmapPath);
+        if (!m_pMainBitmap)
+            return -1;
+    }
+    else
+        m_pMainBitmap = m_BitmapFile.LoadAndReleaseBitmap();
 
     m_MainBitmapOwned = true;
 
@@ -250,8 +262,23 @@ int SceneLayer::SaveData(string bitmapPath)
     if (bitmapPath.empty())
         return -1;
 
+    // Save out the bitmap as a compressed scene layer file, unless bitmaps are wanted
+    if (m_pMainBitmap && !g_SettingsMan.SaveSceneLayersAsBitmaps() && bitmap_color_depth(m_pMainBitmap) == 8)
+    {
+        // The first time a layer copied from a preset gets saved, remember the preset's bitmap so only what changed from it needs storing from then on.
+        // Bitmaps saved with metagames can be overwritten, so they don't make good bases
+        const std::string &currentPath = m_BitmapFile.GetDataPath();
+        if (m_BaseBitmapPath.empty() && !currentPath.empty() && !SceneLayerCodec::IsLayerFile(currentPath) && currentPath.find(METASAVEPATH) != 0)
+            m_BaseBitmapPath = currentPath;
+
+        std::string layerPath = bitmapPath.substr(0, bitmapPath.find_last_of('.')) + SceneLayerCodec::c_FileExtension;
+        if (SceneLayerCodec::SaveLayer(layerPath, m_pMainBitmap, m_BaseBitmapPath) < 0)
+            return -1;
+
+        m_BitmapFile.SetDataPath(layerPath);
+    }
     // Save out the bitmap
-    if (m_pMainBitmap)
+    else if (m_pMainBitmap)
     {
         PALETTE palette;
         get_palette(palette);
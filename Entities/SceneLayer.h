@@ -36,6 +36,7 @@ class SceneLayer:
     public Entity
 {
 	friend class NetworkServer;
+	friend class Scene;
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Public member variable, method and friend function declarations
@@ -160,7 +161,9 @@ ClassInfoGetters
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  SaveData
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Saves data currently in memory to disk.
+// Description:     Saves data currently in memory to disk. Unless the setting to save scene
+//                  layers as bitmaps is on, this is saved as a compressed scene layer file
+//                  instead, at the same path but with the scene layer file extension.
 // Arguments:       The filepath to the where to save the Bitmap data.
 // Return value:    An error return value signaling success or any particular failure.
 //                  Anything below 0 is an error signal.
@@ -498,6 +501,8 @@ protected:
     static Entity::ClassInfo m_sClass;
 
     ContentFile m_BitmapFile;
+    // The path of the bitmap this was first loaded from, if it was a preset's. Scene layer files only store what differs from it
+    std::string m_BaseBitmapPath;
 
     BITMAP *m_pMainBitmap;
     // Whether main bitmap is owned by this
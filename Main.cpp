@@ -43,6 +43,9 @@
 
 #include "MultiplayerServerLobby.h"
 #include "NetworkServer.h"
+#include "SimBenchmark.h"
+#include "TelemetryWriter.h"
+#include "InputReplay.h"
 
 extern "C" { FILE __iob_func[3] = { *stdin,*stdout,*stderr }; }
 
@@ -119,6 +122,11 @@ volatile bool g_Quit = false;
 bool g_ResetRTE = false; //!< Signals to reset the entire RTE next iteration.
 bool g_LaunchIntoEditor = false; //!< Flag for launching directly into editor activity.
 const char *g_EditorToLaunch = ""; //!< String with editor activity name to launch.
+std::string g_NetworkReplayToPlay = ""; //!< Path to a recorded network stream to play back instead of running the game, if any.
+bool g_NetworkReplayAtMaxSpeed = false; //!< Whether the network replay should be played back as fast as possible for benchmarking instead of at the recorded pace.
+SimBenchmark g_SimBenchmark; //!< The headless sim benchmark to run instead of the game, if one was asked for.
+TelemetryWriter g_TelemetryWriter; //!< Writes periodic telemetry records to a file while the game runs, if asked for.
+InputReplay g_InputReplay; //!< Records the input of an Activity or plays a recording back headlessly instead of running the game, if asked for.
 bool g_InActivity = false;
 bool g_ResetActivity = false;
 bool g_ResumeActivity = false;
@@ -1604,7 +1612,6 @@ bool RunGameLoop() {
 			}
 			g_FrameMan.Update();
 			g_AudioMan.Update();
-			g_LuaMan.Update();
 			g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
 			g_ActivityMan.Update();
 			g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
@@ -1613,6 +1620,8 @@ bool RunGameLoop() {
 			g_ActivityMan.LateUpdateGlobalScripts();
 
 			g_ConsoleMan.Update();
+			// Lua garbage collection goes last so it can use whatever time is left in this sim update
+			g_LuaMan.Update();
 			g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
 
 			if (!g_InActivity) {
@@ -1661,13 +1670,33 @@ bool RunGameLoop() {
 			}
 		}
 		g_FrameMan.Draw();
-		g_FrameMan.FlipFrameBuffers();
+		g_FrameMan.PresentFrame();
+		g_TelemetryWriter.Update();
 	}
+	g_FrameMan.WaitForFramePresent();
 	return true;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+/// <summary>
+/// Runs the Activity to record one fixed sim update per drawn frame, recording the input of every player, until it ends or escape is pressed.
+/// </summary>
+/// <returns>Whether the recording was made successfully.</returns>
+bool RunInputRecording() {
+	if (g_InputReplay.StartRecording() < 0) {
+		return false;
+	}
+	while (!g_Quit && g_ActivityMan.ActivityRunning() && !g_UInputMan.KeyPressed(KEY_ESC)) {
+		g_FrameMan.ClearBackBuffer8();
+		g_InputReplay.RecordSimUpdate();
+		g_FrameMan.FlipFrameBuffers();
+	}
+	return g_InputReplay.StopRecording() >= 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 /// <summary>
 /// Command-line argument handling.
 /// </summary>
@@ -1689,6 +1718,9 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar) {
             // Print loading screen console to cout
 			if (std::strcmp(argv[i], "-cout") == 0) {
 				g_System.SetLogToCLI(true);
+			// Play back the network replay as fast as possible without presenting frames
+			} else if (std::strcmp(argv[i], "-netreplayfast") == 0) {
+				g_NetworkReplayAtMaxSpeed = true;
 			} else if (i + 1 < argc) {
 				// Launch game in server mode
                 if (std::strcmp(argv[i], "-server") == 0 && i + 1 < argc) {
@@ -1705,6 +1737,50 @@ bool HandleMainArgs(int argc, char *argv[], int &appExitVar) {
 						g_EditorToLaunch = editorName;
 						g_LaunchIntoEditor = true;
 					}
+				// Record the outgoing network stream of each client to files starting with the specified name
+				} else if (std::strcmp(argv[i], "-netrecord") == 0 && i + 1 < argc) {
+					g_NetworkServer.SetRecordingFileName(argv[++i]);
+				// Play back a recorded network stream instead of running the game
+				} else if (std::strcmp(argv[i], "-netreplay") == 0 && i + 1 < argc) {
+					g_NetworkReplayToPlay = argv[++i];
+				// Run the sim headlessly for the specified number of sim updates and print the timings and state checksum instead of running the game
+				} else if (std::strcmp(argv[i], "-benchmark") == 0 && i + 1 < argc) {
+					g_SimBenchmark.SetSimUpdateCount(std::max(std::atoi(argv[++i]), 0));
+					g_System.SetLogToCLI(true);
+				// Scene to run the benchmark on
+				} else if (std::strcmp(argv[i], "-benchscene") == 0 && i + 1 < argc) {
+					g_SimBenchmark.SetSceneName(argv[i + 1]);
+					g_InputReplay.SetSceneName(argv[++i]);
+				// Activity class and preset name to run the benchmark with
+				} else if (std::strcmp(argv[i], "-benchactivity") == 0 && i + 2 < argc) {
+					const char *activityType = argv[++i];
+					g_SimBenchmark.SetActivity(activityType, argv[i + 1]);
+					g_InputReplay.SetActivity(activityType, argv[++i]);
+				// Seed for the benchmark's or input recording's RNG
+				} else if (std::strcmp(argv[i], "-seed") == 0 && i + 1 < argc) {
+					unsigned int seed = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+					g_SimBenchmark.SetSeed(seed);
+					g_InputReplay.SetSeed(seed);
+				// Built-in stress scenario to run on top of the benchmark's Activity
+				} else if (std::strcmp(argv[i], "-benchscenario") == 0 && i + 1 < argc) {
+					g_SimBenchmark.SetScenarioName(argv[++i]);
+				// Periodically append telemetry records to the specified file while the game runs
+				} else if (std::strcmp(argv[i], "-telemetry") == 0 && i + 1 < argc) {
+					g_TelemetryWriter.SetFilePath(argv[++i]);
+				// Seconds between telemetry records
+				} else if (std::strcmp(argv[i], "-telemetryinterval") == 0 && i + 1 < argc) {
+					g_TelemetryWriter.SetRecordInterval(std::atoi(argv[++i]));
+				// Record the input of every player for every sim update of the benchmark's Scene and Activity to the specified file, instead of running the game
+				} else if (std::strcmp(argv[i], "-inputrecord") == 0 && i + 1 < argc) {
+					g_InputReplay.SetRecordFileName(argv[++i]);
+				// Play back an input recording headlessly as fast as possible and check the sim ends up in the same state after every sim update, instead of running the game
+				} else if (std::strcmp(argv[i], "-inputreplay") == 0 && i + 1 < argc) {
+					g_InputReplay.SetReplayFileName(argv[++i]);
+					g_System.SetLogToCLI(true);
+				// Record the specified number of sim updates of the benchmark's Scene and Activity with HDFirearms firing the whole time, then play the recording back and check it matches, instead of running the game
+				} else if (std::strcmp(argv[i], "-inputreplaycheck") == 0 && i + 1 < argc) {
+					g_InputReplay.SetGunfireCheckSimUpdateCount(std::atoi(argv[++i]));
+					g_System.SetLogToCLI(true);
 				}
             }
         }
@@ -1776,7 +1852,8 @@ int main(int argc, char *argv[]) {
     g_PresetMan.Create();
     g_FrameMan.Create();
     g_PostProcessMan.Create();
-    if (g_AudioMan.Create() >= 0) {
+	// Benchmarks and input playbacks run without audio, so leave it disabled and every sound call does nothing
+    if (!g_SimBenchmark.IsEnabled() && !g_InputReplay.IsReplayEnabled() && !g_InputReplay.IsGunfireCheckEnabled() && g_AudioMan.Create() >= 0) {
         g_GUISound.Create();
     }
     g_UInputMan.Create();
@@ -1814,30 +1891,48 @@ int main(int argc, char *argv[]) {
 		if (std::filesystem::exists(g_System.GetWorkingDirectory() + "/LogLoadingWarning.txt")) { std::remove("LogLoadingWarning.txt"); }
 	}
 
-    if (!g_NetworkServer.IsServerModeEnabled()) {
-		if (g_LaunchIntoEditor) {
-			// Force mouse + keyboard with default mapping so we won't need to change manually if player 1 is set to keyboard only or gamepad.
-			g_UInputMan.GetControlScheme(Players::PlayerOne)->SetDevice(InputDevice::DEVICE_MOUSE_KEYB);
-			g_UInputMan.GetControlScheme(Players::PlayerOne)->SetPreset(InputPreset::PRESET_WASDKEYS);
-			// Start the specified editor activity.
-			EnterEditorActivity(g_EditorToLaunch);
-		} else if (!g_SettingsMan.LaunchIntoActivity()) {
-			g_IntroState = g_SettingsMan.SkipIntro() ? MENUAPPEAR : START;
-			PlayIntroTitle();
-		}
+	// Benchmarks, recordings and their playback all rely on the sim giving the same results every run
+	g_TimerMan.SetDeterministic(g_SimBenchmark.IsEnabled() || g_InputReplay.IsGunfireCheckEnabled() || g_InputReplay.IsReplayEnabled() || g_InputReplay.IsRecordingEnabled());
+
+	bool benchmarkFailed = false;
+	if (g_SimBenchmark.IsEnabled()) {
+		benchmarkFailed = g_SimBenchmark.Run() < 0;
+	} else if (g_InputReplay.IsGunfireCheckEnabled()) {
+		benchmarkFailed = g_InputReplay.RunGunfireCheck() < 0;
+	} else if (g_InputReplay.IsReplayEnabled()) {
+		benchmarkFailed = g_InputReplay.Replay() < 0;
+	} else if (g_InputReplay.IsRecordingEnabled()) {
+		benchmarkFailed = !RunInputRecording();
+	} else if (!g_NetworkReplayToPlay.empty()) {
+		g_NetworkClient.RunReplay(g_NetworkReplayToPlay, g_NetworkReplayAtMaxSpeed);
 	} else {
-		// NETWORK Create multiplayer lobby activity to start as default if server is running
-		EnterMultiplayerLobby();
-	}
+		if (!g_NetworkServer.IsServerModeEnabled()) {
+			if (g_LaunchIntoEditor) {
+				// Force mouse + keyboard with default mapping so we won't need to change manually if player 1 is set to keyboard only or gamepad.
+				g_UInputMan.GetControlScheme(Players::PlayerOne)->SetDevice(InputDevice::DEVICE_MOUSE_KEYB);
+				g_UInputMan.GetControlScheme(Players::PlayerOne)->SetPreset(InputPreset::PRESET_WASDKEYS);
+				// Start the specified editor activity.
+				EnterEditorActivity(g_EditorToLaunch);
+			} else if (!g_SettingsMan.LaunchIntoActivity()) {
+				g_IntroState = g_SettingsMan.SkipIntro() ? MENUAPPEAR : START;
+				PlayIntroTitle();
+			}
+		} else {
+			// NETWORK Create multiplayer lobby activity to start as default if server is running
+			EnterMultiplayerLobby();
+		}
 
-    // If we fail to start/reset the activity, then revert to the intro/menu
-    if (!ResetActivity()) { PlayIntroTitle(); }
-	
-    RunGameLoop();
+		// If we fail to start/reset the activity, then revert to the intro/menu
+		if (!ResetActivity()) { PlayIntroTitle(); }
+
+		RunGameLoop();
+	}
 
     ///////////////////////////////////////////////////////////////////
     // Clean up
 
+	// The last record needs the managers to still be around
+	g_TelemetryWriter.Destroy();
 	g_NetworkClient.Destroy();
 	g_NetworkServer.Destroy();
 
@@ -1862,7 +1957,7 @@ int main(int argc, char *argv[]) {
     Entity::ClassInfo::DumpPoolMemoryInfo(Writer("MemCleanupInfo.txt"));
 #endif
 	
-    return 0;
+    return benchmarkFailed ? 2 : 0;
 }
 
 int APIENTRY WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) { return main(__argc, __argv); }
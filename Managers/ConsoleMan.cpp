@@ -33,6 +33,8 @@ namespace RTE {
 		m_InputLogPosition = m_InputLog.begin();
 		m_LastInputString.clear();
 		m_LastLogMove = 0;
+		m_MainThreadID = std::this_thread::get_id();
+		m_QueuedStrings.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -183,10 +185,28 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void ConsoleMan::PrintString(const std::string &stringToPrint) const {
+		if (std::this_thread::get_id() != m_MainThreadID) {
+			std::lock_guard<std::mutex> queuedStringsLock(m_QueuedStringsMutex);
+			m_QueuedStrings.push_back(stringToPrint);
+			return;
+		}
 		m_ConsoleText->SetText(m_ConsoleText->GetText() + "\n" + stringToPrint);
 		if (g_System.GetLogToCLI()) { g_System.PrintToCLI(stringToPrint); }
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ConsoleMan::PrintQueuedStrings() {
+		std::vector<std::string> queuedStrings;
+		{
+			std::lock_guard<std::mutex> queuedStringsLock(m_QueuedStringsMutex);
+			queuedStrings.swap(m_QueuedStrings);
+		}
+		for (const std::string &queuedString : queuedStrings) {
+			PrintString(queuedString);
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void ConsoleMan::ShowShortcuts() {
@@ -207,11 +227,15 @@ namespace RTE {
 		PrintString("F3 - Save console log");
 		PrintString("F4 - Save console user input log");
 		PrintString("F5 - Clear console log ");
+		PrintString("F6 - Start/stop Lua script profiling, saves LuaProfile.folded when stopped");
+		PrintString("F7 - Start/stop profile capture, saves ProfileTrace.json when stopped");
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void ConsoleMan::Update() {
+		PrintQueuedStrings();
+
 		if (g_UInputMan.FlagCtrlState() && g_UInputMan.KeyPressed(KEY_TILDE)) {
 			SetReadOnly();
 		}
@@ -119,11 +119,16 @@ namespace RTE {
 
 #pragma region Concrete Methods
 		/// <summary>
-		/// Prints a string into the console.
+		/// Prints a string into the console. Can be called from any thread, but strings from threads other than the main one are only queued, and printed by PrintQueuedStrings.
 		/// </summary>
 		/// <param name="stringToPrint">The string to print.</param>
 		void PrintString(const std::string &stringToPrint) const;
 
+		/// <summary>
+		/// Prints the strings other threads have queued with PrintString, in the order they were queued. Must be called from the main thread. Is done every Update.
+		/// </summary>
+		void PrintQueuedStrings();
+
 		/// <summary>
 		/// Opens the console and prints the shortcut help text.
 		/// </summary>
@@ -176,6 +181,10 @@ namespace RTE {
 		std::string m_LastInputString; //!< Place to save the last worked on input string before deactivating the console.
 		short m_LastLogMove; //!< The last direction the log marker was moved. Needed so that changing directions won't need double tapping.
 
+		std::thread::id m_MainThreadID; //!< The thread this ConsoleMan was made on, which is the only one allowed to touch the console text directly.
+		mutable std::vector<std::string> m_QueuedStrings; //!< Strings printed from other threads, waiting to be printed on the main thread.
+		mutable std::mutex m_QueuedStringsMutex; //!< Mutex guarding the queued strings.
+
 	private:
 
 		/// <summary>
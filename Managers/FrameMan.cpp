@@ -3,6 +3,7 @@
 #include "PrimitiveMan.h"
 #include "PerformanceMan.h"
 #include "ActivityMan.h"
+#include "MovableMan.h"
 #include "ConsoleMan.h"
 #include "SettingsMan.h"
 #include "UInputMan.h"
@@ -57,6 +58,9 @@ namespace RTE {
 		m_ScenePreviewDumpGradient = nullptr;
 		m_BackBuffer8 = nullptr;
 		m_BackBuffer32 = nullptr;
+		m_PresentBuffer32 = nullptr;
+		m_FramePendingPresent = false;
+		m_StopPresentThread = false;
 		m_DrawNetworkBackBuffer = false;
 		m_StoreNetworkBackBuffer = false;
 		m_NetworkFrameCurrent = 0;
@@ -365,8 +369,11 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void FrameMan::Destroy() {
+		StopPresentThread();
+
 		destroy_bitmap(m_BackBuffer8);
 		destroy_bitmap(m_BackBuffer32);
+		destroy_bitmap(m_PresentBuffer32);
 		destroy_bitmap(m_PlayerScreen);
 		destroy_bitmap(m_ScreenDumpBuffer);
 		destroy_bitmap(m_WorldDumpBuffer);
@@ -385,6 +392,8 @@ namespace RTE {
 		delete m_LargeFont;
 		delete m_SmallFont;
 
+		m_RotatedSpriteCache.Destroy();
+
 		Clear();
 	}
 
@@ -443,6 +452,8 @@ namespace RTE {
 		unsigned short resX = m_ResX;
 		unsigned short resY = m_ResY;
 
+		WaitForFramePresent();
+
 		// Set the GFX_TEXT driver to hack around Allegro's window resizing limitations (specifically reducing window size) when switching from 2X mode to 1X mode.
 		// This will force a state where there is no actual game window between multiplier switches and the next set_gfx_mode call will recreate it correctly.
 		set_gfx_mode(GFX_TEXT, 0, 0, 0, 0);
@@ -509,6 +520,8 @@ namespace RTE {
 
 		ValidateResolution(newResX, newResY, newMultiplier);
 
+		WaitForFramePresent();
+
 		// Set the GFX_TEXT driver to hack around Allegro's window resizing limitations.
 		set_gfx_mode(GFX_TEXT, 0, 0, 0, 0);
 
@@ -650,12 +663,87 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void FrameMan::FlipFrameBuffers() const {
+	void FrameMan::FlipFrameBuffers() {
+		WaitForFramePresent();
+		BlitToScreen(m_BackBuffer32);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void FrameMan::PresentFrame() {
+		if (!g_SettingsMan.PipelinedRendering()) {
+			FlipFrameBuffers();
+			return;
+		}
+		WaitForFramePresent();
+
+		// The copy is done here on the main thread so the present thread never reads the backbuffer while the next frame is drawn to it
+		if (!m_PresentBuffer32 || m_PresentBuffer32->w != m_BackBuffer32->w || m_PresentBuffer32->h != m_BackBuffer32->h) {
+			destroy_bitmap(m_PresentBuffer32);
+			m_PresentBuffer32 = create_bitmap_ex(32, m_BackBuffer32->w, m_BackBuffer32->h);
+		}
+		blit(m_BackBuffer32, m_PresentBuffer32, 0, 0, 0, 0, m_BackBuffer32->w, m_BackBuffer32->h);
+
+		if (!m_PresentThread.joinable()) {
+			m_StopPresentThread = false;
+			m_PresentThread = std::thread(&FrameMan::PresentThreadFunction, this);
+		}
+		{
+			std::lock_guard<std::mutex> presentLock(m_PresentMutex);
+			m_FramePendingPresent = true;
+		}
+		m_PresentCondition.notify_all();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void FrameMan::WaitForFramePresent() {
+		std::unique_lock<std::mutex> presentLock(m_PresentMutex);
+		m_PresentCondition.wait(presentLock, [this]() { return !m_FramePendingPresent; });
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void FrameMan::BlitToScreen(BITMAP *frameBuffer) const {
 		if (m_ResMultiplier > 1) {
-			stretch_blit(m_BackBuffer32, screen, 0, 0, m_BackBuffer32->w, m_BackBuffer32->h, 0, 0, SCREEN_W, SCREEN_H);
+			stretch_blit(frameBuffer, screen, 0, 0, frameBuffer->w, frameBuffer->h, 0, 0, SCREEN_W, SCREEN_H);
 		} else {
-			blit(m_BackBuffer32, screen, 0, 0, 0, 0, m_BackBuffer32->w, m_BackBuffer32->h);
+			blit(frameBuffer, screen, 0, 0, 0, 0, frameBuffer->w, frameBuffer->h);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void FrameMan::PresentThreadFunction() {
+		std::unique_lock<std::mutex> presentLock(m_PresentMutex);
+		while (true) {
+			m_PresentCondition.wait(presentLock, [this]() { return m_FramePendingPresent || m_StopPresentThread; });
+			if (m_StopPresentThread) {
+				return;
+			}
+			// The main thread doesn't touch the present buffer or the screen while a frame is pending, so the lock isn't needed for the blit itself
+			presentLock.unlock();
+			BlitToScreen(m_PresentBuffer32);
+			presentLock.lock();
+
+			m_FramePendingPresent = false;
+			m_PresentCondition.notify_all();
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void FrameMan::StopPresentThread() {
+		if (!m_PresentThread.joinable()) {
+			return;
+		}
+		WaitForFramePresent();
+		{
+			std::lock_guard<std::mutex> presentLock(m_PresentMutex);
+			m_StopPresentThread = true;
 		}
+		m_PresentCondition.notify_all();
+		m_PresentThread.join();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -747,6 +835,7 @@ namespace RTE {
 				break;
 			case ScreenDump:
 				if (screen) {
+					WaitForFramePresent();
 					if (!m_ScreenDumpBuffer) { m_ScreenDumpBuffer = create_bitmap_ex(24, screen->w, screen->h); }
 					blit(screen, m_ScreenDumpBuffer, 0, 0, 0, 0, screen->w, screen->h);
 					// nullptr for the PALETTE parameter here because we're saving a 24bpp file and it's irrelevant.
@@ -1190,8 +1279,9 @@ namespace RTE {
 			unsigned char effectStrength = 0;
 			Vector targetPos(0, 0);
 
-			// Draw objects
+			// Draw objects. With interpolated drawing they aren't in the MO color layer so draw them directly
 			draw_sprite(m_WorldDumpBuffer, g_SceneMan.GetMOColorBitmap(), 0, 0);
+			if (g_SettingsMan.InterpolatedDrawing()) { g_MovableMan.Draw(m_WorldDumpBuffer); }
 
 			// Draw post-effects
 			g_PostProcessMan.GetPostScreenEffectsWrapped(targetPos, worldBitmapWidth, worldBitmapHeight, postEffectsList, -1);
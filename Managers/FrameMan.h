@@ -4,6 +4,7 @@
 #include "ContentFile.h"
 #include "Timer.h"
 #include "Box.h"
+#include "RotatedSpriteCache.h"
 
 #define g_FrameMan FrameMan::Instance()
 
@@ -84,6 +85,12 @@ namespace RTE {
 		/// </summary>
 		/// <returns>A pointer to the BITMAP 32bpp backbuffer. OWNERSHIP IS NOT TRANSFERRED!</returns>
 		BITMAP * GetBackBuffer32() const { return m_BackBuffer32; }
+
+		/// <summary>
+		/// Gets the cache of rotated sprite frames shared by all MOSRotatings.
+		/// </summary>
+		/// <returns>A reference to the RotatedSpriteCache.</returns>
+		RotatedSpriteCache & GetRotatedSpriteCache() { return m_RotatedSpriteCache; }
 #pragma endregion
 
 #pragma region Resolution Handling
@@ -319,9 +326,22 @@ namespace RTE {
 
 #pragma region Drawing
 		/// <summary>
-		/// Flips the frame buffers, showing the backbuffer on the current display.
+		/// Flips the frame buffers, showing the backbuffer on the current display. Waits for any frame still being presented first.
+		/// </summary>
+		void FlipFrameBuffers();
+
+		/// <summary>
+		/// Shows the finished 32bpp backbuffer on the current display. With pipelined rendering the backbuffer is copied to the present buffer and handed to the present thread, so the flip (and any VSync wait in it) overlaps the next sim updates. Otherwise it's flipped right away.
 		/// </summary>
-		void FlipFrameBuffers() const;
+		void PresentFrame();
+
+		/// <summary>
+		/// Waits until the frame handed to the present thread by PresentFrame, if any, is on the screen.
+		/// Threading assumption: Allegro 4 doesn't support drawing to the screen from more than one thread, so the present thread is the only one touching the screen between PresentFrame handing it a frame and this returning.
+		/// Anything on the main thread that uses the screen or the graphics mode (flipping, screen dumps, resolution switches, exiting) must call this first. The present thread only reads the present buffer, never the backbuffers, so drawing the next frame doesn't need to wait.
+		/// This isn't a guarantee Allegro makes, which is why pipelined rendering is opt-in.
+		/// </summary>
+		void WaitForFramePresent();
 
 		/// <summary>
 		/// Clears the 8bpp backbuffer with black.
@@ -614,10 +634,13 @@ namespace RTE {
 
 		BITMAP *m_BackBuffer8; //!< Screen backbuffer, always 8bpp, gets copied to the 32bpp buffer for post-processing.
 		BITMAP *m_BackBuffer32; //!< 32bpp backbuffer, only used for post-processing.
+		BITMAP *m_PresentBuffer32; //!< Copy of the 32bpp backbuffer the present thread flips to the screen, so the backbuffer can be drawn to again while it does.
 		BITMAP *m_ScreenDumpBuffer; //!< Temporary buffer for making quick screencaps.
 		BITMAP *m_WorldDumpBuffer; //!< Temporary buffer for making whole scene screencaps.
 		BITMAP *m_ScenePreviewDumpGradient; //!< BITMAP for the scene preview sky gradient (easier to load from a pre-made file because it's dithered).
 
+		RotatedSpriteCache m_RotatedSpriteCache; //!< Rotated sprite frames shared by all MOSRotatings, so they don't get rotated again every frame.
+
 		BITMAP *m_NetworkBackBufferIntermediate8[2][c_MaxScreenCount]; //!< Per-player allocated frame buffer to draw upon during FrameMan draw.
 		BITMAP *m_NetworkBackBufferIntermediateGUI8[2][c_MaxScreenCount]; //!< Per-player allocated frame buffer to draw upon during FrameMan draw. Used to draw UI only.
 		BITMAP *m_NetworkBackBufferFinal8[2][c_MaxScreenCount]; //!< Per-player allocated frame buffer to copy Intermediate before sending.
@@ -652,6 +675,28 @@ namespace RTE {
 		BITMAP *m_TempNetworkBackBufferFinal8[2][c_MaxScreenCount];
 		BITMAP *m_TempNetworkBackBufferFinalGUI8[2][c_MaxScreenCount];
 
+		std::thread m_PresentThread; //!< The thread flipping the present buffer to the screen when pipelined rendering is enabled. Started with the first presented frame.
+		std::mutex m_PresentMutex; //!< Mutex guarding the present thread's state flags.
+		std::condition_variable m_PresentCondition; //!< Signaled when a frame is handed to the present thread, when it's done presenting it, and when it should stop.
+		bool m_FramePendingPresent; //!< Whether the present buffer holds a frame the present thread hasn't finished flipping to the screen yet.
+		bool m_StopPresentThread; //!< Whether the present thread should exit.
+
+		/// <summary>
+		/// Blits a 32bpp frame buffer to the screen, stretching it if the resolution multiplier is above 1.
+		/// </summary>
+		/// <param name="frameBuffer">The frame buffer to show.</param>
+		void BlitToScreen(BITMAP *frameBuffer) const;
+
+		/// <summary>
+		/// The present thread's loop. Waits for frames handed over by PresentFrame and flips them to the screen until told to stop.
+		/// </summary>
+		void PresentThreadFunction();
+
+		/// <summary>
+		/// Waits for any frame still being presented, then stops and joins the present thread if it's running.
+		/// </summary>
+		void StopPresentThread();
+
 		/// <summary>
 		/// Callback function for the Allegro set_display_switch_callback. It will be called when focus is switched away from the game window. 
 		/// It will temporarily disable positioning of the mouse so that when focus is switched back to the game window, the game window won't fly away because the user clicked the title bar of the window.
@@ -46,6 +46,9 @@
 #include "PrimitiveMan.h"
 #include "UInputMan.h"
 #include "SettingsMan.h"
+#include "TimerMan.h"
+#include "PerformanceMan.h"
+#include "ProfileScope.h"
 
 #include "lua.hpp"
 
@@ -419,6 +422,20 @@ void LuaMan::Clear()
     m_pTempEntity = 0;
     m_TempEntityVector.clear();
     m_TempEntityVector.shrink_to_fit();
+    m_ThreadSafeAIScripts.clear();
+    m_ParallelAIUpdate = 0;
+    m_ParallelAIWorkersFinished = 0;
+    m_StopParallelAIThreads = false;
+    m_GCCycleRunning = false;
+    m_GCHeapSizeAfterCycle = 0;
+    m_GCCycleCount = 0;
+    m_GCPauseTimes.clear();
+    m_ProfilingScripts = false;
+    m_ProfiledUpdateCount = 0;
+    m_ProfiledScriptStack.clear();
+    m_ProfiledScriptStackPrefix.clear();
+    m_ScriptProfile.clear();
+    m_ScriptProfileSamples.clear();
 
 	//Clear files list
 	for (int i = 0; i < MAX_OPEN_FILES; ++i)
@@ -431,42 +448,54 @@ int LuaMan::Create()
 {
     // Create the master state
     m_pMasterState = lua_open();
-    // Attach the master state to LuaBind
-    open(m_pMasterState);
-    // Open the lua libs for the master state
-    //luaL_openlibs(m_pMasterState);
+    InitializeState(m_pMasterState);
+
+	// Garbage collection is scheduled in Update, so only let the collector start cycles by itself as a safety net when scripts outpace the scheduler
+	lua_gc(m_pMasterState, LUA_GCSETPAUSE, c_GCAutomaticPause);
+
+    return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::InitializeState(lua_State *luaState)
+{
+    // Attach the state to LuaBind
+    open(luaState);
+    // Open the lua libs for the state
+    //luaL_openlibs(luaState);
 
 	// Load only libraries we need
-	lua_pushcfunction(m_pMasterState, luaopen_base);
-	lua_pushliteral(m_pMasterState, LUA_COLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_base);
+	lua_pushliteral(luaState, LUA_COLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_table);
-	lua_pushliteral(m_pMasterState, LUA_TABLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_table);
+	lua_pushliteral(luaState, LUA_TABLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_string);
-	lua_pushliteral(m_pMasterState, LUA_STRLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_string);
+	lua_pushliteral(luaState, LUA_STRLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_math);
-	lua_pushliteral(m_pMasterState, LUA_MATHLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_math);
+	lua_pushliteral(luaState, LUA_MATHLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_debug);
-	lua_pushliteral(m_pMasterState, LUA_DBLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_debug);
+	lua_pushliteral(luaState, LUA_DBLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_package);
-	lua_pushliteral(m_pMasterState, LUA_LOADLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_package);
+	lua_pushliteral(luaState, LUA_LOADLIBNAME);
+	lua_call(luaState, 1, 0);
 
-	lua_pushcfunction(m_pMasterState, luaopen_jit);
-	lua_pushliteral(m_pMasterState, LUA_LOADLIBNAME);
-	lua_call(m_pMasterState, 1, 0);
+	lua_pushcfunction(luaState, luaopen_jit);
+	lua_pushliteral(luaState, LUA_LOADLIBNAME);
+	lua_call(luaState, 1, 0);
 
 	// LuaJIT should start automatically after we load the library but we're making sure it did anyway.
-	if (!luaJIT_setmode(m_pMasterState, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON)) { RTEAbort("Failed to initialize LuaJIT!"); }
+	if (!luaJIT_setmode(luaState, 0, LUAJIT_MODE_ENGINE | LUAJIT_MODE_ON)) { RTEAbort("Failed to initialize LuaJIT!"); }
 
     // From LuaBind documentation:
     // As mentioned in the Lua documentation, it is possible to pass an error handler function to lua_pcall().
@@ -474,8 +503,8 @@ int LuaMan::Create()
     // It is possible to set the error handler function that Luabind will use globally:
     //set_pcall_callback(&AddFileAndLineToError); //NOTE: This seems to do nothing
 
-    // Declare all useful classes in the master state
-    module(m_pMasterState)
+    // Declare all useful classes in the state
+    module(luaState)
     [
         class_<Vector>("Vector")
             .def(luabind::constructor<>())
@@ -2110,7 +2139,17 @@ int LuaMan::Create()
             .def("FileClose", &LuaMan::FileClose)
             .def("FileReadLine", &LuaMan::FileReadLine)
             .def("FileWriteLine", &LuaMan::FileWriteLine)
-            .def("FileEOF", &LuaMan::FileEOF),
+            .def("FileEOF", &LuaMan::FileEOF)
+            .property("ProfilingScripts", &LuaMan::IsProfilingScripts)
+            .def("StartScriptProfiling", &LuaMan::StartScriptProfiling)
+            .def("StopScriptProfiling", &LuaMan::StopScriptProfiling)
+            .def("SaveScriptProfile", &LuaMan::SaveScriptProfile),
+
+        class_<PerformanceMan>("PerformanceManager")
+            .property("CapturingProfile", &PerformanceMan::IsCapturingProfile)
+            .def("StartProfileCapture", &PerformanceMan::StartProfileCapture)
+            .def("StopProfileCapture", &PerformanceMan::StopProfileCapture)
+            .def("SaveProfileTrace", &PerformanceMan::SaveProfileTrace),
 
         class_<SettingsMan>("SettingsManager")
             .property("PrintDebugInfo", &SettingsMan::PrintDebugInfo, &SettingsMan::SetPrintDebugInfo)
@@ -2203,23 +2242,24 @@ int LuaMan::Create()
 			]
     ];
 
-    // Assign the manager instances to globals in the lua master state
-    globals(m_pMasterState)["TimerMan"] = &g_TimerMan;
-    globals(m_pMasterState)["FrameMan"] = &g_FrameMan;
-	globals(m_pMasterState)["PostProcessMan"] = &g_PostProcessMan;
-	globals(m_pMasterState)["PrimitiveMan"] = &g_PrimitiveMan;
-    globals(m_pMasterState)["PresetMan"] = &g_PresetMan;
-    globals(m_pMasterState)["AudioMan"] = &g_AudioMan;
-    globals(m_pMasterState)["UInputMan"] = &g_UInputMan;
-    globals(m_pMasterState)["SceneMan"] = &g_SceneMan;
-    globals(m_pMasterState)["ActivityMan"] = &g_ActivityMan;
-    globals(m_pMasterState)["MetaMan"] = &g_MetaMan;
-    globals(m_pMasterState)["MovableMan"] = &g_MovableMan;
-    globals(m_pMasterState)["ConsoleMan"] = &g_ConsoleMan;
-    globals(m_pMasterState)["LuaMan"] = &g_LuaMan;
-    globals(m_pMasterState)["SettingsMan"] = &g_SettingsMan;
-
-    luaL_dostring(m_pMasterState,
+    // Assign the manager instances to globals in the lua state
+    globals(luaState)["TimerMan"] = &g_TimerMan;
+    globals(luaState)["FrameMan"] = &g_FrameMan;
+	globals(luaState)["PostProcessMan"] = &g_PostProcessMan;
+	globals(luaState)["PrimitiveMan"] = &g_PrimitiveMan;
+    globals(luaState)["PresetMan"] = &g_PresetMan;
+    globals(luaState)["AudioMan"] = &g_AudioMan;
+    globals(luaState)["UInputMan"] = &g_UInputMan;
+    globals(luaState)["SceneMan"] = &g_SceneMan;
+    globals(luaState)["ActivityMan"] = &g_ActivityMan;
+    globals(luaState)["MetaMan"] = &g_MetaMan;
+    globals(luaState)["MovableMan"] = &g_MovableMan;
+    globals(luaState)["ConsoleMan"] = &g_ConsoleMan;
+    globals(luaState)["LuaMan"] = &g_LuaMan;
+    globals(luaState)["PerformanceMan"] = &g_PerformanceMan;
+    globals(luaState)["SettingsMan"] = &g_SettingsMan;
+
+    luaL_dostring(luaState,
         // Override print() in the lua state to output to the console
         "print = function(toPrint) ConsoleMan:PrintString(\"PRINT: \" .. tostring(toPrint)); end;\n"
         // Add cls() as a shorcut to ConsoleMan:Clear()
@@ -2227,8 +2267,6 @@ int LuaMan::Create()
         // Add package path to the defaults
         "package.path = package.path .. \";Base.rte/?.lua\";\n"
     );
-
-    return 0;
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2242,6 +2280,11 @@ void LuaMan::ClearUserModuleCache()
 
 void LuaMan::Destroy()
 {
+    if (m_ProfilingScripts)
+        StopScriptProfiling();
+
+    DestroyParallelAIWorkers();
+
     lua_close(m_pMasterState);
 
 	//Close all opened files
@@ -2351,6 +2394,7 @@ bool LuaMan::ExpressionIsTrue(string expression, bool consoleErrors)
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int LuaMan::RunScriptedFunction(const std::string &functionName, const std::string &selfObjectName, std::vector<std::string> variablesToSafetyCheck, std::vector<Entity *> functionEntityArguments, std::vector<std::string> functionLiteralArguments) {
+    ProfileScope profileScope("LuaMan::RunScriptedFunction");
     std::string scriptString = "";
     if (!variablesToSafetyCheck.empty()) {
         scriptString += "if ";
@@ -2387,6 +2431,7 @@ int LuaMan::RunScriptedFunction(const std::string &functionName, const std::stri
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int LuaMan::RunScriptString(const std::string &scriptString, bool consoleErrors) {
+    ProfileScope profileScope("LuaMan::RunScriptString");
     if (scriptString.empty()) {
         return -1;
     }
@@ -2423,6 +2468,7 @@ int LuaMan::RunScriptString(const std::string &scriptString, bool consoleErrors)
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int LuaMan::RunScriptFile(const std::string &filePath, bool consoleErrors) {
+    ProfileScope profileScope("LuaMan::RunScriptFile");
     if (filePath.empty()) {
         m_LastError = "Can't run a script file with an empty filepath!";
         return -1;
@@ -2487,7 +2533,84 @@ string LuaMan::GetNewObjectID()
 
 void LuaMan::Update()
 {
-	lua_gc(m_pMasterState, LUA_GCSTEP, 1);
+	if (m_ProfilingScripts)
+		m_ProfiledUpdateCount++;
+
+	size_t heapSize = GetHeapSize();
+	if (!m_GCCycleRunning && heapSize > static_cast<size_t>(static_cast<float>(m_GCHeapSizeAfterCycle) * c_GCCycleStartGrowth))
+		m_GCCycleRunning = true;
+
+	unsigned int pauseTime = 0;
+	if (m_GCCycleRunning && g_TimerMan.IsDeterministic())
+	{
+		// Collection that depends on real time would collect at different points every run, so take a fixed number of steps every sim update instead
+		unsigned long long startTime = g_TimerMan.GetAbsoluteTime();
+		for (int step = 0; step < c_GCDeterministicStepCount; ++step)
+		{
+			if (lua_gc(m_pMasterState, LUA_GCSTEP, c_GCStepSizeKB))
+			{
+				m_GCCycleRunning = false;
+				m_GCHeapSizeAfterCycle = GetHeapSize();
+				m_GCCycleCount++;
+				break;
+			}
+		}
+		pauseTime = static_cast<unsigned int>(g_TimerMan.GetAbsoluteTime() - startTime);
+	}
+	// Only collect once per drawn frame, so frames catching up on several sim updates don't pay for it several times over when they're already slow
+	else if (m_GCCycleRunning && g_TimerMan.DrawnSimUpdate())
+	{
+		// Fit the collection into what's left of this sim update, unless the heap is growing faster than it's being collected
+		long long timeLeft = static_cast<long long>(g_TimerMan.GetDeltaTimeMS() * 1000.0F) - static_cast<long long>(g_PerformanceMan.GetElapsedMeasurementTime(PerformanceMan::PERF_SIM_TOTAL)) - c_GCFrameMarginUS;
+		unsigned int budget = std::clamp(timeLeft, static_cast<long long>(c_GCMinBudgetUS), static_cast<long long>(c_GCMaxBudgetUS));
+		if (heapSize > static_cast<size_t>(static_cast<float>(m_GCHeapSizeAfterCycle) * c_GCCatchUpGrowth))
+			budget = c_GCMaxBudgetUS;
+
+		unsigned long long startTime = g_TimerMan.GetAbsoluteTime();
+		while (g_TimerMan.GetAbsoluteTime() - startTime < budget)
+		{
+			// A step returns 1 when it finished a full cycle
+			if (lua_gc(m_pMasterState, LUA_GCSTEP, c_GCStepSizeKB))
+			{
+				m_GCCycleRunning = false;
+				m_GCHeapSizeAfterCycle = GetHeapSize();
+				m_GCCycleCount++;
+				break;
+			}
+		}
+		pauseTime = static_cast<unsigned int>(g_TimerMan.GetAbsoluteTime() - startTime);
+	}
+
+	m_GCPauseTimes.push_back(pauseTime);
+	while (m_GCPauseTimes.size() > c_GCPauseSampleSize)
+		m_GCPauseTimes.pop_front();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+size_t LuaMan::GetHeapSize() const
+{
+	return static_cast<size_t>(lua_gc(m_pMasterState, LUA_GCCOUNT, 0)) * 1024 + static_cast<size_t>(lua_gc(m_pMasterState, LUA_GCCOUNTB, 0));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+unsigned int LuaMan::GetAverageGCPauseTime() const
+{
+	if (m_GCPauseTimes.empty())
+		return 0;
+
+	unsigned long long totalPauseTime = 0;
+	for (const unsigned int &pauseTime : m_GCPauseTimes)
+		totalPauseTime += pauseTime;
+	return static_cast<unsigned int>(totalPauseTime / m_GCPauseTimes.size());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+unsigned int LuaMan::GetPeakGCPauseTime() const
+{
+	return m_GCPauseTimes.empty() ? 0 : *std::max_element(m_GCPauseTimes.begin(), m_GCPauseTimes.end());
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -2590,4 +2713,390 @@ bool LuaMan::FileEOF(int file)
 			return false;
 	return true;
 }
-}
\ No newline at end of file
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::StartScriptProfiling() {
+	if (m_ProfilingScripts) {
+		return;
+	}
+	m_ProfiledUpdateCount = 0;
+	m_ProfiledScriptStack.clear();
+	m_ProfiledScriptStackPrefix.clear();
+	m_ScriptProfile.clear();
+	m_ScriptProfileSamples.clear();
+	m_ProfilingScripts = true;
+
+	// Sample the function level call stack every millisecond, so each sample in the flamegraph is roughly a millisecond spent there
+	luaJIT_profile_start(m_pMasterState, "fi1", &ScriptProfilerSampleCallback, this);
+	g_ConsoleMan.PrintString("SYSTEM: Lua script profiling started.");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::StopScriptProfiling() {
+	if (!m_ProfilingScripts) {
+		return;
+	}
+	luaJIT_profile_stop(m_pMasterState);
+	m_ProfilingScripts = false;
+	m_ProfiledScriptStack.clear();
+	m_ProfiledScriptStackPrefix.clear();
+	g_ConsoleMan.PrintString("SYSTEM: Lua script profiling stopped after " + std::to_string(m_ProfiledUpdateCount) + " sim updates.");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::StartProfiledScript(const std::string &scopeName) {
+	if (!m_ProfilingScripts) {
+		return;
+	}
+	size_t memoryInUse = GetHeapSize();
+	m_ProfiledScriptStack.push_back({scopeName, g_TimerMan.GetAbsoluteTime(), 0, memoryInUse, 0});
+
+	if (!m_ProfiledScriptStackPrefix.empty()) { m_ProfiledScriptStackPrefix += ';'; }
+	m_ProfiledScriptStackPrefix += scopeName;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+LuaMan::ProfiledScriptScope::ProfiledScriptScope(const std::string &scriptPath, const std::string &functionName) : m_Profiling(g_LuaMan.IsProfilingScripts()) {
+	if (m_Profiling) { g_LuaMan.StartProfiledScript(scriptPath + ":" + functionName); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+LuaMan::ProfiledScriptScope::~ProfiledScriptScope() {
+	if (m_Profiling) { g_LuaMan.EndProfiledScript(); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::EndProfiledScript() {
+	if (m_ProfiledScriptStack.empty()) {
+		return;
+	}
+	const ProfiledScriptFrame &frame = m_ProfiledScriptStack.back();
+	unsigned long long elapsedTime = g_TimerMan.GetAbsoluteTime() - frame.StartTime;
+	size_t memoryInUse = GetHeapSize();
+	// Garbage collection steps during the function can shrink the state, so this is only a net figure and can't go below zero
+	long long allocated = static_cast<long long>(memoryInUse) - static_cast<long long>(frame.StartMemory);
+
+	ScriptProfileEntry &entry = m_ScriptProfile[frame.Name];
+	if (entry.Name.empty()) { entry.Name = frame.Name; }
+	entry.CallCount++;
+	entry.TotalTimeUS += elapsedTime;
+	entry.SelfTimeUS += elapsedTime > frame.NestedTime ? elapsedTime - frame.NestedTime : 0;
+	entry.AllocatedBytes += static_cast<unsigned long long>(std::max(allocated - frame.NestedAllocated, 0LL));
+
+	m_ProfiledScriptStack.pop_back();
+	if (!m_ProfiledScriptStack.empty()) {
+		m_ProfiledScriptStack.back().NestedTime += elapsedTime;
+		m_ProfiledScriptStack.back().NestedAllocated += allocated;
+	}
+	size_t lastSeparator = m_ProfiledScriptStackPrefix.find_last_of(';');
+	m_ProfiledScriptStackPrefix.erase(lastSeparator == std::string::npos ? 0 : lastSeparator);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::vector<LuaMan::ScriptProfileEntry> LuaMan::GetTopProfiledScripts(int count) const {
+	std::vector<ScriptProfileEntry> topEntries;
+	topEntries.reserve(m_ScriptProfile.size());
+	for (const std::pair<const std::string, ScriptProfileEntry> &profileEntry : m_ScriptProfile) {
+		topEntries.push_back(profileEntry.second);
+	}
+	count = std::min(count, static_cast<int>(topEntries.size()));
+	std::partial_sort(topEntries.begin(), topEntries.begin() + count, topEntries.end(), [](const ScriptProfileEntry &lhs, const ScriptProfileEntry &rhs) { return lhs.SelfTimeUS > rhs.SelfTimeUS; });
+	topEntries.resize(count);
+	return topEntries;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::SaveScriptProfile(const std::string &fileName) {
+	std::ofstream profileFile(fileName);
+	if (!profileFile.is_open()) {
+		g_ConsoleMan.PrintString("ERROR: Failed to open " + fileName + " to save the Lua script profile to!");
+		return -1;
+	}
+	for (const std::pair<const std::string, unsigned long> &stackSamples : m_ScriptProfileSamples) {
+		profileFile << stackSamples.first << " " << stackSamples.second << "\n";
+	}
+	profileFile.close();
+
+	unsigned long updateCount = std::max(m_ProfiledUpdateCount, 1UL);
+	char line[512];
+	g_ConsoleMan.PrintString("--- LUA SCRIPT PROFILE (per sim update, over " + std::to_string(m_ProfiledUpdateCount) + " updates) ---");
+	for (const ScriptProfileEntry &entry : GetTopProfiledScripts(c_ScriptProfileConsoleCount)) {
+		sprintf_s(line, sizeof(line), "%8.1f us self | %8.1f us total | %6.1f calls | %7.1f KB | %s", static_cast<float>(entry.SelfTimeUS) / updateCount, static_cast<float>(entry.TotalTimeUS) / updateCount, static_cast<float>(entry.CallCount) / updateCount, static_cast<float>(entry.AllocatedBytes) / 1024.0F / updateCount, entry.Name.c_str());
+		g_ConsoleMan.PrintString(line);
+	}
+	g_ConsoleMan.PrintString("SYSTEM: Lua script profile flamegraph stacks saved to " + fileName);
+	return 0;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::ScriptProfilerSampleCallback(void *luaMan, lua_State *luaState, int samples, int vmState) {
+	LuaMan *profilingLuaMan = static_cast<LuaMan *>(luaMan);
+
+	// Dump the stack outermost function first, separated by semicolons without a trailing one, which is the folded stack format flamegraph tools take
+	size_t stackLength = 0;
+	const char *stackDump = luaJIT_profile_dumpstack(luaState, "pFZ;", -c_ScriptProfileMaxStackDepth, &stackLength);
+
+	std::string foldedStack = profilingLuaMan->m_ProfiledScriptStackPrefix.empty() ? "(unprofiled)" : profilingLuaMan->m_ProfiledScriptStackPrefix;
+	if (stackLength > 0) { foldedStack.append(";").append(stackDump, stackLength); }
+	// Spaces separate the stack from the sample count in the folded format
+	std::replace(foldedStack.begin(), foldedStack.end(), ' ', '_');
+	profilingLuaMan->m_ScriptProfileSamples[foldedStack] += samples;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::UpdateParallelAI(const std::vector<Actor *> &actors) {
+	if (m_ParallelAIWorkers.empty()) { CreateParallelAIWorkers(); }
+
+	for (ParallelAIWorker &worker : m_ParallelAIWorkers) {
+		worker.Actors.clear();
+		worker.FailedActors.clear();
+		for (unsigned long releasedActor : worker.ReleasedActors) {
+			RunParallelAIScriptString(worker, "ParallelAIObjects[" + std::to_string(releasedActor) + "] = nil;");
+			worker.InitializedActors.erase(releasedActor);
+		}
+		worker.ReleasedActors.clear();
+	}
+	for (int actorIndex = 0; actorIndex < actors.size(); ++actorIndex) {
+		ParallelAIWorker &worker = m_ParallelAIWorkers[actors[actorIndex]->GetUniqueID() % m_ParallelAIWorkers.size()];
+		if (SetUpParallelAIActor(worker, actors[actorIndex])) {
+			worker.Actors.push_back({ actorIndex, actors[actorIndex] });
+		} else {
+			worker.FailedActors.push_back(actors[actorIndex]);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> parallelAILock(m_ParallelAIMutex);
+		m_ParallelAIWorkersFinished = 0;
+		m_ParallelAIUpdate++;
+	}
+	m_ParallelAIUpdateStarted.notify_all();
+	{
+		std::unique_lock<std::mutex> parallelAILock(m_ParallelAIMutex);
+		m_ParallelAIUpdateFinished.wait(parallelAILock, [this] { return m_ParallelAIWorkersFinished == m_ParallelAIWorkers.size(); });
+	}
+
+	for (ParallelAIWorker &worker : m_ParallelAIWorkers) {
+		for (const std::string &message : worker.Messages) {
+			g_ConsoleMan.PrintString(message);
+		}
+		worker.Messages.clear();
+
+		for (const std::pair<int, Actor *> &actorEntry : worker.Actors) {
+			actorEntry.second->SetAIUpdatedInParallel(true);
+		}
+		// Actors whose scripts failed fall back to running them on the master state from now on, which will report the errors in full if they keep happening
+		for (Actor *actor : worker.FailedActors) {
+			actor->SetAIUpdatedInParallel(false);
+			actor->DisableParallelAI();
+		}
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::ReleaseParallelAIActor(unsigned long uniqueID) {
+	if (m_ParallelAIWorkers.empty()) {
+		return;
+	}
+	ParallelAIWorker &worker = m_ParallelAIWorkers[uniqueID % m_ParallelAIWorkers.size()];
+	if (worker.InitializedActors.find(uniqueID) != worker.InitializedActors.end()) { worker.ReleasedActors.push_back(uniqueID); }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::CreateParallelAIWorkers() {
+	// The main thread waits for the workers to finish, so every core can get one
+	int workerCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, static_cast<int>(c_MaxParallelAIWorkers));
+	m_ParallelAIWorkers.resize(workerCount);
+
+	for (ParallelAIWorker &worker : m_ParallelAIWorkers) {
+		worker.State = lua_open();
+		InitializeState(worker.State);
+
+		// The console isn't thread-safe, so printed text is kept for the main thread to put in it
+		lua_pushlightuserdata(worker.State, &worker);
+		lua_pushcclosure(worker.State, &ParallelAIPrint, 1);
+		lua_setglobal(worker.State, "print");
+
+		luaL_dostring(worker.State, "ParallelAIScripts = {}; ParallelAIObjects = {};");
+	}
+
+	m_StopParallelAIThreads = false;
+	for (int workerIndex = 0; workerIndex < workerCount; ++workerIndex) {
+		m_ParallelAIThreads.emplace_back(&LuaMan::ParallelAIThreadFunction, this, workerIndex, m_ParallelAIUpdate);
+	}
+	g_ConsoleMan.PrintString("SYSTEM: Started " + std::to_string(workerCount) + " parallel AI worker threads.");
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::DestroyParallelAIWorkers() {
+	if (m_ParallelAIWorkers.empty()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> parallelAILock(m_ParallelAIMutex);
+		m_StopParallelAIThreads = true;
+	}
+	m_ParallelAIUpdateStarted.notify_all();
+	for (std::thread &parallelAIThread : m_ParallelAIThreads) {
+		parallelAIThread.join();
+	}
+	m_ParallelAIThreads.clear();
+
+	// The script objects only point to the Actors without owning them, so closing the states doesn't delete anything
+	for (ParallelAIWorker &worker : m_ParallelAIWorkers) {
+		lua_close(worker.State);
+	}
+	m_ParallelAIWorkers.clear();
+	m_StopParallelAIThreads = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void LuaMan::ParallelAIThreadFunction(int workerIndex, unsigned int startingUpdate) {
+	ParallelAIWorker &worker = m_ParallelAIWorkers[workerIndex];
+	unsigned int lastUpdate = startingUpdate;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> parallelAILock(m_ParallelAIMutex);
+			m_ParallelAIUpdateStarted.wait(parallelAILock, [this, lastUpdate] { return m_StopParallelAIThreads || m_ParallelAIUpdate != lastUpdate; });
+			if (m_StopParallelAIThreads) {
+				return;
+			}
+			lastUpdate = m_ParallelAIUpdate;
+		}
+
+		for (const std::pair<int, Actor *> &actorEntry : worker.Actors) {
+			// Each Actor only ever draws random numbers from its own stream and has what its scripts create and add put aside for it, so nothing depends on which worker gets where first
+			g_MovableMan.SetParallelAIActorIndex(actorEntry.first);
+			g_ThreadRNG = &actorEntry.second->GetRandomStream();
+			if (!UpdateParallelAIActor(worker, actorEntry.second)) {
+				worker.FailedActors.push_back(actorEntry.second);
+			} else if (const char *refusedCall = g_MovableMan.GetParallelAIRefusedCall(actorEntry.first)) {
+				// Calls that change things shared between Actors can't run on the workers, so the Actor's AI goes back to the main thread where they work
+				worker.Messages.push_back("ERROR: " + actorEntry.second->GetPresetName() + "'s AI scripts called " + refusedCall + ", which isn't thread-safe. Running them on the main thread from now on.");
+				worker.FailedActors.push_back(actorEntry.second);
+			}
+		}
+		g_ThreadRNG = nullptr;
+		g_MovableMan.SetParallelAIActorIndex(-1);
+
+		{
+			std::lock_guard<std::mutex> parallelAILock(m_ParallelAIMutex);
+			m_ParallelAIWorkersFinished++;
+		}
+		m_ParallelAIUpdateFinished.notify_one();
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::SetUpParallelAIActor(ParallelAIWorker &worker, Actor *actor) {
+	for (const std::pair<std::string, bool> *scriptEntry : actor->GetUpdateAIScripts()) {
+		if (scriptEntry->second && worker.LoadedScripts.find(scriptEntry->first) == worker.LoadedScripts.end()) {
+			if (RunParallelAIScriptString(worker, "UpdateAI = nil;") < 0 || RunParallelAIScriptFile(worker, scriptEntry->first) < 0 || RunParallelAIScriptString(worker, "ParallelAIScripts[\"" + scriptEntry->first + "\"] = {UpdateAI = UpdateAI};") < 0) {
+				return false;
+			}
+			worker.LoadedScripts.insert(scriptEntry->first);
+		}
+	}
+	// The Actor's script object lives on in this worker's state, so anything its scripts store in it carries over to the next update.
+	// Create already ran on the master state's script object, and running it again here would repeat whatever it did, so UpdateAI sets up its own fields
+	if (worker.InitializedActors.find(actor->GetUniqueID()) == worker.InitializedActors.end()) {
+		globals(worker.State)["ParallelAITempEntity"] = static_cast<Entity *>(actor);
+		if (RunParallelAIScriptString(worker, "ParallelAIObjects[" + std::to_string(actor->GetUniqueID()) + "] = To" + actor->GetClassName() + "(ParallelAITempEntity); ParallelAITempEntity = nil;") < 0) {
+			return false;
+		}
+		worker.InitializedActors.insert(actor->GetUniqueID());
+	}
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool LuaMan::UpdateParallelAIActor(ParallelAIWorker &worker, Actor *actor) {
+	std::string objectName = "ParallelAIObjects[" + std::to_string(actor->GetUniqueID()) + "]";
+
+	// Same as Controller::Update does before running AI on the main thread, which will then leave these states alone
+	actor->GetController()->ResetCommandState();
+
+	for (const std::pair<std::string, bool> *scriptEntry : actor->GetUpdateAIScripts()) {
+		if (scriptEntry->second && RunParallelAIScriptString(worker, "ParallelAIScripts[\"" + scriptEntry->first + "\"].UpdateAI(" + objectName + ");") < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::RunParallelAIScriptString(ParallelAIWorker &worker, const std::string &scriptString) {
+	ProfileScope profileScope("LuaMan::RunParallelAIScriptString");
+	int error = 0;
+
+	lua_pushcfunction(worker.State, &AddFileAndLineToError);
+	try {
+		if (luaL_loadstring(worker.State, scriptString.c_str()) || lua_pcall(worker.State, 0, LUA_MULTRET, -2)) {
+			worker.Messages.push_back(std::string("ERROR: In parallel AI: ") + lua_tostring(worker.State, -1));
+			lua_pop(worker.State, 1);
+			error = -1;
+		}
+	} catch (const std::exception &e) {
+		worker.Messages.push_back(std::string("ERROR: In parallel AI: ") + e.what());
+		error = -1;
+	}
+	lua_pop(worker.State, 1);
+
+	return error;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::RunParallelAIScriptFile(ParallelAIWorker &worker, const std::string &filePath) {
+	int error = 0;
+
+	lua_pushcfunction(worker.State, &AddFileAndLineToError);
+	try {
+		if (luaL_loadfile(worker.State, filePath.c_str()) || lua_pcall(worker.State, 0, LUA_MULTRET, -2)) {
+			worker.Messages.push_back(std::string("ERROR: In parallel AI: ") + lua_tostring(worker.State, -1));
+			lua_pop(worker.State, 1);
+			error = -1;
+		}
+	} catch (const std::exception &e) {
+		worker.Messages.push_back(std::string("ERROR: In parallel AI: ") + e.what());
+		error = -1;
+	}
+	lua_pop(worker.State, 1);
+
+	return error;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int LuaMan::ParallelAIPrint(lua_State *luaState) {
+	ParallelAIWorker *worker = static_cast<ParallelAIWorker *>(lua_touserdata(luaState, lua_upvalueindex(1)));
+
+	// Go through Lua's own tostring so the text is the same as the master state's print would give
+	lua_getglobal(luaState, "tostring");
+	lua_pushvalue(luaState, 1);
+	lua_call(luaState, 1, 1);
+	const char *printedText = lua_tostring(luaState, -1);
+	worker->Messages.push_back(std::string("PRINT: ") + (printedText ? printedText : "nil"));
+	lua_pop(luaState, 1);
+
+	return 0;
+}
+}
@@ -19,6 +19,8 @@ struct lua_State;
 namespace RTE
 {
 
+class Actor;
+
 #define MAX_OPEN_FILES 10
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +41,17 @@ class LuaMan:
 
 public:
 
+    /// <summary>
+    /// Accumulated cost of one profiled script function while the script profiler is running.
+    /// </summary>
+    struct ScriptProfileEntry {
+        std::string Name; //!< The script path and function name this entry is for.
+        unsigned long CallCount = 0; //!< How many times the function was called.
+        unsigned long long TotalTimeUS = 0; //!< Real time in microseconds spent in the function, including the profiled functions it triggered.
+        unsigned long long SelfTimeUS = 0; //!< Real time in microseconds spent in the function itself, excluding the profiled functions it triggered.
+        unsigned long long AllocatedBytes = 0; //!< Net bytes the Lua state grew by while running the function itself.
+    };
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Constructor:     LuaMan
@@ -257,8 +270,11 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          Update
 //////////////////////////////////////////////////////////////////////////////////////////
-// Description:     Updates the state of this LuaMan. Supposed to be done every frame
-//                  before drawing.
+// Description:     Updates the state of this LuaMan and, on the last sim update before a
+//                  frame is drawn, runs as much garbage collection as fits in what's left
+//                  of it. When the sim has to be deterministic, a fixed number of steps
+//                  is taken every sim update instead. Supposed to be done at the end of
+//                  every sim update, after all scripts have run.
 // Arguments:       None.
 // Return value:    None.
  
@@ -335,6 +351,152 @@ public:
 
 	void ClearUserModuleCache();
 
+#pragma region Garbage Collection
+    /// <summary>
+    /// Gets how much memory the master Lua state is using.
+    /// </summary>
+    /// <returns>The size of the Lua heap in bytes.</returns>
+    size_t GetHeapSize() const;
+
+    /// <summary>
+    /// Gets how long the garbage collection steps run by the last Update took.
+    /// </summary>
+    /// <returns>The last garbage collection pause in microseconds.</returns>
+    unsigned int GetLastGCPauseTime() const { return m_GCPauseTimes.empty() ? 0 : m_GCPauseTimes.back(); }
+
+    /// <summary>
+    /// Gets the average time the scheduled garbage collection steps took per sim update, over the last c_GCPauseSampleSize updates.
+    /// </summary>
+    /// <returns>The average garbage collection pause in microseconds.</returns>
+    unsigned int GetAverageGCPauseTime() const;
+
+    /// <summary>
+    /// Gets the longest time the scheduled garbage collection steps took in a single sim update, over the last c_GCPauseSampleSize updates.
+    /// </summary>
+    /// <returns>The peak garbage collection pause in microseconds.</returns>
+    unsigned int GetPeakGCPauseTime() const;
+
+    /// <summary>
+    /// Gets how many full garbage collection cycles the scheduler has completed since the master state was created.
+    /// </summary>
+    /// <returns>The number of completed garbage collection cycles.</returns>
+    unsigned long GetGCCycleCount() const { return m_GCCycleCount; }
+#pragma endregion
+
+#pragma region Parallel Scripted AI
+    /// <summary>
+    /// Marks a script file as having an UpdateAI function that is safe to run on a worker thread, which scripts do by defining ThreadSafeAI = true.
+    /// Such UpdateAI functions may only read the game state, set their own Actor's controller states and add new MOs to MovableMan. Their Create functions only run on the master state, so UpdateAI has to set up any fields it keeps on its Actor itself.
+    /// </summary>
+    /// <param name="scriptPath">The path of the script file.</param>
+    void AddThreadSafeAIScript(const std::string &scriptPath) { m_ThreadSafeAIScripts.insert(scriptPath); }
+
+    /// <summary>
+    /// Tells whether a script file was marked as having a thread-safe UpdateAI function.
+    /// </summary>
+    /// <param name="scriptPath">The path of the script file.</param>
+    /// <returns>Whether the script's UpdateAI can run on a worker thread.</returns>
+    bool IsThreadSafeAIScript(const std::string &scriptPath) const { return m_ThreadSafeAIScripts.find(scriptPath) != m_ThreadSafeAIScripts.end(); }
+
+    /// <summary>
+    /// Runs the thread-safe UpdateAI scripts of a number of Actors spread over the parallel AI worker threads, each with its own Lua state, and waits for all of them to finish.
+    /// Each Actor always goes to the same worker so its script object and the fields its scripts set on it persist between updates. The workers are started the first time this is called.
+    /// The scripts are loaded into the workers' states and the Actors' script objects set up there by the calling thread beforehand, so only UpdateAI runs on the workers. There, random numbers come from each Actor's own RandomStream, and MovableMan puts aside the MOs the scripts create and add for each Actor.
+    /// Actors whose scripts ran successfully are flagged to have had their AI updated, the rest are flagged to not be updated in parallel anymore.
+    /// </summary>
+    /// <param name="actors">The Actors to update the AI of. Their UpdateAI scripts must all be thread-safe.</param>
+    void UpdateParallelAI(const std::vector<Actor *> &actors);
+
+    /// <summary>
+    /// Removes the script object of an Actor that is being deleted from the parallel AI worker it was assigned to. The worker does so before its next update.
+    /// </summary>
+    /// <param name="uniqueID">The unique ID of the Actor being deleted.</param>
+    void ReleaseParallelAIActor(unsigned long uniqueID);
+
+    /// <summary>
+    /// Stops the parallel AI worker threads and closes their Lua states, so they start over with freshly loaded scripts the next time they're needed.
+    /// </summary>
+    void DestroyParallelAIWorkers();
+#pragma endregion
+
+#pragma region Script Profiling
+    /// <summary>
+    /// Tells whether the script profiler is currently running.
+    /// </summary>
+    /// <returns>Whether scripts are being profiled.</returns>
+    bool IsProfilingScripts() const { return m_ProfilingScripts; }
+
+    /// <summary>
+    /// Clears any previously gathered profile and starts timing every profiled script function, as well as sampling the Lua call stacks for a flamegraph.
+    /// </summary>
+    void StartScriptProfiling();
+
+    /// <summary>
+    /// Stops the script profiler. The gathered profile is kept until the profiler is started again, so it can still be drawn and saved.
+    /// </summary>
+    void StopScriptProfiling();
+
+    /// <summary>
+    /// Marks the start of a profiled script function. Calls can be nested, the time and allocations of nested functions are excluded from the self cost of the function that triggered them.
+    /// Should only be called while IsProfilingScripts is true, so the name doesn't need to be built otherwise.
+    /// </summary>
+    /// <param name="scopeName">The script path and function name to attribute the cost to.</param>
+    void StartProfiledScript(const std::string &scopeName);
+
+    /// <summary>
+    /// Marks the end of the last started profiled script function and adds its cost to the profile. Does nothing if there is no started function, i.e. the profiler was started or stopped inside one.
+    /// </summary>
+    void EndProfiledScript();
+
+    /// <summary>
+    /// Profiles the script function run in the block it's declared in, if the script profiler is running when it's declared. Ends the profiled function whichever way the block is left.
+    /// </summary>
+    class ProfiledScriptScope {
+
+    public:
+
+        /// <summary>
+        /// Constructor method used to instantiate a ProfiledScriptScope object in system memory, starting a profiled script function if the script profiler is running.
+        /// </summary>
+        /// <param name="scriptPath">The path of the script the function is in.</param>
+        /// <param name="functionName">The name of the function. Only joined with the path if the script profiler is running.</param>
+        ProfiledScriptScope(const std::string &scriptPath, const std::string &functionName);
+
+        /// <summary>
+        /// Destructor method used to end the profiled script function, if one was started.
+        /// </summary>
+        ~ProfiledScriptScope();
+
+    private:
+
+        bool m_Profiling; //!< Whether a profiled script function was started.
+
+        // Disallow the use of some implicit methods.
+        ProfiledScriptScope(const ProfiledScriptScope &reference) {}
+        ProfiledScriptScope & operator=(const ProfiledScriptScope &rhs) {}
+    };
+
+    /// <summary>
+    /// Gets the profiled script functions with the highest self time.
+    /// </summary>
+    /// <param name="count">The maximum number of entries to get.</param>
+    /// <returns>The most expensive entries, sorted from highest self time down.</returns>
+    std::vector<ScriptProfileEntry> GetTopProfiledScripts(int count) const;
+
+    /// <summary>
+    /// Gets how many sim updates have passed since the script profiler was started.
+    /// </summary>
+    /// <returns>The number of profiled updates.</returns>
+    unsigned long GetProfiledUpdateCount() const { return m_ProfiledUpdateCount; }
+
+    /// <summary>
+    /// Saves the sampled Lua call stacks to a file in the folded format used by flamegraph tools, with each stack prefixed by the profiled script functions it ran under, and prints the most expensive script functions to the console.
+    /// </summary>
+    /// <param name="fileName">The path of the file to save to.</param>
+    /// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+    int SaveScriptProfile(const std::string &fileName);
+#pragma endregion
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Protected member variable and method declarations
@@ -359,6 +521,67 @@ protected:
     // Temporary holder for a vector of Entities that we want to pass into the Lua state without a fuss. Usually used to pass arguments to special Lua functions.
     std::vector<Entity *> m_TempEntityVector;
 
+    /// <summary>
+    /// A profiled script function that is currently running.
+    /// </summary>
+    struct ProfiledScriptFrame {
+        std::string Name; //!< The script path and function name of this frame.
+        unsigned long long StartTime; //!< Absolute time in microseconds when the function started.
+        unsigned long long NestedTime; //!< Time in microseconds spent in profiled functions this one triggered.
+        size_t StartMemory; //!< Bytes in use by the Lua state when the function started.
+        long long NestedAllocated; //!< Bytes the Lua state grew by in profiled functions this one triggered.
+    };
+
+    /// <summary>
+    /// A worker with its own Lua state that runs thread-safe scripted AI updates on its own thread.
+    /// </summary>
+    struct ParallelAIWorker {
+        lua_State *State = nullptr; //!< This worker's Lua state, which has the same bindings as the master state.
+        std::unordered_set<std::string> LoadedScripts; //!< The paths of the thread-safe AI scripts already loaded into this worker's state.
+        std::unordered_set<unsigned long> InitializedActors; //!< The unique IDs of the Actors whose script objects are set up in this worker's state.
+        std::vector<unsigned long> ReleasedActors; //!< The unique IDs of deleted Actors whose script objects should be removed from this worker's state before its next update.
+        std::vector<std::pair<int, Actor *>> Actors; //!< The Actors this worker updates the AI of in the current update, along with their index in the ones passed to UpdateParallelAI.
+        std::vector<Actor *> FailedActors; //!< The Actors whose AI scripts failed to run in the current update.
+        std::vector<std::string> Messages; //!< Errors and printed text from the current update, printed to the console by the main thread afterwards since the console isn't thread-safe.
+    };
+
+    static constexpr unsigned short c_MaxParallelAIWorkers = 8; //!< The maximum number of parallel AI worker threads.
+
+    std::unordered_set<std::string> m_ThreadSafeAIScripts; //!< The paths of the script files whose UpdateAI functions are marked as thread-safe.
+    std::vector<ParallelAIWorker> m_ParallelAIWorkers; //!< The parallel AI workers. Empty until the first parallel AI update.
+    std::vector<std::thread> m_ParallelAIThreads; //!< The threads running the parallel AI workers, one for each.
+    std::mutex m_ParallelAIMutex; //!< Mutex guarding the parallel AI update counters below.
+    std::condition_variable m_ParallelAIUpdateStarted; //!< Notified when there's a new parallel AI update for the workers to run, or when they should stop.
+    std::condition_variable m_ParallelAIUpdateFinished; //!< Notified by each worker when it's done with the current parallel AI update.
+    unsigned int m_ParallelAIUpdate; //!< Number of the current parallel AI update, so workers can tell when a new one starts.
+    unsigned int m_ParallelAIWorkersFinished; //!< How many workers are done with the current parallel AI update.
+    bool m_StopParallelAIThreads; //!< Whether the parallel AI worker threads should exit.
+
+    static constexpr unsigned short c_GCStepSizeKB = 16; //!< Size of each incremental garbage collection step, small enough that a single step barely registers.
+    static constexpr int c_GCDeterministicStepCount = 8; //!< How many incremental garbage collection steps are taken each sim update while a cycle is running, when the sim has to be deterministic.
+    static constexpr unsigned int c_GCMinBudgetUS = 250; //!< Time in microseconds the garbage collector always gets per drawn frame while a cycle is running, even when the sim update is already over time, so collection keeps up with allocation.
+    static constexpr unsigned int c_GCMaxBudgetUS = 4000; //!< Time in microseconds the garbage collector is allowed at most per drawn frame.
+    static constexpr unsigned int c_GCFrameMarginUS = 1000; //!< Time in microseconds left untouched at the end of each sim update when working out the garbage collection budget, for drawing and everything after the sim.
+    static constexpr float c_GCCycleStartGrowth = 1.5F; //!< How many times larger the heap has to get than it was after the last cycle before a new one is started.
+    static constexpr float c_GCCatchUpGrowth = 2.5F; //!< How many times larger the heap can get than it was after the last cycle before collection gets the maximum budget regardless of time left.
+    static constexpr int c_GCAutomaticPause = 400; //!< The Lua garbage collector's own pause, in percent. Set well above the scheduler's so it only starts cycles by itself when scripts allocate too fast for the scheduler to keep up.
+    static constexpr unsigned short c_GCPauseSampleSize = 120; //!< How many sim updates of garbage collection pause times are kept for the statistics.
+
+    bool m_GCCycleRunning; //!< Whether the scheduler started a garbage collection cycle that hasn't finished yet.
+    size_t m_GCHeapSizeAfterCycle; //!< Heap size in bytes right after the last completed garbage collection cycle.
+    unsigned long m_GCCycleCount; //!< How many garbage collection cycles the scheduler completed.
+    std::deque<unsigned int> m_GCPauseTimes; //!< Time in microseconds spent in scheduled garbage collection in each of the last sim updates.
+
+    static constexpr int c_ScriptProfileConsoleCount = 20; //!< How many of the most expensive script functions to print to the console when saving a profile.
+    static constexpr int c_ScriptProfileMaxStackDepth = 64; //!< How many Lua call stack levels to record in each profile sample.
+
+    bool m_ProfilingScripts; //!< Whether the script profiler is running.
+    unsigned long m_ProfiledUpdateCount; //!< How many sim updates passed since the profiler was started.
+    std::vector<ProfiledScriptFrame> m_ProfiledScriptStack; //!< The profiled script functions that are currently running, outermost first.
+    std::string m_ProfiledScriptStackPrefix; //!< The names in m_ProfiledScriptStack joined in folded stack format, kept up to date so samples don't need to rebuild it.
+    std::unordered_map<std::string, ScriptProfileEntry> m_ScriptProfile; //!< The accumulated cost of each profiled script function, by name.
+    std::unordered_map<std::string, unsigned long> m_ScriptProfileSamples; //!< Number of samples taken in each folded Lua call stack, prefixed by the profiled script functions it ran under.
+
 
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
@@ -375,6 +598,74 @@ private:
 
     void Clear();
 
+    /// <summary>
+    /// Opens the needed libraries in a newly created Lua state and registers all the engine bindings and manager globals in it.
+    /// </summary>
+    /// <param name="luaState">The Lua state to initialize.</param>
+    void InitializeState(lua_State *luaState);
+
+    /// <summary>
+    /// Creates the parallel AI workers and their Lua states, and starts their threads.
+    /// </summary>
+    void CreateParallelAIWorkers();
+
+    /// <summary>
+    /// The function each parallel AI worker thread runs, which waits for parallel AI updates and runs its share of them until told to stop.
+    /// </summary>
+    /// <param name="workerIndex">The index of the worker in m_ParallelAIWorkers this thread runs.</param>
+    /// <param name="startingUpdate">The parallel AI update number when the thread was started, so it doesn't run that update.</param>
+    void ParallelAIThreadFunction(int workerIndex, unsigned int startingUpdate);
+
+    /// <summary>
+    /// Loads the UpdateAI scripts of an Actor into a parallel AI worker's state and sets up the Actor's script object there, if not done already. Must be called while the workers are idle.
+    /// Script files can run any code when loaded, so this is done by the main thread instead of the worker.
+    /// </summary>
+    /// <param name="worker">The worker the Actor is assigned to.</param>
+    /// <param name="actor">The Actor to set up.</param>
+    /// <returns>Whether all the scripts loaded and the script object was set up successfully.</returns>
+    bool SetUpParallelAIActor(ParallelAIWorker &worker, Actor *actor);
+
+    /// <summary>
+    /// Runs the UpdateAI scripts of an Actor on a parallel AI worker's state. The Actor must have been set up with SetUpParallelAIActor.
+    /// </summary>
+    /// <param name="worker">The worker to run the scripts on.</param>
+    /// <param name="actor">The Actor to update the AI of.</param>
+    /// <returns>Whether all the scripts ran successfully.</returns>
+    bool UpdateParallelAIActor(ParallelAIWorker &worker, Actor *actor);
+
+    /// <summary>
+    /// Runs a script snippet on a parallel AI worker's state, keeping any error to be printed by the main thread.
+    /// </summary>
+    /// <param name="worker">The worker to run the snippet on.</param>
+    /// <param name="scriptString">The string with the script snippet.</param>
+    /// <returns>Returns less than zero if any errors were encountered when running the snippet.</returns>
+    int RunParallelAIScriptString(ParallelAIWorker &worker, const std::string &scriptString);
+
+    /// <summary>
+    /// Loads and runs a script file on a parallel AI worker's state, keeping any error to be printed by the main thread.
+    /// </summary>
+    /// <param name="worker">The worker to run the file on.</param>
+    /// <param name="filePath">The path to the file to load and run.</param>
+    /// <returns>Returns less than zero if any errors were encountered when running the file.</returns>
+    int RunParallelAIScriptFile(ParallelAIWorker &worker, const std::string &filePath);
+
+    /// <summary>
+    /// Replacement for print() in the parallel AI worker states, which keeps the printed text to be put in the console by the main thread.
+    /// The worker is passed in as the function's upvalue.
+    /// </summary>
+    /// <param name="luaState">The worker's Lua state.</param>
+    /// <returns>The number of values returned to Lua, which is none.</returns>
+    static int ParallelAIPrint(lua_State *luaState);
+
+    /// <summary>
+    /// Callback for the LuaJIT sampling profiler, which adds the current Lua call stack to the profile samples.
+    /// </summary>
+    /// <param name="luaMan">The LuaMan that started the profiler.</param>
+    /// <param name="luaState">The Lua state being sampled.</param>
+    /// <param name="samples">Number of samples taken since the last callback.</param>
+    /// <param name="vmState">The state of the Lua VM when the sample was taken.</param>
+    static void ScriptProfilerSampleCallback(void *luaMan, lua_State *luaState, int samples, int vmState);
+
 
     // Disallow the use of some implicit methods.
 	LuaMan(const LuaMan &reference) {}
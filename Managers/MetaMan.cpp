@@ -17,6 +17,7 @@
 #include "UInputMan.h"
 #include "ConsoleMan.h"
 #include "ActivityMan.h"
+#include "SceneMan.h"
 
 #include "GUI/GUI.h"
 #include "GUI/GUIFont.h"
@@ -96,7 +97,8 @@ int MetaMan::NewGame(float gameSize)
     list<Scene *> scenePresets;
     SelectScenePresets(gameSize, m_Players.size(), &scenePresets);
 
-    // Destroy and clear any pre-existing scenes from previous games
+    // Destroy and clear any pre-existing scenes from previous games, and any preloaded clone of one of them
+    g_SceneMan.DiscardPreloadedScene();
     for (vector<Scene *>::iterator sItr = m_Scenes.begin(); sItr != m_Scenes.end(); ++sItr)
     {
         delete *sItr;
@@ -194,7 +196,8 @@ int MetaMan::EndGame()
 	//Reset metagame UI
 	m_pMetaGUI->SetToStartNewGame();
 
-    // Destroy and clear any pre-existing scenes from previous games
+    // Destroy and clear any pre-existing scenes from previous games, and any preloaded clone of one of them
+    g_SceneMan.DiscardPreloadedScene();
     for (vector<Scene *>::iterator sItr = m_Scenes.begin(); sItr != m_Scenes.end(); ++sItr)
     {
         delete *sItr;
@@ -239,6 +242,7 @@ int MetaMan::Load(const MetaSave *pSave)
         return -1;
 
     // Clear off players, scenes, and offensive activiies before filling up on new ones read from disk
+    g_SceneMan.DiscardPreloadedScene();
     m_Players.clear();
     for (vector<Scene *>::iterator sItr = m_Scenes.begin(); sItr != m_Scenes.end(); ++sItr)
         delete (*sItr);
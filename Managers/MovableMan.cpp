@@ -14,6 +14,8 @@
 #include "MovableMan.h"
 #include "PostProcessMan.h"
 #include "PerformanceMan.h"
+#include "FrameMan.h"
+#include "SettingsMan.h"
 #include "PresetMan.h"
 #include "AHuman.h"
 #include "MOPixel.h"
@@ -28,6 +30,7 @@
 namespace RTE {
 
 const string MovableMan::m_ClassName = "MovableMan";
+thread_local int MovableMan::s_ParallelAIActorIndex = -1;
 
 
 // Comparison functor for sorting movable objects by their X position using STL's sort
@@ -70,6 +73,20 @@ void MovableMan::Clear()
     m_SloMoDuration = 1000;
     m_SettlingEnabled = true;
     m_MOSubtractionEnabled = true;
+    m_DrawList.clear();
+    m_DrawListItemsStart = 0;
+    m_DrawListActorsStart = 0;
+    m_DrawGrid.clear();
+    m_DrawGridCellsX = 0;
+    m_DrawGridCellsY = 0;
+    m_DrawGridValid = false;
+    m_DrawListVisibleStamps.clear();
+    m_DrawVisibleStamp = 0;
+    m_VisibleDrawIndices.clear();
+    m_ParallelAIActors.clear();
+    m_ParallelAIEffects.clear();
+    m_TemporaryUniqueIDStart = -1;
+    m_UpdateLODTierCounts.assign(MovableObject::LOD_TIERCOUNT, 0);
 }
 
 
@@ -193,7 +210,10 @@ MovableObject * MovableMan::GetMOFromID(MOID whichID) {
 void MovableMan::RegisterObject(MovableObject * mo) 
 { 
 	if (mo) 
+	{
+		std::lock_guard<std::mutex> knownObjectsLock(m_KnownObjectsMutex);
 		m_KnownObjects[mo->GetUniqueID()] = mo; 
+	}
 }
 
 
@@ -206,13 +226,77 @@ void MovableMan::RegisterObject(MovableObject * mo)
 
 void MovableMan::UnregisterObject(MovableObject * mo) 
 { 
+	if (mo && s_ParallelAIActorIndex >= 0)
+	{
+		// An MO created and destroyed again by the same AI script never got its unique ID
+		std::vector<MovableObject *> &createdMOs = m_ParallelAIEffects[s_ParallelAIActorIndex].CreatedMOs;
+		std::vector<MovableObject *>::iterator createdMOItr = std::find(createdMOs.begin(), createdMOs.end(), mo);
+		if (createdMOItr != createdMOs.end())
+		{
+			createdMOs.erase(createdMOItr);
+			return;
+		}
+	}
 	if (mo)
 	{
+		std::lock_guard<std::mutex> knownObjectsLock(m_KnownObjectsMutex);
 		m_KnownObjects.erase(mo->GetUniqueID());
 		//g_ConsoleMan.PrintString(std::to_string(mo->GetUniqueID()));
 	}
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferParallelAIUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds off giving an MO created by the AI scripts of an Actor on a
+//                  parallel AI worker its unique ID until the workers are all done.
+
+long int MovableMan::DeferParallelAIUniqueID(MovableObject *mo)
+{
+    if (s_ParallelAIActorIndex < 0)
+        return 0;
+
+    // Interleave the Actors' temporary IDs, so they're unique without the workers having to agree on anything
+    ParallelAIEffects &effects = m_ParallelAIEffects[s_ParallelAIActorIndex];
+    long int temporaryID = m_TemporaryUniqueIDStart - static_cast<long int>(effects.CreatedMOCount * m_ParallelAIEffects.size() + s_ParallelAIActorIndex);
+    effects.CreatedMOCount++;
+    effects.CreatedMOs.push_back(mo);
+    return temporaryID;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferParallelAIMovePathUpdate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds off updating an Actor's move path asked for by the AI scripts of
+//                  an Actor on a parallel AI worker until the workers are all done.
+
+bool MovableMan::DeferParallelAIMovePathUpdate(Actor *actor)
+{
+    if (s_ParallelAIActorIndex < 0)
+        return false;
+
+    m_ParallelAIEffects[s_ParallelAIActorIndex].MovePathUpdates.push_back(actor);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RefuseInParallelAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Refuses a call that changes things shared between Actors in ways that
+//                  can't be put aside for later, if made by the AI scripts of an Actor on a
+//                  parallel AI worker.
+
+bool MovableMan::RefuseInParallelAI(const char *callName)
+{
+    if (s_ParallelAIActorIndex < 0)
+        return false;
+
+    ParallelAIEffects &effects = m_ParallelAIEffects[s_ParallelAIActorIndex];
+    if (!effects.RefusedCall)
+        effects.RefusedCall = callName;
+    return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          PurgeAllMOs
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -221,6 +305,9 @@ void MovableMan::UnregisterObject(MovableObject * mo)
 
 void MovableMan::PurgeAllMOs()
 {
+    if (RefuseInParallelAI("MovableMan::PurgeAllMOs"))
+        return;
+
     for (deque<Actor *>::iterator it1 = m_Actors.begin(); it1 != m_Actors.end(); ++it1)
         delete (*it1);
     for (deque<MovableObject *>::iterator it2 = m_Items.begin(); it2 != m_Items.end(); ++it2)
@@ -231,6 +318,7 @@ void MovableMan::PurgeAllMOs()
     m_Actors.clear();
     m_Items.clear();
     m_Particles.clear();
+    m_DrawGridValid = false;
     m_AddedActors.clear();
     m_AddedItems.clear();
     m_AddedParticles.clear();
@@ -246,6 +334,7 @@ void MovableMan::PurgeAllMOs()
     m_AddedAlarmEvents.clear();
     m_AlarmEvents.clear();
     m_MOIDIndex.clear();
+    m_PerceptionCache.Reset();
 
     // Set the time limit to 0 so it will report as being past it from the start of simulation
     m_SloMoTimer.SetRealTimeLimitMS(0);
@@ -777,6 +866,41 @@ Actor * MovableMan::GetUnassignedBrain(int team) const
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStateChecksum
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a checksum of the state of all the Actors, items and
+//                  particles currently held, for telling whether two runs of the
+//                  simulation have diverged.
+
+unsigned long long MovableMan::GetStateChecksum() const
+{
+    // Start with the counts, so MOs moving between the lists change the checksum
+    size_t moCounts[3] = { m_Actors.size(), m_Items.size(), m_Particles.size() };
+    unsigned long long checksum = HashBytes(moCounts, sizeof(moCounts));
+    auto hashMO = [&checksum](const MovableObject *pMO)
+    {
+        unsigned long uniqueID = pMO->GetUniqueID();
+        float state[6] = { pMO->GetPos().m_X, pMO->GetPos().m_Y, pMO->GetVel().m_X, pMO->GetVel().m_Y, pMO->GetRotAngle(), pMO->GetAngularVel() };
+        checksum = HashBytes(&uniqueID, sizeof(uniqueID), checksum);
+        checksum = HashBytes(state, sizeof(state), checksum);
+    };
+
+    for (const Actor *pActor : m_Actors)
+    {
+        int health = pActor->GetHealth();
+        hashMO(pActor);
+        checksum = HashBytes(&health, sizeof(health), checksum);
+    }
+    for (const MovableObject *pItem : m_Items)
+        hashMO(pItem);
+    for (const MovableObject *pParticle : m_Particles)
+        hashMO(pParticle);
+
+    return checksum;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          AddMO
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -829,6 +953,11 @@ bool MovableMan::AddMO(MovableObject *pMOToAdd)
 
 void MovableMan::AddActor(Actor *pActorToAdd)
 {
+    if (pActorToAdd && s_ParallelAIActorIndex >= 0)
+    {
+        m_ParallelAIEffects[s_ParallelAIActorIndex].AddedActors.push_back(pActorToAdd);
+        return;
+    }
     if (pActorToAdd)
     {
 //        pActorToAdd->SetPrevPos(pActorToAdd->GetPos());
@@ -866,6 +995,11 @@ void MovableMan::AddActor(Actor *pActorToAdd)
 
 void MovableMan::AddItem(MovableObject *pItemToAdd)
 {
+    if (pItemToAdd && s_ParallelAIActorIndex >= 0)
+    {
+        m_ParallelAIEffects[s_ParallelAIActorIndex].AddedItems.push_back(pItemToAdd);
+        return;
+    }
     if (pItemToAdd)
     {
 //        pItemToAdd->SetPrevPos(pItemToAdd->GetPos());
@@ -903,6 +1037,11 @@ void MovableMan::AddItem(MovableObject *pItemToAdd)
 
 void MovableMan::AddParticle(MovableObject *pMOToAdd)
 {
+    if (pMOToAdd && s_ParallelAIActorIndex >= 0)
+    {
+        m_ParallelAIEffects[s_ParallelAIActorIndex].AddedParticles.push_back(pMOToAdd);
+        return;
+    }
     if (pMOToAdd)
     {
 //        pMOToAdd->SetPrevPos(pMOToAdd->GetPos());
@@ -941,6 +1080,9 @@ void MovableMan::AddParticle(MovableObject *pMOToAdd)
 
 bool MovableMan::RemoveActor(MovableObject *pActorToRem)
 {
+    if (RefuseInParallelAI("MovableMan::RemoveActor"))
+        return false;
+
     bool removed = false;
 
     if (pActorToRem)
@@ -950,6 +1092,7 @@ bool MovableMan::RemoveActor(MovableObject *pActorToRem)
             if (*itr == pActorToRem)
             {
                 m_Actors.erase(itr);
+                m_DrawGridValid = false;
                 removed = true;
                 break;
             }
@@ -982,6 +1125,9 @@ bool MovableMan::RemoveActor(MovableObject *pActorToRem)
 
 bool MovableMan::RemoveItem(MovableObject *pItemToRem)
 {
+    if (RefuseInParallelAI("MovableMan::RemoveItem"))
+        return false;
+
     bool removed = false;
 
     if (pItemToRem)
@@ -991,6 +1137,7 @@ bool MovableMan::RemoveItem(MovableObject *pItemToRem)
             if (*itr == pItemToRem)
             {
                 m_Items.erase(itr);
+                m_DrawGridValid = false;
                 removed = true;
                 break;
             }
@@ -1066,6 +1213,9 @@ void MovableMan::RemoveActorFromTeamRoster(Actor * pActorToRem)
 
 void MovableMan::ChangeActorTeam(Actor * pActor, int team)
 {
+	if (RefuseInParallelAI("MovableMan::ChangeActorTeam"))
+		return;
+
 	if (!pActor)
 		return;
 
@@ -1084,6 +1234,9 @@ void MovableMan::ChangeActorTeam(Actor * pActor, int team)
 
 bool MovableMan::RemoveParticle(MovableObject *pMOToRem)
 {
+    if (RefuseInParallelAI("MovableMan::RemoveParticle"))
+        return false;
+
     bool removed = false;
 
     if (pMOToRem)
@@ -1093,6 +1246,7 @@ bool MovableMan::RemoveParticle(MovableObject *pMOToRem)
             if (*itr == pMOToRem)
             {
                 m_Particles.erase(itr);
+                m_DrawGridValid = false;
                 removed = true;
                 break;
             }
@@ -1354,6 +1508,9 @@ MOID MovableMan::GetRootMOID(MOID checkMOID)
 
 bool MovableMan::RemoveMO(MovableObject *pMOToRem)
 {
+    if (RefuseInParallelAI("MovableMan::RemoveMO"))
+        return false;
+
     if (pMOToRem)
     {
         if (RemoveItem(pMOToRem))
@@ -1375,6 +1532,9 @@ bool MovableMan::RemoveMO(MovableObject *pMOToRem)
 
 int MovableMan::KillAllActors(int exceptTeam)
 {
+    if (RefuseInParallelAI("MovableMan::KillAllActors"))
+        return 0;
+
     int killCount = 0;
     AHuman *pHuman = 0;
 
@@ -1434,6 +1594,7 @@ int MovableMan::EjectAllActors(list<SceneObject *> &actorList, int onlyTeam, boo
     }
     // Clear the internal Actor list; we transferred the ownership of them
     m_Actors.clear();
+    m_DrawGridValid = false;
 
     // Add all Actors added this frame
     for (deque<Actor *>::iterator aIt = m_AddedActors.begin(); aIt != m_AddedActors.end(); ++aIt)
@@ -1476,6 +1637,7 @@ int MovableMan::EjectAllItems(list<SceneObject *> &itemList)
     }
     // Clear the internal Actor list; we transferred the ownership of them
     m_Items.clear();
+    m_DrawGridValid = false;
 
     // Add all Items added this frame
     for (deque<MovableObject *>::iterator iIt = m_AddedItems.begin(); iIt != m_AddedItems.end(); ++iIt)
@@ -1509,6 +1671,9 @@ int MovableMan::GetTeamMOIDCount(int team) const
 
 void MovableMan::OpenAllDoors(bool open, int team)
 {
+    if (RefuseInParallelAI("MovableMan::OpenAllDoors"))
+        return;
+
     ADoor *pDoor = 0;
     for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
     {
@@ -1551,6 +1716,9 @@ void MovableMan::OpenAllDoors(bool open, int team)
 
 void MovableMan::OverrideMaterialDoors(bool enable, int team)
 {
+    if (RefuseInParallelAI("MovableMan::OverrideMaterialDoors"))
+        return;
+
     ADoor *pDoor = 0;
     for (deque<Actor *>::iterator aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
     {
@@ -1638,6 +1806,11 @@ void MovableMan::Update()
         return;
 
 	m_SimUpdateFrameNumber++;
+    m_PerceptionCache.Update(m_SimUpdateFrameNumber);
+    UpdateLODTiers();
+
+    // Everything is about to move, so the draw grid has to be rebuilt for the next drawn frame
+    m_DrawGridValid = false;
 
     // Clear the MO color layer only if this is a drawn update
     if (g_TimerMan.DrawnSimUpdate())
@@ -1681,7 +1854,8 @@ void MovableMan::Update()
         {
             for (aIt = m_Actors.begin(); aIt != m_Actors.end(); ++aIt)
             {
-                if (!((*aIt)->IsUpdated()))
+                // Dormant Actors stay put in between their full updates, any forces on them are applied once they're due
+                if (!((*aIt)->IsUpdated()) && !(*aIt)->IsPhysicsPausedByLOD())
                 {
                     (*aIt)->ApplyForces();
                     (*aIt)->PreTravel();
@@ -1705,7 +1879,7 @@ void MovableMan::Update()
         {
             for (iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt)
             {
-                if (!((*iIt)->IsUpdated()))
+                if (!((*iIt)->IsUpdated()) && !(*iIt)->IsPhysicsPausedByLOD())
                 {
                     (*iIt)->ApplyForces();
                     (*iIt)->PreTravel();
@@ -1736,6 +1910,9 @@ void MovableMan::Update()
         g_SceneMan.UnlockScene();
     }
 
+    // Run the thread-safe scripted AI on the parallel AI workers before the Actors' own updates, which will then skip it
+    UpdateParallelScriptedAI();
+
     ////////////////////////////////////////////////////////////////////////////
     // Second Pass
 
@@ -1760,7 +1937,9 @@ void MovableMan::Update()
             int itemLimit = m_Items.size() - m_MaxDroppedItems;
             for (iIt = m_Items.begin(); iIt != m_Items.end(); ++iIt, ++count)
             {
-                (*iIt)->Update();
+                // Settled items have nothing to update in between their full updates, but their scripts and any impulses that would wake them up still get to run
+                if (!(*iIt)->IsPhysicsPausedByLOD())
+                    (*iIt)->Update();
                 (*iIt)->UpdateScripts();
                 (*iIt)->ApplyImpulses();
                 if (count <= itemLimit)
@@ -2019,8 +2198,9 @@ void MovableMan::Update()
 
     ////////////////////////////////////////////////////////////////////
     // Draw the MO colors ONLY if this is a drawn update!
+    // With interpolated drawing the MOs are instead drawn straight onto the screens every frame by SceneMan::Draw
 
-    if (g_TimerMan.DrawnSimUpdate())
+    if (g_TimerMan.DrawnSimUpdate() && !g_SettingsMan.InterpolatedDrawing())
         Draw(g_SceneMan.GetMOColorBitmap());
 
     // Sort team rosters if necessary
@@ -2152,17 +2332,32 @@ void MovableMan::UpdateDrawMOIDs(BITMAP *pTargetBitmap)
 // Description:     Draws this MovableMan's current graphical representation to a
 //                  BITMAP of choice.
 
-void MovableMan::Draw(BITMAP *pTargetBitmap, const Vector &targetPos)
+void MovableMan::Draw(BITMAP *pTargetBitmap, const Vector &targetPos, float interpolationFactor)
 {
-    // Draw objects to accumulation bitmap, in reverse order so actors appear on top.
-    for (deque<MovableObject *>::iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
-        (*parIt)->Draw(pTargetBitmap, targetPos);
+    // Targets covering the whole scene, like the MO color layer, get everything drawn onto them without going through the culling grid
+    if (pTargetBitmap->w >= g_SceneMan.GetSceneWidth() && pTargetBitmap->h >= g_SceneMan.GetSceneHeight())
+    {
+        // Draw objects to accumulation bitmap, in reverse order so actors appear on top.
+        for (deque<MovableObject *>::iterator parIt = m_Particles.begin(); parIt != m_Particles.end(); ++parIt)
+            (*parIt)->Draw(pTargetBitmap, interpolationFactor < 1.0F ? targetPos + GetDrawInterpolationOffset(*parIt, interpolationFactor) : targetPos);
+
+        for (deque<MovableObject *>::reverse_iterator itmIt = m_Items.rbegin(); itmIt != m_Items.rend(); ++itmIt)
+            (*itmIt)->Draw(pTargetBitmap, interpolationFactor < 1.0F ? targetPos + GetDrawInterpolationOffset(*itmIt, interpolationFactor) : targetPos);
+
+        for (deque<Actor *>::reverse_iterator aIt = m_Actors.rbegin(); aIt != m_Actors.rend(); ++aIt)
+            (*aIt)->Draw(pTargetBitmap, interpolationFactor < 1.0F ? targetPos + GetDrawInterpolationOffset(*aIt, interpolationFactor) : targetPos);
+        return;
+    }
 
-	for (deque<MovableObject *>::reverse_iterator itmIt = m_Items.rbegin(); itmIt != m_Items.rend(); ++itmIt)
-        (*itmIt)->Draw(pTargetBitmap, targetPos);
+    // Only visit the objects near this screen's view. Interpolated objects are drawn up to the max interpolation distance away from where they are now.
+    GatherVisibleMOs(targetPos, pTargetBitmap->w, pTargetBitmap->h, interpolationFactor < 1.0F ? c_MaxDrawInterpolationDistance : 0.0F);
 
-    for (deque<Actor *>::reverse_iterator aIt = m_Actors.rbegin(); aIt != m_Actors.rend(); ++aIt)
-        (*aIt)->Draw(pTargetBitmap, targetPos);
+    // Shift each object back along the path it travelled in the last sim update if interpolating. Attachables are drawn relative to the same shifted target position so they move along with their parent.
+    for (const int drawIndex : m_VisibleDrawIndices)
+    {
+        MovableObject *pMO = m_DrawList[drawIndex];
+        pMO->Draw(pTargetBitmap, interpolationFactor < 1.0F ? targetPos + GetDrawInterpolationOffset(pMO, interpolationFactor) : targetPos);
+    }
 }
 
 
@@ -2172,14 +2367,372 @@ void MovableMan::Draw(BITMAP *pTargetBitmap, const Vector &targetPos)
 // Description:     Draws this MovableMan's current graphical representation to a
 //                  BITMAP of choice.
 
-void MovableMan::DrawHUD(BITMAP *pTargetBitmap, const Vector &targetPos, int which, bool playerControlled)
+void MovableMan::DrawHUD(BITMAP *pTargetBitmap, const Vector &targetPos, int which, bool playerControlled, float interpolationFactor)
+{
+    GatherVisibleMOs(targetPos, pTargetBitmap->w, pTargetBitmap->h, c_DrawCullHUDMargin + (interpolationFactor < 1.0F ? c_MaxDrawInterpolationDistance : 0.0F));
+
+    // Draw HUD elements, following the interpolated positions of their MOs if needed.
+    // Controlled actors and ones showing their waypoints can draw HUD elements anywhere on the screen, so they're always drawn no matter where they are.
+    for (int drawIndex = m_DrawListItemsStart; drawIndex < m_DrawList.size(); ++drawIndex)
+    {
+        MovableObject *pMO = m_DrawList[drawIndex];
+        if (m_DrawListVisibleStamps[drawIndex] != m_DrawVisibleStamp)
+        {
+            if (drawIndex < m_DrawListActorsStart)
+                continue;
+            const Actor *pActor = static_cast<Actor *>(pMO);
+            if (!pActor->IsPlayerControlled() && !pActor->GetDrawWaypoints())
+                continue;
+        }
+        pMO->DrawHUD(pTargetBitmap, interpolationFactor < 1.0F ? targetPos + GetDrawInterpolationOffset(pMO, interpolationFactor) : targetPos, which);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Static function: GetDrawGridCellSpans
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Finds the draw grid cells along one axis that overlap a range of
+//                  scene pixels, wrapping it around the scene edge if needed. The range
+//                  splits in two spans of cells when it crosses the wrapping seam.
+// Return value:    The number of spans written to the out-arrays, 0 to 2.
+
+static int GetDrawGridCellSpans(float minPixel, float maxPixel, int sceneSize, int cellCount, bool wraps, int spanStarts[2], int spanEnds[2])
+{
+    int min = static_cast<int>(std::floor(minPixel));
+    int max = static_cast<int>(std::floor(maxPixel));
+    const int lastCell = cellCount - 1;
+
+    if (!wraps)
+    {
+        min = std::max(min, 0);
+        max = std::min(max, sceneSize - 1);
+        if (min > max)
+            return 0;
+        spanStarts[0] = min / c_DrawCullGridCellSize;
+        spanEnds[0] = std::min(max / c_DrawCullGridCellSize, lastCell);
+        return 1;
+    }
+
+    if (max - min + 1 >= sceneSize)
+    {
+        spanStarts[0] = 0;
+        spanEnds[0] = lastCell;
+        return 1;
+    }
+
+    // Bring the start of the range into the scene, the end then lies at most one scene size past it
+    const int length = max - min;
+    min = ((min % sceneSize) + sceneSize) % sceneSize;
+    max = min + length;
+    spanStarts[0] = min / c_DrawCullGridCellSize;
+    if (max < sceneSize)
+    {
+        spanEnds[0] = std::min(max / c_DrawCullGridCellSize, lastCell);
+        return 1;
+    }
+    spanEnds[0] = lastCell;
+    spanStarts[1] = 0;
+    spanEnds[1] = std::min((max - sceneSize) / c_DrawCullGridCellSize, lastCell);
+    return 2;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLODTiers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sorts all Actors and items into level of detail update tiers and works
+//                  out which ones are due for their full update this sim update.
+
+void MovableMan::UpdateLODTiers()
+{
+    // How many sim updates apart the full updates of each tier are
+    static const int lodTierIntervals[MovableObject::LOD_TIERCOUNT] = { 1, 2, 4, 8 };
+
+    std::fill(m_UpdateLODTierCounts.begin(), m_UpdateLODTierCounts.end(), 0);
+    bool lodEnabled = g_SettingsMan.UpdateLODEnabled();
+
+    // The players' views, to measure how far outside of them everything is
+    int screenCount = std::min(static_cast<int>(g_FrameMan.GetScreenCount()), static_cast<int>(c_MaxScreenCount));
+    Vector halfView(static_cast<float>(g_FrameMan.GetPlayerScreenWidth()) / 2.0F, static_cast<float>(g_FrameMan.GetPlayerScreenHeight()) / 2.0F);
+    Vector viewCenters[c_MaxScreenCount];
+    for (int screen = 0; screen < screenCount; ++screen)
+        viewCenters[screen] = g_SceneMan.GetOffset(screen) + halfView;
+    float reducedRange = static_cast<float>(g_FrameMan.GetPlayerScreenWidth()) * c_UpdateLODReducedRange;
+
+    // Gets how far outside the nearest view an MO's bounding radius is, 0 if it's in view
+    auto distanceOutsideViews = [&](const MovableObject *pMO) {
+        float closestDistance = std::numeric_limits<float>::max();
+        for (int screen = 0; screen < screenCount; ++screen)
+        {
+            Vector toMO = g_SceneMan.ShortestDistance(viewCenters[screen], pMO->GetPos());
+            float outsideX = std::max(std::fabs(toMO.m_X) - halfView.m_X - pMO->GetRadius(), 0.0F);
+            float outsideY = std::max(std::fabs(toMO.m_Y) - halfView.m_Y - pMO->GetRadius(), 0.0F);
+            closestDistance = std::min(closestDistance, std::sqrt(outsideX * outsideX + outsideY * outsideY));
+        }
+        return closestDistance;
+    };
+    // Offset by the unique ID so the full updates of everything at the same tier are spread out evenly over the sim updates
+    auto setLOD = [&](MovableObject *pMO, int tier) {
+        pMO->SetUpdateLOD(tier, (m_SimUpdateFrameNumber + pMO->GetUniqueID()) % lodTierIntervals[tier] == 0);
+        m_UpdateLODTierCounts[tier]++;
+    };
+
+    for (Actor *pActor : m_Actors)
+    {
+        int tier = MovableObject::LOD_FULL;
+        // Only AI controlled Actors are ever updated less often, and only while out of view
+        if (lodEnabled && pActor->GetController()->GetInputMode() == Controller::CIM_AI)
+        {
+            float viewDistance = distanceOutsideViews(pActor);
+            if (viewDistance > 0)
+                tier = viewDistance > reducedRange ? MovableObject::LOD_LOW : MovableObject::LOD_REDUCED;
+            // Far away sentries that are standing still can go dormant until something disturbs them
+            bool settled = UpdateLODIdleFrames(pActor) && pActor->GetAIMode() == Actor::AIMODE_SENTRY && pActor->GetStatus() == Actor::STABLE;
+            if (tier == MovableObject::LOD_LOW && settled)
+                tier = MovableObject::LOD_DORMANT;
+        }
+        setLOD(pActor, tier);
+    }
+    for (MovableObject *pItem : m_Items)
+    {
+        int tier = MovableObject::LOD_FULL;
+        // Items only have to be fully updated while they move or can be seen
+        if (lodEnabled && UpdateLODIdleFrames(pItem) && distanceOutsideViews(pItem) > 0)
+            tier = MovableObject::LOD_DORMANT;
+        setLOD(pItem, tier);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLODIdleFrames
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Works out whether an MO is idle this sim update, counting up its idle
+//                  sim updates if so and resetting them otherwise.
+
+bool MovableMan::UpdateLODIdleFrames(MovableObject *pMO)
+{
+    bool idle = pMO->GetVel().GetLargest() < c_UpdateLODIdleSpeed && std::fabs(pMO->GetAngularVel()) < c_UpdateLODIdleAngularSpeed;
+    // Make sure it's not just hanging at the top of an arc, or left floating after the terrain under it got dug out
+    if (idle && pMO->GetLODIdleFrames() >= c_UpdateLODSettleFrames && pMO->IsUpdateDue())
+        idle = !g_SceneMan.OverAltitude(pMO->GetPos(), static_cast<int>(pMO->GetRadius()) + 4, 3);
+
+    pMO->SetLODIdleFrames(idle ? pMO->GetLODIdleFrames() + 1 : 0);
+    return pMO->GetLODIdleFrames() >= c_UpdateLODSettleFrames;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateParallelScriptedAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the thread-safe scripted AI of all AI controlled Actors on the
+//                  parallel AI workers, if enabled in the settings.
+
+void MovableMan::UpdateParallelScriptedAI()
+{
+    if (!g_SettingsMan.ParallelScriptedAI())
+        return;
+
+    m_ParallelAIActors.clear();
+    for (Actor *pActor : m_Actors)
+    {
+        if (pActor->GetController()->GetInputMode() == Controller::CIM_AI && !pActor->GetController()->IsDisabled() && pActor->IsUpdateDue() && pActor->CanUpdateAIInParallel())
+            m_ParallelAIActors.push_back(pActor);
+    }
+    if (m_ParallelAIActors.empty())
+        return;
+
+    g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
+    m_ParallelAIEffects.resize(m_ParallelAIActors.size());
+    g_LuaMan.UpdateParallelAI(m_ParallelAIActors);
+    g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTORS_AI);
+
+    // Now hand out the unique IDs of anything the AI scripts created and properly add anything they spawned.
+    // Going through the Actors in order makes it all happen the same way every run, no matter how the workers got to them
+    int maxCreatedMOCount = 0;
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        for (MovableObject *pMO : effects.CreatedMOs)
+            pMO->AssignUniqueID();
+        maxCreatedMOCount = std::max(maxCreatedMOCount, effects.CreatedMOCount);
+    }
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        for (Actor *pActor : effects.AddedActors)
+            AddActor(pActor);
+    }
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        for (MovableObject *pItem : effects.AddedItems)
+            AddItem(pItem);
+    }
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        for (MovableObject *pParticle : effects.AddedParticles)
+            AddParticle(pParticle);
+    }
+    // Pathfinding overrides the doors' materials and updates the Scene's pathfinder, so the paths are found one at a time
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        for (Actor *pActor : effects.MovePathUpdates)
+        {
+            if (ValidMO(pActor))
+                pActor->UpdateMovePath();
+        }
+    }
+    for (ParallelAIEffects &effects : m_ParallelAIEffects)
+    {
+        effects.CreatedMOs.clear();
+        effects.CreatedMOCount = 0;
+        effects.AddedActors.clear();
+        effects.AddedItems.clear();
+        effects.AddedParticles.clear();
+        effects.MovePathUpdates.clear();
+        effects.RefusedCall = nullptr;
+    }
+
+    // Attachables keep their temporary IDs as their atom subgroup IDs, so the next update's temporary IDs start below these. Start over long before they could overflow
+    m_TemporaryUniqueIDStart -= static_cast<long int>(maxCreatedMOCount * m_ParallelAIEffects.size());
+    if (m_TemporaryUniqueIDStart < -(1L << 30))
+        m_TemporaryUniqueIDStart = -1;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDrawGrid
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Rebuilds the draw list and sorts every MO in it into the draw grid
+//                  cells its bounding radius overlaps, if not done since the MOs last
+//                  changed.
+
+void MovableMan::UpdateDrawGrid()
+{
+    if (m_DrawGridValid)
+        return;
+
+    // Same order as everything is drawn in, particles first and actors last so they appear on top
+    m_DrawList.clear();
+    m_DrawList.insert(m_DrawList.end(), m_Particles.begin(), m_Particles.end());
+    m_DrawListItemsStart = m_DrawList.size();
+    m_DrawList.insert(m_DrawList.end(), m_Items.rbegin(), m_Items.rend());
+    m_DrawListActorsStart = m_DrawList.size();
+    m_DrawList.insert(m_DrawList.end(), m_Actors.rbegin(), m_Actors.rend());
+
+    const int sceneWidth = g_SceneMan.GetSceneWidth();
+    const int sceneHeight = g_SceneMan.GetSceneHeight();
+    const int cellsX = std::max(1, (sceneWidth + c_DrawCullGridCellSize - 1) / c_DrawCullGridCellSize);
+    const int cellsY = std::max(1, (sceneHeight + c_DrawCullGridCellSize - 1) / c_DrawCullGridCellSize);
+    // Keep the cells' allocations around between rebuilds unless the scene changed size
+    if (cellsX != m_DrawGridCellsX || cellsY != m_DrawGridCellsY)
+    {
+        m_DrawGrid.clear();
+        m_DrawGrid.resize(cellsX * cellsY);
+        m_DrawGridCellsX = cellsX;
+        m_DrawGridCellsY = cellsY;
+    }
+    else
+    {
+        for (vector<int> &cell : m_DrawGrid)
+            cell.clear();
+    }
+
+    const bool wrapsX = g_SceneMan.SceneWrapsX();
+    const bool wrapsY = g_SceneMan.SceneWrapsY();
+    int startsX[2];
+    int endsX[2];
+    int startsY[2];
+    int endsY[2];
+    for (int drawIndex = 0; drawIndex < m_DrawList.size(); ++drawIndex)
+    {
+        const Vector &pos = m_DrawList[drawIndex]->GetPos();
+        const float radius = m_DrawList[drawIndex]->GetRadius();
+        const int spansX = GetDrawGridCellSpans(pos.m_X - radius, pos.m_X + radius, sceneWidth, cellsX, wrapsX, startsX, endsX);
+        const int spansY = GetDrawGridCellSpans(pos.m_Y - radius, pos.m_Y + radius, sceneHeight, cellsY, wrapsY, startsY, endsY);
+        for (int spanY = 0; spanY < spansY; ++spanY)
+        {
+            for (int cellY = startsY[spanY]; cellY <= endsY[spanY]; ++cellY)
+            {
+                for (int spanX = 0; spanX < spansX; ++spanX)
+                {
+                    for (int cellX = startsX[spanX]; cellX <= endsX[spanX]; ++cellX)
+                        m_DrawGrid[cellY * cellsX + cellX].push_back(drawIndex);
+                }
+            }
+        }
+    }
+
+    m_DrawListVisibleStamps.assign(m_DrawList.size(), 0);
+    m_DrawVisibleStamp = 0;
+    m_DrawGridValid = true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GatherVisibleMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Fills m_VisibleDrawIndices with the MOs whose draw grid cells overlap
+//                  a view of the scene, taking scene wrapping into account.
+
+void MovableMan::GatherVisibleMOs(const Vector &viewPos, int viewWidth, int viewHeight, float margin)
+{
+    UpdateDrawGrid();
+
+    m_VisibleDrawIndices.clear();
+    if (++m_DrawVisibleStamp == 0)
+    {
+        std::fill(m_DrawListVisibleStamps.begin(), m_DrawListVisibleStamps.end(), 0);
+        m_DrawVisibleStamp = 1;
+    }
+
+    int startsX[2];
+    int endsX[2];
+    int startsY[2];
+    int endsY[2];
+    const int spansX = GetDrawGridCellSpans(viewPos.m_X - margin, viewPos.m_X + viewWidth + margin, g_SceneMan.GetSceneWidth(), m_DrawGridCellsX, g_SceneMan.SceneWrapsX(), startsX, endsX);
+    const int spansY = GetDrawGridCellSpans(viewPos.m_Y - margin, viewPos.m_Y + viewHeight + margin, g_SceneMan.GetSceneHeight(), m_DrawGridCellsY, g_SceneMan.SceneWrapsY(), startsY, endsY);
+    for (int spanY = 0; spanY < spansY; ++spanY)
+    {
+        for (int cellY = startsY[spanY]; cellY <= endsY[spanY]; ++cellY)
+        {
+            for (int spanX = 0; spanX < spansX; ++spanX)
+            {
+                for (int cellX = startsX[spanX]; cellX <= endsX[spanX]; ++cellX)
+                {
+                    // Objects overlapping several cells are only gathered the first time they're found
+                    for (const int drawIndex : m_DrawGrid[cellY * m_DrawGridCellsX + cellX])
+                    {
+                        if (m_DrawListVisibleStamps[drawIndex] != m_DrawVisibleStamp)
+                        {
+                            m_DrawListVisibleStamps[drawIndex] = m_DrawVisibleStamp;
+                            m_VisibleDrawIndices.push_back(drawIndex);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Cells are visited in scene order, so restore the drawing order
+    std::sort(m_VisibleDrawIndices.begin(), m_VisibleDrawIndices.end());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDrawInterpolationOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much to shift the drawing target position of an MO so it gets
+//                  drawn in between its previous and current sim update positions.
+
+Vector MovableMan::GetDrawInterpolationOffset(const MovableObject *pMO, float interpolationFactor) const
 {
-    // Draw HUD elements
-	for (deque<MovableObject *>::reverse_iterator itmIt = m_Items.rbegin(); itmIt != m_Items.rend(); ++itmIt)
-        (*itmIt)->DrawHUD(pTargetBitmap, targetPos, which);
+    Vector travel = g_SceneMan.ShortestDistance(pMO->GetPrevPos(), pMO->GetPos());
+    // Don't smear objects that were just added or teleported across the screen
+    if (travel.GetLargest() > c_MaxDrawInterpolationDistance)
+        return Vector();
 
-    for (deque<Actor *>::reverse_iterator aIt = m_Actors.rbegin(); aIt != m_Actors.rend(); ++aIt)
-        (*aIt)->DrawHUD(pTargetBitmap, targetPos, which);
+    // Drawing relative to a target position further along the travel makes the object appear further back
+    return travel * (1.0F - interpolationFactor);
 }
 
 } // namespace RTE
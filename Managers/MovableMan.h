@@ -19,6 +19,7 @@
 #include "SceneMan.h"
 #include "LuaMan.h"
 #include "Singleton.h"
+#include "PerceptionCache.h"
 
 #define g_MovableMan MovableMan::Instance()
 
@@ -379,6 +380,26 @@ public:
     Actor * GetUnassignedBrain(int team = 0) const;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetActorCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of Actors currently held.
+// Arguments:       None.
+// Return value:    The number of Actors.
+
+    long GetActorCount() const { return m_Actors.size(); }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetItemCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the number of items currently held.
+// Arguments:       None.
+// Return value:    The number of items.
+
+    long GetItemCount() const { return m_Items.size(); }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetParticleCount
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -389,6 +410,19 @@ public:
     long GetParticleCount() const { return m_Particles.size(); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetStateChecksum
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Calculates a checksum of the state of all the Actors, items and
+//                  particles currently held, for telling whether two runs of the
+//                  simulation have diverged.
+// Arguments:       None.
+// Return value:    The checksum of the IDs, positions, velocities, rotations and Actor
+//                  healths of everything held, in update order.
+
+    unsigned long long GetStateChecksum() const;
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetAGResolution
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -843,9 +877,12 @@ public:
 //                  BITMAP of choice.
 // Arguments:       A pointer to a BITMAP to draw on.
 //                  The absolute position of the target bitmap's upper left corner in the scene.
+//                  How far along the real time is towards the next sim update, used to
+//                  draw each MO in between its previous and current position. 1 draws
+//                  everything at the current positions.
 // Return value:    None.
 
-    void Draw(BITMAP *pTargetBitmap, const Vector &targetPos = Vector());
+    void Draw(BITMAP *pTargetBitmap, const Vector &targetPos = Vector(), float interpolationFactor = 1.0F);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -857,9 +894,11 @@ public:
 //                  The absolute position of the target bitmap's upper left corner in the scene.
 //                  Which player's screen is being drawn. Tis affects which actor's HUDs
 //                  get drawn.
+//                  How far along the real time is towards the next sim update, used to
+//                  draw each HUD in between its MO's previous and current position.
 // Return value:    None.
 
-    void DrawHUD(BITMAP *pTargetBitmap, const Vector &targetPos = Vector(), int which = 0, bool playerControlled = false);
+    void DrawHUD(BITMAP *pTargetBitmap, const Vector &targetPos = Vector(), int which = 0, bool playerControlled = false, float interpolationFactor = 1.0F);
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -892,6 +931,71 @@ public:
 	void UnregisterObject(MovableObject * mo);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferParallelAIUniqueID
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds off giving an MO created by the AI scripts of an Actor on a
+//                  parallel AI worker its unique ID until the workers are all done, so
+//                  the IDs are handed out in the same order every run. Until then it has
+//                  a temporary negative one and can't be found by it.
+// Arguments:       The MO that is being created.
+// Return value:    The temporary unique ID to give the MO, or 0 if this isn't called on
+//                  behalf of a parallel AI update and the MO should get its ID right away.
+
+	long int DeferParallelAIUniqueID(MovableObject *mo);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetParallelAIActorIndex
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Tells which Actor the AI scripts run by the calling thread next belong
+//                  to, so any MOs they create or add can be put aside for the main thread
+//                  to finish in a fixed order once the parallel AI update is done.
+// Arguments:       The index of the Actor in the ones passed to LuaMan::UpdateParallelAI,
+//                  or -1 when done with it.
+// Return value:    None.
+
+	void SetParallelAIActorIndex(int actorIndex) { s_ParallelAIActorIndex = actorIndex; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DeferParallelAIMovePathUpdate
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Holds off updating an Actor's move path asked for by the AI scripts of
+//                  an Actor on a parallel AI worker until the workers are all done, since
+//                  pathfinding overrides the doors' materials and updates the Scene's
+//                  pathfinder. The paths are then updated in the order they were asked for.
+// Arguments:       The Actor whose move path should be updated.
+// Return value:    Whether the update was deferred, or false if this isn't called on behalf
+//                  of a parallel AI update and the path should be updated right away.
+
+	bool DeferParallelAIMovePathUpdate(Actor *actor);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RefuseInParallelAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Refuses a call that changes things shared between Actors in ways that
+//                  can't be put aside for later, if made by the AI scripts of an Actor on a
+//                  parallel AI worker. The refused Actor's AI falls back to running on the
+//                  main thread, where the call works, from its next update on.
+// Arguments:       The name of the call, for the error message.
+// Return value:    Whether the call was refused and should return without doing anything.
+
+	bool RefuseInParallelAI(const char *callName);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetParallelAIRefusedCall
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the first call the AI scripts of an Actor on a parallel AI worker
+//                  made that got refused in the current parallel AI update.
+// Arguments:       The index of the Actor in the ones passed to LuaMan::UpdateParallelAI.
+// Return value:    The name of the refused call, or nullptr if none were refused.
+
+	const char * GetParallelAIRefusedCall(int actorIndex) const { return m_ParallelAIEffects[actorIndex].RefusedCall; }
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          FindObjectByUniqueId
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -899,7 +1003,7 @@ public:
 // Arguments:       Unique Id to look for.
 // Return value:    Object found or 0 if not found any.
 
-	MovableObject * FindObjectByUniqueID(long int id) { if (m_KnownObjects.count(id) > 0) return m_KnownObjects[id]; else return 0; }
+	MovableObject * FindObjectByUniqueID(long int id) { std::lock_guard<std::mutex> knownObjectsLock(m_KnownObjectsMutex); std::map<long int, MovableObject *>::const_iterator objectItr = m_KnownObjects.find(id); return (objectItr != m_KnownObjects.end()) ? objectItr->second : 0; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -921,6 +1025,27 @@ public:
 
 	unsigned int GetSimUpdateFrameNumber() const { return m_SimUpdateFrameNumber; }
 
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetPerceptionCache
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the cache that Actors look for MOs, gold and unseen areas through.
+// Arguments:       None.
+// Return value:    The PerceptionCache shared by all Actors.
+
+	PerceptionCache & GetPerceptionCache() { return m_PerceptionCache; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetUpdateLODTierCount
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how many Actors and items were at a level of detail update tier
+//                  in the last update.
+// Arguments:       The MovableObject::UpdateLODTier to get the count of.
+// Return value:    The number of Actors and items at that tier.
+
+	int GetUpdateLODTierCount(int tier) const { return (tier >= 0 && tier < static_cast<int>(m_UpdateLODTierCounts.size())) ? m_UpdateLODTierCounts[tier] : 0; }
+
 	void OnPieMenu(Actor *pActor);
 
 
@@ -987,8 +1112,70 @@ protected:
 
 	unsigned int m_SimUpdateFrameNumber;
 
+    // What Actors have seen recently, so they don't have to cast all their perception rays every update
+    PerceptionCache m_PerceptionCache;
+
+    // How many Actors and items were at each level of detail update tier in the last update
+    std::vector<int> m_UpdateLODTierCounts;
+    // The furthest in pixels outside the players' views Actors are still updated at LOD_REDUCED, rather than LOD_LOW, as a fraction of the screen width
+    static constexpr float c_UpdateLODReducedRange = 0.5F;
+    // The fastest, in m/s, an MO can move and still count as idle
+    static constexpr float c_UpdateLODIdleSpeed = 0.5F;
+    // The fastest, in rad/s, an MO can rotate and still count as idle
+    static constexpr float c_UpdateLODIdleAngularSpeed = 0.1F;
+    // For how many sim updates in a row an MO has to be idle before it can go dormant
+    static constexpr int c_UpdateLODSettleFrames = 30;
+
 	// Global map which stores all objects so they could be foud by their unique ID
 	std::map<long int, MovableObject *> m_KnownObjects;
+	// Guards m_KnownObjects, since objects can be created and destroyed by AI scripts running on parallel AI workers
+	std::mutex m_KnownObjectsMutex;
+
+    // What the AI scripts of one Actor did on a parallel AI worker that the main thread has to finish once the workers are all done
+    struct ParallelAIEffects
+    {
+        // MOs created, in the order they were created in, waiting for their unique IDs
+        std::vector<MovableObject *> CreatedMOs;
+        // How many MOs were created, including any destroyed again, so no two get the same temporary unique ID
+        int CreatedMOCount = 0;
+        // MOs added, waiting to be added properly
+        std::vector<Actor *> AddedActors;
+        std::vector<MovableObject *> AddedItems;
+        std::vector<MovableObject *> AddedParticles;
+        // Actors whose move paths were asked to be updated, waiting to be updated one at a time, since pathfinding changes the doors and the Scene's pathfinder
+        std::vector<Actor *> MovePathUpdates;
+        // The name of the first call the AI scripts made that isn't thread-safe and got refused, or nullptr if none
+        const char *RefusedCall = nullptr;
+    };
+
+    // Actors whose scripted AI gets updated on the parallel AI workers this update. Reused between updates, does NOT own any instances.
+    std::vector<Actor *> m_ParallelAIActors;
+    // What the AI scripts of each of the above Actors did, in the same order. Only ever touched by the thread running that Actor's scripts until the workers are done
+    std::vector<ParallelAIEffects> m_ParallelAIEffects;
+    // The index in m_ParallelAIActors of the Actor whose AI scripts this thread is running, or -1 if none
+    static thread_local int s_ParallelAIActorIndex;
+    // The temporary unique IDs of the current parallel AI update count down from this, so they never match the ones of earlier updates either
+    long int m_TemporaryUniqueIDStart;
+
+    // All particles, items and actors in the order they are drawn in. Rebuilt along with the draw grid when first needed after an update. Does NOT own any instances.
+    std::vector<MovableObject *> m_DrawList;
+    // Index in m_DrawList where the items start, everything before it is a particle
+    int m_DrawListItemsStart;
+    // Index in m_DrawList where the actors start
+    int m_DrawListActorsStart;
+    // Scene grid of c_DrawCullGridCellSize cells, each listing the indices in m_DrawList of the MOs whose bounding radius overlaps it
+    std::vector<std::vector<int>> m_DrawGrid;
+    // Number of draw grid cells in each dimension
+    int m_DrawGridCellsX;
+    int m_DrawGridCellsY;
+    // Whether the draw list and grid are up to date with the MOs and their positions
+    bool m_DrawGridValid;
+    // Per m_DrawList index, the last view query that found the MO visible, so MOs overlapping several cells are only gathered once
+    std::vector<unsigned int> m_DrawListVisibleStamps;
+    // The number of the current view query
+    unsigned int m_DrawVisibleStamp;
+    // Indices in m_DrawList of the MOs visible in the current view query, in drawing order. Reused between queries.
+    std::vector<int> m_VisibleDrawIndices;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1007,6 +1194,80 @@ private:
     void Clear();
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetDrawInterpolationOffset
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets how much to shift the drawing target position of an MO so it gets
+//                  drawn in between its previous and current sim update positions.
+// Arguments:       The MO to get the offset for.
+//                  How far along the real time is towards the next sim update.
+// Return value:    The offset to add to the drawing target position. Zero if the MO
+//                  moved too far to be interpolated.
+
+    Vector GetDrawInterpolationOffset(const MovableObject *pMO, float interpolationFactor) const;
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateDrawGrid
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Rebuilds the draw list and sorts every MO in it into the draw grid
+//                  cells its bounding radius overlaps, if not done since the MOs last
+//                  changed.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateDrawGrid();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GatherVisibleMOs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Fills m_VisibleDrawIndices with the MOs whose draw grid cells overlap
+//                  a view of the scene, taking scene wrapping into account.
+// Arguments:       The absolute position of the view's upper left corner in the scene.
+//                  The width and height of the view.
+//                  Extra distance around the view to gather MOs in.
+// Return value:    None.
+
+    void GatherVisibleMOs(const Vector &viewPos, int viewWidth, int viewHeight, float margin);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateParallelScriptedAI
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Runs the thread-safe scripted AI of all AI controlled Actors on the
+//                  parallel AI workers, if enabled in the settings. Their Controllers
+//                  will then skip running it again in the Actors' updates.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateParallelScriptedAI();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLODTiers
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sorts all Actors and items into level of detail update tiers by how far
+//                  they are from the players' views and whether they're idle, works out
+//                  which ones are due for their full update this sim update, and reports
+//                  the tier counts to PerformanceMan.
+// Arguments:       None.
+// Return value:    None.
+
+    void UpdateLODTiers();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          UpdateLODIdleFrames
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Works out whether an MO is idle this sim update, counting up its idle
+//                  sim updates if so and resetting them otherwise.
+// Arguments:       The MO to check.
+// Return value:    Whether the MO has been idle long enough to be considered settled.
+
+    bool UpdateLODIdleFrames(MovableObject *pMO);
+
+
     // Disallow the use of some implicit methods.
 	MovableMan(const MovableMan &reference) {}
 	MovableMan & operator=(const MovableMan &rhs) {}
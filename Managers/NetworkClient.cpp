@@ -5,6 +5,7 @@
 #include "SettingsMan.h"
 #include "PerformanceMan.h"
 #include "UInputMan.h"
+#include "TimerMan.h"
 
 #include "NetworkClient.h"
 
@@ -44,12 +45,27 @@ namespace RTE {
 		m_IsNATPunched = false;
 		m_ActiveBackgroundLayers = 0;
 		m_SceneWrapsX = false;
+		m_IsReplaying = false;
+		m_PendingBoxJobs.clear();
+		m_PendingBoxData.clear();
+		m_NextBoxJob = 0;
+		m_DecodeBatch = 0;
+		m_DecodeWorkersFinished = 0;
+		m_StopDecodeThreads = false;
+		m_BackgroundCompositeBitmap = 0;
+		m_DirtyCompositeTiles.clear();
+		m_CompositeTilesX = 0;
+		m_CompositeTilesY = 0;
+		m_FullCompositeRedraw = true;
+		m_CompositedTargetPos.Reset();
 
 		for (int f = 0; f < c_FramesToRemember; f++) {
 			m_TargetPos[f].Reset();
 		}
 		for (int i = 0; i < c_MaxLayersStoredForNetwork; i++) {
 			m_BackgroundBitmaps[i] = 0;
+			m_CompositedLayerOffsetX[i] = 0;
+			m_CompositedLayerOffsetY[i] = 0;
 		}
 		for (int i = 0; i < MAX_MOUSE_BUTTONS; i++) {
 			m_MouseButtonPressedState[i] = -1;
@@ -74,6 +90,24 @@ namespace RTE {
 		return 0;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::Destroy() {
+		if (!m_DecodeThreads.empty()) {
+			{
+				std::lock_guard<std::mutex> decodeLock(m_DecodeMutex);
+				m_StopDecodeThreads = true;
+			}
+			m_DecodeWorkAvailable.notify_all();
+			for (std::thread &decodeThread : m_DecodeThreads) {
+				decodeThread.join();
+			}
+			m_DecodeThreads.clear();
+		}
+		if (m_BackgroundCompositeBitmap) { destroy_bitmap(m_BackgroundCompositeBitmap); }
+		Clear();
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::Connect(std::string serverName, unsigned short serverPort, std::string playerName) {
@@ -327,6 +361,7 @@ namespace RTE {
 					LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameLine)), (char *)(bmp->line[lineNumber]), frameData->DataSize, bmp->w);
 				}
 			}
+			MarkCompositeRectDirty(0, lineNumber, bmp->w, 1);
 		}
 		release_bitmap(bmp);
 	}
@@ -339,52 +374,39 @@ namespace RTE {
 		int bpy = frameData->BoxY;
 		m_CurrentSceneLayerReceived = -1;
 
-		BITMAP *bmp = 0;
+		const BITMAP *bmp = 0;
 
 		if (frameData->Layer == 0) {
 			bmp = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
 		} else if (frameData->Layer == 1) {
 			bmp = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
 		}
-
-		acquire_bitmap(bmp);
+		if (!bmp || sizeof(MsgFrameBox) + frameData->DataSize > packet->length) {
+			return;
+		}
 
 		int maxWidth = frameData->BoxWidth;
 		int maxHeight = frameData->BoxHeight;
-		int size = frameData->DataSize;
 
 		m_ReceivedData += frameData->DataSize;
 		m_CompressedData += frameData->UncompressedSize;
 
-		if (bpx + maxWidth - 1 < bmp->w && bpy + maxHeight - 1 < bmp->h && bpx >= 0 && bpy >= 0) {
-			// Unpack box
-			if (frameData->DataSize == 0) {
-				//memset(bmp->line[lineNumber], g_MaskColor, bmp->w);
-				rectfill(bmp, bpx, bpy, bpx + maxWidth - 1, bpy + maxHeight - 1, g_MaskColor);
-			} else {
-				if (frameData->DataSize == frameData->UncompressedSize) {
-					memcpy_s(m_PixelLineBuffer, size, packet->data + sizeof(MsgFrameBox), size);
-				} else {
-					LZ4_decompress_safe((char *)(packet->data + sizeof(MsgFrameBox)), (char *)(m_PixelLineBuffer), size, frameData->UncompressedSize);
-				}
-				// Copy box to bitmap line by line
-				const unsigned char *lineAddr = m_PixelLineBuffer;
-				for (int y = 0; y < maxHeight; y++) {
-					memcpy_s(bmp->line[bpy + y] + bpx, maxWidth, lineAddr, maxWidth);
-					lineAddr += maxWidth;
-				}
+		if (bpx + maxWidth - 1 < bmp->w && bpy + maxHeight - 1 < bmp->h && bpx >= 0 && bpy >= 0 && (frameData->DataSize == 0 || frameData->UncompressedSize >= maxWidth * maxHeight)) {
+			// Defer unpacking until the frame is drawn so all the boxes of the frame can be decompressed in parallel
+			m_PendingBoxJobs.push_back({ *frameData, m_PendingBoxData.size() });
+			m_PendingBoxData.insert(m_PendingBoxData.end(), packet->data + sizeof(MsgFrameBox), packet->data + sizeof(MsgFrameBox) + frameData->DataSize);
 
-#if defined DEBUG_BUILD || defined MIN_DEBUG_BUILD
-				if (g_UInputMan.KeyHeld(KEY_0)) { rect(bmp, bpx, bpy, bpx + maxWidth - 1, bpy + maxHeight - 1, g_BlackColor); }
-#endif
-			}
+			MarkCompositeRectDirty(bpx, bpy, maxWidth, maxHeight);
 		}
-		release_bitmap(bmp);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::SendSceneAcceptedMsg() {
+		// Nobody to acknowledge to when playing back a recorded stream
+		if (m_IsReplaying) {
+			return;
+		}
 		MsgRegister msg;
 		msg.Id = ID_CLT_SCENE_ACCEPTED;
 		m_Client->Send((const char *)&msg, sizeof(msg), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
@@ -454,6 +476,8 @@ namespace RTE {
 		// This is purely for aesthetic reasons to draw bitmap during level loading
 		clear_to_color(m_SceneForegroundBitmap, g_MaskColor);
 
+		m_FullCompositeRedraw = true;
+
 		m_SceneWrapsX = frameData->SceneWrapsX;
 		m_SceneWidth = frameData->Width;
 		m_SceneHeight = frameData->Height;
@@ -502,6 +526,10 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::SendSceneSetupAcceptedMsg() {
+		// Nobody to acknowledge to when playing back a recorded stream
+		if (m_IsReplaying) {
+			return;
+		}
 		MsgRegister msg;
 		msg.Id = ID_CLT_SCENE_SETUP_ACCEPTED;
 		m_Client->Send((const char *)&msg, sizeof(msg), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ServerID, false);
@@ -539,6 +567,13 @@ namespace RTE {
 				src += frameData->W;
 			}
 		}
+
+		// The scene layers are drawn wrapped around the seam, so the change may be visible on either side of it
+		int screenX = frameData->X - static_cast<int>(m_TargetPos[m_CurrentFrame].m_X);
+		int screenY = frameData->Y - static_cast<int>(m_TargetPos[m_CurrentFrame].m_Y);
+		MarkCompositeRectDirty(screenX, screenY, frameData->W, frameData->H);
+		MarkCompositeRectDirty(screenX - m_SceneWidth, screenY, frameData->W, frameData->H);
+		MarkCompositeRectDirty(screenX + m_SceneWidth, screenY, frameData->W, frameData->H);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -846,59 +881,220 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkClient::DrawFrame() {
+		DecodePendingFrameBoxes();
+
+		const BITMAP *dst_bmp = g_FrameMan.GetNetworkBackBuffer8Ready(0);
+
+		int tilesX = (dst_bmp->w + c_NetworkCompositeTileSize - 1) / c_NetworkCompositeTileSize;
+		int tilesY = (dst_bmp->h + c_NetworkCompositeTileSize - 1) / c_NetworkCompositeTileSize;
+		if (tilesX != m_CompositeTilesX || tilesY != m_CompositeTilesY) {
+			m_CompositeTilesX = tilesX;
+			m_CompositeTilesY = tilesY;
+			m_DirtyCompositeTiles.assign(tilesX * tilesY, true);
+			m_FullCompositeRedraw = true;
+		}
+		if (!m_BackgroundCompositeBitmap || m_BackgroundCompositeBitmap->w != dst_bmp->w || m_BackgroundCompositeBitmap->h != dst_bmp->h) {
+			if (m_BackgroundCompositeBitmap) { destroy_bitmap(m_BackgroundCompositeBitmap); }
+			m_BackgroundCompositeBitmap = create_bitmap_ex(8, dst_bmp->w, dst_bmp->h);
+			m_FullCompositeRedraw = true;
+		}
+
+		// Everything on screen moves if the view or any of the background layers scrolled, otherwise only what the server sent or the terrain changed needs to be redrawn
+		if (m_TargetPos[m_CurrentFrame] != m_CompositedTargetPos) { m_FullCompositeRedraw = true; }
+		for (int i = 0; i < m_ActiveBackgroundLayers && !m_FullCompositeRedraw; i++) {
+			if (m_BackgroundLayers[m_CurrentFrame][i].OffsetX != m_CompositedLayerOffsetX[i] || m_BackgroundLayers[m_CurrentFrame][i].OffsetY != m_CompositedLayerOffsetY[i]) { m_FullCompositeRedraw = true; }
+		}
+
+		if (m_FullCompositeRedraw) {
+			// Have to clear to color to fallback if there's no skybox on client
+			clear_to_color(m_BackgroundCompositeBitmap, g_BlackColor);
+			DrawBackgrounds(m_BackgroundCompositeBitmap);
+
+			m_CompositedTargetPos = m_TargetPos[m_CurrentFrame];
+			for (int i = 0; i < c_MaxLayersStoredForNetwork; i++) {
+				m_CompositedLayerOffsetX[i] = m_BackgroundLayers[m_CurrentFrame][i].OffsetX;
+				m_CompositedLayerOffsetY[i] = m_BackgroundLayers[m_CurrentFrame][i].OffsetY;
+			}
+			std::fill(m_DirtyCompositeTiles.begin(), m_DirtyCompositeTiles.end(), true);
+			m_FullCompositeRedraw = false;
+		}
+
+		// Composite the dirty tiles row by row, merging horizontal runs of them so each run goes through every layer in a single pass
+		for (int tileY = 0; tileY < m_CompositeTilesY; tileY++) {
+			int tileX = 0;
+			while (tileX < m_CompositeTilesX) {
+				if (!m_DirtyCompositeTiles[tileY * m_CompositeTilesX + tileX]) {
+					tileX++;
+					continue;
+				}
+				int runStart = tileX;
+				while (tileX < m_CompositeTilesX && m_DirtyCompositeTiles[tileY * m_CompositeTilesX + tileX]) {
+					m_DirtyCompositeTiles[tileY * m_CompositeTilesX + tileX] = false;
+					tileX++;
+				}
+				int rectX = runStart * c_NetworkCompositeTileSize;
+				int rectY = tileY * c_NetworkCompositeTileSize;
+				CompositeFrameRect(rectX, rectY, std::min((tileX - runStart) * c_NetworkCompositeTileSize, dst_bmp->w - rectX), std::min(static_cast<int>(c_NetworkCompositeTileSize), dst_bmp->h - rectY));
+			}
+		}
+
+		DrawPostEffects(m_CurrentFrame);
+
+		g_PerformanceMan.SetCurrentPing(GetPing());
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::CompositeFrameRect(int x, int y, int width, int height) {
 		BITMAP *src_bmp = g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0);
 		BITMAP *dst_bmp = g_FrameMan.GetNetworkBackBuffer8Ready(0);
 
 		BITMAP *src_gui_bmp = g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
 		BITMAP *dst_gui_bmp = g_FrameMan.GetNetworkBackBufferGUI8Ready(0);
 
-		// Have to clear to color to fallback if there's no skybox on client
-		clear_to_color(dst_bmp, g_BlackColor);
-		clear_to_color(dst_gui_bmp, g_MaskColor);
-
-		// Draw Scene background
-		int sourceX = m_TargetPos[m_CurrentFrame].m_X;
-		int sourceY = m_TargetPos[m_CurrentFrame].m_Y;
-		int destX = 0;
-		int destY = 0;
-
-		DrawBackgrounds(dst_bmp);
-		masked_blit(m_SceneBackgroundBitmap, dst_bmp, sourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
-		
-		if (sourceX < 0) {
-			// Draw if the out of seam portion is to the left
-			int newSourceX = m_SceneBackgroundBitmap->w + sourceX;
-
-			masked_blit(m_SceneBackgroundBitmap, dst_bmp, newSourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
-		} else if (sourceX + g_FrameMan.GetResX() >= m_SceneBackgroundBitmap->w) {
-			// Draw if the out of seam portion is to the right
-			int newDestX = m_SceneBackgroundBitmap->w - sourceX;
-			int width = g_FrameMan.GetResX() - newDestX;
-
-			masked_blit(m_SceneBackgroundBitmap, dst_bmp, 0, sourceY, newDestX, destY, width, src_bmp->h);
+		blit(m_BackgroundCompositeBitmap, dst_bmp, x, y, x, y, width, height);
+		DrawSceneLayerRect(m_SceneBackgroundBitmap, dst_bmp, x, y, width, height);
+		masked_blit(src_bmp, dst_bmp, x, y, x, y, width, height);
+		DrawSceneLayerRect(m_SceneForegroundBitmap, dst_bmp, x, y, width, height);
+
+		// The GUI buffer has nothing under it, so a plain copy gives the same result as clearing to mask color and masked blitting over it
+		blit(src_gui_bmp, dst_gui_bmp, x, y, x, y, width, height);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::DrawSceneLayerRect(BITMAP *sceneBitmap, BITMAP *targetBitmap, int x, int y, int width, int height) const {
+		if (!sceneBitmap || sceneBitmap->w <= 0) {
+			return;
 		}
+		int sourceX = (static_cast<int>(m_TargetPos[m_CurrentFrame].m_X) + x) % sceneBitmap->w;
+		if (sourceX < 0) { sourceX += sceneBitmap->w; }
+		int sourceY = static_cast<int>(m_TargetPos[m_CurrentFrame].m_Y) + y;
+
+		// Split the rectangle where it crosses the scene seam
+		int destX = x;
+		int remainingWidth = width;
+		while (remainingWidth > 0) {
+			int blitWidth = std::min(remainingWidth, sceneBitmap->w - sourceX);
+			masked_blit(sceneBitmap, targetBitmap, sourceX, sourceY, destX, y, blitWidth, height);
+			destX += blitWidth;
+			remainingWidth -= blitWidth;
+			sourceX = 0;
+		}
+	}
 
-		//draw_sprite(src_bmp, dst_bmp, 0, 0);
-		masked_blit(src_bmp, dst_bmp, 0, 0, 0, 0, src_bmp->w, src_bmp->h);
-		masked_blit(src_gui_bmp, dst_gui_bmp, 0, 0, 0, 0, src_bmp->w, src_bmp->h);
-		masked_blit(m_SceneForegroundBitmap, dst_bmp, sourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-		if (sourceX < 0) {
-			// Draw if the out of seam portion is to the left
-			int newSourceX = m_SceneForegroundBitmap->w + sourceX;
+	void NetworkClient::MarkCompositeRectDirty(int x, int y, int width, int height) {
+		if (m_DirtyCompositeTiles.empty() || width <= 0 || height <= 0 || x + width <= 0 || y + height <= 0) {
+			return;
+		}
+		int firstTileX = std::max(x, 0) / c_NetworkCompositeTileSize;
+		int firstTileY = std::max(y, 0) / c_NetworkCompositeTileSize;
+		int lastTileX = std::min((x + width - 1) / c_NetworkCompositeTileSize, m_CompositeTilesX - 1);
+		int lastTileY = std::min((y + height - 1) / c_NetworkCompositeTileSize, m_CompositeTilesY - 1);
+
+		for (int tileY = firstTileY; tileY <= lastTileY; tileY++) {
+			for (int tileX = firstTileX; tileX <= lastTileX; tileX++) {
+				m_DirtyCompositeTiles[tileY * m_CompositeTilesX + tileX] = true;
+			}
+		}
+	}
 
-			masked_blit(m_SceneForegroundBitmap, dst_bmp, newSourceX, sourceY, destX, destY, src_bmp->w, src_bmp->h);
-		} else if (sourceX + g_FrameMan.GetResX() >= m_SceneForegroundBitmap->w) {
-			// Draw if the out of seam portion is to the right
-			int newDestX = m_SceneForegroundBitmap->w - sourceX;
-			int width = g_FrameMan.GetResX() - newDestX;
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-			masked_blit(m_SceneForegroundBitmap, dst_bmp, 0, sourceY, newDestX, destY, width, src_bmp->h);
+	void NetworkClient::DecodePendingFrameBoxes() {
+		if (m_PendingBoxJobs.empty()) {
+			return;
+		}
+		if (m_DecodeThreads.empty()) {
+			// Leave one core for the main thread, which decodes alongside the workers
+			int threadCount = std::min(static_cast<int>(std::thread::hardware_concurrency()) - 1, static_cast<int>(c_MaxNetworkDecodeThreads));
+			for (int i = 0; i < threadCount; i++) {
+				m_DecodeThreads.emplace_back(&NetworkClient::DecodeThreadFunction, this, m_DecodeBatch);
+			}
 		}
 
-		DrawPostEffects(m_CurrentFrame);
+		m_NextBoxJob = 0;
+		{
+			std::lock_guard<std::mutex> decodeLock(m_DecodeMutex);
+			m_DecodeWorkersFinished = 0;
+			m_DecodeBatch++;
+		}
+		m_DecodeWorkAvailable.notify_all();
 
-		g_PerformanceMan.SetCurrentPing(GetPing());
+		std::vector<unsigned char> pixelBuffer(std::numeric_limits<unsigned short>::max());
+		DecodeFrameBoxes(pixelBuffer.data());
+
+		std::unique_lock<std::mutex> decodeLock(m_DecodeMutex);
+		m_DecodeWorkDone.wait(decodeLock, [this] { return m_DecodeWorkersFinished == static_cast<int>(m_DecodeThreads.size()); });
+		decodeLock.unlock();
+
+#if defined DEBUG_BUILD || defined MIN_DEBUG_BUILD
+		if (g_UInputMan.KeyHeld(KEY_0)) {
+			for (const FrameBoxDecodeJob &boxJob : m_PendingBoxJobs) {
+				if (boxJob.Header.DataSize > 0) {
+					BITMAP *bmp = (boxJob.Header.Layer == 0) ? g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0) : g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+					rect(bmp, boxJob.Header.BoxX, boxJob.Header.BoxY, boxJob.Header.BoxX + boxJob.Header.BoxWidth - 1, boxJob.Header.BoxY + boxJob.Header.BoxHeight - 1, g_BlackColor);
+				}
+			}
+		}
+#endif
+		m_PendingBoxJobs.clear();
+		m_PendingBoxData.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::DecodeFrameBoxes(unsigned char *pixelBuffer) {
+		int jobCount = static_cast<int>(m_PendingBoxJobs.size());
+
+		// Boxes never overlap, so each one can be written to the intermediate buffers without any locking
+		for (int jobIndex = m_NextBoxJob++; jobIndex < jobCount; jobIndex = m_NextBoxJob++) {
+			const MsgFrameBox &boxData = m_PendingBoxJobs[jobIndex].Header;
+			const BITMAP *bmp = (boxData.Layer == 0) ? g_FrameMan.GetNetworkBackBufferIntermediate8Ready(0) : g_FrameMan.GetNetworkBackBufferIntermediateGUI8Ready(0);
+
+			if (boxData.DataSize == 0) {
+				for (int y = 0; y < boxData.BoxHeight; y++) {
+					memset(bmp->line[boxData.BoxY + y] + boxData.BoxX, g_MaskColor, boxData.BoxWidth);
+				}
+			} else {
+				const unsigned char *lineAddr = &m_PendingBoxData[m_PendingBoxJobs[jobIndex].DataOffset];
+				if (boxData.DataSize != boxData.UncompressedSize) {
+					LZ4_decompress_safe((const char *)lineAddr, (char *)pixelBuffer, boxData.DataSize, boxData.UncompressedSize);
+					lineAddr = pixelBuffer;
+				}
+				// Copy box to bitmap line by line
+				for (int y = 0; y < boxData.BoxHeight; y++) {
+					memcpy(bmp->line[boxData.BoxY + y] + boxData.BoxX, lineAddr, boxData.BoxWidth);
+					lineAddr += boxData.BoxWidth;
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkClient::DecodeThreadFunction(unsigned int startingBatch) {
+		std::vector<unsigned char> pixelBuffer(std::numeric_limits<unsigned short>::max());
+		unsigned int lastBatch = startingBatch;
+
+		while (true) {
+			{
+				std::unique_lock<std::mutex> decodeLock(m_DecodeMutex);
+				m_DecodeWorkAvailable.wait(decodeLock, [this, lastBatch] { return m_StopDecodeThreads || m_DecodeBatch != lastBatch; });
+				if (m_StopDecodeThreads) {
+					return;
+				}
+				lastBatch = m_DecodeBatch;
+			}
+			DecodeFrameBoxes(pixelBuffer.data());
+			{
+				std::lock_guard<std::mutex> decodeLock(m_DecodeMutex);
+				m_DecodeWorkersFinished++;
+			}
+			m_DecodeWorkDone.notify_one();
+		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -945,6 +1141,9 @@ namespace RTE {
 			if (m_CurrentSceneLayerReceived == 1) { masked_stretch_blit(m_SceneBackgroundBitmap, dst_bmp, 0, 0, bmp->w, bmp->h, x, y, w, h); }
 
 			masked_stretch_blit(bmp, dst_bmp, 0, 0, bmp->w, bmp->h, x, y, w, h);
+
+			// The loading animation overwrote the last composited frame
+			m_FullCompositeRedraw = true;
 		}
 
 		// Detect short mouse events like presses and releases. Holds are detected during input send
@@ -1060,30 +1259,6 @@ namespace RTE {
 					msg += packet->systemAddress.ToString(true);
 					g_ConsoleMan.PrintString(msg);
 					break;
-				case ID_SRV_FRAME_SETUP:
-					ReceiveFrameSetupMsg(packet);
-					break;
-				case ID_SRV_FRAME_LINE:
-					ReceiveFrameLineMsg(packet);
-					break;
-				case ID_SRV_FRAME_BOX:
-					ReceiveFrameBoxMsg(packet);
-					break;
-				case ID_SRV_SCENE_SETUP:
-					ReceiveSceneSetupMsg(packet);
-					break;
-				case ID_SRV_SCENE:
-					ReceiveSceneMsg(packet);
-					break;
-				case ID_SRV_SCENE_END:
-					ReceiveSceneEndMsg();
-					break;
-				case ID_SRV_ACCEPTED:
-					ReceiveAcceptedMsg();
-					break;
-				case ID_SRV_TERRAIN:
-					ReceiveTerrainChangeMsg(packet);
-					break;
 				case ID_NAT_SERVER_GUID:
 					ReceiveServerGUIDAnswer(packet);
 					break;
@@ -1091,15 +1266,6 @@ namespace RTE {
 					m_IsConnected = false;
 					m_IsNATPunched = false;
 					break;
-				case ID_SRV_POST_EFFECTS:
-					ReceivePostEffectsMsg(packet);
-					break;
-				case ID_SRV_SOUND_EVENTS:
-					ReceiveSoundEventsMsg(packet);
-					break;
-				case ID_SRV_MUSIC_EVENTS:
-					ReceiveMusicEventsMsg(packet);
-					break;
 				case ID_NAT_TARGET_NOT_CONNECTED:
 					g_ConsoleMan.PrintString("Failed: ID_NAT_TARGET_NOT_CONNECTED");
 					m_IsConnected = false;
@@ -1126,8 +1292,148 @@ namespace RTE {
 					ConnectNAT(packet->systemAddress);
 					break;
 				default:
+					HandleServerStreamPacket(packet);
 					break;
 			}
 		}
 	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool NetworkClient::HandleServerStreamPacket(RakNet::Packet *packet) {
+		switch (GetPacketIdentifier(packet)) {
+			case ID_SRV_FRAME_SETUP:
+				ReceiveFrameSetupMsg(packet);
+				break;
+			case ID_SRV_FRAME_LINE:
+				ReceiveFrameLineMsg(packet);
+				break;
+			case ID_SRV_FRAME_BOX:
+				ReceiveFrameBoxMsg(packet);
+				break;
+			case ID_SRV_SCENE_SETUP:
+				ReceiveSceneSetupMsg(packet);
+				break;
+			case ID_SRV_SCENE:
+				ReceiveSceneMsg(packet);
+				break;
+			case ID_SRV_SCENE_END:
+				ReceiveSceneEndMsg();
+				break;
+			case ID_SRV_ACCEPTED:
+				ReceiveAcceptedMsg();
+				break;
+			case ID_SRV_TERRAIN:
+				ReceiveTerrainChangeMsg(packet);
+				break;
+			case ID_SRV_POST_EFFECTS:
+				ReceivePostEffectsMsg(packet);
+				break;
+			case ID_SRV_SOUND_EVENTS:
+				ReceiveSoundEventsMsg(packet);
+				break;
+			case ID_SRV_MUSIC_EVENTS:
+				ReceiveMusicEventsMsg(packet);
+				break;
+			default:
+				return false;
+		}
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool NetworkClient::RunReplay(const std::string &replayFilePath, bool playAtMaxSpeed) {
+		std::ifstream replayFile(replayFilePath, std::ios::in | std::ios::binary);
+		if (!replayFile.is_open()) {
+			g_ConsoleMan.PrintString("CLIENT: Failed to open network replay file " + replayFilePath);
+			return false;
+		}
+
+		NetworkReplayHeader header;
+		if (!replayFile.read(reinterpret_cast<char *>(&header), sizeof(NetworkReplayHeader)) || std::strncmp(header.Magic, "CCNR", sizeof(header.Magic)) != 0 || header.Version != c_NetworkReplayVersion) {
+			g_ConsoleMan.PrintString("CLIENT: " + replayFilePath + " is not a valid network replay file or was recorded with an incompatible version");
+			return false;
+		}
+		if (header.ResolutionX != g_FrameMan.GetResX() || header.ResolutionY != g_FrameMan.GetResY()) {
+			g_ConsoleMan.PrintString("CLIENT: WARNING: Replay was recorded at " + std::to_string(header.ResolutionX) + "x" + std::to_string(header.ResolutionY) + ", frames will be cropped to the current resolution");
+		}
+
+		// Load the whole stream up front so file reading doesn't skew the measurements
+		std::vector<unsigned char> replayData((std::istreambuf_iterator<char>(replayFile)), std::istreambuf_iterator<char>());
+		replayFile.close();
+
+		m_IsReplaying = true;
+		m_ReceivedData = 0;
+		m_CompressedData = 0;
+
+		RakNet::Packet packet;
+		packet.systemAddress = RakNet::UNASSIGNED_SYSTEM_ADDRESS;
+		packet.guid = RakNet::UNASSIGNED_RAKNET_GUID;
+		packet.deleteData = false;
+		packet.wasGeneratedLocally = true;
+
+		unsigned int framesDrawn = 0;
+		unsigned int messagesHandled = 0;
+		long long decodeTime = 0;
+		long long drawTime = 0;
+		long long replayStartTime = g_TimerMan.GetAbsoluteTime();
+
+		size_t readPos = 0;
+		while (readPos + sizeof(NetworkReplayRecord) <= replayData.size()) {
+			const NetworkReplayRecord *record = reinterpret_cast<const NetworkReplayRecord *>(&replayData[readPos]);
+			readPos += sizeof(NetworkReplayRecord);
+			if (record->DataSize == 0 || readPos + record->DataSize > replayData.size()) {
+				break;
+			}
+			packet.data = &replayData[readPos];
+			packet.length = record->DataSize;
+			packet.bitSize = BYTES_TO_BITS(record->DataSize);
+			readPos += record->DataSize;
+
+			bool isFrameSetup = GetPacketIdentifier(&packet) == ID_SRV_FRAME_SETUP;
+
+			if (!playAtMaxSpeed) {
+				while ((g_TimerMan.GetAbsoluteTime() - replayStartTime) / 1000 < record->TimeMS) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				}
+			}
+
+			long long handleStartTime = g_TimerMan.GetAbsoluteTime();
+			if (!HandleServerStreamPacket(&packet)) {
+				continue;
+			}
+			long long handleTime = g_TimerMan.GetAbsoluteTime() - handleStartTime;
+			messagesHandled++;
+
+			// Frame setup messages decompress the boxes and draw the previously received frame before setting up the next one
+			if (isFrameSetup) {
+				drawTime += handleTime;
+				framesDrawn++;
+
+				if (!playAtMaxSpeed) {
+					blit(g_FrameMan.GetNetworkBackBuffer8Ready(0), g_FrameMan.GetBackBuffer8(), 0, 0, 0, 0, g_FrameMan.GetBackBuffer8()->w, g_FrameMan.GetBackBuffer8()->h);
+					masked_blit(g_FrameMan.GetNetworkBackBufferGUI8Ready(0), g_FrameMan.GetBackBuffer8(), 0, 0, 0, 0, g_FrameMan.GetBackBuffer8()->w, g_FrameMan.GetBackBuffer8()->h);
+					blit(g_FrameMan.GetBackBuffer8(), g_FrameMan.GetBackBuffer32(), 0, 0, 0, 0, g_FrameMan.GetBackBuffer8()->w, g_FrameMan.GetBackBuffer8()->h);
+					g_FrameMan.FlipFrameBuffers();
+					g_AudioMan.Update();
+				}
+			} else {
+				decodeTime += handleTime;
+			}
+		}
+		long long totalTime = g_TimerMan.GetAbsoluteTime() - replayStartTime;
+
+		char buf[256];
+		std::snprintf(buf, sizeof(buf), "CLIENT: Replayed %u messages and %u frames in %.2f ms (%.1f FPS)", messagesHandled, framesDrawn, static_cast<double>(totalTime) / 1000.0, framesDrawn > 0 ? static_cast<double>(framesDrawn) / (static_cast<double>(totalTime) / 1000000.0) : 0.0);
+		g_ConsoleMan.PrintString(buf);
+		std::snprintf(buf, sizeof(buf), "CLIENT: Receive %.3f ms/frame, Decode and DrawFrame %.3f ms/frame", framesDrawn > 0 ? static_cast<double>(decodeTime) / 1000.0 / framesDrawn : 0.0, framesDrawn > 0 ? static_cast<double>(drawTime) / 1000.0 / framesDrawn : 0.0);
+		g_ConsoleMan.PrintString(buf);
+		std::snprintf(buf, sizeof(buf), "CLIENT: Stream size %zu bytes, frame data %li bytes compressed from %li bytes", replayData.size(), m_ReceivedData, m_CompressedData);
+		g_ConsoleMan.PrintString(buf);
+
+		m_IsReplaying = false;
+		m_IsRegistered = false;
+		return true;
+	}
 }
\ No newline at end of file
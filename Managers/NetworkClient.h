@@ -49,7 +49,7 @@ namespace RTE {
 		/// <summary>
 		/// Destroys and resets (through Clear()) the NetworkClient object.
 		/// </summary>
-		void Destroy() { Clear(); }
+		void Destroy();
 #pragma endregion
 
 #pragma region Getters
@@ -58,6 +58,12 @@ namespace RTE {
 		/// </summary>
 		/// <returns>Whether the client is connected and registered to a server.</returns>
 		bool IsConnectedAndRegistered() const { return m_IsConnected && m_IsRegistered; }
+
+		/// <summary>
+		/// Gets whether a recorded network stream is being played back instead of receiving one from a server.
+		/// </summary>
+		/// <returns>Whether a network replay is being played back.</returns>
+		bool IsReplaying() const { return m_IsReplaying; }
 #pragma endregion
 
 #pragma region Concrete Methods
@@ -108,6 +114,17 @@ namespace RTE {
 		RakNet::SystemAddress ConnectBlocking(RakNet::RakPeerInterface *rakPeer, const char *address, unsigned short port);
 #pragma endregion
 
+#pragma region Network Replay Handling
+		/// <summary>
+		/// Loads a network stream recorded by the server and plays it back offline through the same message handlers used for a live connection.
+		/// Blocks until the whole replay was played, then prints decode and draw throughput statistics to the console.
+		/// </summary>
+		/// <param name="replayFilePath">Path to the replay file to play back.</param>
+		/// <param name="playAtMaxSpeed">Whether to play back as fast as possible without presenting frames, or at the recorded pace while presenting every frame.</param>
+		/// <returns>Whether the replay file was loaded and played back successfully.</returns>
+		bool RunReplay(const std::string &replayFilePath, bool playAtMaxSpeed);
+#pragma endregion
+
 #pragma region Class Info
 		/// <summary>
 		/// Gets the class name of this object.
@@ -169,6 +186,37 @@ namespace RTE {
 		int m_MouseButtonPressedState[3]; //!<
 		int m_MouseButtonReleasedState[3]; //!<
 
+		bool m_IsReplaying; //!< Whether a recorded network stream is being played back.
+
+		/// <summary>
+		/// A received frame box waiting to be decompressed into its intermediate buffer by the decode workers.
+		/// </summary>
+		struct FrameBoxDecodeJob {
+			MsgFrameBox Header; //!< Copy of the received box message header.
+			size_t DataOffset; //!< Offset of the box's pixel data in m_PendingBoxData.
+		};
+
+		std::vector<FrameBoxDecodeJob> m_PendingBoxJobs; //!< Frame boxes received since the last frame was drawn, decompressed in one go by the decode workers right before drawing.
+		std::vector<unsigned char> m_PendingBoxData; //!< The compressed pixel data of all pending frame boxes, back to back.
+		std::atomic<int> m_NextBoxJob; //!< Index of the next pending frame box a decode worker should pick up.
+
+		std::vector<std::thread> m_DecodeThreads; //!< Worker threads that decompress frame boxes in parallel.
+		std::mutex m_DecodeMutex; //!< Mutex guarding the decode worker synchronization state.
+		std::condition_variable m_DecodeWorkAvailable; //!< Signaled when a new batch of frame boxes is ready to be decompressed, or when the workers should stop.
+		std::condition_variable m_DecodeWorkDone; //!< Signaled when a decode worker finished its share of the current batch.
+		unsigned int m_DecodeBatch; //!< Number of the current batch of frame boxes, used by the workers to tell new batches apart from spurious wakeups.
+		int m_DecodeWorkersFinished; //!< Number of decode workers that finished the current batch.
+		bool m_StopDecodeThreads; //!< Whether the decode workers should exit.
+
+		BITMAP *m_BackgroundCompositeBitmap; //!< The background layers as composited for the last drawn frame. Only redrawn when the view or the layer offsets change.
+		std::vector<bool> m_DirtyCompositeTiles; //!< Which screen tiles changed since the last drawn frame and need to be composited again.
+		int m_CompositeTilesX; //!< Number of composite tiles horizontally.
+		int m_CompositeTilesY; //!< Number of composite tiles vertically.
+		bool m_FullCompositeRedraw; //!< Whether the next frame must be composited in its entirety, e.g. because the view moved.
+		Vector m_CompositedTargetPos; //!< The view target position of the last drawn frame.
+		float m_CompositedLayerOffsetX[c_MaxLayersStoredForNetwork]; //!< The horizontal background layer offsets of the last drawn frame.
+		float m_CompositedLayerOffsetY[c_MaxLayersStoredForNetwork]; //!< The vertical background layer offsets of the last drawn frame.
+
 	private:
 
 #pragma region Update Breakdown
@@ -176,6 +224,13 @@ namespace RTE {
 		/// 
 		/// </summary>
 		void HandleNetworkPackets();
+
+		/// <summary>
+		/// Handles a single message of the server's outgoing stream, whether it was received from a live connection or read from a replay file.
+		/// </summary>
+		/// <param name="packet">The packet holding the message to handle.</param>
+		/// <returns>Whether the message was part of the server stream and was handled.</returns>
+		bool HandleServerStreamPacket(RakNet::Packet *packet);
 #pragma endregion
 
 #pragma region Network Event Handling
@@ -307,6 +362,54 @@ namespace RTE {
 		/// 
 		/// </summary>
 		void DrawFrame();
+
+		/// <summary>
+		/// Composites a rectangle of the received frame over the background layers and scene layers into the final network back buffers.
+		/// </summary>
+		/// <param name="x">Left edge of the rectangle, in screen coordinates.</param>
+		/// <param name="y">Top edge of the rectangle, in screen coordinates.</param>
+		/// <param name="width">Width of the rectangle.</param>
+		/// <param name="height">Height of the rectangle.</param>
+		void CompositeFrameRect(int x, int y, int width, int height);
+
+		/// <summary>
+		/// Draws a rectangle of a scene layer bitmap as seen from the current view target onto a target bitmap, wrapping around the scene seam.
+		/// </summary>
+		/// <param name="sceneBitmap">The scene layer bitmap to draw.</param>
+		/// <param name="targetBitmap">The bitmap to draw onto.</param>
+		/// <param name="x">Left edge of the rectangle, in screen coordinates.</param>
+		/// <param name="y">Top edge of the rectangle, in screen coordinates.</param>
+		/// <param name="width">Width of the rectangle.</param>
+		/// <param name="height">Height of the rectangle.</param>
+		void DrawSceneLayerRect(BITMAP *sceneBitmap, BITMAP *targetBitmap, int x, int y, int width, int height) const;
+
+		/// <summary>
+		/// Flags the composite tiles overlapping a screen rectangle as changed so they are composited again when the next frame is drawn.
+		/// </summary>
+		/// <param name="x">Left edge of the rectangle, in screen coordinates.</param>
+		/// <param name="y">Top edge of the rectangle, in screen coordinates.</param>
+		/// <param name="width">Width of the rectangle.</param>
+		/// <param name="height">Height of the rectangle.</param>
+		void MarkCompositeRectDirty(int x, int y, int width, int height);
+#pragma endregion
+
+#pragma region Frame Box Decoding
+		/// <summary>
+		/// Decompresses all pending frame boxes into the intermediate buffers, spreading the work over the decode workers. Blocks until all boxes are done.
+		/// </summary>
+		void DecodePendingFrameBoxes();
+
+		/// <summary>
+		/// Picks up pending frame boxes one at a time and decompresses them until none are left. Run by the decode workers and the calling thread alike.
+		/// </summary>
+		/// <param name="pixelBuffer">Scratch buffer to decompress into, large enough to hold the biggest possible box.</param>
+		void DecodeFrameBoxes(unsigned char *pixelBuffer);
+
+		/// <summary>
+		/// Function that runs in each decode worker thread, waiting for batches of frame boxes and decompressing them.
+		/// </summary>
+		/// <param name="startingBatch">The batch number at the time the worker was started, so the worker doesn't miss a batch that was issued before it got to wait for one.</param>
+		void DecodeThreadFunction(unsigned int startingBatch);
 #pragma endregion
 
 		/// <summary>
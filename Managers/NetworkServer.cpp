@@ -13,6 +13,8 @@
 #include "UInputMan.h"
 #include "TimerMan.h"
 #include "AudioMan.h"
+#include "PerformanceMan.h"
+#include "ProfileScope.h"
 
 #include "RakNetStatistics.h"
 #include "RakSleep.h"
@@ -30,6 +32,7 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::BackgroundSendThreadFunction(NetworkServer *server, short player) {
+		g_PerformanceMan.SetProfileThreadName("Network Send " + std::to_string(player));
 		while (server->IsServerModeEnabled() && server->IsPlayerConnected(player)) {
 			if (server->NeedToSendSceneSetupData(player) && server->IsSceneAvailable(player)) {
 				server->SendSceneSetupData(player);
@@ -92,6 +95,12 @@ namespace RTE {
 
 			m_ResetActivityVotes[i] = false;
 
+			m_RecordingStartTime[i] = 0;
+
+			m_TerrainChangeTilesX[i] = 0;
+			m_TerrainChangeTilesY[i] = 0;
+			m_HasPendingTerrainChanges[i] = false;
+
 			m_FrameNumbers[i] = 0;
 
 			m_Ping[i] = 0;
@@ -141,6 +150,7 @@ namespace RTE {
 		m_BoxWidth = 32;
 		m_BoxHeight = 44;
 		m_NatServerConnected = false;
+		m_NullSinkPlayerCount = 0;
 		m_LastPackedReceived.Reset();
 	}
 
@@ -186,6 +196,7 @@ namespace RTE {
 		RakNet::RakPeerInterface::DestroyInstance(m_Server);
 
 		for (short i = 0; i < c_MaxClients; i++) {
+			StopRecording(i);
 			DestroyBackBuffer(i);
 
 			if (m_LZ4CompressionState[i]) { free(m_LZ4CompressionState[i]); }		
@@ -285,11 +296,35 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::RegisterTerrainChange(SceneMan::TerrainChange terrainChange) {
-		if (m_IsInServerMode) {
+		if (m_IsInServerMode && terrainChange.w > 0 && terrainChange.h > 0) {
+			int tilesX = (g_SceneMan.GetSceneWidth() + c_TerrainChangeTileSize - 1) / c_TerrainChangeTileSize;
+			int tilesY = (g_SceneMan.GetSceneHeight() + c_TerrainChangeTileSize - 1) / c_TerrainChangeTileSize;
+			if (tilesX <= 0 || tilesY <= 0) {
+				return;
+			}
+
+			int firstTileX = std::clamp(terrainChange.x / c_TerrainChangeTileSize, 0, tilesX - 1);
+			int firstTileY = std::clamp(terrainChange.y / c_TerrainChangeTileSize, 0, tilesY - 1);
+			int lastTileX = std::clamp((terrainChange.x + terrainChange.w - 1) / c_TerrainChangeTileSize, 0, tilesX - 1);
+			int lastTileY = std::clamp((terrainChange.y + terrainChange.h - 1) / c_TerrainChangeTileSize, 0, tilesY - 1);
+			short layer = terrainChange.back ? 1 : 0;
+
 			for (short player = 0; player < c_MaxClients; player++) {
 				if (IsPlayerConnected(player)) {
 					m_Mutex[player].lock();
-					m_PendingTerrainChanges[player].push(terrainChange);
+					// Scene changed since the bitsets were last sized, anything marked for the old scene is meaningless now
+					if (m_TerrainChangeTilesX[player] != tilesX || m_TerrainChangeTilesY[player] != tilesY) {
+						m_TerrainChangeTilesX[player] = tilesX;
+						m_TerrainChangeTilesY[player] = tilesY;
+						m_PendingTerrainChangeTiles[player][0].assign(tilesX * tilesY, false);
+						m_PendingTerrainChangeTiles[player][1].assign(tilesX * tilesY, false);
+					}
+					for (int tileY = firstTileY; tileY <= lastTileY; tileY++) {
+						for (int tileX = firstTileX; tileX <= lastTileX; tileX++) {
+							m_PendingTerrainChangeTiles[player][layer][tileY * tilesX + tileX] = true;
+						}
+					}
+					m_HasPendingTerrainChanges[player] = true;
 					m_Mutex[player].unlock();
 				}
 			}
@@ -357,12 +392,19 @@ namespace RTE {
 		if (!connected) { g_ConsoleMan.PrintString("SERVER: Could not accept connection"); }
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::SendToPlayer(short player, const char *data, int dataSize, PacketPriority priority, PacketReliability reliability) {
+		if (player >= m_NullSinkPlayerCount) { m_Server->Send(data, dataSize, priority, reliability, 0, m_ClientConnections[player].ClientId, false); }
+		RecordMessage(player, data, dataSize);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendAcceptedMsg(short player) {
 		MsgAccepted msg;
 		msg.Id = ID_SRV_ACCEPTED;
-		m_Server->Send((const char *)&msg, sizeof(MsgAccepted), HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+		SendToPlayer(player, (const char *)&msg, sizeof(MsgAccepted), HIGH_PRIORITY, RELIABLE_SEQUENCED);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -381,6 +423,8 @@ namespace RTE {
 				//delete m_ClientConnections[index].SendThread;
 				m_ClientConnections[index].SendThread = 0;
 
+				StopRecording(index);
+
 				m_SendSceneSetupData[index] = true;
 				m_SendSceneData[index] = false;
 				m_SendFrameData[index] = false;
@@ -413,6 +457,7 @@ namespace RTE {
 
 				m_Server->SetTimeoutTime(5000, m_ClientConnections[index].ClientId);
 
+				StartRecording(index);
 				m_ClientConnections[index].SendThread = new std::thread(BackgroundSendThreadFunction, this, index);
 				SendAcceptedMsg(index);
 
@@ -594,7 +639,7 @@ namespace RTE {
 			//If one more sound would overflow the container, send sounds now then reset to continue
 			if ((msg->SoundEventsCount * sizeof(AudioMan::NetworkSoundData)) >= (c_MaxPixelLineBufferSize - sizeof(AudioMan::NetworkSoundData) - sizeof(MsgSoundEvents))) {
 				int payloadSize = sizeof(MsgSoundEvents) + sizeof(AudioMan::NetworkSoundData) * msg->SoundEventsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->SoundEventsCount = 0;
 				sndDataPtr = (AudioMan::NetworkSoundData *)((char *)msg + sizeof(MsgSoundEvents));
 
@@ -612,7 +657,7 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgSoundEvents) + sizeof(AudioMan::NetworkSoundData) * msg->SoundEventsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
 			m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
 			m_SoundDataSentTotal[player] += payloadSize;
@@ -650,7 +695,7 @@ namespace RTE {
 
 			if (msg->MusicEventsCount >= 4) {
 				int payloadSize = sizeof(MsgMusicEvents) + sizeof(AudioMan::NetworkMusicData) * msg->MusicEventsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->MusicEventsCount = 0;
 				musDataPtr = (AudioMan::NetworkMusicData *)((char *)msg + sizeof(MsgMusicEvents));
 
@@ -669,7 +714,7 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgMusicEvents) + sizeof(AudioMan::NetworkMusicData) * msg->MusicEventsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
 			m_SoundDataSentCurrent[player][STAT_CURRENT] += payloadSize;
 			m_SoundDataSentTotal[player] += payloadSize;
@@ -729,7 +774,7 @@ namespace RTE {
 
 		int payloadSize = sizeof(MsgSceneSetup);
 
-		m_Server->Send((const char *)&msgSceneSetup, payloadSize, HIGH_PRIORITY, RELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+		SendToPlayer(player, (const char *)&msgSceneSetup, payloadSize, HIGH_PRIORITY, RELIABLE_SEQUENCED);
 
 		m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 		m_DataSentTotal[player] += payloadSize;
@@ -768,6 +813,8 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendSceneData(short player) {
+		ProfileScope profileScope("NetworkServer::SendSceneData");
+
 		// Check for congestion
 		RakNet::RakNetStatistics rns;
 
@@ -833,7 +880,7 @@ namespace RTE {
 
 					int payloadSize = sceneData->DataSize + sizeof(MsgSceneLine);
 
-					m_Server->Send((const char *)sceneData, payloadSize, HIGH_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+					SendToPlayer(player, (const char *)sceneData, payloadSize, HIGH_PRIORITY, RELIABLE);
 
 					m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 					m_DataSentTotal[player] += payloadSize;
@@ -880,12 +927,11 @@ namespace RTE {
 
 	void NetworkServer::ClearTerrainChangeQueue(short player) {
 		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty()) {
-			m_PendingTerrainChanges[player].pop();
-		}
-		while (!m_CurrentTerrainChanges[player].empty()) {
-			m_CurrentTerrainChanges[player].pop();
+		for (short layer = 0; layer < 2; layer++) {
+			std::fill(m_PendingTerrainChangeTiles[player][layer].begin(), m_PendingTerrainChangeTiles[player][layer].end(), false);
+			m_CurrentTerrainChangeTiles[player][layer].clear();
 		}
+		m_HasPendingTerrainChanges[player] = false;
 		m_Mutex[player].unlock();
 	}
 
@@ -895,7 +941,7 @@ namespace RTE {
 		bool result;
 
 		m_Mutex[player].lock();
-		result = !m_PendingTerrainChanges[player].empty();
+		result = m_HasPendingTerrainChanges[player];
 		m_Mutex[player].unlock();
 
 		return result;
@@ -905,51 +951,94 @@ namespace RTE {
 
 	void NetworkServer::ProcessTerrainChanges(short player) {
 		m_Mutex[player].lock();
-		while (!m_PendingTerrainChanges[player].empty()) {
-			m_CurrentTerrainChanges[player].push(m_PendingTerrainChanges[player].front());
-			m_PendingTerrainChanges[player].pop();
+		if (!m_HasPendingTerrainChanges[player]) {
+			m_Mutex[player].unlock();
+			return;
+		}
+		int tilesX = m_TerrainChangeTilesX[player];
+		int tilesY = m_TerrainChangeTilesY[player];
+		for (short layer = 0; layer < 2; layer++) {
+			m_CurrentTerrainChangeTiles[player][layer].swap(m_PendingTerrainChangeTiles[player][layer]);
+			m_PendingTerrainChangeTiles[player][layer].assign(tilesX * tilesY, false);
 		}
+		m_HasPendingTerrainChanges[player] = false;
 		m_Mutex[player].unlock();
 
-		while (!m_CurrentTerrainChanges[player].empty()) {
-			int maxSize = 1280;
-
-			SceneMan::TerrainChange terrainChange = m_CurrentTerrainChanges[player].front();
-			m_CurrentTerrainChanges[player].pop();
-
-			// Fragment region if it does not fit one packet
-			if (terrainChange.w * terrainChange.h > maxSize) {
-				int size = 0;
-				int height = 1;
-				int heightStart = 0;
-
-				for (int y = 0; y < terrainChange.h; y++) {
-					height++;
-					size += terrainChange.w;
-
-					// Store changed block if the size is over the MTU or if it's the last block.
-					if (size + terrainChange.w >= maxSize || y == terrainChange.h - 1) {
-						SceneMan::TerrainChange tcf;
-						tcf.x = terrainChange.x;
-						tcf.y = terrainChange.y + heightStart;
-						tcf.w = terrainChange.w;
-						tcf.h = height;
-						tcf.back = terrainChange.back;
-						tcf.color = terrainChange.color;
-
-						SendTerrainChangeMsg(player, tcf);
-
-						size = 0;
-						heightStart = y;
-						height = 1;
+		// Widest run of tiles that still fits into a single terrain change packet row.
+		const int maxRunLength = std::max(1, 1280 / c_TerrainChangeTileSize);
+
+		for (short layer = 0; layer < 2; layer++) {
+			std::vector<bool> &dirtyTiles = m_CurrentTerrainChangeTiles[player][layer];
+			if (dirtyTiles.size() != static_cast<size_t>(tilesX * tilesY)) {
+				continue;
+			}
+			for (int tileY = 0; tileY < tilesY; tileY++) {
+				int tileX = 0;
+				while (tileX < tilesX) {
+					if (!dirtyTiles[tileY * tilesX + tileX]) {
+						tileX++;
+						continue;
 					}
+					// Find a horizontal run of dirty tiles, then grow it downwards for as long as every tile under the run is dirty as well.
+					int runStart = tileX;
+					while (tileX < tilesX && tileX - runStart < maxRunLength && dirtyTiles[tileY * tilesX + tileX]) {
+						dirtyTiles[tileY * tilesX + tileX] = false;
+						tileX++;
+					}
+					int runEnd = tileX;
+					int runBottom = tileY + 1;
+					while (runBottom < tilesY) {
+						bool rowIsDirty = true;
+						for (int runTileX = runStart; runTileX < runEnd && rowIsDirty; runTileX++) {
+							rowIsDirty = dirtyTiles[runBottom * tilesX + runTileX];
+						}
+						if (!rowIsDirty) {
+							break;
+						}
+						for (int runTileX = runStart; runTileX < runEnd; runTileX++) {
+							dirtyTiles[runBottom * tilesX + runTileX] = false;
+						}
+						runBottom++;
+					}
+
+					SceneMan::TerrainChange terrainChange;
+					terrainChange.x = runStart * c_TerrainChangeTileSize;
+					terrainChange.y = tileY * c_TerrainChangeTileSize;
+					terrainChange.w = std::min(runEnd * c_TerrainChangeTileSize, g_SceneMan.GetSceneWidth()) - terrainChange.x;
+					terrainChange.h = std::min(runBottom * c_TerrainChangeTileSize, g_SceneMan.GetSceneHeight()) - terrainChange.y;
+					terrainChange.back = layer == 1;
+					terrainChange.color = g_MaskColor;
+
+					if (terrainChange.w > 0 && terrainChange.h > 0) { SendFragmentedTerrainChange(player, terrainChange); }
 				}
-			} else {
-				SendTerrainChangeMsg(player, terrainChange);
 			}
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::SendFragmentedTerrainChange(short player, SceneMan::TerrainChange terrainChange) {
+		// Single pixel changes are sent as a color value instead of bitmap data, so read the color the pixel currently has.
+		if (terrainChange.w == 1 && terrainChange.h == 1) {
+			SLTerrain *terrain = g_SceneMan.GetScene()->GetTerrain();
+			const BITMAP *bmp = terrainChange.back ? terrain->GetBGColorBitmap() : terrain->GetFGColorBitmap();
+			terrainChange.color = bmp->line[terrainChange.y][terrainChange.x];
+			SendTerrainChangeMsg(player, terrainChange);
+			return;
+		}
+
+		int maxSize = 1280;
+		int rowsPerMessage = std::max(1, maxSize / terrainChange.w);
+
+		// Fragment region if it does not fit one packet
+		for (int rowStart = 0; rowStart < terrainChange.h; rowStart += rowsPerMessage) {
+			SceneMan::TerrainChange terrainChangeFragment = terrainChange;
+			terrainChangeFragment.y = terrainChange.y + rowStart;
+			terrainChangeFragment.h = std::min(rowsPerMessage, terrainChange.h - rowStart);
+			SendTerrainChangeMsg(player, terrainChangeFragment);
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::SendTerrainChangeMsg(short player, SceneMan::TerrainChange terrainChange) {
@@ -968,7 +1057,7 @@ namespace RTE {
 
 			int payloadSize = sizeof(MsgTerrainChange);
 
-			m_Server->Send((const char *)&msg, payloadSize, MEDIUM_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+			SendToPlayer(player, (const char *)&msg, payloadSize, MEDIUM_PRIORITY, RELIABLE);
 
 			m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 			m_DataSentTotal[player] += payloadSize;
@@ -1019,7 +1108,7 @@ namespace RTE {
 
 			int payloadSize = sizeof(MsgTerrainChange) + msg->DataSize;
 
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE, 0, m_ClientConnections[player].ClientId, false);
+			SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE);
 
 			m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 			m_DataSentTotal[player] += payloadSize;
@@ -1045,7 +1134,7 @@ namespace RTE {
 	void NetworkServer::SendSceneEndMsg(short player) {
 		MsgSceneEnd msg;
 		msg.Id = ID_SRV_SCENE_END;
-		m_Server->Send((const char *)&msg, sizeof(MsgSceneSetup), HIGH_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+		SendToPlayer(player, (const char *)&msg, sizeof(MsgSceneSetup), HIGH_PRIORITY, RELIABLE_ORDERED);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1081,7 +1170,7 @@ namespace RTE {
 
 		int payloadSize = sizeof(MsgSceneSetup);
 
-		m_Server->Send((const char *)&msgFrameSetup, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+		SendToPlayer(player, (const char *)&msgFrameSetup, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
 		m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 		m_DataSentTotal[player] += payloadSize;
@@ -1124,7 +1213,7 @@ namespace RTE {
 
 			if (msg->PostEffectsCount >= 75) {
 				int payloadSize = sizeof(MsgPostEffects) + sizeof(PostEffectNetworkData) * msg->PostEffectsCount;
-				m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+				SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 				msg->PostEffectsCount = 0;
 				effDataPtr = (PostEffectNetworkData *)((char *)msg + sizeof(MsgPostEffects));
 
@@ -1142,7 +1231,7 @@ namespace RTE {
 			//int sz = sizeof(size_t);
 
 			int payloadSize = sizeof(MsgPostEffects) + sizeof(PostEffectNetworkData) * msg->PostEffectsCount;
-			m_Server->Send((const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED, 0, m_ClientConnections[player].ClientId, false);
+			SendToPlayer(player, (const char *)msg, payloadSize, MEDIUM_PRIORITY, RELIABLE_ORDERED);
 
 			m_PostEffectDataSentCurrent[player][STAT_CURRENT] += payloadSize;
 			m_PostEffectDataSentTotal[player] += payloadSize;
@@ -1154,6 +1243,8 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	int NetworkServer::SendFrame(short player) {
+		ProfileScope profileScope("NetworkServer::SendFrame");
+
 		long long currentTicks = g_TimerMan.GetRealTickCount();
 		double fps = static_cast<double>(m_EncodingFps);
 		double secsPerFrame = 1.0 / fps;
@@ -1167,7 +1258,10 @@ namespace RTE {
 		// Return time to sleep till next frame in microseconds
 		m_MSecsSinceLastUpdate[player] = static_cast<long>(secsSinceLastFrame * 1000.0);
 
-		if (secsSinceLastFrame < secsPerFrame) {
+		// Null sink players have no client to keep up with, so they get a frame whenever asked
+		bool nullSink = player < m_NullSinkPlayerCount;
+
+		if (!nullSink && secsSinceLastFrame < secsPerFrame) {
 			SetThreadExitReason(player, NetworkServer::TOO_EARLY_TO_SEND);
 			return static_cast<int>((secsPerFrame - secsSinceLastFrame) * microSeconds);
 		}
@@ -1180,22 +1274,24 @@ namespace RTE {
 		m_LastFrameSentTime[player] = g_TimerMan.GetRealTickCount();
 
 		// Check for congestion
-		RakNet::RakNetStatistics rns;
+		if (!nullSink) {
+			RakNet::RakNetStatistics rns;
 
-		m_Server->GetStatistics(m_ClientConnections[player].ClientId, &rns);
+			m_Server->GetStatistics(m_ClientConnections[player].ClientId, &rns);
 
-		m_SendBufferBytes[player] = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
-		m_SendBufferMessages[player] = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
+			m_SendBufferBytes[player] = (int)rns.bytesInSendBuffer[MEDIUM_PRIORITY] + (int)rns.bytesInSendBuffer[HIGH_PRIORITY];
+			m_SendBufferMessages[player] = (int)rns.messageInSendBuffer[MEDIUM_PRIORITY] + (int)rns.messageInSendBuffer[HIGH_PRIORITY];
 
-		if (rns.isLimitedByCongestionControl) {
-			SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_LIMITED_BY_CONGESTION);
-			m_FramesSkipped[player]++;
-			return static_cast<int>((1.0 / fps) * microSeconds);
-		}
-		if (rns.messageInSendBuffer[MEDIUM_PRIORITY] > 1000) {
-			SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_FULL);
-			m_FramesSkipped[player]++;
-			return 0;
+			if (rns.isLimitedByCongestionControl) {
+				SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_LIMITED_BY_CONGESTION);
+				m_FramesSkipped[player]++;
+				return static_cast<int>((1.0 / fps) * microSeconds);
+			}
+			if (rns.messageInSendBuffer[MEDIUM_PRIORITY] > 1000) {
+				SetThreadExitReason(player, NetworkServer::SEND_BUFFER_IS_FULL);
+				m_FramesSkipped[player]++;
+				return 0;
+			}
 		}
 
 		// Wait till FrameMan releases bitmap
@@ -1360,7 +1456,7 @@ namespace RTE {
 
 						int payloadSize = frameData->DataSize + sizeof(MsgFrameBox);
 
-						m_Server->Send((const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+						SendToPlayer(player, (const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED);
 
 						m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 						m_DataSentTotal[player] += payloadSize;
@@ -1459,7 +1555,7 @@ namespace RTE {
 
 					int payloadSize = frameData->DataSize + sizeof(MsgFrameLine);
 
-					m_Server->Send((const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED, 0, m_ClientConnections[player].ClientId, false);
+					SendToPlayer(player, (const char *)frameData, payloadSize, MEDIUM_PRIORITY, UNRELIABLE_SEQUENCED);
 
 					m_DataSentCurrent[player][STAT_CURRENT] += payloadSize;
 					m_DataSentTotal[player] += payloadSize;
@@ -1481,6 +1577,58 @@ namespace RTE {
 		return 0;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::StartRecording(short player) {
+		if (m_RecordingFileName.empty()) {
+			return;
+		}
+		std::lock_guard<std::mutex> recordingLock(m_RecordingMutex[player]);
+
+		if (m_RecordingStreams[player].is_open()) { m_RecordingStreams[player].close(); }
+
+		std::string recordingFilePath = m_RecordingFileName + "_P" + std::to_string(player + 1) + ".netreplay";
+		m_RecordingStreams[player].open(recordingFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_RecordingStreams[player].is_open()) {
+			g_ConsoleMan.PrintString("SERVER: Failed to open network recording file " + recordingFilePath);
+			return;
+		}
+
+		NetworkReplayHeader header;
+		std::memcpy(header.Magic, "CCNR", sizeof(header.Magic));
+		header.Version = c_NetworkReplayVersion;
+		header.ResolutionX = m_ClientConnections[player].ResX;
+		header.ResolutionY = m_ClientConnections[player].ResY;
+		m_RecordingStreams[player].write(reinterpret_cast<const char *>(&header), sizeof(NetworkReplayHeader));
+
+		m_RecordingStartTime[player] = g_TimerMan.GetAbsoluteTime();
+		g_ConsoleMan.PrintString("SERVER: Recording player " + std::to_string(player + 1) + " stream to " + recordingFilePath);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::StopRecording(short player) {
+		std::lock_guard<std::mutex> recordingLock(m_RecordingMutex[player]);
+		if (m_RecordingStreams[player].is_open()) { m_RecordingStreams[player].close(); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void NetworkServer::RecordMessage(short player, const char *data, int dataSize) {
+		if (m_RecordingFileName.empty() || dataSize <= 0) {
+			return;
+		}
+		std::lock_guard<std::mutex> recordingLock(m_RecordingMutex[player]);
+
+		if (m_RecordingStreams[player].is_open()) {
+			NetworkReplayRecord record;
+			record.TimeMS = static_cast<unsigned int>((g_TimerMan.GetAbsoluteTime() - m_RecordingStartTime[player]) / 1000);
+			record.DataSize = static_cast<unsigned int>(dataSize);
+			m_RecordingStreams[player].write(reinterpret_cast<const char *>(&record), sizeof(NetworkReplayRecord));
+			m_RecordingStreams[player].write(data, dataSize);
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::UpdateStats(short player) {
@@ -1595,7 +1743,7 @@ namespace RTE {
 			}
 
 			// Update compression ratio
-			double compressionRatio = (m_DataUncompressedTotal[i] > 0) ? static_cast<double>(m_DataSentTotal[i]) / static_cast<double>(m_DataUncompressedTotal[i]) : 0;
+			double compressionRatio = GetCompressionRatio(i);
 			double emptyRatio = (m_EmptyBlocks[i] > 0) ? static_cast<double>(m_FullBlocks[i]) / static_cast<double>(m_EmptyBlocks[i]) : 0;
 
 			int fps = 0;
@@ -1726,6 +1874,39 @@ namespace RTE {
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int NetworkServer::StartNullSink(short playerCount) {
+		if (m_IsInServerMode) {
+			g_ConsoleMan.PrintString("ERROR: Can't encode frames for null sink players while serving real clients!");
+			return -1;
+		}
+		if (playerCount <= 0 || playerCount > c_MaxClients) {
+			g_ConsoleMan.PrintString("ERROR: Can't encode frames for " + std::to_string(playerCount) + " null sink players, there can be 1 to " + std::to_string(c_MaxClients) + "!");
+			return -1;
+		}
+		for (short player = 0; player < playerCount; player++) {
+			if (!m_LZ4CompressionState[player] || !m_LZ4FastCompressionState[player] || !g_FrameMan.GetNetworkBackBuffer8Ready(player) || !g_FrameMan.GetNetworkBackBufferGUI8Ready(player)) {
+				g_ConsoleMan.PrintString("ERROR: Can't encode frames for null sink player " + std::to_string(player + 1) + ", there's no compression state or network back buffer for it!");
+				return -1;
+			}
+		}
+		m_NullSinkPlayerCount = playerCount;
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	long long NetworkServer::SendNullSinkFrames() {
+		long long bytesSent = 0;
+		for (short player = 0; player < m_NullSinkPlayerCount; player++) {
+			unsigned long dataSentBefore = m_DataSentTotal[player];
+			SendFrame(player);
+			bytesSent += static_cast<long long>(m_DataSentTotal[player] - dataSentBefore);
+		}
+		return bytesSent;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void NetworkServer::HandleNetworkPackets() {
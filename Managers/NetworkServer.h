@@ -124,6 +124,48 @@ namespace RTE {
 		/// <param name="player">The player to get for.</param>
 		/// <returns>The ping time of the player.</returns>
 		unsigned short GetPing(short player) const { return m_Ping[player]; }
+
+		/// <summary>
+		/// Gets how much data was sent to the specified player over the last full second.
+		/// </summary>
+		/// <param name="player">The player to get for, or c_MaxClients for the totals of all players.</param>
+		/// <returns>The number of bytes sent over the last full second.</returns>
+		unsigned long GetDataSentPerSecond(short player) const { return m_DataSentCurrent[player][STAT_SHOWN]; }
+
+		/// <summary>
+		/// Gets how much data was sent to the specified player over the last full second, before compression.
+		/// </summary>
+		/// <param name="player">The player to get for, or c_MaxClients for the totals of all players.</param>
+		/// <returns>The number of uncompressed bytes sent over the last full second.</returns>
+		unsigned long GetDataUncompressedPerSecond(short player) const { return m_DataUncompressedCurrent[player][STAT_SHOWN]; }
+
+		/// <summary>
+		/// Gets the ratio of compressed to uncompressed data sent to the specified player since the player connected.
+		/// </summary>
+		/// <param name="player">The player to get for, or c_MaxClients for the totals of all players.</param>
+		/// <returns>The compression ratio, or 0 if nothing was sent yet.</returns>
+		double GetCompressionRatio(short player) const { return (m_DataUncompressedTotal[player] > 0) ? static_cast<double>(m_DataSentTotal[player]) / static_cast<double>(m_DataUncompressedTotal[player]) : 0; }
+
+		/// <summary>
+		/// Gets the number of frames sent to the specified player.
+		/// </summary>
+		/// <param name="player">The player to get for, or c_MaxClients for the totals of all players.</param>
+		/// <returns>The number of frames sent.</returns>
+		unsigned int GetFramesSent(short player) const { return m_FramesSent[player]; }
+
+		/// <summary>
+		/// Gets the number of frames skipped for the specified player.
+		/// </summary>
+		/// <param name="player">The player to get for, or c_MaxClients for the totals of all players.</param>
+		/// <returns>The number of frames skipped.</returns>
+		unsigned int GetFramesSkipped(short player) const { return m_FramesSkipped[player]; }
+
+		/// <summary>
+		/// Sets the base file name used for recording the outgoing message stream of each player. An empty name disables recording.
+		/// Each registered player's stream is written to its own file that can be played back offline by NetworkClient::RunReplay.
+		/// </summary>
+		/// <param name="fileName">The base file name to record to. The player number and extension are appended to it.</param>
+		void SetRecordingFileName(const std::string &fileName) { m_RecordingFileName = fileName; }
 #pragma endregion
 
 #pragma region Concrete Methods
@@ -137,6 +179,20 @@ namespace RTE {
 		/// </summary>
 		/// <param name="processInput">Whether to process packets of player input data or not.</param>
 		void Update(bool processInput = false);
+
+		/// <summary>
+		/// Makes the first players encode and compress their frames the same way as for connected clients, but drops the messages instead of sending them, so the cost of serving frames can be measured without any clients.
+		/// FrameMan has to be in multiplayer mode with a network back buffer for each of the players, and this can't be in server mode.
+		/// </summary>
+		/// <param name="playerCount">How many players, starting from the first, to encode frames for.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int StartNullSink(short playerCount);
+
+		/// <summary>
+		/// Encodes, compresses and drops a frame for each null sink player, regardless of the encoding fps.
+		/// </summary>
+		/// <returns>How many bytes would have been sent to all the null sink players together.</returns>
+		long long SendNullSinkFrames();
 #pragma endregion
 
 #pragma region Network Scene Handling
@@ -152,9 +208,9 @@ namespace RTE {
 		void ResetScene();
 
 		/// <summary>
-		/// 
+		/// Marks the terrain tiles covered by a terrain change as dirty for every connected client. The actual pixel data is read and sent later by each client's send thread.
 		/// </summary>
-		/// <param name="terrainChange"></param>
+		/// <param name="terrainChange">The terrain change to register. Must already be cropped to the scene bounds.</param>
 		void RegisterTerrainChange(SceneMan::TerrainChange terrainChange);
 #pragma endregion
 
@@ -184,6 +240,7 @@ namespace RTE {
 		static const std::string c_ClassName; //!< A string with the friendly-formatted type name of this object.
 
 		bool m_IsInServerMode = false; //!<
+		short m_NullSinkPlayerCount; //!< How many players, starting from the first, have their frames encoded and dropped instead of sent. 0 when serving real clients.
 
 		int m_ThreadExitReason[c_MaxClients]; //!<
 
@@ -235,8 +292,11 @@ namespace RTE {
 		std::mutex m_SceneLock[c_MaxClients]; //!<
 
 		unsigned char m_TerrainChangeBuffer[c_MaxClients][c_MaxPixelLineBufferSize]; //!<
-		std::queue<SceneMan::TerrainChange> m_PendingTerrainChanges[c_MaxClients]; //!<
-		std::queue<SceneMan::TerrainChange> m_CurrentTerrainChanges[c_MaxClients]; //!<
+		int m_TerrainChangeTilesX[c_MaxClients]; //!< Number of terrain change tiles horizontally across the scene each client's pending bitsets were sized for.
+		int m_TerrainChangeTilesY[c_MaxClients]; //!< Number of terrain change tiles vertically across the scene each client's pending bitsets were sized for.
+		bool m_HasPendingTerrainChanges[c_MaxClients]; //!< Whether any terrain change tile is marked dirty for each client.
+		std::vector<bool> m_PendingTerrainChangeTiles[c_MaxClients][2]; //!< Per-client dirty tile bitsets for the foreground (0) and background (1) terrain layers, filled by RegisterTerrainChange.
+		std::vector<bool> m_CurrentTerrainChangeTiles[c_MaxClients][2]; //!< Per-client dirty tile bitsets being sent by the send thread. Swapped with the pending bitsets in ProcessTerrainChanges.
 
 		std::mutex m_Mutex[c_MaxClients]; //!<
 
@@ -294,6 +354,11 @@ namespace RTE {
 		unsigned long m_OtherDataSentCurrent[MAX_STAT_RECORDS][2]; //!<
 		unsigned long m_OtherDataSentTotal[MAX_STAT_RECORDS]; //!<
 
+		std::string m_RecordingFileName; //!< Base file name for recording each player's outgoing message stream. Empty if recording is disabled.
+		std::ofstream m_RecordingStreams[c_MaxClients]; //!< The file stream each player's outgoing messages are being recorded to.
+		long long m_RecordingStartTime[c_MaxClients]; //!< Absolute time in microseconds when recording of each player's stream started.
+		std::mutex m_RecordingMutex[c_MaxClients]; //!< Mutex for recording each player's stream, since messages are sent from both the main and the player's send thread.
+
 	private:
 
 #pragma region Thread Handling
@@ -326,6 +391,16 @@ namespace RTE {
 		/// <param name="packet"></param>
 		void ReceiveNewIncomingConnection(RakNet::Packet *packet);
 
+		/// <summary>
+		/// Sends a message to the specified player and records it if recording is enabled.
+		/// </summary>
+		/// <param name="player">The player to send the message to.</param>
+		/// <param name="data">Pointer to the message data.</param>
+		/// <param name="dataSize">Size of the message data in bytes.</param>
+		/// <param name="priority">Priority to send the message with.</param>
+		/// <param name="reliability">Reliability to send the message with.</param>
+		void SendToPlayer(short player, const char *data, int dataSize, PacketPriority priority, PacketReliability reliability);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -436,11 +511,19 @@ namespace RTE {
 		bool NeedToProcessTerrainChanges(short player);
 
 		/// <summary>
-		/// 
+		/// Sends merged rectangles of all terrain tiles that were marked dirty since the last call, reading the pixel data straight from the current terrain bitmaps.
+		/// Repeated changes to the same tile are sent only once per call.
 		/// </summary>
-		/// <param name="player"></param>
+		/// <param name="player">The player to send the terrain changes to.</param>
 		void ProcessTerrainChanges(short player);
 
+		/// <summary>
+		/// Sends a terrain change rectangle, fragmenting it into multiple messages if it does not fit a single packet.
+		/// </summary>
+		/// <param name="player">The player to send the terrain change to.</param>
+		/// <param name="terrainChange">The terrain change rectangle to send.</param>
+		void SendFragmentedTerrainChange(short player, SceneMan::TerrainChange terrainChange);
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -503,6 +586,28 @@ namespace RTE {
 		int SendFrame(short player);
 #pragma endregion
 
+#pragma region Network Stream Recording
+		/// <summary>
+		/// Opens the recording file for the specified player and writes the replay header to it. Does nothing if recording is disabled.
+		/// </summary>
+		/// <param name="player">The player to start recording the outgoing stream of.</param>
+		void StartRecording(short player);
+
+		/// <summary>
+		/// Closes the recording file of the specified player, if one is open.
+		/// </summary>
+		/// <param name="player">The player to stop recording the outgoing stream of.</param>
+		void StopRecording(short player);
+
+		/// <summary>
+		/// Appends a message sent to the specified player to that player's recording file, if one is open.
+		/// </summary>
+		/// <param name="player">The player the message was sent to.</param>
+		/// <param name="data">Pointer to the message data.</param>
+		/// <param name="dataSize">Size of the message data in bytes.</param>
+		void RecordMessage(short player, const char *data, int dataSize);
+#pragma endregion
+
 #pragma region Network Stats Handling
 		/// <summary>
 		/// 
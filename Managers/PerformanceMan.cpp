@@ -2,6 +2,8 @@
 #include "MovableMan.h"
 #include "FrameMan.h"
 #include "AudioMan.h"
+#include "LuaMan.h"
+#include "ConsoleMan.h"
 #include "Timer.h"
 
 #include "GUI.h"
@@ -10,6 +12,7 @@
 namespace RTE {
 
 	const std::string PerformanceMan::c_ClassName = "PerformanceMan";
+	thread_local PerformanceMan::ThreadScopeBufferOwner PerformanceMan::s_ThreadScopeBufferOwner;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -21,6 +24,11 @@ namespace RTE {
 		m_MSPFs.clear();
 		m_MSPFAverage = 0;
 		m_SimSpeed = 1.0;
+		m_RecordingScopes = false;
+		m_CapturingProfile = false;
+		m_ProfileCaptureStartTime = 0;
+		m_ScopeBuffers.clear();
+		m_ScopeHistories.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -31,10 +39,10 @@ namespace RTE {
 
 		for (unsigned short counter = 0; counter < PERF_COUNT; ++counter) {
 			std::fill_n(m_PerfData[counter], c_MaxSamples, 0);
-			std::fill_n(m_PerfPercentages[counter], c_MaxSamples, 0);
 			m_PerfMeasureStart[counter] = 0;
 			m_PerfMeasureStop[counter] = 0;
 		}
+		ResetPerformanceCounterTotals();
 
 		// Set up performance counter's names
 		m_PerfCounterNames[PERF_SIM_TOTAL] = "Total";
@@ -45,6 +53,9 @@ namespace RTE {
 		m_PerfCounterNames[PERF_ACTORS_AI] = "Act AI";
 		m_PerfCounterNames[PERF_ACTIVITY] = "Activity";
 
+		SetProfileThreadName("Main");
+		UpdateScopeRecording();
+
 		return 0;
 	}
 
@@ -52,6 +63,20 @@ namespace RTE {
 
 	void PerformanceMan::Destroy() {
 		delete m_FrameTimer;
+		// This thread's buffer is let go of so it can be deleted and isn't touched when the thread exits
+		if (s_ThreadScopeBufferOwner.Buffer) {
+			s_ThreadScopeBufferOwner.Buffer->InUse = false;
+			s_ThreadScopeBufferOwner.Buffer = nullptr;
+		}
+		{
+			// Other threads can still be running and own their buffers, like the never joined NetworkServer send threads and the std::async pool threads, and they hand their buffers back when they exit.
+			// Those buffers are leaked on purpose so the exiting threads don't write into freed memory. Handing over is done under the lock, so a buffer that isn't in use can't be taken while it's deleted.
+			std::lock_guard<std::mutex> buffersLock(m_ScopeBuffersMutex);
+			for (const ThreadScopeBuffer *buffer : m_ScopeBuffers) {
+				if (!buffer->InUse) { delete buffer; }
+			}
+			m_ScopeBuffers.clear();
+		}
 		Clear();
 	}
 
@@ -102,40 +127,177 @@ namespace RTE {
 	void PerformanceMan::StopPerformanceMeasurement(PerformanceCounters counter) {
 		m_PerfMeasureStop[counter] = g_TimerMan.GetAbsoluteTime();
 		AddPerformanceSample(counter, m_PerfMeasureStop[counter] - m_PerfMeasureStart[counter]);
+		// The fixed counters are scopes too, so they show up in the graphs and traces along with the rest
+		if (IsRecordingScopes()) { RecordScope(m_PerfCounterNames[counter].c_str(), m_PerfMeasureStart[counter], m_PerfMeasureStop[counter] - m_PerfMeasureStart[counter]); }
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned long long PerformanceMan::GetElapsedMeasurementTime(PerformanceCounters counter) const { return g_TimerMan.GetAbsoluteTime() - m_PerfMeasureStart[counter]; }
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::NewPerformanceSample() {
+		// Whatever was recorded since the last sample goes into the one that's ending
+		if (IsRecordingScopes()) { CollectScopeSamples(); }
+
 		m_Sample++;
+		m_TotalSampleCount++;
 		if (m_Sample >= c_MaxSamples) { m_Sample = 0; }
 
 		for (unsigned short counter = 0; counter < PERF_COUNT; ++counter) {
 			m_PerfData[counter][m_Sample] = 0;
-			m_PerfPercentages[counter][m_Sample] = 0;
+		}
+		for (std::pair<const char *const, ScopeHistory> &scopeHistory : m_ScopeHistories) {
+			scopeHistory.second.Samples[m_Sample] = 0;
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void PerformanceMan::CalculateSamplePercentages() {
-		for (unsigned short counter = 0; counter < PERF_COUNT; ++counter) {
-			unsigned short samplePercentage = static_cast<unsigned short>(static_cast<float>(m_PerfData[counter][m_Sample]) / static_cast<float>(m_PerfData[counter][PERF_SIM_TOTAL]) * 100);
-			m_PerfPercentages[counter][m_Sample] = samplePercentage;
+	void PerformanceMan::RecordScope(const char *name, long long startTime, long long duration) {
+		ThreadScopeBuffer &buffer = GetThreadScopeBuffer();
+		unsigned long long writeCount = buffer.WriteCount.load(std::memory_order_relaxed);
+		buffer.Records[writeCount & (c_ScopeBufferSize - 1)] = { name, startTime, duration };
+		buffer.WriteCount.store(writeCount + 1, std::memory_order_release);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::SetProfileThreadName(const std::string &threadName) {
+		ThreadScopeBuffer &buffer = GetThreadScopeBuffer();
+		std::lock_guard<std::mutex> buffersLock(m_ScopeBuffersMutex);
+		buffer.ThreadName = threadName;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::StartProfileCapture() {
+		if (m_CapturingProfile) {
+			return;
+		}
+		m_ProfileCaptureStartTime = g_TimerMan.GetAbsoluteTime();
+		m_CapturingProfile = true;
+		UpdateScopeRecording();
+		g_ConsoleMan.PrintString("SYSTEM: Profile capture started.");
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::StopProfileCapture() {
+		if (!m_CapturingProfile) {
+			return;
+		}
+		m_CapturingProfile = false;
+		UpdateScopeRecording();
+		g_ConsoleMan.PrintString("SYSTEM: Profile capture stopped.");
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int PerformanceMan::SaveProfileTrace(const std::string &fileName) {
+		std::ofstream traceFile(fileName);
+		if (!traceFile.is_open()) {
+			g_ConsoleMan.PrintString("ERROR: Failed to open " + fileName + " to save the profile trace to!");
+			return -1;
+		}
+		traceFile << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		char eventString[512];
+		bool firstEvent = true;
+		unsigned long long eventCount = 0;
+		std::vector<ScopeRecord> records;
+		std::lock_guard<std::mutex> buffersLock(m_ScopeBuffersMutex);
+		for (const ThreadScopeBuffer *buffer : m_ScopeBuffers) {
+			std::snprintf(eventString, sizeof(eventString), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%i,\"args\":{\"name\":\"%s\"}}", firstEvent ? "" : ",", buffer->ThreadIndex, buffer->ThreadName.c_str());
+			traceFile << eventString;
+			firstEvent = false;
+
+			records.clear();
+			CopyScopeRecords(*buffer, 0, records);
+			for (const ScopeRecord &record : records) {
+				if (record.StartTime >= m_ProfileCaptureStartTime) {
+					std::snprintf(eventString, sizeof(eventString), ",\n{\"name\":\"%s\",\"cat\":\"RTE\",\"ph\":\"X\",\"ts\":%lli,\"dur\":%lli,\"pid\":1,\"tid\":%i}", record.Name, record.StartTime, record.Duration, buffer->ThreadIndex);
+					traceFile << eventString;
+					eventCount++;
+				}
+			}
+		}
+		traceFile << "\n]}\n";
+		if (!traceFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Failed to write the profile trace to " + fileName + "!");
+			return -1;
+		}
+		g_ConsoleMan.PrintString("SYSTEM: Saved " + std::to_string(eventCount) + " profiled scopes to " + fileName + ". Open it with chrome://tracing or ui.perfetto.dev.");
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PerformanceMan::ThreadScopeBuffer & PerformanceMan::GetThreadScopeBuffer() {
+		if (!s_ThreadScopeBufferOwner.Buffer) {
+			std::lock_guard<std::mutex> buffersLock(m_ScopeBuffersMutex);
+			std::vector<ThreadScopeBuffer *>::iterator freeBuffer = std::find_if(m_ScopeBuffers.begin(), m_ScopeBuffers.end(), [](const ThreadScopeBuffer *buffer) { return !buffer->InUse; });
+			if (freeBuffer == m_ScopeBuffers.end()) {
+				ThreadScopeBuffer *newBuffer = new ThreadScopeBuffer();
+				newBuffer->ThreadIndex = static_cast<int>(m_ScopeBuffers.size());
+				m_ScopeBuffers.push_back(newBuffer);
+				freeBuffer = std::prev(m_ScopeBuffers.end());
+			}
+			(*freeBuffer)->InUse = true;
+			(*freeBuffer)->ThreadName = "Thread " + std::to_string((*freeBuffer)->ThreadIndex);
+			s_ThreadScopeBufferOwner.Buffer = *freeBuffer;
+		}
+		return *s_ThreadScopeBufferOwner.Buffer;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned long long PerformanceMan::CopyScopeRecords(const ThreadScopeBuffer &buffer, unsigned long long fromCount, std::vector<ScopeRecord> &records) const {
+		unsigned long long writeCount = buffer.WriteCount.load(std::memory_order_acquire);
+		unsigned long long firstRecord = std::max(fromCount, writeCount > c_ScopeBufferSize ? writeCount - c_ScopeBufferSize : 0);
+		size_t firstCopied = records.size();
+		for (unsigned long long recordIndex = firstRecord; recordIndex < writeCount; ++recordIndex) {
+			records.push_back(buffer.Records[recordIndex & (c_ScopeBufferSize - 1)]);
+		}
+		// The thread may have lapped the oldest copied records while they were being copied, including the one it's writing right now, so those can't be trusted
+		std::atomic_thread_fence(std::memory_order_acquire);
+		unsigned long long overwrittenCount = buffer.WriteCount.load(std::memory_order_relaxed) + 1;
+		if (overwrittenCount > firstRecord + c_ScopeBufferSize) {
+			size_t untrustedCount = std::min(static_cast<size_t>(overwrittenCount - firstRecord - c_ScopeBufferSize), records.size() - firstCopied);
+			records.erase(records.begin() + firstCopied, records.begin() + firstCopied + untrustedCount);
+		}
+		return writeCount;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::CollectScopeSamples() {
+		std::vector<ScopeRecord> records;
+		{
+			std::lock_guard<std::mutex> buffersLock(m_ScopeBuffersMutex);
+			for (ThreadScopeBuffer *buffer : m_ScopeBuffers) {
+				buffer->CollectedCount = CopyScopeRecords(*buffer, buffer->CollectedCount, records);
+			}
+		}
+		for (const ScopeRecord &record : records) {
+			ScopeHistory &scopeHistory = m_ScopeHistories[record.Name];
+			scopeHistory.Name = record.Name;
+			scopeHistory.Samples[m_Sample] += record.Duration;
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	unsigned long long PerformanceMan::GetPerformanceCounterAverage(PerformanceCounters counter) const {
-		unsigned long long totalPerformanceMeasurement = 0;
+	unsigned long long PerformanceMan::GetScopeAverage(const ScopeHistory &scopeHistory) const {
+		unsigned long long totalScopeTime = 0;
 		unsigned short sample = m_Sample;
 		for (unsigned short i = 0; i < c_Average; ++i) {
-			totalPerformanceMeasurement += m_PerfData[counter][sample];
+			totalScopeTime += scopeHistory.Samples[sample];
 			if (sample == 0) { sample = c_MaxSamples; }
 			sample--;
 		}
-		return totalPerformanceMeasurement / c_Average;
+		return totalScopeTime / c_Average;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -196,30 +358,56 @@ namespace RTE {
 			}
 			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 100, str, GUIFont::Left);
 
+			sprintf_s(str, sizeof(str), "Lua GC: %.2f ms avg | %.2f ms peak | %i KB heap | %lu cycles", static_cast<float>(g_LuaMan.GetAverageGCPauseTime()) / 1000.0F, static_cast<float>(g_LuaMan.GetPeakGCPauseTime()) / 1000.0F, static_cast<int>(g_LuaMan.GetHeapSize() / 1024), g_LuaMan.GetGCCycleCount());
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 110, str, GUIFont::Left);
+
+			sprintf_s(str, sizeof(str), "Update LOD: %i Full | %i Reduced | %i Low | %i Dormant", g_MovableMan.GetUpdateLODTierCount(MovableObject::LOD_FULL), g_MovableMan.GetUpdateLODTierCount(MovableObject::LOD_REDUCED), g_MovableMan.GetUpdateLODTierCount(MovableObject::LOD_LOW), g_MovableMan.GetUpdateLODTierCount(MovableObject::LOD_DORMANT));
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 120, str, GUIFont::Left);
+
+			const RotatedSpriteCache &rotatedSpriteCache = g_FrameMan.GetRotatedSpriteCache();
+			sprintf_s(str, sizeof(str), "Rotation Cache: %zu frames | %zu / %zu KB | %.1f%% hits", rotatedSpriteCache.GetEntryCount(), rotatedSpriteCache.GetMemoryUsage() / 1024, rotatedSpriteCache.GetMaxMemoryUsage() / 1024, rotatedSpriteCache.GetHitRate() * 100.0F);
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, c_StatsHeight + 130, str, GUIFont::Left);
+
 			// If in split screen mode don't draw graphs because they don't fit anyway.
 			if (m_AdvancedPerfStats && g_FrameMan.GetScreenCount() == 1) { DrawPeformanceGraphs(bitmapToDrawTo); }
+
+			if (g_LuaMan.IsProfilingScripts()) { DrawScriptProfile(bitmapToDrawTo); }
 		}
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::DrawPeformanceGraphs(AllegroBitmap bitmapToDrawTo) {
-		CalculateSamplePercentages();
+		std::unordered_map<const char *, ScopeHistory>::const_iterator totalHistory = m_ScopeHistories.find(m_PerfCounterNames[PERF_SIM_TOTAL].c_str());
+		if (totalHistory == m_ScopeHistories.end()) {
+			return;
+		}
+		// The total always goes first, followed by whichever scopes took the most time lately
+		std::vector<std::pair<unsigned long long, const ScopeHistory *>> scopeAverages;
+		for (const std::pair<const char *const, ScopeHistory> &scopeHistory : m_ScopeHistories) {
+			if (&scopeHistory.second != &totalHistory->second) { scopeAverages.emplace_back(GetScopeAverage(scopeHistory.second), &scopeHistory.second); }
+		}
+		size_t topScopeCount = std::min(static_cast<size_t>(c_GraphCount - 1), scopeAverages.size());
+		std::partial_sort(scopeAverages.begin(), scopeAverages.begin() + topScopeCount, scopeAverages.end(), [](const std::pair<unsigned long long, const ScopeHistory *> &lhs, const std::pair<unsigned long long, const ScopeHistory *> &rhs) { return lhs.first > rhs.first; });
+		scopeAverages.resize(topScopeCount);
+		unsigned long long totalAverage = GetScopeAverage(totalHistory->second);
+		scopeAverages.emplace(scopeAverages.begin(), totalAverage, &totalHistory->second);
 
 		char str[512];
 
-		for (unsigned short pc = 0; pc < PERF_COUNT; ++pc) {
+		for (unsigned short pc = 0; pc < scopeAverages.size(); ++pc) {
+			const ScopeHistory &scopeHistory = *scopeAverages[pc].second;
 			unsigned short blockStart = c_GraphsStartOffsetY + pc * c_GraphBlockHeight;
 
-			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, blockStart, m_PerfCounterNames[pc], GUIFont::Left);
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX, blockStart, scopeHistory.Name, GUIFont::Left);
 
-			// Print percentage from PerformanceCounters::PERF_SIM_TOTAL
-			unsigned short perc = static_cast<unsigned short>((static_cast<float>(GetPerformanceCounterAverage(static_cast<PerformanceCounters>(pc))) / static_cast<float>(GetPerformanceCounterAverage(PERF_SIM_TOTAL)) * 100));
+			// Print percentage from PerformanceCounters::PERF_SIM_TOTAL. Scopes on other threads can go above 100
+			unsigned short perc = static_cast<unsigned short>((static_cast<float>(scopeAverages[pc].first) / static_cast<float>(std::max(totalAverage, 1ULL)) * 100));
 			sprintf_s(str, sizeof(str), "%%: %u", perc);
 			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX + 60, blockStart, str, GUIFont::Left);
 
 			// Print average processing time in ms
-			sprintf_s(str, sizeof(str), "T: %lli", GetPerformanceCounterAverage(static_cast<PerformanceCounters>(pc)) / 1000);
+			sprintf_s(str, sizeof(str), "T: %lli", scopeAverages[pc].first / 1000);
 			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, c_StatsOffsetX + 96, blockStart, str, GUIFont::Left);
 
 			unsigned short graphStart = blockStart + c_GraphsOffsetX;
@@ -233,11 +421,11 @@ namespace RTE {
 			unsigned short sample = m_Sample;
 			for (unsigned short i = 0; i < c_MaxSamples; i++) {
 				// Show microseconds in graphs, assume that 33333 microseconds (one frame of 30 fps) is the highest value on the graph
-				unsigned short value = Limit(static_cast<unsigned short>(static_cast<float>(m_PerfData[pc][sample]) / (1000000 / 30) * 100), 100, 0);
+				unsigned short value = Limit(static_cast<unsigned short>(static_cast<float>(scopeHistory.Samples[sample]) / (1000000 / 30) * 100), 100, 0);
 				unsigned short dotHeight = static_cast<unsigned short>(static_cast<float>(c_GraphHeight) / 100.0 * static_cast<float>(value));
 
 				bitmapToDrawTo.SetPixel(c_StatsOffsetX - 1 + c_MaxSamples - i, graphStart + c_GraphHeight - dotHeight, 13);
-				peak = Limit(peak, m_PerfData[pc][sample], 0);
+				peak = Limit(peak, scopeHistory.Samples[sample], 0);
 
 				if (sample == 0) { sample = c_MaxSamples; }
 				sample--;
@@ -249,6 +437,25 @@ namespace RTE {
 		}
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerformanceMan::DrawScriptProfile(AllegroBitmap bitmapToDrawTo) {
+		int textRightEdge = bitmapToDrawTo.GetWidth() - c_StatsOffsetX;
+		float updateCount = static_cast<float>(std::max(g_LuaMan.GetProfiledUpdateCount(), 1UL));
+
+		char str[512];
+		sprintf_s(str, sizeof(str), "Lua Script Profile (%lu updates, [F6] to stop and save)", g_LuaMan.GetProfiledUpdateCount());
+		g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, textRightEdge, c_StatsHeight, str, GUIFont::Right);
+
+		unsigned short line = 1;
+		for (const LuaMan::ScriptProfileEntry &entry : g_LuaMan.GetTopProfiledScripts(c_ScriptProfileTopCount)) {
+			// Show the averages per sim update so the numbers can be compared with the performance graphs
+			sprintf_s(str, sizeof(str), "%s  %.0f us  %.1f calls  %.1f KB", entry.Name.c_str(), static_cast<float>(entry.SelfTimeUS) / updateCount, static_cast<float>(entry.CallCount) / updateCount, static_cast<float>(entry.AllocatedBytes) / 1024.0F / updateCount);
+			g_FrameMan.GetLargeFont()->DrawAligned(&bitmapToDrawTo, textRightEdge, c_StatsHeight + line * 10, str, GUIFont::Right);
+			line++;
+		}
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PerformanceMan::DrawCurrentPing() {
@@ -13,6 +13,7 @@ namespace RTE {
 
 	/// <summary>
 	/// Singleton manager responsible for all performance stats counting and drawing.
+	/// Besides the fixed performance counters, ProfileScopes placed anywhere in the code record named timings into a buffer per thread, which are drawn as graphs of the most expensive scopes and can be captured and saved as a Chrome trace.
 	/// </summary>
 	class PerformanceMan : public Singleton<PerformanceMan> {
 
@@ -92,7 +93,7 @@ namespace RTE {
 		/// Sets whether to display the performance stats on-screen or not.
 		/// </summary>
 		/// <param name="showStats">Whether to show the performance stats or not.</param>
-		void ShowPerformanceStats(bool showStats = true) { m_ShowPerfStats = showStats; }
+		void ShowPerformanceStats(bool showStats = true) { m_ShowPerfStats = showStats; UpdateScopeRecording(); }
 
 		/// <summary>
 		/// Tells whether to display the performance graphs on-screen or not.
@@ -104,7 +105,52 @@ namespace RTE {
 		/// Sets whether to display the performance graphs on-screen or not.
 		/// </summary>
 		/// <param name="showGraphs">Whether to show the performance graphs or not.</param>
-		void ShowAdvancedPerformanceStats(bool showGraphs = true) { m_AdvancedPerfStats = showGraphs; }
+		void ShowAdvancedPerformanceStats(bool showGraphs = true) { m_AdvancedPerfStats = showGraphs; UpdateScopeRecording(); }
+#pragma endregion
+
+#pragma region Profile Scope Handling
+		/// <summary>
+		/// Tells whether ProfileScopes should record their timings, i.e. whether the graphs are showing or a profile capture is running. Safe to call from any thread.
+		/// </summary>
+		/// <returns>Whether ProfileScopes are being recorded.</returns>
+		bool IsRecordingScopes() const { return m_RecordingScopes.load(std::memory_order_relaxed); }
+
+		/// <summary>
+		/// Records the timing of a finished ProfileScope into the calling thread's buffer, without taking any locks unless it's the first scope recorded on the thread. Safe to call from any thread.
+		/// </summary>
+		/// <param name="name">The name of the scope. Has to stay valid as long as the PerformanceMan does, like a string literal.</param>
+		/// <param name="startTime">When the scope started, in absolute microseconds.</param>
+		/// <param name="duration">How long the scope took, in microseconds.</param>
+		void RecordScope(const char *name, long long startTime, long long duration);
+
+		/// <summary>
+		/// Sets the name the calling thread is shown with in saved profile traces. Safe to call from any thread.
+		/// </summary>
+		/// <param name="threadName">The name of the thread.</param>
+		void SetProfileThreadName(const std::string &threadName);
+
+		/// <summary>
+		/// Tells whether a profile capture is running.
+		/// </summary>
+		/// <returns>Whether a profile capture is running.</returns>
+		bool IsCapturingProfile() const { return m_CapturingProfile; }
+
+		/// <summary>
+		/// Starts a profile capture, making ProfileScopes record even when the graphs aren't showing. Scopes recorded before it are left out of saved traces.
+		/// </summary>
+		void StartProfileCapture();
+
+		/// <summary>
+		/// Stops the profile capture. The recorded scopes stay in the buffers until newer ones overwrite them, so they can still be saved.
+		/// </summary>
+		void StopProfileCapture();
+
+		/// <summary>
+		/// Saves the scopes held in the buffers of all threads to a file in the Chrome trace event JSON format, which chrome://tracing and Perfetto can open.
+		/// </summary>
+		/// <param name="fileName">The path of the file to save to.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int SaveProfileTrace(const std::string &fileName);
 #pragma endregion
 
 #pragma region Performance Counter Handling
@@ -130,6 +176,44 @@ namespace RTE {
 		/// <param name="counter">Counter to stop and updated measurement for.</param>
 		void StopPerformanceMeasurement(PerformanceCounters counter);
 
+		/// <summary>
+		/// Gets how much time passed since the last measurement of a performance counter was started, for checking how much of a sim update is left while it runs.
+		/// </summary>
+		/// <param name="counter">Counter to get the elapsed time of.</param>
+		/// <returns>The time since the measurement started in microseconds.</returns>
+		unsigned long long GetElapsedMeasurementTime(PerformanceCounters counter) const;
+
+		/// <summary>
+		/// Gets the display name of a performance counter.
+		/// </summary>
+		/// <param name="counter">Counter to get the name of.</param>
+		/// <returns>The name of the counter.</returns>
+		const std::string & GetPerformanceCounterName(PerformanceCounters counter) const { return m_PerfCounterNames[counter]; }
+
+		/// <summary>
+		/// Gets the total time measured by a performance counter since the totals were last reset, unlike the sample ring which only holds the last c_MaxSamples sim updates.
+		/// </summary>
+		/// <param name="counter">Counter to get the total of.</param>
+		/// <returns>The total measured time in microseconds.</returns>
+		unsigned long long GetPerformanceCounterTotal(PerformanceCounters counter) const { return m_PerfTotals[counter]; }
+
+		/// <summary>
+		/// Gets how many performance samples were started since the totals were last reset.
+		/// </summary>
+		/// <returns>The number of samples in the totals.</returns>
+		unsigned long long GetTotalSampleCount() const { return m_TotalSampleCount; }
+
+		/// <summary>
+		/// Gets the simulation speed over real time, as last calculated from the average MSPF.
+		/// </summary>
+		/// <returns>The sim speed, where 1.0 is real time.</returns>
+		float GetSimSpeed() const { return m_SimSpeed; }
+
+		/// <summary>
+		/// Resets the totals of all performance counters and the total sample count to 0.
+		/// </summary>
+		void ResetPerformanceCounterTotals() { std::fill_n(m_PerfTotals, PERF_COUNT, 0); m_TotalSampleCount = 0; }
+
 		/// <summary>
 		/// Sets the current ping value to display.
 		/// </summary>
@@ -155,9 +239,51 @@ namespace RTE {
 		const unsigned short c_StatsOffsetX = 17; //!< Offset of the stat text from the left edge of the screen.
 		const unsigned short c_StatsHeight = 14; //!< Height of each stat text line.
 		const unsigned short c_GraphsOffsetX = 14; //!< Offset of the graph from the left edge of the screen.
-		const unsigned short c_GraphsStartOffsetY = 134; //!< Position the first graph block will be drawn from the top edge of the screen.
+		const unsigned short c_GraphsStartOffsetY = 154; //!< Position the first graph block will be drawn from the top edge of the screen.
 		const unsigned short c_GraphHeight = 20; //!< Height of the performance graph.
 		const unsigned short c_GraphBlockHeight = 34; //!< Height of the whole graph block (text height and graph height combined).
+		const unsigned short c_ScriptProfileTopCount = 10; //!< How many of the most expensive script functions to list while the Lua script profiler is running.
+		const unsigned short c_GraphCount = 7; //!< How many performance graphs to draw, the total sim update time followed by the most expensive scopes.
+		static constexpr unsigned int c_ScopeBufferSize = 1 << 17; //!< How many of the latest scopes each thread's buffer holds. Has to be a power of two.
+
+		/// <summary>
+		/// The timing of a finished ProfileScope.
+		/// </summary>
+		struct ScopeRecord {
+			const char *Name; //!< The name of the scope.
+			long long StartTime; //!< When the scope started, in absolute microseconds.
+			long long Duration; //!< How long the scope took, in microseconds.
+		};
+
+		/// <summary>
+		/// A ring buffer of the latest scopes recorded on one thread. Only the owning thread writes to it, and readers check the write count again after copying records out, to drop the ones that got overwritten in the meantime.
+		/// </summary>
+		struct ThreadScopeBuffer {
+			std::vector<ScopeRecord> Records = std::vector<ScopeRecord>(c_ScopeBufferSize); //!< The ring of records.
+			std::atomic<unsigned long long> WriteCount { 0 }; //!< How many records were ever written to this buffer. The next one goes to WriteCount % c_ScopeBufferSize.
+			std::atomic<bool> InUse { false }; //!< Whether a thread owns this buffer. Buffers of exited threads are handed to new ones.
+			int ThreadIndex = 0; //!< The index of this buffer, used as the thread ID in saved traces.
+			std::string ThreadName; //!< The name of the owning thread in saved traces.
+			unsigned long long CollectedCount = 0; //!< How many records were added to the graphs so far. Only used by the main thread.
+		};
+
+		/// <summary>
+		/// The per sim update history of a scope's total time, for the graphs.
+		/// </summary>
+		struct ScopeHistory {
+			const char *Name; //!< The name of the scope.
+			unsigned long long Samples[c_MaxSamples]; //!< The total time of the scope in each sample, in microseconds.
+		};
+
+		/// <summary>
+		/// Holds a thread's scope buffer, and hands it back when the thread exits so a new thread can take it over.
+		/// </summary>
+		struct ThreadScopeBufferOwner {
+			ThreadScopeBuffer *Buffer = nullptr; //!< The thread's scope buffer, or nullptr if it didn't record any scopes yet.
+			~ThreadScopeBufferOwner() { if (Buffer) { Buffer->InUse = false; } }
+		};
+
+		static thread_local ThreadScopeBufferOwner s_ThreadScopeBufferOwner; //!< The scope buffer of each thread.
 
 		bool m_ShowPerfStats; //!< Whether to show performance stats on screen or not.
 		bool m_AdvancedPerfStats; //!< Whether to show performance graphs on screen or not.
@@ -171,10 +297,18 @@ namespace RTE {
 		unsigned short m_CurrentPing; //!< Current ping value to display on screen.
 
 		std::string m_PerfCounterNames[PERF_COUNT]; //!< Performance counter names displayed on screen.
-		unsigned short m_PerfPercentages[PERF_COUNT][c_MaxSamples]; //!< Array to store percentages from PERF_SIM_TOTAL.
 		unsigned long long m_PerfData[PERF_COUNT][c_MaxSamples]; //!< Array to store performance measurements in microseconds.	
 		unsigned long long m_PerfMeasureStart[PERF_COUNT]; //!< Current measurement start time in microseconds.
 		unsigned long long m_PerfMeasureStop[PERF_COUNT]; //!< Current measurement stop time in microseconds.
+		unsigned long long m_PerfTotals[PERF_COUNT]; //!< Total measured time of each counter in microseconds since the totals were last reset.
+		unsigned long long m_TotalSampleCount; //!< How many samples were started since the totals were last reset.
+
+		std::atomic<bool> m_RecordingScopes; //!< Whether ProfileScopes are being recorded.
+		bool m_CapturingProfile; //!< Whether a profile capture is running.
+		long long m_ProfileCaptureStartTime; //!< When the last profile capture was started, in absolute microseconds. Scopes from before are left out of saved traces.
+		std::vector<ThreadScopeBuffer *> m_ScopeBuffers; //!< The scope buffers of all threads that ever recorded a scope. Owned by this, except the ones still in use when this is destroyed, which are leaked to their threads.
+		std::mutex m_ScopeBuffersMutex; //!< Guards m_ScopeBuffers against threads recording their first scope while it's being gone through.
+		std::unordered_map<const char *, ScopeHistory> m_ScopeHistories; //!< The per sample history of every scope recorded while the graphs were showing, by name.
 
 	private:
 
@@ -184,26 +318,53 @@ namespace RTE {
 		/// </summary>
 		/// <param name="counter">Counter to update.</param>
 		/// <param name="value">Value to add to this counter.</param>
-		void AddPerformanceSample(PerformanceCounters counter, int64_t value) { m_PerfData[counter][m_Sample] += value; }
+		void AddPerformanceSample(PerformanceCounters counter, int64_t value) { m_PerfData[counter][m_Sample] += value; m_PerfTotals[counter] += value; }
+#pragma endregion
+
+#pragma region Profile Scope Handling
+		/// <summary>
+		/// Updates whether ProfileScopes should be recorded, after the graphs were shown or hidden or a capture was started or stopped.
+		/// </summary>
+		void UpdateScopeRecording() { m_RecordingScopes.store((m_ShowPerfStats && m_AdvancedPerfStats) || m_CapturingProfile, std::memory_order_relaxed); }
 
 		/// <summary>
-		/// Calculates current sample's percentages from SIM_TOTAL for all performance counters and stores them to m_PerfPercenrages.
+		/// Gets the scope buffer of the calling thread, taking a free one or making a new one if the thread doesn't have one yet.
 		/// </summary>
-		void CalculateSamplePercentages();
+		/// <returns>The calling thread's scope buffer.</returns>
+		ThreadScopeBuffer & GetThreadScopeBuffer();
 
 		/// <summary>
-		/// Returns an average value of c_Average last samples for specified performance counter.
+		/// Copies the records a scope buffer holds out of it, leaving out any that its thread overwrote while they were being copied. m_ScopeBuffersMutex has to be locked.
 		/// </summary>
-		/// <param name="counter">Counter to get average value from.</param>
-		/// <returns>An average value for specified counter.</returns>
-		unsigned long long GetPerformanceCounterAverage(PerformanceCounters counter) const;
+		/// <param name="buffer">The scope buffer to copy from.</param>
+		/// <param name="fromCount">The write count to start copying from. Records older than the buffer holds are skipped.</param>
+		/// <param name="records">The vector to add the copied records to.</param>
+		/// <returns>The write count of the buffer when the copying started, to continue from next time.</returns>
+		unsigned long long CopyScopeRecords(const ThreadScopeBuffer &buffer, unsigned long long fromCount, std::vector<ScopeRecord> &records) const;
+
+		/// <summary>
+		/// Adds the scopes recorded on all threads since the last call to the current sample of their histories.
+		/// </summary>
+		void CollectScopeSamples();
+
+		/// <summary>
+		/// Returns an average value of c_Average last samples of a scope history.
+		/// </summary>
+		/// <param name="scopeHistory">The scope history to get the average value from.</param>
+		/// <returns>The average value of the scope history, in microseconds.</returns>
+		unsigned long long GetScopeAverage(const ScopeHistory &scopeHistory) const;
 #pragma endregion
 
 		/// <summary>
-		/// Draws the performance graphs to the screen. This will be called by Draw() if advanced performance stats are enabled.
+		/// Draws the performance graphs of the total sim update time and the most expensive scopes to the screen. This will be called by Draw() if advanced performance stats are enabled.
 		/// </summary>
 		void DrawPeformanceGraphs(AllegroBitmap bitmapToDrawTo);
 
+		/// <summary>
+		/// Draws the most expensive script functions found by the Lua script profiler to the screen. This will be called by Draw() while the profiler is running.
+		/// </summary>
+		void DrawScriptProfile(AllegroBitmap bitmapToDrawTo);
+
 		/// <summary>
 		/// Clears all the member variables of this PerformanceMan, effectively resetting the members of this abstraction level only.
 		/// </summary>
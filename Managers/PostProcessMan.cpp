@@ -3,6 +3,7 @@
 #include "Scene.h"
 #include "ContentFile.h"
 #include "Matrix.h"
+#include "ProfileScope.h"
 
 namespace RTE {
 
@@ -274,6 +275,8 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PostProcessMan::PostProcess() {
+		ProfileScope profileScope("PostProcessMan::PostProcess");
+
 		// First copy the current 8bpp backbuffer to the 32bpp buffer; we'll add effects to it
 		blit(g_FrameMan.GetBackBuffer8(), g_FrameMan.GetBackBuffer32(), 0, 0, 0, 0, g_FrameMan.GetBackBuffer8()->w, g_FrameMan.GetBackBuffer8()->h);
 
@@ -883,6 +883,8 @@ string PresetMan::GetEntityDataLocation(string type, string preset, int whichMod
 void PresetMan::ReloadAllScripts()
 {
 	g_LuaMan.ClearUserModuleCache();
+	// The parallel AI workers keep their own copies of the scripts, so have them recreated with the reloaded ones when next needed
+	g_LuaMan.DestroyParallelAIWorkers();
 
     // Go through all modules and reset all scripts in all their Presets
     for (int i = 0; i < m_pDataModules.size(); ++i)
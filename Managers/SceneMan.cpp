@@ -30,6 +30,8 @@
 #include "MOPixel.h"
 #include "Atom.h"
 #include "Material.h"
+#include "LoadingGUI.h"
+#include "ProfileScope.h"
 // Temp
 #include "Controller.h"
 
@@ -40,6 +42,7 @@ namespace RTE
 #define COMPACTINGHEIGHT 25
 
 const std::string SceneMan::m_ClassName = "SceneMan";
+thread_local Vector SceneMan::s_LastRayHitPos;
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -76,12 +79,16 @@ void SceneMan::Clear()
     m_pSceneToLoad = 0;
     m_PlaceObjects = true;
 	m_PlaceUnits = true;
+    m_pStagedScene = 0;
+    m_PreloadSourceGeneration = 0;
+    m_StagedSceneLoading = std::future<int>();
+    m_StagedSceneProgress.clear();
     m_pCurrentScene = 0;
     m_pMOColorLayer = 0;
     m_pMOIDLayer = 0;
     m_MOIDDrawings.clear();
     m_pDebugLayer = 0;
-    m_LastRayHitPos.Reset();
+    s_LastRayHitPos.Reset();
 
     m_LayerDrawMode = g_LayerNormal;
 
@@ -175,6 +182,14 @@ int SceneMan::LoadScene(Scene *pNewScene, bool placeObjects, bool placeUnits)
     if (!pNewScene)
         return -1;
 
+    // Load the layer data on a worker thread while showing its progress, unless that was already done by preloading this very Scene
+    if (pNewScene != m_pStagedScene)
+        StageScene(pNewScene);
+    int error = FinishStagedScene();
+    // Ownership of the staged Scene is passed on from here
+    m_pStagedScene = 0;
+    m_PreloadSourceGeneration = 0;
+
     // Unload and destroy any scene we might have loaded already
     if (m_pCurrentScene)
     {
@@ -189,8 +204,9 @@ int SceneMan::LoadScene(Scene *pNewScene, bool placeObjects, bool placeUnits)
 
 	g_NetworkServer.LockScene(true);
 
+    // Only the placement of objects and the pathfinding init, which need the managers, are left to do here on the main thread
     m_pCurrentScene = pNewScene;
-    if (m_pCurrentScene->LoadData(placeObjects, true, placeUnits) < 0)
+    if (error < 0 || m_pCurrentScene->PlaceLoadedObjects(placeObjects, true, placeUnits) < 0)
     {
         g_ConsoleMan.PrintString("ERROR: Loading scene \'" + m_pCurrentScene->GetPresetName() + "\' failed! Has it been properly defined?");
 		g_NetworkServer.LockScene(false);
@@ -301,6 +317,10 @@ int SceneMan::LoadScene()
         }
     }
 
+    // Use the preloaded clone of the Scene if there is one
+    if (m_pStagedScene && m_PreloadSourceGeneration == m_pSceneToLoad->GetLayerDataGeneration())
+        return LoadScene(m_pStagedScene, m_PlaceObjects, m_PlaceUnits);
+
     return LoadScene(dynamic_cast<Scene *>(m_pSceneToLoad->Clone()), m_PlaceObjects, m_PlaceUnits);
 }
 
@@ -322,6 +342,104 @@ int SceneMan::LoadScene(std::string sceneName, bool placeObjects, bool placeUnit
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PreloadScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts loading the layer data of a clone of a Scene on a worker
+//                  thread, so that loading it later only has to place its objects.
+
+void SceneMan::PreloadScene(const Scene *pSceneToPreload)
+{
+    if (!pSceneToPreload || (m_pStagedScene && m_PreloadSourceGeneration == pSceneToPreload->GetLayerDataGeneration()))
+        return;
+
+    StageScene(dynamic_cast<Scene *>(pSceneToPreload->Clone()));
+    m_PreloadSourceGeneration = pSceneToPreload->GetLayerDataGeneration();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DiscardPreloadedScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Throws away any Scene being preloaded, waiting for its worker to
+//                  finish first.
+
+void SceneMan::DiscardPreloadedScene()
+{
+    if (m_StagedSceneLoading.valid())
+        m_StagedSceneLoading.wait();
+    m_StagedSceneLoading = std::future<int>();
+
+    delete m_pStagedScene;
+    m_pStagedScene = 0;
+    m_PreloadSourceGeneration = 0;
+
+    std::lock_guard<std::mutex> progressLock(m_StagedSceneProgressMutex);
+    m_StagedSceneProgress.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StageScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts loading the layer data of a Scene on a worker thread, after
+//                  discarding any Scene already staged.
+
+void SceneMan::StageScene(Scene *pScene)
+{
+    DiscardPreloadedScene();
+    if (!pScene)
+        return;
+
+    m_pStagedScene = pScene;
+    m_StagedSceneLoading = std::async(std::launch::async, [this, pScene]() {
+        return pScene->LoadLayerData(true, [this](const std::string &report) {
+            std::lock_guard<std::mutex> progressLock(m_StagedSceneProgressMutex);
+            m_StagedSceneProgress.push_back(report);
+        });
+    });
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FinishStagedScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Waits for the worker loading the staged Scene's layer data, showing
+//                  its progress on the loading screen meanwhile.
+
+int SceneMan::FinishStagedScene()
+{
+    if (!m_StagedSceneLoading.valid())
+        return -1;
+
+    while (m_StagedSceneLoading.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+        ShowStagedSceneProgress();
+    ShowStagedSceneProgress();
+
+    return m_StagedSceneLoading.get();
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ShowStagedSceneProgress
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows any new progress reports of the worker loading the staged
+//                  Scene on the loading screen.
+
+void SceneMan::ShowStagedSceneProgress()
+{
+    std::deque<std::string> reports;
+    {
+        std::lock_guard<std::mutex> progressLock(m_StagedSceneProgressMutex);
+        reports.swap(m_StagedSceneProgress);
+    }
+    for (const std::string &report : reports)
+        LoadingGUI::LoadingSplashProgressReport(report, true);
+    // Any errors the worker printed are queued until now
+    g_ConsoleMan.PrintQueuedStrings();
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Virtual method:  ReadProperty
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -418,6 +536,8 @@ int SceneMan::Save(Writer &writer) const
 
 void SceneMan::Destroy()
 {
+    DiscardPreloadedScene();
+
     for (int i = 0; i < c_PaletteEntriesNumber; ++i)
         delete m_apMatPalette[i];
 
@@ -622,6 +742,37 @@ MOID SceneMan::GetMOIDPixel(int pixelX, int pixelY)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTerrMattersAndMOIDs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the terrain materials and MOIDs at a batch of pixel coordinates in
+//                  one go, exactly as GetTerrMatter and GetMOIDPixel would get them for
+//                  each, but reading the bitmaps directly.
+
+void SceneMan::GetTerrMattersAndMOIDs(int pixelCount, const int *pixelXs, const int *pixelYs, unsigned char *terrMatters, MOID *moids)
+{
+    RTEAssert(m_pCurrentScene, "Trying to get terrain matter before there is a scene or terrain!");
+
+    SLTerrain *pTerrain = m_pCurrentScene->GetTerrain();
+    const BITMAP *pTMatBitmap = pTerrain->GetMaterialBitmap();
+    const BITMAP *pMOIDBitmap = m_pMOIDLayer->GetBitmap();
+    RTEAssert(bitmap_color_depth(const_cast<BITMAP *>(pMOIDBitmap)) == c_MOIDLayerBitDepth && is_memory_bitmap(const_cast<BITMAP *>(pMOIDBitmap)), "MOID layer isn't a 16bpp memory bitmap, so it can't be read directly!");
+
+    for (int pixel = 0; pixel < pixelCount; ++pixel)
+    {
+        int pixelX = pixelXs[pixel];
+        int pixelY = pixelYs[pixel];
+        // Positions on the terrain can't be wrapped any further, and Atoms have almost always just been wrapped, so only call out for the rest
+        if (pixelX < 0 || pixelX >= pTMatBitmap->w || pixelY < 0 || pixelY >= pTMatBitmap->h)
+            pTerrain->WrapPosition(pixelX, pixelY);
+
+        // Same out of bounds handling as GetTerrMatter and GetMOIDPixel
+        terrMatters[pixel] = (pixelX < 0 || pixelX >= pTMatBitmap->w || pixelY < 0 || pixelY >= pTMatBitmap->h) ? g_MaterialAir : pTMatBitmap->line[pixelY][pixelX];
+        moids[pixel] = (pixelX < 0 || pixelX >= pMOIDBitmap->w || pixelY < 0 || pixelY >= pMOIDBitmap->h) ? g_NoMOID : reinterpret_cast<const unsigned short *>(pMOIDBitmap->line[pixelY])[pixelX];
+    }
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetMaterial
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -891,11 +1042,37 @@ void SceneMan::RegisterMOIDDrawing(const Vector &center, float radius)
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Clears all registered drawn areas of the MOID layer to the g_NoMOID
 //                  color and clears the registrations too. Should be done each sim update.
+//                  Overlapping areas are merged first where that clears fewer pixels.
 
 void SceneMan::ClearAllMOIDDrawings()
 {
-    for (list<IntRect>::iterator itr = m_MOIDDrawings.begin(); itr != m_MOIDDrawings.end(); ++itr)
-        ClearMOIDRect(itr->m_Left, itr->m_Top, itr->m_Right, itr->m_Bottom);
+    // Attachables register their own areas on top of their parents', so a lot of them overlap. Sorting by the left edges puts the overlapping ones next to each other
+    std::sort(m_MOIDDrawings.begin(), m_MOIDDrawings.end(), [](const IntRect &lhs, const IntRect &rhs) { return lhs.m_Left < rhs.m_Left; });
+
+    // Merge each area into one of the last few merged ones if their bounding rect has no more pixels than the two have separately, i.e. if they overlap enough
+    const int maxMergeCandidates = 8;
+    int mergedCount = 0;
+    for (const IntRect &drawing : m_MOIDDrawings)
+    {
+        bool merged = false;
+        for (int candidate = mergedCount - 1; candidate >= std::max(mergedCount - maxMergeCandidates, 0) && !merged; --candidate)
+        {
+            IntRect &mergedRect = m_MOIDDrawings[candidate];
+            IntRect boundingRect(std::min(mergedRect.m_Left, drawing.m_Left), std::min(mergedRect.m_Top, drawing.m_Top), std::max(mergedRect.m_Right, drawing.m_Right), std::max(mergedRect.m_Bottom, drawing.m_Bottom));
+            long long separateArea = static_cast<long long>(mergedRect.m_Right - mergedRect.m_Left + 1) * (mergedRect.m_Bottom - mergedRect.m_Top + 1) + static_cast<long long>(drawing.m_Right - drawing.m_Left + 1) * (drawing.m_Bottom - drawing.m_Top + 1);
+            if (static_cast<long long>(boundingRect.m_Right - boundingRect.m_Left + 1) * (boundingRect.m_Bottom - boundingRect.m_Top + 1) <= separateArea)
+            {
+                mergedRect = boundingRect;
+                merged = true;
+            }
+        }
+        // The merged areas are compacted to the front of the same vector, which never overtakes the area being read
+        if (!merged)
+            m_MOIDDrawings[mergedCount++] = drawing;
+    }
+
+    for (int i = 0; i < mergedCount; ++i)
+        ClearMOIDRect(m_MOIDDrawings[i].m_Left, m_MOIDDrawings[i].m_Top, m_MOIDDrawings[i].m_Right, m_MOIDDrawings[i].m_Bottom);
 
     m_MOIDDrawings.clear();
 }
@@ -979,6 +1156,9 @@ bool SceneMan::WillPenetrate(const int posX,
 
 int SceneMan::RemoveOrphans(int posX, int posY, int radius, int maxArea, bool remove)
 {
+	if (g_MovableMan.RefuseInParallelAI("SceneMan::RemoveOrphans"))
+		return 0;
+
 	if (radius > MAXORPHANRADIUS)
 		radius = MAXORPHANRADIUS;
 
@@ -1385,6 +1565,9 @@ bool SceneMan::TryPenetrate(const int posX,
 
 void SceneMan::MakeAllUnseen(Vector pixelSize, const int team)
 {
+    if (g_MovableMan.RefuseInParallelAI("SceneMan::MakeAllUnseen"))
+        return;
+
     RTEAssert(m_pCurrentScene, "Messing with scene before the scene exists!");
 	if (team < Activity::TeamOne || team >= Activity::MaxTeamCount) 
 		return;
@@ -1410,6 +1593,9 @@ void SceneMan::MakeAllUnseen(Vector pixelSize, const int team)
 
 bool SceneMan::LoadUnseenLayer(std::string bitmapPath, int team)
 {
+    if (g_MovableMan.RefuseInParallelAI("SceneMan::LoadUnseenLayer"))
+        return false;
+
     ContentFile bitmapFile(bitmapPath.c_str());
     SceneLayer *pUnseenLayer = new SceneLayer();
     if (pUnseenLayer->Create(bitmapFile.LoadAndReleaseBitmap(), true, Vector(), m_pCurrentScene->WrapsX(), m_pCurrentScene->WrapsY(), Vector(1.0, 1.0)) < 0)
@@ -1476,7 +1662,8 @@ bool SceneMan::IsUnseen(const int posX, const int posY, const int team)
         Vector scale = pUnseenLayer->GetScaleInverse();
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
-        return getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY) != g_MaskColor;
+        VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team);
+        return !pVisibilityGrid || !pVisibilityGrid->IsRevealed(scaledX, scaledY);
     }
 
     return false;
@@ -1502,16 +1689,12 @@ bool SceneMan::RevealUnseen(const int posX, const int posY, const int team)
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
 
-        // Make sure we're actually revealing an unseen pixel that is ON the bitmap!
-        int pixel = getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY);
-        if (pixel != g_MaskColor && pixel != -1)
+        // Make sure we're actually revealing an unseen pixel that is ON the map! It gets drawn onto the unseen layer, and visually flashed, when the scene updates
+        VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team);
+        if (pVisibilityGrid && pVisibilityGrid->Reveal(scaledX, scaledY))
         {
-            // Add the pixel to the list of now seen pixels so it can be visually flashed
-            m_pCurrentScene->GetSeenPixels(team).push_back(Vector(scaledX, scaledY));
-            // Clear to key color that pixel on the map so it won't be detected as unseen again
-            putpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY, g_MaskColor);
             // Play the reveal sound, if there's not too many already revealed this frame
-            if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && m_pCurrentScene->GetSeenPixels(team).size() < 5)
+            if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && pVisibilityGrid->GetRecentlyRevealedCount() < 5)
                 m_pUnseenRevealSound->Play(Vector(posX, posY));
             // Show that we actually cleared an unseen pixel
             return true;
@@ -1522,6 +1705,48 @@ bool SceneMan::RevealUnseen(const int posX, const int posY, const int team)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RevealUnseenPixels
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reveals a batch of pixels on the unseen map for a specific team, if there
+//                  is any, locking the team's visibility grid only once for all of them.
+
+bool SceneMan::RevealUnseenPixels(const std::vector<std::pair<int, int>> &scenePixels, const int team)
+{
+    RTEAssert(m_pCurrentScene, "Checking scene before the scene exists!");
+	if (team < Activity::TeamOne || team >= Activity::MaxTeamCount || scenePixels.empty())
+		return false;
+
+    SceneLayer *pUnseenLayer = m_pCurrentScene->GetUnseenLayer(team);
+    VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team);
+    if (!pUnseenLayer || !pVisibilityGrid)
+        return false;
+
+    // Kept around per thread so sight rays don't allocate every time
+    static thread_local std::vector<std::pair<int, int>> scaledPixels;
+    static thread_local std::vector<int> newlyRevealed;
+
+    // Translate to the scaled unseen layer's coordinates
+    Vector scale = pUnseenLayer->GetScaleInverse();
+    scaledPixels.clear();
+    for (const std::pair<int, int> &scenePixel : scenePixels)
+        scaledPixels.emplace_back(static_cast<int>(scenePixel.first * scale.m_X), static_cast<int>(scenePixel.second * scale.m_Y));
+
+    int recentlyRevealedCount = pVisibilityGrid->Reveal(scaledPixels, newlyRevealed);
+    if (newlyRevealed.empty())
+        return false;
+
+    // Play the reveal sound for the pixels that were revealed while there weren't too many already revealed this frame
+    if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound)
+    {
+        int countBeforeBatch = recentlyRevealedCount - static_cast<int>(newlyRevealed.size());
+        for (int revealed = 0; revealed < static_cast<int>(newlyRevealed.size()) && countBeforeBatch + revealed + 1 < 5; ++revealed)
+            m_pUnseenRevealSound->Play(Vector(scenePixels[newlyRevealed[revealed]].first, scenePixels[newlyRevealed[revealed]].second));
+    }
+    return true;
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RestoreUnseen
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1541,16 +1766,12 @@ bool SceneMan::RestoreUnseen(const int posX, const int posY, const int team)
         int scaledX = posX * scale.m_X;
         int scaledY = posY * scale.m_Y;
 
-        // Make sure we're actually revealing an unseen pixel that is ON the bitmap!
-        int pixel = getpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY);
-        if (pixel != g_BlackColor && pixel != -1)
+        // Make sure we're actually hiding a seen pixel that is ON the map!
+        VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team);
+        if (pVisibilityGrid && pVisibilityGrid->Restore(scaledX, scaledY))
         {
-            // Add the pixel to the list of now seen pixels so it can be visually flashed
-            m_pCurrentScene->GetSeenPixels(team).push_back(Vector(scaledX, scaledY));
-            // Clear to key color that pixel on the map so it won't be detected as unseen again
-            putpixel(pUnseenLayer->GetBitmap(), scaledX, scaledY, g_BlackColor);
             // Play the reveal sound, if there's not too many already revealed this frame
-            //if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && m_pCurrentScene->GetSeenPixels(team).size() < 5)
+            //if (g_SettingsMan.BlipOnRevealUnseen() && m_pUnseenRevealSound && pVisibilityGrid->GetRecentlyRevealedCount() < 5)
             //    m_pUnseenRevealSound->Play(g_SceneMan.TargetDistanceScalar(Vector(posX, posY)));
             // Show that we actually cleared an unseen pixel
             return true;
@@ -1583,7 +1804,8 @@ void SceneMan::RevealUnseenBox(const int posX, const int posY, const int width,
         int scaledH = height * scale.m_Y;
 
         // Fill the box
-        rectfill(pUnseenLayer->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_MaskColor);
+        if (VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team))
+            pVisibilityGrid->SetBox(scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, true);
     }
 }
 
@@ -1610,7 +1832,8 @@ void SceneMan::RestoreUnseenBox(const int posX, const int posY, const int width,
         int scaledH = height * scale.m_Y;
 
         // Fill the box
-        rectfill(pUnseenLayer->GetBitmap(), scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, g_BlackColor);
+        if (VisibilityGrid *pVisibilityGrid = m_pCurrentScene->GetVisibilityGrid(team))
+            pVisibilityGrid->SetBox(scaledX, scaledY, scaledX + scaledW, scaledY + scaledH, false);
     }
 }
 
@@ -1624,6 +1847,7 @@ void SceneMan::RestoreUnseenBox(const int posX, const int posY, const int width,
 
 bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, Vector &endPos, int strengthLimit, int skip, bool reveal)
 {
+    ProfileScope profileScope("SceneMan::CastUnseenRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -1638,6 +1862,9 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
     unsigned char materialID;
     Material const * foundMaterial;
     int totalStrength = 0;
+    // The pixels to reveal are gathered and revealed together once the ray is done, so the visibility grid is only locked once per ray
+    static thread_local std::vector<std::pair<int, int>> pixelsToReveal;
+    pixelsToReveal.clear();
     // Save the projected end of the ray pos
     endPos = start + ray;
 
@@ -1704,7 +1931,7 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
             g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
             // Reveal if we can, save the result
 			if (reveal)
-				affectedAny = RevealUnseen(intPos[X], intPos[Y], team) || affectedAny;
+				pixelsToReveal.emplace_back(intPos[X], intPos[Y]);
 			else
 				affectedAny = RestoreUnseen(intPos[X], intPos[Y], team) || affectedAny;
 
@@ -1731,6 +1958,9 @@ bool SceneMan::CastUnseenRay(int team, const Vector &start, const Vector &ray, V
         }
     }
 
+    if (reveal)
+        affectedAny = RevealUnseenPixels(pixelsToReveal, team);
+
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->UnlockBitmaps();
@@ -1773,6 +2003,7 @@ bool SceneMan::CastUnseeRay(int team, const Vector &start, const Vector &ray, Ve
 
 bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool wrap)
 {
+    ProfileScope profileScope("SceneMan::CastMaterialRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -1852,7 +2083,7 @@ bool SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
                 foundPixel = true;
                 result.SetXY(intPos[X], intPos[Y]);
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                 break;
             }
 
@@ -1904,6 +2135,7 @@ float SceneMan::CastMaterialRay(const Vector &start, const Vector &ray, unsigned
 
 bool SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsigned char material, Vector &result, int skip, bool checkMOs)
 {
+    ProfileScope profileScope("SceneMan::CastNotMaterialRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -1984,7 +2216,7 @@ bool SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsign
                 foundPixel = true;
                 result.SetXY(intPos[X], intPos[Y]);
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                 break;
             }
 
@@ -2035,6 +2267,7 @@ float SceneMan::CastNotMaterialRay(const Vector &start, const Vector &ray, unsig
 
 float SceneMan::CastStrengthSumRay(const Vector &start, const Vector &end, int skip, unsigned char ignoreMaterial)
 {
+    ProfileScope profileScope("SceneMan::CastStrengthSumRay");
     Vector ray = g_SceneMan.ShortestDistance(start, end);
     float strengthSum = 0;
 
@@ -2129,14 +2362,27 @@ float SceneMan::CastStrengthSumRay(const Vector &start, const Vector &end, int s
 
 float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int skip)
 {
+    RTEAssert(m_pCurrentScene, "Trying to get terrain matter before there is a scene or terrain!");
+
+    return CastMaxStrengthRayInBitmap(start, end, skip, m_pCurrentScene->GetTerrain()->GetMaterialBitmap());
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastMaxStrengthRayInBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Same as CastMaxStrengthRay, but traces through a specific material
+//                  bitmap the size of the scene instead of the terrain's own.
+
+float SceneMan::CastMaxStrengthRayInBitmap(const Vector &start, const Vector &end, int skip, BITMAP *materialBitmap)
+{
+    ProfileScope profileScope("SceneMan::CastMaxStrengthRayInBitmap");
     Vector ray = g_SceneMan.ShortestDistance(start, end);
     float maxStrength = 0;
 
     int error, dom, sub, domSteps, skipped = skip;
     int intPos[2], delta[2], delta2[2], increment[2];
-    bool foundPixel = false;
     unsigned char materialID;
-    Material foundMaterial;
 
     intPos[X] = floorf(start.m_X);
     intPos[Y] = floorf(start.m_Y);
@@ -2201,8 +2447,8 @@ float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int s
             // Scene wrapping, if necessary
             g_SceneMan.WrapPosition(intPos[X], intPos[Y]);
 
-            // Sum all strengths
-            materialID = GetTerrMatter(intPos[X], intPos[Y]);
+            // Anything out of bounds after wrapping is air, same as in GetTerrMatter
+            materialID = (intPos[X] >= 0 && intPos[X] < materialBitmap->w && intPos[Y] >= 0 && intPos[Y] < materialBitmap->h) ? getpixel(materialBitmap, intPos[X], intPos[Y]) : g_MaterialAir;
             if (materialID != g_MaterialDoor)
                 maxStrength = std::max(maxStrength, GetMaterialFromID(materialID)->GetIntegrity());
 
@@ -2224,6 +2470,7 @@ float SceneMan::CastMaxStrengthRay(const Vector &start, const Vector &end, int s
 
 bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, unsigned char ignoreMaterial, bool wrap)
 {
+    ProfileScope profileScope("SceneMan::CastStrengthRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -2312,7 +2559,7 @@ bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float str
                     foundPixel = true;
                     result.SetXY(intPos[X], intPos[Y]);
                     // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                    s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                     break;
                 }
             }
@@ -2348,6 +2595,7 @@ bool SceneMan::CastStrengthRay(const Vector &start, const Vector &ray, float str
 
 bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float strength, Vector &result, int skip, bool wrap)
 {
+    ProfileScope profileScope("SceneMan::CastWeaknessRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -2432,7 +2680,7 @@ bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float str
                 foundPixel = true;
                 result.SetXY(intPos[X], intPos[Y]);
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                 break;
             }
 
@@ -2468,6 +2716,7 @@ bool SceneMan::CastWeaknessRay(const Vector &start, const Vector &ray, float str
 
 MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
 {
+    ProfileScope profileScope("SceneMan::CastMORay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -2558,7 +2807,7 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
                     else
                     {
                         // Save last ray pos
-                        m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                        s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                         return hitMOID;
                     }
                 }
@@ -2566,7 +2815,7 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
                 else
                 {
                     // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                    s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                     return hitMOID;
                 }
             }
@@ -2578,7 +2827,7 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
                 if (hitTerrain != g_MaterialAir && hitTerrain != ignoreMaterial)
                 {
                     // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                    s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                     return g_NoMOID;
                 }
             }
@@ -2610,6 +2859,7 @@ MOID SceneMan::CastMORay(const Vector &start, const Vector &ray, MOID ignoreMOID
 
 bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID targetMOID, Vector &resultPos, unsigned char ignoreMaterial, bool ignoreAllTerrain, int skip)
 {
+    ProfileScope profileScope("SceneMan::CastFindMORay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -2689,7 +2939,7 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
                 // Found target MOID, so save result and report success
                 resultPos.SetXY(intPos[X], intPos[Y]);
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                 return true;
             }
 
@@ -2700,7 +2950,7 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
                 if (hitTerrain != g_MaterialAir && hitTerrain != ignoreMaterial)
                 {
                     // Save last ray pos
-                    m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                    s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                     return false;
                 }
             }
@@ -2733,6 +2983,7 @@ bool SceneMan::CastFindMORay(const Vector &start, const Vector &ray, MOID target
 
 float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &obstaclePos, Vector &freePos, MOID ignoreMOID, int ignoreTeam, unsigned char ignoreMaterial, int skip)
 {
+    ProfileScope profileScope("SceneMan::CastObstacleRay");
 #ifdef DEBUG_BUILD
     if (m_pDebugLayer)
         m_pDebugLayer->LockBitmaps();
@@ -2834,7 +3085,7 @@ float SceneMan::CastObstacleRay(const Vector &start, const Vector &ray, Vector &
                 hitObstacle = true;
                 obstaclePos.SetXY(intPos[X], intPos[Y]);
                 // Save last ray pos
-                m_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
+                s_LastRayHitPos.SetIntXY(intPos[X], intPos[Y]);
                 break;
             }
             else
@@ -3383,6 +3634,9 @@ int SceneMan::WrapBox(const Box &wrapBox, list<Box> &outputList)
 
 bool SceneMan::AddTerrainObject(TerrainObject *pObject)
 {
+    if (g_MovableMan.RefuseInParallelAI("SceneMan::AddTerrainObject"))
+        return false;
+
     if (!pObject)
         return false;
 
@@ -3417,7 +3671,7 @@ bool SceneMan::AddSceneObject(SceneObject *pObject)
     }
     else if (TerrainObject *pTO = dynamic_cast<TerrainObject *>(pObject))
     {
-        bool result = m_pCurrentScene->GetTerrain()->ApplyObject(pTO);
+        bool result = !g_MovableMan.RefuseInParallelAI("SceneMan::AddSceneObject") && m_pCurrentScene->GetTerrain()->ApplyObject(pTO);
         // Have to clean up the added object here, since ApplyObject doesn't take ownership
         delete pTO;
         pObject = pTO = 0;
@@ -3590,6 +3844,11 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
     int team = m_ScreenTeam[m_LastUpdatedScreen];
     SceneLayer *pUnseenLayer = team != Activity::NoTeam ? m_pCurrentScene->GetUnseenLayer(team) : 0;
 
+    // How far between their last two sim update positions the movables should be drawn. Nothing moves while the activity is paused, so draw them where they are
+    float interpolationFactor = 1.0F;
+    if (g_SettingsMan.InterpolatedDrawing() && !(g_ActivityMan.GetActivity() && g_ActivityMan.ActivityPaused()))
+        interpolationFactor = g_TimerMan.GetSimInterpolationFactor();
+
     // Set up the target box to draw to on the target bitmap, if it is larger than the scene in either dimension
     Box targetBox(Vector(0, 0), pTargetBitmap->w, pTargetBitmap->h);
 
@@ -3631,6 +3890,9 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
 				pTerrain->DrawBackground(pTargetBitmap, targetBox);
             // Movables' color layer
             m_pMOColorLayer->Draw(pTargetBitmap, targetBox);
+            // With interpolated drawing the movables aren't in the color layer, draw them in between their last two sim update positions
+            if (g_SettingsMan.InterpolatedDrawing())
+                g_MovableMan.Draw(pTargetBitmap, targetPos, interpolationFactor);
             // Terrain foreground
             pTerrain->SetToDrawMaterial(false);
 			if (!skipTerrain)
@@ -3644,7 +3906,7 @@ void SceneMan::Draw(BITMAP *pTargetBitmap, BITMAP *pTargetGUIBitmap, const Vecto
             }
 
             // Actor and gameplay HUDs and GUIs
-            g_MovableMan.DrawHUD(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
+            g_MovableMan.DrawHUD(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen, false, interpolationFactor);
 			g_PrimitiveMan.DrawPrimitives(m_LastUpdatedScreen, pTargetGUIBitmap, targetPos);
 //            g_ActivityMan.GetActivity()->Draw(pTargetBitmap, targetPos, m_LastUpdatedScreen);
             g_ActivityMan.GetActivity()->DrawGUI(pTargetGUIBitmap, targetPos, m_LastUpdatedScreen);
@@ -258,6 +258,32 @@ public:
 	int LoadScene(std::string sceneName, bool placeObjects = true) { return LoadScene(sceneName, placeObjects, true); }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          PreloadScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts loading the layer data of a clone of a Scene on a worker
+//                  thread, so that loading it later with SetSceneToLoad and LoadScene
+//                  only has to place its objects. Any other Scene being preloaded is
+//                  discarded.
+// Arguments:       The instance reference of the Scene, ownership IS NOT (!!) transferred!
+//                  The preloaded clone is only used if the Scene is still at the same
+//                  layer data generation when it's loaded.
+// Return value:    None.
+
+	void PreloadScene(const Scene *pSceneToPreload);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          DiscardPreloadedScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Throws away any Scene being preloaded, waiting for its worker to
+//                  finish first.
+// Arguments:       None.
+// Return value:    None.
+
+	void DiscardPreloadedScene();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:  Reset
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -526,6 +552,23 @@ public:
     MOID GetMOIDPixel(int pixelX, int pixelY);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          GetTerrMattersAndMOIDs
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Gets the terrain materials and MOIDs at a batch of pixel coordinates in
+//                  one go, exactly as GetTerrMatter and GetMOIDPixel would get them for
+//                  each, but reading the bitmaps directly. LockScene() must be called
+//                  before using this method.
+// Arguments:       How many pixel coordinates there are.
+//                  The X coordinates of the pixels.
+//                  The Y coordinates of the pixels.
+//                  The array to put the terrain material at each pixel into.
+//                  The array to put the MOID at each pixel into.
+// Return value:    None.
+
+    void GetTerrMattersAndMOIDs(int pixelCount, const int *pixelXs, const int *pixelYs, unsigned char *terrMatters, MOID *moids);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          GetGlobalAcc
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -796,6 +839,7 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////
 // Description:     Clears all registered drawn areas of the MOID layer to the g_NoMOID
 //                  color and clears the registrations too. Should be done each sim update.
+//                  Overlapping areas are merged first where that clears fewer pixels.
 // Arguments:       None.
 // Return value:    None.
 
@@ -1000,6 +1044,18 @@ public:
     bool RevealUnseen(const int posX, const int posY, const int team);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          RevealUnseenPixels
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Reveals a batch of pixels on the unseen map for a specific team, if there
+//                  is any, locking the team's visibility grid only once for all of them.
+// Arguments:       The X and Y coords of the scene pixels that are to be revealed.
+//                  The team to reveal for.
+// Return value:    A bool indicating whether any unseen pixels were revealed.
+
+    bool RevealUnseenPixels(const std::vector<std::pair<int, int>> &scenePixels, const int team);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          RestoreUnseen
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1197,6 +1253,24 @@ public:
     float CastMaxStrengthRay(const Vector &start, const Vector &end, int skip);
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          CastMaxStrengthRayInBitmap
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Same as CastMaxStrengthRay, but traces through a specific material
+//                  bitmap the size of the scene instead of the terrain's own, such as a
+//                  snapshot of it. Doesn't touch the terrain, so it can be used on other
+//                  threads while the terrain changes.
+// Arguments:       The starting position.
+//                  The ending position.
+//                  For every pixel checked along the line, how many to skip between them
+//                  for optimization reasons. 0 = every pixel is checked.
+//                  The material bitmap to trace through. Ownership is NOT transferred!
+// Return value:    The max of all encountered pixels' material strength vales. So if it was
+//                  all Air, then 0 is returned (Air's strength value is 0).
+
+    float CastMaxStrengthRayInBitmap(const Vector &start, const Vector &end, int skip, BITMAP *materialBitmap);
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Method:          CastStrengthRay
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1311,7 +1385,18 @@ public:
 // Arguments:       None.
 // Return value:    A vector witht he absoltue pos of where the last ray cast hit somehting.
 
-    const Vector & GetLastRayHitPos() { return m_LastRayHitPos; }
+    const Vector & GetLastRayHitPos() { return s_LastRayHitPos; }
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          SetLastRayHitPos
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Sets the absolute pos of where the last cast ray hit something. Used
+//                  when a cached ray result is given out in place of actually casting one.
+// Arguments:       The absolute pos of where the ray hit something.
+// Return value:    None.
+
+    void SetLastRayHitPos(const Vector &hitPos) { s_LastRayHitPos = hitPos; }
 
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -1692,6 +1777,17 @@ protected:
 	// Whether to place units and deployments when loading scence
 	bool m_PlaceUnits;
 
+    // The Scene whose layer data is being loaded or was loaded on a worker thread, waiting to be loaded for real. OWNED
+    Scene *m_pStagedScene;
+    // The layer data generation of the Scene the staged Scene was cloned from with PreloadScene, or 0 if none. Unlike its address, this is never reused by another Scene
+    unsigned long long m_PreloadSourceGeneration;
+    // The loading of the staged Scene's layer data on the worker thread
+    std::future<int> m_StagedSceneLoading;
+    // The progress reports of the worker thread that haven't been shown yet
+    std::deque<std::string> m_StagedSceneProgress;
+    // Guards the above progress reports
+    std::mutex m_StagedSceneProgressMutex;
+
     // Current scene being used
     Scene *m_pCurrentScene;
     // Color MO layer
@@ -1699,12 +1795,12 @@ protected:
     // MovableObject ID layer
     SceneLayer *m_pMOIDLayer;
     // All the areas drawn within on the MOID layer since last Update
-    std::list<IntRect> m_MOIDDrawings;
+    std::vector<IntRect> m_MOIDDrawings;
 
     // Debug layer for seeing cast rays etc
     SceneLayer *m_pDebugLayer;
-    // The absolute end position of the last ray cast
-    Vector m_LastRayHitPos;
+    // The absolute end position of the last ray cast on each thread, since the parallel AI workers cast rays too
+    static thread_local Vector s_LastRayHitPos;
     // The mode we're drawing layers in to the screen
     int m_LayerDrawMode;
 
@@ -1760,6 +1856,40 @@ protected:
 	BITMAP * m_pOrphanSearchBitmap;
 
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          StageScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Starts loading the layer data of a Scene on a worker thread, after
+//                  discarding any Scene already staged.
+// Arguments:       The Scene to load the layer data of, ownership IS transferred!
+// Return value:    None.
+
+    void StageScene(Scene *pScene);
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          FinishStagedScene
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Waits for the worker loading the staged Scene's layer data, showing
+//                  its progress on the loading screen meanwhile.
+// Arguments:       None.
+// Return value:    An error return value signaling sucess or any particular failure.
+//                  Anything below 0 is an error signal.
+
+    int FinishStagedScene();
+
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Method:          ShowStagedSceneProgress
+//////////////////////////////////////////////////////////////////////////////////////////
+// Description:     Shows any new progress reports of the worker loading the staged
+//                  Scene on the loading screen.
+// Arguments:       None.
+// Return value:    None.
+
+    void ShowStagedSceneProgress();
+
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Private member variable and method declarations
 
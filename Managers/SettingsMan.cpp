@@ -19,6 +19,8 @@ namespace RTE {
 		m_ForceVirtualFullScreenGfxDriver = false;
 		m_ForceOverlayedWindowGfxDriver = false;
 		m_ForceNonOverlayedWindowGfxDriver = false;
+		m_InterpolatedDrawing = false;
+		m_PipelinedRendering = false;
 
 		m_SoundPanningEffectStrength = 0.6F;
 		//////////////////////////////////////////////////
@@ -59,6 +61,9 @@ namespace RTE {
 
 		m_RecommendedMOIDCount = 240;
 		m_PreciseCollisions = true;
+		m_ParallelScriptedAI = false;
+		m_UpdateLODEnabled = true;
+		m_SaveSceneLayersAsBitmaps = false;
 
 		m_LaunchIntoActivity = false;
 
@@ -119,6 +124,10 @@ namespace RTE {
 			reader >> m_ForceOverlayedWindowGfxDriver;
 		} else if (propName == "ForceNonOverlayedWindowGfxDriver") {
 			reader >> m_ForceNonOverlayedWindowGfxDriver;
+		} else if (propName == "InterpolatedDrawing") {
+			reader >> m_InterpolatedDrawing;
+		} else if (propName == "PipelinedRendering") {
+			reader >> m_PipelinedRendering;
 		} else if (propName == "SoundVolume") {
 			g_AudioMan.SetSoundsVolume(std::stod(reader.ReadPropValue()) / 100.0);
 		} else if (propName == "MusicVolume") {
@@ -171,6 +180,12 @@ namespace RTE {
 			reader >> m_PreciseCollisions;
 		*/
 
+		} else if (propName == "ParallelScriptedAI") {
+			reader >> m_ParallelScriptedAI;
+		} else if (propName == "EnableUpdateLOD") {
+			reader >> m_UpdateLODEnabled;
+		} else if (propName == "SaveSceneLayersAsBitmaps") {
+			reader >> m_SaveSceneLayersAsBitmaps;
 		} else if (propName == "EnableParticleSettling") {
 			g_MovableMan.ReadProperty(propName, reader);
 		} else if (propName == "EnableMOSubtraction") {
@@ -279,6 +294,10 @@ namespace RTE {
 		writer << m_ForceOverlayedWindowGfxDriver;
 		writer.NewProperty("ForceNonOverlayedWindowGfxDriver");
 		writer << m_ForceNonOverlayedWindowGfxDriver;
+		writer.NewProperty("InterpolatedDrawing");
+		writer << m_InterpolatedDrawing;
+		writer.NewProperty("PipelinedRendering");
+		writer << m_PipelinedRendering;
 
 		writer.NewLine(false, 2);
 		writer.NewDivider(false);
@@ -349,6 +368,12 @@ namespace RTE {
 		writer << m_PreciseCollisions;
 		*/
 
+		writer.NewProperty("ParallelScriptedAI");
+		writer << m_ParallelScriptedAI;
+		writer.NewProperty("EnableUpdateLOD");
+		writer << m_UpdateLODEnabled;
+		writer.NewProperty("SaveSceneLayersAsBitmaps");
+		writer << m_SaveSceneLayersAsBitmaps;
 		writer.NewProperty("EnableParticleSettling");
 		writer << g_MovableMan.IsParticleSettlingEnabled();
 		writer.NewProperty("EnableMOSubtraction");
@@ -87,6 +87,24 @@ namespace RTE {
 		/// </summary>
 		/// <param name="newValue">True for precise collisions.</param>
 		void SetPreciseCollisions(bool newValue) { m_PreciseCollisions = newValue; }
+
+		/// <summary>
+		/// Gets whether the scripted AI of Actors whose AI scripts are marked as thread-safe is run on multiple threads at once, each with its own Lua state.
+		/// </summary>
+		/// <returns>Whether thread-safe AI scripts are run in parallel.</returns>
+		bool ParallelScriptedAI() const { return m_ParallelScriptedAI; }
+
+		/// <summary>
+		/// Gets whether Actors and items far from the players' views, or idle and settled there, are updated less often than every sim update.
+		/// </summary>
+		/// <returns>Whether level of detail update scheduling is enabled.</returns>
+		bool UpdateLODEnabled() const { return m_UpdateLODEnabled; }
+
+		/// <summary>
+		/// Gets whether the layers of Scenes saved with metagames are exported as plain bitmaps instead of compressed scene layer files.
+		/// </summary>
+		/// <returns>Whether scene layers are saved as bitmaps.</returns>
+		bool SaveSceneLayersAsBitmaps() const { return m_SaveSceneLayersAsBitmaps; }
 #pragma endregion
 
 #pragma region Display Settings
@@ -107,6 +125,18 @@ namespace RTE {
 		/// </summary>
 		/// <returns>True if forced to use software driver.</returns>
 		bool ForceNonOverlayedWindowGfxDriver() const { return m_ForceNonOverlayedWindowGfxDriver; }
+
+		/// <summary>
+		/// Whether MovableObjects are drawn each frame in between their last two sim update positions instead of being drawn once per sim update, so motion stays smooth when the frame rate is higher than the sim rate.
+		/// </summary>
+		/// <returns>Whether interpolated drawing is enabled.</returns>
+		bool InterpolatedDrawing() const { return m_InterpolatedDrawing; }
+
+		/// <summary>
+		/// Whether a drawn frame is presented to the screen on a separate thread while the next sim updates are already running.
+		/// </summary>
+		/// <returns>Whether pipelined rendering is enabled.</returns>
+		bool PipelinedRendering() const { return m_PipelinedRendering; }
 #pragma endregion
 
 #pragma region Audio Settings
@@ -480,6 +510,8 @@ namespace RTE {
 		bool m_ForceVirtualFullScreenGfxDriver; //!< Whether we should try using fullscreen mode.
 		bool m_ForceOverlayedWindowGfxDriver; //!< Whether we should try using overlayed window driver.
 		bool m_ForceNonOverlayedWindowGfxDriver; //!< Whether we should try using non-overlayed window driver.
+		bool m_InterpolatedDrawing; //!< Whether MovableObjects are drawn in between their last two sim update positions every frame.
+		bool m_PipelinedRendering; //!< Whether frames are presented to the screen on a separate thread while the sim keeps updating.
 
 		float m_SoundPanningEffectStrength; //!< The strength of the sound panning effect, 0 (no panning) - 1 (full panning).
 
@@ -531,6 +563,9 @@ namespace RTE {
 		bool m_ShowMetaScenes; //!< Show MetaScenes in editors and activities.
 
 		unsigned int m_RecommendedMOIDCount; //!< Recommended max MOID's before removing actors from scenes.
+		bool m_ParallelScriptedAI; //!< Whether thread-safe AI scripts are run on multiple threads at once.
+		bool m_UpdateLODEnabled; //!< Whether Actors and items far from the players' views get updated less often.
+		bool m_SaveSceneLayersAsBitmaps; //!< Whether scene layers are saved as plain bitmaps instead of compressed scene layer files.
 		bool m_PreciseCollisions; //!<Whether to use additional Draws during MO's PreTravel and PostTravel to update MO layer this frame with more precision, or just uses data from the last frame with less precision.
 
 		bool m_LaunchIntoActivity; //!< Whether to skip the intro and main menu and launch directly into the set default activity instead.
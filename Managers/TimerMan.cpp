@@ -25,6 +25,7 @@ namespace RTE {
 		// This gets dynamically turned on for short periods when sim gets heavy (explosions) and slow-mo effect is appropriate
 		m_OneSimUpdatePerFrame = false;
 		m_SimSpeedLimited = true;
+		m_Deterministic = false;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -82,6 +82,12 @@ namespace RTE {
 		/// <returns>Whether there is enough sim time to do a physics update.</returns>
 		bool TimeForSimUpdate() const { return m_SimAccumulator >= m_DeltaTime; }
 
+		/// <summary>
+		/// Gets how far along the real time is from the last sim update towards the next one. Used to draw things in between their last two sim update states.
+		/// </summary>
+		/// <returns>A factor between 0 (the last sim update just happened) and 1 (the next sim update is due). Always 1 while the sim is paused.</returns>
+		float GetSimInterpolationFactor() const { return m_SimPaused ? 1.0F : std::min(static_cast<float>(m_SimAccumulator) / static_cast<float>(m_DeltaTime), 1.0F); }
+
 		/// <summary>
 		/// Tells whether the current simulation update will be drawn in a frame. Use this to check if it is necessary to draw purely graphical things during the sim update.
 		/// </summary>
@@ -143,6 +149,18 @@ namespace RTE {
 		/// <param name="simLimited">Whether the sim speed should be limited to not exceed 1.0.</param>
 		void SetSimSpeedLimited(bool simLimited = true) { m_SimSpeedLimited = simLimited; }
 
+		/// <summary>
+		/// Shows whether the sim has to give the same results every run, like when benchmarking or recording and playing back input. Systems that would otherwise adapt to how much real time is left, or finish work on other threads whenever it's ready, do a fixed amount of work at fixed sim updates instead.
+		/// </summary>
+		/// <returns>Whether the sim has to be deterministic.</returns>
+		bool IsDeterministic() const { return m_Deterministic; }
+
+		/// <summary>
+		/// Sets whether the sim has to give the same results every run, like when benchmarking or recording and playing back input.
+		/// </summary>
+		/// <param name="deterministic">Whether the sim has to be deterministic.</param>
+		void SetDeterministic(bool deterministic = true) { m_Deterministic = deterministic; }
+
 		/// <summary>
 		/// Gets the number of ticks per second (the resolution of the timer).
 		/// </summary>
@@ -215,6 +233,12 @@ namespace RTE {
 		/// </summary>
 		void UpdateSim();
 
+		/// <summary>
+		/// Advances the simulation time by exactly one DeltaTime, no matter how much real time has passed. The real time is advanced by the same amount, so real time Timers run the same way every time too.
+		/// Used to run the simulation as fast as possible and the same way every time, like when benchmarking. Update should not be called while stepping like this.
+		/// </summary>
+		void UpdateSimFixedStep() { m_RealTimeTicks += m_DeltaTime; m_SimAccumulator = m_DeltaTime; UpdateSim(); }
+
 		/// <summary>
 		/// Updates the real time ticks based on the actual clock time and adds it to the accumulator which the simulation ticks will draw from in whole DeltaTime-sized chunks.
 		/// </summary>
@@ -262,6 +286,7 @@ namespace RTE {
 		bool m_SimPaused; //!< Simulation paused; no real time ticks will go to the sim accumulator.
 		bool m_OneSimUpdatePerFrame; //!< Whether to force this to artificially make time for only one single sim update for the graphics frame. Useful for debugging or profiling.
 		bool m_SimSpeedLimited; //!< Whether the simulation is limited to going at 1.0x and not faster.
+		bool m_Deterministic; //!< Whether the sim has to give the same results every run, so nothing in it may depend on real time or thread timing.
 
 	private:
 
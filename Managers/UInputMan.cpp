@@ -5,6 +5,7 @@
 #include "ConsoleMan.h"
 #include "PresetMan.h"
 #include "PerformanceMan.h"
+#include "LuaMan.h"
 #include "GUIInput.h"
 #include "Icon.h"
 
@@ -32,6 +33,7 @@ namespace RTE {
 
 	void UInputMan::Clear() {
 		m_OverrideInput = false;
+		m_ReplayingInput = false;
 		m_RawMouseMovement.Reset();
 		m_AnalogMouseData.Reset();
 		m_MouseSensitivity = 0.6F;
@@ -297,6 +299,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	Vector UInputMan::AnalogMoveValues(short whichPlayer) {
+		if (m_ReplayingInput && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
+			return m_ReplayedInputStates[whichPlayer].AnalogMove;
+		}
 		Vector moveValues(0, 0);
 		InputDevice device = m_ControlScheme[whichPlayer].GetDevice();
 		if (device >= InputDevice::DEVICE_GAMEPAD_1) {
@@ -312,6 +317,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	Vector UInputMan::AnalogAimValues(short whichPlayer) {
+		if (m_ReplayingInput && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
+			return m_ReplayedInputStates[whichPlayer].AnalogAim;
+		}
 		InputDevice device = m_ControlScheme[whichPlayer].GetDevice();
 
 		if (IsInMultiplayerMode()) { device = InputDevice::DEVICE_MOUSE_KEYB; }
@@ -458,6 +466,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	Vector UInputMan::GetMouseMovement(short whichPlayer) const {
+		if (m_ReplayingInput && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
+			return m_ReplayedInputStates[whichPlayer].MouseMovement;
+		}
 		if (IsInMultiplayerMode() && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
 			return m_NetworkAccumulatedRawMouseMovement[whichPlayer];
 		}
@@ -634,6 +645,25 @@ namespace RTE {
 		return accumulatedMovement;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void UInputMan::GetPlayerInputState(short player, PlayerInputState &inputState) {
+		for (short element = InputElements::INPUT_L_UP; element < InputElements::INPUT_COUNT; ++element) {
+			for (short whichState = InputState::Held; whichState < InputState::InputStateCount; ++whichState) {
+				inputState.ElementStates[element][whichState] = GetInputElementState(player, element, static_cast<InputState>(whichState));
+			}
+		}
+		for (short mouseButton = MouseButtons::MOUSE_LEFT; mouseButton < MouseButtons::MAX_MOUSE_BUTTONS; ++mouseButton) {
+			for (short whichState = InputState::Held; whichState < InputState::InputStateCount; ++whichState) {
+				inputState.MouseButtonStates[mouseButton][whichState] = GetMouseButtonState(player, mouseButton, static_cast<InputState>(whichState));
+			}
+		}
+		inputState.AnalogMove = AnalogMoveValues(player);
+		inputState.AnalogAim = AnalogAimValues(player);
+		inputState.MouseMovement = GetMouseMovement(player);
+		inputState.MouseWheelChange = MouseWheelMovedByPlayer(player);
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void UInputMan::ClearNetworkAccumulatedStates() {
@@ -647,6 +677,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	bool UInputMan::GetInputElementState(short whichPlayer, short whichElement, InputState whichState) {
+		if (m_ReplayingInput && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
+			return m_ReplayedInputStates[whichPlayer].ElementStates[whichElement][whichState];
+		}
 		if (IsInMultiplayerMode() && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
 			return m_TrapMousePosPerPlayer[whichPlayer] ? m_NetworkInputElementState[whichPlayer][whichElement][whichState] : false;
 		}
@@ -712,6 +745,9 @@ namespace RTE {
 		if (whichButton < MouseButtons::MOUSE_LEFT || whichButton >= MouseButtons::MAX_MOUSE_BUTTONS) {
 			return false;
 		}
+		if (m_ReplayingInput && whichPlayer >= Players::PlayerOne && whichPlayer < Players::MaxPlayerCount) {
+			return m_ReplayedInputStates[whichPlayer].MouseButtonStates[whichButton][whichState];
+		}
 		if (IsInMultiplayerMode()) {
 			if (whichPlayer < Players::PlayerOne || whichPlayer >= Players::MaxPlayerCount) {
 				for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; player++) {
@@ -889,6 +925,22 @@ namespace RTE {
 				g_ConsoleMan.SaveInputLog("Console.input.log");
 			} else if (KeyPressed(KEY_F5)) {
 				g_ConsoleMan.ClearLog();
+			// F6 to toggle the Lua script profiler, saving the profile when it's stopped
+			} else if (KeyPressed(KEY_F6)) {
+				if (g_LuaMan.IsProfilingScripts()) {
+					g_LuaMan.StopScriptProfiling();
+					g_LuaMan.SaveScriptProfile("LuaProfile.folded");
+				} else {
+					g_LuaMan.StartScriptProfiling();
+				}
+			// F7 to toggle the profile capture, saving the trace when it's stopped
+			} else if (KeyPressed(KEY_F7)) {
+				if (g_PerformanceMan.IsCapturingProfile()) {
+					g_PerformanceMan.StopProfileCapture();
+					g_PerformanceMan.SaveProfileTrace("ProfileTrace.json");
+				} else {
+					g_PerformanceMan.StartProfileCapture();
+				}
 			}
 
 			if (g_PerformanceMan.IsShowingPerformanceStats()) {
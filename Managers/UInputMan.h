@@ -40,6 +40,18 @@ namespace RTE {
 			MENU_EITHER
 		};
 
+		/// <summary>
+		/// Everything a player's input amounts to in one update, as the Controllers and Activities read it. Used to record input and play it back.
+		/// </summary>
+		struct PlayerInputState {
+			bool ElementStates[InputElements::INPUT_COUNT][InputState::InputStateCount]; //!< The state of each input element.
+			bool MouseButtonStates[MouseButtons::MAX_MOUSE_BUTTONS][InputState::InputStateCount]; //!< The state of each mouse button.
+			Vector AnalogMove; //!< The analog movement values.
+			Vector AnalogAim; //!< The analog aiming values.
+			Vector MouseMovement; //!< The raw mouse movement since the last update.
+			int MouseWheelChange; //!< The relative mouse wheel position.
+		};
+
 #pragma region Creation
 		/// <summary>
 		/// Constructor method used to instantiate a UInputMan object in system memory. Create() should be called before using the object.
@@ -468,6 +480,9 @@ namespace RTE {
 		/// <param name="player">The player to get mouse wheel position for.</param>
 		/// <returns>The relative mouse wheel position for the specified player.</returns>
 		int MouseWheelMovedByPlayer(short player) const {
+			if (m_ReplayingInput && player >= Players::PlayerOne && player < Players::MaxPlayerCount) {
+				return m_ReplayedInputStates[player].MouseWheelChange;
+			}
 			return (IsInMultiplayerMode() && player >= Players::PlayerOne && player < Players::MaxPlayerCount) ? m_NetworkMouseWheelState[player] : m_MouseWheelChange;
 		}
 
@@ -736,6 +751,34 @@ namespace RTE {
 		void ClearNetworkAccumulatedStates();
 #pragma endregion
 
+#pragma region Input Replay Handling
+		/// <summary>
+		/// Gets everything a player's input amounts to in the current update, for recording it.
+		/// </summary>
+		/// <param name="player">The player to get for.</param>
+		/// <param name="inputState">The PlayerInputState to fill in.</param>
+		void GetPlayerInputState(short player, PlayerInputState &inputState);
+
+		/// <summary>
+		/// Gets whether the input of all players is being played back from PlayerInputStates instead of read from the devices.
+		/// </summary>
+		/// <returns>Whether input is being played back.</returns>
+		bool IsReplayingInput() const { return m_ReplayingInput; }
+
+		/// <summary>
+		/// Sets what a player's input amounts to in the current update, and starts playing back input instead of reading it from the devices if it wasn't already.
+		/// Input that isn't read per player, like hotkeys and the GUI, is still read from the devices.
+		/// </summary>
+		/// <param name="player">The player to set for.</param>
+		/// <param name="inputState">The input of the player in the current update.</param>
+		void SetReplayedInputState(short player, const PlayerInputState &inputState) { if (player >= Players::PlayerOne && player < Players::MaxPlayerCount) { m_ReplayedInputStates[player] = inputState; m_ReplayingInput = true; } }
+
+		/// <summary>
+		/// Stops playing back input, so it's read from the devices again.
+		/// </summary>
+		void StopReplayingInput() { m_ReplayingInput = false; }
+#pragma endregion
+
 #pragma region Class Info
 		/// <summary>
 		/// Gets the class name of this object.
@@ -794,6 +837,9 @@ namespace RTE {
 
 		bool m_TrapMousePosPerPlayer[Players::MaxPlayerCount]; //!< Whether to trap the mouse position to the middle of the screen for each player during network multiplayer.
 
+		bool m_ReplayingInput; //!< Whether the input of all players is being played back from m_ReplayedInputStates instead of read from the devices.
+		PlayerInputState m_ReplayedInputStates[Players::MaxPlayerCount]; //!< The input of each player being played back in the current update.
+
 	private:
 
 #pragma region Input State Handling
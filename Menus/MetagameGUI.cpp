@@ -1978,7 +1978,7 @@ void MetagameGUI::Draw(BITMAP *drawBitmap)
         // Transparency effect on the scene dots and lines
         drawing_mode(DRAW_MODE_TRANS, 0, 0, 0);
         // Screen blend the dots and lines, with some flickering in its intensity
-		int blendAmount = 130 + RandomNum(-45, 45);
+		int blendAmount = 130 + g_DrawRNG.RandomNum(-45, 45);
         set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
 
         // Draw the scene location dots
@@ -2005,11 +2005,11 @@ void MetagameGUI::Draw(BITMAP *drawBitmap)
             else
             {
                 // Make it flicker more if it's currently being fought over
-				blendAmount = 95 + (battleSite ? RandomNum(-25, 25) : RandomNum(-15, 15));
+				blendAmount = 95 + (battleSite ? g_DrawRNG.RandomNum(-25, 25) : g_DrawRNG.RandomNum(-15, 15));
                 set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
                 circlefill(drawBitmap, screenLocation.m_X, screenLocation.m_Y, 4, c_GUIColorYellow);
                 circlefill(drawBitmap, screenLocation.m_X, screenLocation.m_Y, 2, c_GUIColorYellow);
-				blendAmount = 210 + RandomNum(-45, 45);
+				blendAmount = 210 + g_DrawRNG.RandomNum(-45, 45);
                 set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
                 circlefill(drawBitmap, screenLocation.m_X, screenLocation.m_Y, 1, c_GUIColorYellow);
             }
@@ -4522,6 +4522,10 @@ void MetagameGUI::UpdateOffensives()
         m_BattleCausedOwnershipChange = false;
         m_PreBattleTeamOwnership = Activity::NoTeam;
 
+        // Start loading the site's layer data in the background while the players are looking at the battle info, unless it's going to be automatically resolved anyway
+        if (g_MetaMan.m_RoundOffensives[g_MetaMan.m_CurrentOffensive]->GetHumanCount() > 0 && g_MetaMan.m_RoundOffensives[g_MetaMan.m_CurrentOffensive]->GetTeamCount() > 1)
+            g_SceneMan.PreloadScene(m_pAnimScene);
+
         ChangeAnimMode(TARGETZEROING);
         m_AnimActivityChange = false;
     }
@@ -6685,7 +6689,7 @@ void MetagameGUI::UpdatePlayerLineRatios(vector<SiteLine> &lineList, int metaPla
 
 void MetagameGUI::DrawGlowLine(BITMAP *drawBitmap, const Vector &start, const Vector &end, int color)
 {
-	int blendAmount = 210 + RandomNum(-15, 15);
+	int blendAmount = 210 + g_DrawRNG.RandomNum(-15, 15);
     set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
     line(drawBitmap, start.m_X, start.m_Y, end.m_X, end.m_Y, color);
 /* Looks like ass
@@ -6701,7 +6705,7 @@ void MetagameGUI::DrawGlowLine(BITMAP *drawBitmap, const Vector &start, const Ve
         line(drawBitmap, start.m_X - 1, start.m_Y, end.m_X - 1, end.m_Y, color);
     }
 */
-	blendAmount = 45 + RandomNum(-25, 25);
+	blendAmount = 45 + g_DrawRNG.RandomNum(-25, 25);
     set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
     line(drawBitmap, start.m_X + 1, start.m_Y, end.m_X + 1, end.m_Y, color);
     line(drawBitmap, start.m_X - 1, start.m_Y, end.m_X - 1, end.m_Y, color);
@@ -6814,7 +6818,7 @@ bool MetagameGUI::DrawScreenLineToSitePoint(BITMAP *drawBitmap,
     // Draw a circle around the site target
     if (!(drawnFirstSegments++ >= onlyFirstSegments || lastSegmentsToDraw-- > onlyLastSegments))
     {
-		int blendAmount = 225 + RandomNum(-20, 20);
+		int blendAmount = 225 + g_DrawRNG.RandomNum(-20, 20);
         set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
 
         // If specified, draw a squareSite instead (with chamfered corners)
@@ -6978,7 +6982,7 @@ bool MetagameGUI::DrawPlayerLineToSitePoint(BITMAP *drawBitmap,
     // Draw a circle around the site target
     if (!(drawnFirstSegments++ >= onlyFirstSegments || lastSegmentsToDraw-- > onlyLastSegments))
     {
-        int blendAmount = 225 + RandomNum(-20, 20);
+        int blendAmount = 225 + g_DrawRNG.RandomNum(-20, 20);
         set_screen_blender(blendAmount, blendAmount, blendAmount, blendAmount);
 
         // If specified, draw a squareSite instead (with chamfered corners)
@@ -480,6 +480,15 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	bool Atom::StepForward(int numSteps) {
+		if (!AdvanceStep()) {
+			return false;
+		}
+		return ResolveStepHits(g_SceneMan.GetTerrMatter(m_IntPos[X], m_IntPos[Y]), m_OwnerMO->m_HitsMOs ? g_SceneMan.GetMOIDPixel(m_IntPos[X], m_IntPos[Y]) : g_NoMOID);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool Atom::AdvanceStep() {
 		RTEAssert(m_OwnerMO, "Stepping an Atom without a parent MO!");
 
 		// Only take the step if the step ratio permits it
@@ -488,7 +497,6 @@ namespace RTE {
 			m_StepWasTaken = true;
 			m_MOIDHit = g_NoMOID;
 			m_TerrainMatHit = g_MaterialAir;
-			bool hitStep = false;
 
 			if (m_DomSteps < m_Delta[m_Dom]) {
 				++m_DomSteps;
@@ -509,47 +517,55 @@ namespace RTE {
 
 	// Scene wrapping, if necessary
 				g_SceneMan.WrapPosition(m_IntPos[X], m_IntPos[Y]);
+				return true;
+			}
+			RTEAssert(0, "Atom shouldn't be taking steps beyond the trajectory!");
+			m_OwnerMO->SetToDelete();
+		}
+		m_StepWasTaken = false;
+		return false;
+	}
 
-				// Detect terrain hits, if not disabled.
-				if (g_MaterialAir != (m_TerrainMatHit = g_SceneMan.GetTerrMatter(m_IntPos[X], m_IntPos[Y]))) {
-					// Check if we're temporarily disabled from hitting terrain
-					if (!m_TerrainHitsDisabled) {
-						m_OwnerMO->SetHitWhatTerrMaterial(m_TerrainMatHit);
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-						m_HitPos[X] = m_IntPos[X];
-						m_HitPos[Y] = m_IntPos[Y];
-						RTEAssert(m_TerrainMatHit != 0, "Atom returning step with positive hit but without ID stored!");
-						hitStep = true;
-					}
-				} else {
-					// Re-enable terrain hits if we are now out of the terrain again
-					m_TerrainHitsDisabled = false;
-				}
+	bool Atom::ResolveStepHits(unsigned char terrainMaterial, MOID hitMOID) {
+		bool hitStep = false;
 
-				// Detect hits with non-ignored MO's, if enabled.
-				if (m_OwnerMO->m_HitsMOs) {
-					m_MOIDHit = g_SceneMan.GetMOIDPixel(m_IntPos[X], m_IntPos[Y]);
-					if (IsIgnoringMOID(m_MOIDHit)) { m_MOIDHit = g_NoMOID; }
-
-					if (m_MOIDHit != g_NoMOID) {
-						if (!m_MOHitsDisabled) {
-							m_HitPos[X] = m_IntPos[X];
-							m_HitPos[Y] = m_IntPos[Y];
-							RTEAssert(m_MOIDHit != g_NoMOID, "Atom returning step with positive hit but without ID stored!");
-							hitStep = true;
-							m_OwnerMO->SetHitWhatMOID(m_MOIDHit);
-						}
-					} else {
-						m_MOHitsDisabled = false;
-					}
+		// Detect terrain hits, if not disabled.
+		if (g_MaterialAir != (m_TerrainMatHit = terrainMaterial)) {
+			// Check if we're temporarily disabled from hitting terrain
+			if (!m_TerrainHitsDisabled) {
+				m_OwnerMO->SetHitWhatTerrMaterial(m_TerrainMatHit);
+
+				m_HitPos[X] = m_IntPos[X];
+				m_HitPos[Y] = m_IntPos[Y];
+				RTEAssert(m_TerrainMatHit != 0, "Atom returning step with positive hit but without ID stored!");
+				hitStep = true;
+			}
+		} else {
+			// Re-enable terrain hits if we are now out of the terrain again
+			m_TerrainHitsDisabled = false;
+		}
+
+		// Detect hits with non-ignored MO's, if enabled.
+		if (m_OwnerMO->m_HitsMOs) {
+			m_MOIDHit = hitMOID;
+			// Empty pixels are by far the most common, and there's nothing to ignore on them
+			if (m_MOIDHit != g_NoMOID && IsIgnoringMOID(m_MOIDHit)) { m_MOIDHit = g_NoMOID; }
+
+			if (m_MOIDHit != g_NoMOID) {
+				if (!m_MOHitsDisabled) {
+					m_HitPos[X] = m_IntPos[X];
+					m_HitPos[Y] = m_IntPos[Y];
+					RTEAssert(m_MOIDHit != g_NoMOID, "Atom returning step with positive hit but without ID stored!");
+					hitStep = true;
+					m_OwnerMO->SetHitWhatMOID(m_MOIDHit);
 				}
-				return hitStep;
+			} else {
+				m_MOHitsDisabled = false;
 			}
-			RTEAssert(0, "Atom shouldn't be taking steps beyond the trajectory!");
-			m_OwnerMO->SetToDelete();
 		}
-		m_StepWasTaken = false;
-		return 0;
+		return hitStep;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
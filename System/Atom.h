@@ -297,7 +297,7 @@ namespace RTE {
 		/// AtomGroup may set this shared list of ignored MOIDs to avoid setting and removing ignored MOIDs for every atom one by one. The list is maintained only by AtomGroup, Atom never owns it.
 		/// </summary>
 		/// <param name="ignoreMOIDsByGroup">New MOIDs list to ignore.</param>
-		void SetIgnoreMOIDsByGroup(std::list<MOID> const * ignoreMOIDsByGroup) { m_IgnoreMOIDsByGroup = ignoreMOIDsByGroup; };
+		void SetIgnoreMOIDsByGroup(std::vector<MOID> const * ignoreMOIDsByGroup) { m_IgnoreMOIDsByGroup = ignoreMOIDsByGroup; };
 
 		/// <summary>
 		/// Clear the list of MOIDs that this Atom is set to ignore collisions with during its next travel sequence. 
@@ -357,6 +357,18 @@ namespace RTE {
 		/// <returns>The current position of the Atom, with the offset baked in.</returns>
 		Vector GetCurrentPos() const { return Vector(m_IntPos[X], m_IntPos[Y]); }
 
+		/// <summary>
+		/// Gets the current X position of this Atom, in whole pixels.
+		/// </summary>
+		/// <returns>The current X position of this Atom.</returns>
+		int GetCurrentIntPosX() const { return m_IntPos[X]; }
+
+		/// <summary>
+		/// Gets the current Y position of this Atom, in whole pixels.
+		/// </summary>
+		/// <returns>The current Y position of this Atom.</returns>
+		int GetCurrentIntPosY() const { return m_IntPos[Y]; }
+
 		/// <summary>
 		/// Sets this Atom up for a straight segment of a trajectory to step through. If this Atom find the startPos to be on an MO, it will ignore any collisions with that MO for the entire segment.
 		/// The Scene MUST BE LOCKED before calling this!
@@ -389,6 +401,21 @@ namespace RTE {
 		/// </returns>
 		bool StepForward(int numSteps = 1);
 
+		/// <summary>
+		/// Takes one step along the trajectory segment set up by SetupSeg() if the step ratio permits it, without checking what's at the new position.
+		/// Together with ResolveStepHits, this lets many Atoms take their steps first and have what's at their new positions looked up all at once with SceneMan::GetTerrMattersAndMOIDs.
+		/// </summary>
+		/// <returns>Whether a step was taken. If so, ResolveStepHits must be called before this Atom steps again.</returns>
+		bool AdvanceStep();
+
+		/// <summary>
+		/// Checks what the step just taken with AdvanceStep hit, given what's at the new position. Reports hits the same way StepForward does.
+		/// </summary>
+		/// <param name="terrainMaterial">The terrain material at the new position, as SceneMan::GetTerrMatter would get it.</param>
+		/// <param name="hitMOID">The MOID at the new position, as SceneMan::GetMOIDPixel would get it. Ignored if this Atom isn't set to hit MOs.</param>
+		/// <returns>Whether anything was hit, with the same exceptions as StepForward.</returns>
+		bool ResolveStepHits(unsigned char terrainMaterial, MOID hitMOID);
+
 		/// <summary>
 		/// Takes one step back, or undos the step, if any, previously taken along the trajectory segment set up by SetupSeg().
 		/// </summary>
@@ -488,8 +515,8 @@ namespace RTE {
 
 		MovableObject *m_OwnerMO; //!< The owner of this Atom. The owner is obviously not owned by this Atom.	
 		MOID m_IgnoreMOID; //!< Special ignored MOID.
-		std::list<MOID> m_IgnoreMOIDs; //!< ignore hits with MOs of these IDs.
-		std::list<MOID> const * m_IgnoreMOIDsByGroup; //!< Also ignore hits with MOs of these IDs. This one may be set externally by atom group.
+		std::vector<MOID> m_IgnoreMOIDs; //!< ignore hits with MOs of these IDs.
+		std::vector<MOID> const * m_IgnoreMOIDsByGroup; //!< Also ignore hits with MOs of these IDs. This one may be set externally by atom group.
 
 		HitData m_LastHit; //!< Data containing information on the last collision experienced by this Atom.
 		MOID m_MOIDHit; //!< The MO, if any, this Atom hit on the last step.	
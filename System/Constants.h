@@ -25,6 +25,9 @@ namespace RTE {
 	static constexpr unsigned short c_PaletteEntriesNumber = 256; //!< Number of indexes in the graphics palette.
 	static constexpr unsigned short c_MOIDLayerBitDepth = 16; //!< Bit depth of MOID layer bitmap.
 	static constexpr unsigned short c_GoldMaterialID = 2; //!< Index of gold material in the material palette.
+	static constexpr unsigned short c_DrawCullGridCellSize = 256; //!< Size in pixels of each square cell of the scene grid MOs are sorted into for culling the ones outside a screen's view.
+	static constexpr unsigned short c_DrawCullHUDMargin = 128; //!< Extra distance in pixels around a screen's view to still draw MO HUDs in, since those extend beyond the MO's bounding radius.
+	static constexpr float c_MaxDrawInterpolationDistance = 100.0F; //!< Maximum distance in pixels an MO can move in one sim update to still have its drawing interpolated. Anything that moved further was likely just added or teleported.
 
 	enum ColorKeys {
 		g_MaskColor = 0, //!< Mask color for all 8bpp bitmaps (palette index 0 (255,0,255)). This color is fully transparent.
@@ -82,6 +85,10 @@ namespace RTE {
 	static constexpr unsigned short c_FramesToRemember = 3;
 	static constexpr unsigned short c_MaxLayersStoredForNetwork = 10;
 	static constexpr unsigned short c_MaxPixelLineBufferSize = 8192;
+	static constexpr unsigned int c_NetworkReplayVersion = 1; //!< Version of the network replay file format, increment when NetworkReplayHeader, NetworkReplayRecord or any recorded message layout changes.
+	static constexpr unsigned short c_TerrainChangeTileSize = 16; //!< Size in pixels of each square tile used to track dirty terrain regions for network replication.
+	static constexpr unsigned short c_NetworkCompositeTileSize = 64; //!< Size in pixels of each square tile the network client uses to track which parts of the received frame need to be composited again.
+	static constexpr unsigned short c_MaxNetworkDecodeThreads = 4; //!< Maximum number of worker threads the network client uses to decompress received frame boxes.
 #pragma endregion
 
 #pragma region Input Constants
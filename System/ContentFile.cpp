@@ -10,6 +10,7 @@ namespace RTE {
 	std::unordered_map<std::string, BITMAP *> ContentFile::s_LoadedBitmaps[BitDepthCount];
 	std::unordered_map<std::string, FMOD::Sound *> ContentFile::s_LoadedSamples;
 	std::unordered_map<size_t, std::string> ContentFile::s_PathHashes;
+	std::recursive_mutex ContentFile::s_BitmapLoadingMutex;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -108,6 +109,7 @@ namespace RTE {
 		BITMAP *returnBitmap = nullptr;
 		int bitDepth = (conversionMode == COLORCONV_8_TO_32) ? BitDepths::ThirtyTwo : BitDepths::Eight;
 
+		std::lock_guard<std::recursive_mutex> bitmapLoadingLock(s_BitmapLoadingMutex);
 		// Check if the file has already been read and loaded from the disk and, if so, use that data.
 		std::unordered_map<std::string, BITMAP *>::iterator foundBitmap = s_LoadedBitmaps[bitDepth].find(m_DataPath);
 		if (foundBitmap != s_LoadedBitmaps[bitDepth].end()) {
@@ -173,6 +175,7 @@ namespace RTE {
 		}
 		BITMAP *returnBitmap = nullptr;
 
+		std::lock_guard<std::recursive_mutex> bitmapLoadingLock(s_BitmapLoadingMutex);
 		PALETTE currentPalette;
 		get_palette(currentPalette);
 
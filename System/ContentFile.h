@@ -176,6 +176,7 @@ namespace RTE {
 		static std::unordered_map<size_t, std::string> s_PathHashes; //!< Static map containing the hash values of paths of all loaded data files.
 		static std::unordered_map<std::string, BITMAP *> s_LoadedBitmaps[BitDepthCount]; //!< Static map containing all the already loaded BITMAPs and their paths for each bit depth.
 		static std::unordered_map<std::string, FMOD::Sound *> s_LoadedSamples; //!< Static map containing all the already loaded FSOUND_SAMPLEs and their paths.
+		static std::recursive_mutex s_BitmapLoadingMutex; //!< Guards the static BITMAP maps and Allegro's color conversion state while loading, since Scene layer data can be loaded on a worker thread.
 
 		std::string m_DataPath; //!< The path to this ContentFile's data file. In the case of an animation, this filename/name will be appended with 000, 001, 002 etc.
 		std::string m_DataPathExtension; //!< The extension of the data file of this ContentFile's path.
@@ -124,17 +124,43 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	void Controller::Update() {
-		// Reset all command states.
+	void Controller::ResetCommandState() {
 		std::fill_n(m_ControlStates, CONTROLSTATECOUNT, false);
 		m_AnalogMove.Reset();
 		m_AnalogAim.Reset();
 		m_AnalogCursor.Reset();
 		m_MouseMovement.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void Controller::ClearOneShotCommandStates() {
+		for (ControlState oneShotState : { BODY_JUMPSTART, AIM_UP, AIM_DOWN, WEAPON_RELOAD, WEAPON_CHANGE_NEXT, WEAPON_CHANGE_PREV, WEAPON_PICKUP, WEAPON_DROP, ACTOR_NEXT, ACTOR_PREV, ACTOR_BRAIN, ACTOR_NEXT_PREP, ACTOR_PREV_PREP, PRESS_PRIMARY, PRESS_SECONDARY, PRESS_RIGHT, PRESS_LEFT, PRESS_UP, PRESS_DOWN, RELEASE_PRIMARY, RELEASE_SECONDARY, PRESS_FACEBUTTON, SCROLL_UP, SCROLL_DOWN }) {
+			m_ControlStates[oneShotState] = false;
+		}
+		m_AnalogCursor.Reset();
+		m_MouseMovement.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	void Controller::Update() {
 		// Update team indicator
 		if (m_ControlledActor) { m_Team = m_ControlledActor->GetTeam(); }
 
+		// Scripted AI that already ran on a parallel AI worker this update has reset and set the command states itself, so leave them be
+		if (m_InputMode == CIM_AI && m_ControlledActor && m_ControlledActor->AIUpdatedInParallel()) {
+			m_ControlledActor->SetAIUpdatedInParallel(false);
+			return;
+		}
+		// AI of Actors updated at a lower level of detail only runs on their full updates, in between they keep doing what it last told them to
+		if (m_InputMode == CIM_AI && m_ControlledActor && !m_ControlledActor->IsUpdateDue() && !m_Disabled && g_ActivityMan.ActivityRunning()) {
+			ClearOneShotCommandStates();
+			return;
+		}
+
+		ResetCommandState();
+
 		// Player Input Mode
 		if (m_InputMode == CIM_PLAYER) {
 			// Disable player input if the console is open but isn't in read-only mode, or the controller is disabled or has no player
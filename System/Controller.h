@@ -285,6 +285,17 @@ namespace RTE {
 #pragma endregion
 
 #pragma region Virtual Override Methods
+		/// <summary>
+		/// Clears all command states and analog inputs of this Controller. Done at the start of each Update, or by a parallel AI worker before it runs the controlled Actor's scripted AI.
+		/// </summary>
+		void ResetCommandState();
+
+		/// <summary>
+		/// Clears the command states that should only register for a single update, like presses and weapon changes, leaving held states like movement and firing as they are.
+		/// Used when the AI of the controlled Actor is skipped for an update, so it keeps doing what it was doing without repeating any one-off actions.
+		/// </summary>
+		void ClearOneShotCommandStates();
+
 		/// <summary>
 		/// Updates this Controller. Supposed to be done every frame.
 		/// </summary>
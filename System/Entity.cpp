@@ -285,6 +285,7 @@ namespace RTE {
 
 		// If concrete class, fill up the pool with pre-allocated memory blocks the size of the type
 		if (m_Allocate && fillAmount > 0) {
+			std::lock_guard<std::mutex> poolLock(m_PoolMutex);
 			for (int i = 0; i < fillAmount; ++i) {
 				m_AllocatedPool.push_back(m_Allocate());
 			}
@@ -295,9 +296,15 @@ namespace RTE {
 
 	void * Entity::ClassInfo::GetPoolMemory() {
 		RTEAssert(IsConcrete(), "Trying to get pool memory of an abstract Entity class!");
+		std::lock_guard<std::mutex> poolLock(m_PoolMutex);
 
-		// If the pool is empty, then fill it up again with as many instances as we are set to
-		if (m_AllocatedPool.empty()) { FillPool((m_PoolAllocBlockCount > 0) ? m_PoolAllocBlockCount : 10); }
+		// If the pool is empty, then fill it up again with as many instances as we are set to. Not through FillPool, which would lock the pool again
+		if (m_AllocatedPool.empty()) {
+			int fillAmount = (m_PoolAllocBlockCount > 0) ? m_PoolAllocBlockCount : 10;
+			for (int i = 0; i < fillAmount; ++i) {
+				m_AllocatedPool.push_back(m_Allocate());
+			}
+		}
 
 		// Get the instance in the top of the pool and pop it off
 		void *foundMemory = m_AllocatedPool.back();
@@ -317,6 +324,7 @@ namespace RTE {
 		if (!returnedMemory) {
 			return 0;
 		}
+		std::lock_guard<std::mutex> poolLock(m_PoolMutex);
 		m_AllocatedPool.push_back(returnedMemory);
 
 		// Keep track of the number of instances passed in
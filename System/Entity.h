@@ -124,6 +124,18 @@ namespace RTE {
 			/// </summary>
 			/// <returns>A pointer to the parent ClassInfo. 0 if this is a root class.</returns>
 			const ClassInfo * GetParent() const { return m_ParentInfo; }
+
+			/// <summary>
+			/// Gets the number of instances of this ClassInfo's type that were passed out from the pool and not returned yet.
+			/// </summary>
+			/// <returns>The number of instances in use.</returns>
+			int GetInstancesInUse() const { return m_InstancesInUse; }
+
+			/// <summary>
+			/// Gets the number of pre-allocated instances of this ClassInfo's type that are waiting in the pool to be passed out.
+			/// </summary>
+			/// <returns>The number of free instances in the pool.</returns>
+			int GetPooledInstanceCount() const { return static_cast<int>(m_AllocatedPool.size()); }
 #pragma endregion
 
 #pragma region Memory Management
@@ -190,6 +202,7 @@ namespace RTE {
 			std::vector<void *> m_AllocatedPool; //!< Pool of pre-allocated objects of the type described by this ClassInfo.
 			int m_PoolAllocBlockCount; //!< The number of instances to fill up the pool of this type with each time it runs dry.
 			int m_InstancesInUse; //!< The number of allocated instances passed out from the pool.
+			std::mutex m_PoolMutex; //!< Guards the pool and the instance count, since MOs can be created and deleted by AI scripts running on the parallel AI workers.
 
 
 			// Forbidding copying
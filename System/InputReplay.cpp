@@ -0,0 +1,345 @@
+#include "InputReplay.h"
+#include "SimBenchmark.h"
+#include "AudioMan.h"
+#include "ConsoleMan.h"
+#include "FrameMan.h"
+#include "MovableMan.h"
+#include "PresetMan.h"
+#include "SceneMan.h"
+#include "TimerMan.h"
+#include "HDFirearm.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::Clear() {
+		m_RecordFileName.clear();
+		m_ReplayFileName.clear();
+		m_SceneName.clear();
+		m_ActivityType.clear();
+		m_ActivityName.clear();
+		m_Seed = 0;
+		m_GunfireCheckSimUpdateCount = 0;
+		m_FiringFirearmCount = 0;
+		m_FiringFirearmIDs.clear();
+		m_RecordedSimUpdateCount = 0;
+		m_NextSimUpdateTime = 0;
+		for (std::array<char, c_PackedInputStateSize> &packedInputState : m_LastPackedInputStates) {
+			packedInputState.fill(0);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int InputReplay::StartRecording() {
+		if (SimBenchmark::StartSeededActivity(m_SceneName, m_ActivityType, m_ActivityName, m_Seed) < 0 || SpawnFiringFirearms() < 0) {
+			return -1;
+		}
+		m_RecordFile.open(m_RecordFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_RecordFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not open " + m_RecordFileName + " to record the input to!");
+			m_RecordFileName.clear();
+			return -1;
+		}
+		float deltaTime = g_TimerMan.GetDeltaTimeSecs();
+		m_RecordFile.write(c_FileSignature, sizeof(c_FileSignature));
+		m_RecordFile.write(reinterpret_cast<const char *>(&c_FormatVersion), sizeof(c_FormatVersion));
+		m_RecordFile.write(reinterpret_cast<const char *>(&m_Seed), sizeof(m_Seed));
+		m_RecordFile.write(reinterpret_cast<const char *>(&deltaTime), sizeof(deltaTime));
+		WriteString(m_RecordFile, m_SceneName);
+		WriteString(m_RecordFile, m_ActivityType);
+		WriteString(m_RecordFile, m_ActivityName);
+		m_RecordFile.write(reinterpret_cast<const char *>(&m_FiringFirearmCount), sizeof(m_FiringFirearmCount));
+
+		m_RecordedSimUpdateCount = 0;
+		m_NextSimUpdateTime = g_TimerMan.GetAbsoluteTime();
+		// The playback starts from the same all-clear input, so players whose input never changes are never written at all
+		for (std::array<char, c_PackedInputStateSize> &packedInputState : m_LastPackedInputStates) {
+			packedInputState.fill(0);
+		}
+		g_ConsoleMan.PrintString("INPUTREPLAY: Recording " + m_ActivityName + " on " + m_SceneName + " with seed " + std::to_string(m_Seed) + " to " + m_RecordFileName);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::RecordSimUpdate() {
+		long long timeToWait = m_NextSimUpdateTime - g_TimerMan.GetAbsoluteTime();
+		if (timeToWait > 0) { std::this_thread::sleep_for(std::chrono::microseconds(timeToWait)); }
+		m_NextSimUpdateTime = std::max(m_NextSimUpdateTime + static_cast<long long>(g_TimerMan.GetDeltaTimeSecs() * 1000000.0F), g_TimerMan.GetAbsoluteTime());
+
+		// Read the devices, then play back exactly what was read so the sim can only see what ends up in the recording
+		g_UInputMan.StopReplayingInput();
+		g_UInputMan.Update();
+		std::array<UInputMan::PlayerInputState, Players::MaxPlayerCount> inputStates;
+		for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+			g_UInputMan.GetPlayerInputState(player, inputStates[player]);
+		}
+		g_AudioMan.Update();
+		RecordSimUpdate(inputStates);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::RecordSimUpdate(std::array<UInputMan::PlayerInputState, Players::MaxPlayerCount> &inputStates) {
+		unsigned char changedPlayers = 0;
+		std::array<std::array<char, c_PackedInputStateSize>, Players::MaxPlayerCount> packedInputStates;
+		for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+			PackInputState(inputStates[player], packedInputStates[player]);
+			// Unpacking again makes sure the sim sees the floats and states with exactly the precision they're stored with
+			UnpackInputState(packedInputStates[player], inputStates[player]);
+			if (packedInputStates[player] != m_LastPackedInputStates[player]) { changedPlayers |= 1 << player; }
+		}
+		for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+			g_UInputMan.SetReplayedInputState(player, inputStates[player]);
+		}
+
+		KeepFirearmsFiring();
+		SimBenchmark::UpdateSimFixedStep(true);
+		unsigned long long stateChecksum = SimBenchmark::CalculateStateChecksum();
+
+		m_RecordFile.put(static_cast<char>(changedPlayers));
+		for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+			if (changedPlayers & (1 << player)) {
+				m_RecordFile.write(packedInputStates[player].data(), c_PackedInputStateSize);
+				m_LastPackedInputStates[player] = packedInputStates[player];
+			}
+		}
+		m_RecordFile.write(reinterpret_cast<const char *>(&stateChecksum), sizeof(stateChecksum));
+		++m_RecordedSimUpdateCount;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int InputReplay::StopRecording() {
+		g_UInputMan.StopReplayingInput();
+		if (!m_RecordFile.is_open()) {
+			return -1;
+		}
+		m_RecordFile.close();
+		if (m_RecordFile.fail()) {
+			g_ConsoleMan.PrintString("ERROR: Failed to write the recording to " + m_RecordFileName + "!");
+			return -1;
+		}
+		g_ConsoleMan.PrintString("INPUTREPLAY: Recorded " + std::to_string(m_RecordedSimUpdateCount) + " sim updates to " + m_RecordFileName);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int InputReplay::Replay() {
+		std::ifstream replayFile(m_ReplayFileName, std::ios::in | std::ios::binary);
+		if (!replayFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not open the recording " + m_ReplayFileName + " to play back!");
+			return -1;
+		}
+		char fileSignature[sizeof(c_FileSignature)];
+		unsigned int formatVersion = 0;
+		unsigned int seed = 0;
+		float deltaTime = 0;
+		replayFile.read(fileSignature, sizeof(fileSignature));
+		replayFile.read(reinterpret_cast<char *>(&formatVersion), sizeof(formatVersion));
+		replayFile.read(reinterpret_cast<char *>(&seed), sizeof(seed));
+		replayFile.read(reinterpret_cast<char *>(&deltaTime), sizeof(deltaTime));
+		std::string sceneName = ReadString(replayFile);
+		std::string activityType = ReadString(replayFile);
+		std::string activityName = ReadString(replayFile);
+		int firingFirearmCount = 0;
+		replayFile.read(reinterpret_cast<char *>(&firingFirearmCount), sizeof(firingFirearmCount));
+		if (!replayFile.good() || !std::equal(std::begin(fileSignature), std::end(fileSignature), std::begin(c_FileSignature)) || formatVersion != c_FormatVersion || firingFirearmCount < 0 || firingFirearmCount > c_GunfireCheckFirearmCount) {
+			g_ConsoleMan.PrintString("ERROR: " + m_ReplayFileName + " is not a valid input recording!");
+			return -1;
+		}
+		// The sim results depend on the DeltaTime, so play back with the one the recording was made with
+		g_TimerMan.SetDeltaTimeSecs(deltaTime);
+		m_FiringFirearmCount = firingFirearmCount;
+		if (SimBenchmark::StartSeededActivity(sceneName, activityType, activityName, seed) < 0 || SpawnFiringFirearms() < 0) {
+			return -1;
+		}
+		g_ConsoleMan.PrintString("INPUTREPLAY: Playing back " + m_ReplayFileName + ", " + activityName + " on " + sceneName + " with seed " + std::to_string(seed));
+
+		std::array<UInputMan::PlayerInputState, Players::MaxPlayerCount> inputStates;
+		std::array<char, c_PackedInputStateSize> clearedPackedInputState;
+		clearedPackedInputState.fill(0);
+		for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+			UnpackInputState(clearedPackedInputState, inputStates[player]);
+		}
+
+		int simUpdate = 0;
+		long long replayStartTime = g_TimerMan.GetAbsoluteTime();
+		int changedPlayers;
+		while ((changedPlayers = replayFile.get()) != std::char_traits<char>::eof()) {
+			std::array<char, c_PackedInputStateSize> packedInputState;
+			for (short player = Players::PlayerOne; player < Players::MaxPlayerCount; ++player) {
+				if (changedPlayers & (1 << player)) {
+					replayFile.read(packedInputState.data(), c_PackedInputStateSize);
+					UnpackInputState(packedInputState, inputStates[player]);
+				}
+				g_UInputMan.SetReplayedInputState(player, inputStates[player]);
+			}
+			unsigned long long recordedStateChecksum = 0;
+			replayFile.read(reinterpret_cast<char *>(&recordedStateChecksum), sizeof(recordedStateChecksum));
+			if (!replayFile.good()) {
+				g_ConsoleMan.PrintString("ERROR: The recording " + m_ReplayFileName + " ends in the middle of sim update " + std::to_string(simUpdate) + "!");
+				g_UInputMan.StopReplayingInput();
+				return -1;
+			}
+
+			// Draw the frame like the recording did, so anything drawing does to the sim state happens the same way
+			KeepFirearmsFiring();
+			SimBenchmark::UpdateSimFixedStep(true);
+			unsigned long long stateChecksum = SimBenchmark::CalculateStateChecksum();
+			if (stateChecksum != recordedStateChecksum) {
+				char buf[128];
+				std::snprintf(buf, sizeof(buf), "INPUTREPLAY: State diverged at sim update %i (recorded %016llx, got %016llx)", simUpdate, recordedStateChecksum, stateChecksum);
+				g_ConsoleMan.PrintString(buf);
+				g_UInputMan.StopReplayingInput();
+				return -1;
+			}
+			++simUpdate;
+		}
+		g_UInputMan.StopReplayingInput();
+
+		double replayTime = static_cast<double>(g_TimerMan.GetAbsoluteTime() - replayStartTime) / 1000000.0;
+		char buf[128];
+		std::snprintf(buf, sizeof(buf), "INPUTREPLAY: All %i sim updates matched the recording, played back in %.2f s (%.1f updates per second)", simUpdate, replayTime, (replayTime > 0) ? static_cast<double>(simUpdate) / replayTime : 0.0);
+		g_ConsoleMan.PrintString(buf);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int InputReplay::RunGunfireCheck() {
+		if (m_RecordFileName.empty()) { m_RecordFileName = c_GunfireCheckFileName; }
+		m_FiringFirearmCount = c_GunfireCheckFirearmCount;
+		if (StartRecording() < 0) {
+			return -1;
+		}
+		// No player input at all, so the check runs the same no matter what's pressed while it does
+		std::array<UInputMan::PlayerInputState, Players::MaxPlayerCount> inputStates;
+		std::array<char, c_PackedInputStateSize> clearedPackedInputState;
+		clearedPackedInputState.fill(0);
+		for (UInputMan::PlayerInputState &inputState : inputStates) {
+			UnpackInputState(clearedPackedInputState, inputState);
+		}
+		for (int simUpdate = 0; simUpdate < m_GunfireCheckSimUpdateCount; ++simUpdate) {
+			RecordSimUpdate(inputStates);
+		}
+		if (StopRecording() < 0) {
+			return -1;
+		}
+		m_ReplayFileName = m_RecordFileName;
+		return Replay();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int InputReplay::SpawnFiringFirearms() {
+		m_FiringFirearmIDs.clear();
+		if (m_FiringFirearmCount <= 0) {
+			return 0;
+		}
+		std::list<Entity *> presets;
+		g_PresetMan.GetAllOfType(presets, "HDFirearm");
+		presets.remove_if([](Entity *preset) { return !dynamic_cast<HDFirearm *>(preset)->IsFullAuto(); });
+		if (presets.empty()) {
+			g_ConsoleMan.PrintString("ERROR: There are no full auto HDFirearms loaded to fire!");
+			return -1;
+		}
+		float screenLeft = g_SceneMan.GetOffset(0).GetX();
+		float screenWidth = static_cast<float>(g_FrameMan.GetPlayerScreenWidth());
+		for (int firearm = 0; firearm < m_FiringFirearmCount; ++firearm) {
+			const HDFirearm *firearmPreset = dynamic_cast<HDFirearm *>(*std::next(presets.begin(), RandomNum<int>(0, presets.size() - 1)));
+			HDFirearm *firingFirearm = dynamic_cast<HDFirearm *>(firearmPreset->Clone());
+			float posX = screenLeft + screenWidth * static_cast<float>(firearm + 1) / static_cast<float>(m_FiringFirearmCount + 1);
+			firingFirearm->SetPos(g_SceneMan.MovePointToGround(Vector(posX, 0), 10, 2));
+			firingFirearm->SetHFlipped(firearm % 2 == 1);
+			m_FiringFirearmIDs.push_back(firingFirearm->GetUniqueID());
+			g_MovableMan.AddItem(firingFirearm);
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::KeepFirearmsFiring() const {
+		for (long int firearmID : m_FiringFirearmIDs) {
+			if (HDFirearm *firingFirearm = dynamic_cast<HDFirearm *>(g_MovableMan.FindObjectByUniqueID(firearmID))) {
+				if (!firingFirearm->IsReloading() && firingFirearm->NeedsReloading()) { firingFirearm->Reload(); }
+				firingFirearm->Activate();
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::PackInputState(const UInputMan::PlayerInputState &inputState, std::array<char, c_PackedInputStateSize> &packedInputState) {
+		packedInputState.fill(0);
+		int bit = 0;
+		for (const auto &elementStates : inputState.ElementStates) {
+			for (bool state : elementStates) {
+				if (state) { packedInputState[bit / 8] |= 1 << (bit % 8); }
+				++bit;
+			}
+		}
+		for (const auto &mouseButtonStates : inputState.MouseButtonStates) {
+			for (bool state : mouseButtonStates) {
+				if (state) { packedInputState[bit / 8] |= 1 << (bit % 8); }
+				++bit;
+			}
+		}
+		const float values[6] = { inputState.AnalogMove.GetX(), inputState.AnalogMove.GetY(), inputState.AnalogAim.GetX(), inputState.AnalogAim.GetY(), inputState.MouseMovement.GetX(), inputState.MouseMovement.GetY() };
+		char *packedValues = packedInputState.data() + (bit + 7) / 8;
+		std::memcpy(packedValues, values, sizeof(values));
+		std::memcpy(packedValues + sizeof(values), &inputState.MouseWheelChange, sizeof(inputState.MouseWheelChange));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::UnpackInputState(const std::array<char, c_PackedInputStateSize> &packedInputState, UInputMan::PlayerInputState &inputState) {
+		int bit = 0;
+		for (auto &elementStates : inputState.ElementStates) {
+			for (bool &state : elementStates) {
+				state = packedInputState[bit / 8] & (1 << (bit % 8));
+				++bit;
+			}
+		}
+		for (auto &mouseButtonStates : inputState.MouseButtonStates) {
+			for (bool &state : mouseButtonStates) {
+				state = packedInputState[bit / 8] & (1 << (bit % 8));
+				++bit;
+			}
+		}
+		float values[6];
+		const char *packedValues = packedInputState.data() + (bit + 7) / 8;
+		std::memcpy(values, packedValues, sizeof(values));
+		std::memcpy(&inputState.MouseWheelChange, packedValues + sizeof(values), sizeof(inputState.MouseWheelChange));
+		inputState.AnalogMove.SetXY(values[0], values[1]);
+		inputState.AnalogAim.SetXY(values[2], values[3]);
+		inputState.MouseMovement.SetXY(values[4], values[5]);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void InputReplay::WriteString(std::ofstream &file, const std::string &text) {
+		unsigned int length = static_cast<unsigned int>(text.size());
+		file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+		file.write(text.data(), length);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::string InputReplay::ReadString(std::ifstream &file) {
+		unsigned int length = 0;
+		file.read(reinterpret_cast<char *>(&length), sizeof(length));
+		// Preset names are never anywhere near this long, so anything longer means the file is broken
+		if (!file.good() || length > 1024) {
+			file.setstate(std::ios::failbit);
+			return "";
+		}
+		std::string text(length, '\0');
+		file.read(&text[0], length);
+		return text;
+	}
+}
@@ -0,0 +1,189 @@
+#ifndef _RTEINPUTREPLAY_
+#define _RTEINPUTREPLAY_
+
+#include "UInputMan.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// Records the input of every player for every sim update of a seeded Activity, along with a checksum of the sim state after each, and plays the recording back headlessly to check the sim still ends up in the same state.
+	/// Recording runs the Activity in lockstep, one fixed sim update per drawn frame, and the playback draws every frame the same way without showing it, so any difference in the checksums means the sim itself changed its results.
+	/// The playback stops at the first sim update whose checksum differs, which makes it a tool for checking that parallelism and other optimizations don't cause desyncs.
+	/// </summary>
+	class InputReplay {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate an InputReplay object in system memory.
+		/// </summary>
+		InputReplay() { Clear(); }
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Tells whether a recording was asked for, i.e. the file to record to has been set.
+		/// </summary>
+		/// <returns>Whether the Activity should be recorded instead of running the game normally.</returns>
+		bool IsRecordingEnabled() const { return !m_RecordFileName.empty(); }
+
+		/// <summary>
+		/// Tells whether a playback was asked for, i.e. the file to play back has been set.
+		/// </summary>
+		/// <returns>Whether a recording should be played back instead of running the game.</returns>
+		bool IsReplayEnabled() const { return !m_ReplayFileName.empty(); }
+
+		/// <summary>
+		/// Tells whether a gunfire check was asked for, i.e. the number of sim updates to record for it has been set.
+		/// </summary>
+		/// <returns>Whether the gunfire check should be run instead of the game.</returns>
+		bool IsGunfireCheckEnabled() const { return m_GunfireCheckSimUpdateCount > 0; }
+
+		/// <summary>
+		/// Sets the file to record to.
+		/// </summary>
+		/// <param name="fileName">The path of the file to record to.</param>
+		void SetRecordFileName(const std::string &fileName) { m_RecordFileName = fileName; }
+
+		/// <summary>
+		/// Sets the file to play back.
+		/// </summary>
+		/// <param name="fileName">The path of the recording to play back.</param>
+		void SetReplayFileName(const std::string &fileName) { m_ReplayFileName = fileName; }
+
+		/// <summary>
+		/// Sets how many sim updates the gunfire check records and plays back.
+		/// </summary>
+		/// <param name="simUpdateCount">The number of sim updates to check.</param>
+		void SetGunfireCheckSimUpdateCount(int simUpdateCount) { m_GunfireCheckSimUpdateCount = simUpdateCount; }
+
+		/// <summary>
+		/// Sets the Scene to record on. If not set, the default Scene set in SceneMan is used.
+		/// </summary>
+		/// <param name="sceneName">The preset name of the Scene.</param>
+		void SetSceneName(const std::string &sceneName) { m_SceneName = sceneName; }
+
+		/// <summary>
+		/// Sets the Activity to record. If not set, the default Activity set in ActivityMan is used.
+		/// </summary>
+		/// <param name="activityType">The class name of the Activity.</param>
+		/// <param name="activityName">The preset name of the Activity.</param>
+		void SetActivity(const std::string &activityType, const std::string &activityName) { m_ActivityType = activityType; m_ActivityName = activityName; }
+
+		/// <summary>
+		/// Sets the seed the RNG is seeded with before the Activity to record is started.
+		/// </summary>
+		/// <param name="seed">The seed to use.</param>
+		void SetSeed(unsigned int seed) { m_Seed = seed; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Starts the Activity to record on the Scene and writes the header of the recording.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int StartRecording();
+
+		/// <summary>
+		/// Reads the input of every player, runs one fixed sim update with it and draws the frame, then records the input and the state checksum. Waits first if the last sim update was less than a DeltaTime ago, so the Activity runs in real time.
+		/// </summary>
+		void RecordSimUpdate();
+
+		/// <summary>
+		/// Stops recording, closes the file and has the input read from the devices again.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int StopRecording();
+
+		/// <summary>
+		/// Starts the recorded Activity and runs it headlessly as fast as possible with the recorded input, drawing every frame like the recording did, and checks the state checksum after every sim update. Prints the results to the console.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure, including the sim diverging from the recording. Anything below 0 is an error signal.</returns>
+		int Replay();
+
+		/// <summary>
+		/// Records the Activity headlessly with a row of full auto HDFirearms firing the whole time and no player input, then plays the recording back and checks it matches.
+		/// Muzzle flashes and other effects registered while drawing are part of every recorded frame, so this catches drawing that changes the sim state. Records to the file set to record to, or c_GunfireCheckFileName if none was.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure, including the sim diverging from the recording. Anything below 0 is an error signal.</returns>
+		int RunGunfireCheck();
+#pragma endregion
+
+	private:
+
+		static constexpr char c_FileSignature[4] = { 'R', 'T', 'E', 'I' }; //!< The signature at the start of every recording.
+		static constexpr unsigned int c_FormatVersion = 2; //!< The version of the recording file format.
+		static constexpr int c_GunfireCheckFirearmCount = 6; //!< How many HDFirearms the gunfire check keeps firing.
+		static constexpr const char *c_GunfireCheckFileName = "InputReplayCheck.rec"; //!< The file the gunfire check records to if no other was set.
+		static constexpr int c_ElementStateCount = InputElements::INPUT_COUNT * UInputMan::InputState::InputStateCount; //!< How many input element states each PlayerInputState has.
+		static constexpr int c_MouseButtonStateCount = MouseButtons::MAX_MOUSE_BUTTONS * UInputMan::InputState::InputStateCount; //!< How many mouse button states each PlayerInputState has.
+		static constexpr int c_PackedInputStateSize = (c_ElementStateCount + c_MouseButtonStateCount + 7) / 8 + 6 * sizeof(float) + sizeof(int); //!< The size of a PlayerInputState packed into a recording, with the states as bits, in bytes.
+
+		std::string m_RecordFileName; //!< The path of the file to record to, or empty if no recording was asked for.
+		std::string m_ReplayFileName; //!< The path of the recording to play back, or empty if no playback was asked for.
+		std::string m_SceneName; //!< The preset name of the Scene to record on, or empty for the default one.
+		std::string m_ActivityType; //!< The class name of the Activity to record, or empty for the default one.
+		std::string m_ActivityName; //!< The preset name of the Activity to record, or empty for the default one.
+		unsigned int m_Seed; //!< The seed the RNG is seeded with before the Activity to record is started.
+		int m_GunfireCheckSimUpdateCount; //!< How many sim updates the gunfire check records and plays back. 0 means no gunfire check was asked for.
+		int m_FiringFirearmCount; //!< How many HDFirearms are spawned and kept firing in the Activity being recorded or played back. Stored in the recording.
+		std::vector<long int> m_FiringFirearmIDs; //!< The unique IDs of the HDFirearms kept firing.
+
+		std::ofstream m_RecordFile; //!< The file being recorded to.
+		int m_RecordedSimUpdateCount; //!< How many sim updates were recorded so far.
+		long long m_NextSimUpdateTime; //!< The absolute time the next sim update is due at when recording, in microseconds.
+		std::array<std::array<char, c_PackedInputStateSize>, Players::MaxPlayerCount> m_LastPackedInputStates; //!< The last recorded input of each player, so only players whose input changed have to be written.
+
+		/// <summary>
+		/// Runs one fixed sim update with the given input of every player and draws the frame, then records the input and the state checksum.
+		/// </summary>
+		/// <param name="inputStates">The input of every player for this sim update. Set to exactly what the sim sees after going through the recording's precision.</param>
+		void RecordSimUpdate(std::array<UInputMan::PlayerInputState, Players::MaxPlayerCount> &inputStates);
+
+		/// <summary>
+		/// Spawns m_FiringFirearmCount randomly picked full auto HDFirearms in a row above the ground across the first screen, facing alternate ways. Uses the RNG, so it has to be done at the same point of the recording and the playback.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int SpawnFiringFirearms();
+
+		/// <summary>
+		/// Reloads any of the spawned HDFirearms that ran dry and activates all of them for the next sim update.
+		/// </summary>
+		void KeepFirearmsFiring() const;
+
+		/// <summary>
+		/// Packs a PlayerInputState into the form it's stored in a recording.
+		/// </summary>
+		/// <param name="inputState">The PlayerInputState to pack.</param>
+		/// <param name="packedInputState">The buffer to pack it into.</param>
+		static void PackInputState(const UInputMan::PlayerInputState &inputState, std::array<char, c_PackedInputStateSize> &packedInputState);
+
+		/// <summary>
+		/// Unpacks a PlayerInputState from the form it's stored in a recording.
+		/// </summary>
+		/// <param name="packedInputState">The packed PlayerInputState.</param>
+		/// <param name="inputState">The PlayerInputState to unpack it into.</param>
+		static void UnpackInputState(const std::array<char, c_PackedInputStateSize> &packedInputState, UInputMan::PlayerInputState &inputState);
+
+		/// <summary>
+		/// Writes a string to a recording, prefixed with its length.
+		/// </summary>
+		/// <param name="file">The file to write to.</param>
+		/// <param name="text">The string to write.</param>
+		static void WriteString(std::ofstream &file, const std::string &text);
+
+		/// <summary>
+		/// Reads a string prefixed with its length from a recording.
+		/// </summary>
+		/// <param name="file">The file to read from.</param>
+		/// <returns>The string that was read.</returns>
+		static std::string ReadString(std::ifstream &file);
+
+		/// <summary>
+		/// Clears all the member variables of this InputReplay, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
@@ -296,6 +296,24 @@ namespace RTE {
 		unsigned int InputElementHeld;
 	};
 
+	/// <summary>
+	/// Header written at the start of a network replay file, which holds the recorded server to client message stream of a single player.
+	/// </summary>
+	struct NetworkReplayHeader {
+		char Magic[4]; //!< Always "CCNR".
+		unsigned int Version; //!< Version of the replay format, see c_NetworkReplayVersion.
+		int ResolutionX; //!< Horizontal resolution of the client the stream was recorded for.
+		int ResolutionY; //!< Vertical resolution of the client the stream was recorded for.
+	};
+
+	/// <summary>
+	/// Header of each recorded message in a network replay file. Immediately followed by DataSize bytes of the message exactly as it was sent.
+	/// </summary>
+	struct NetworkReplayRecord {
+		unsigned int TimeMS; //!< Real time in milliseconds since the recording started when the message was sent.
+		unsigned int DataSize; //!< Size of the recorded message in bytes.
+	};
+
 // Disables the previously set pack pragma.
 #pragma pack(pop)
 }
@@ -9,6 +9,15 @@ namespace RTE {
 		m_NodeDimension = 20;
 		m_DigStrength = 1;
 		m_Pather = 0;
+		m_PathCache.clear();
+		m_FlowFields.clear();
+		m_GoalDemand.clear();
+		m_SearchCount = 0;
+		m_DirtyNodes.clear();
+		m_MaterialSnapshot = 0;
+		m_BackgroundRecalculation = std::future<void>();
+		m_RecalculatedCosts.clear();
+		m_UpdatedSinceSnapshot.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +48,7 @@ namespace RTE {
 				if (nodePos.m_Y >= sceneHeight) { nodePos.m_Y = sceneHeight - 1; }
 				// Create the new node with its in-scene position in the center of it
 				node = new PathNode(nodePos);
+				node->Index = x * nodeYCount + y;
 				// Move current position down for the next node in the column
 				nodePos.m_Y += nodeDimension;
 				// Add the newly created node to the column, transferring ownership to it
@@ -83,14 +93,6 @@ namespace RTE {
 		// Create and allocate the pather class which will do the work
 		m_Pather = new MicroPather(this, allocate);
 
-		// If the scene wraps we must find the cost over the seam before doing RecalculateAllCosts() the first time
-		// since the cost is equal to max(node->LeftCost, node->m_Left->RightCost)
-		if (scene->WrapsX()) {
-			for (int y = 0; y < nodeYCount; ++y) {
-				node = m_NodeGrid[0][y];
-				if (node->Left) { node->Left->RightCost = CostAlongLine(node->Pos, node->Left->Pos); }
-			}
-		}
 		// Set up all the costs between all nodes
 		RecalculateAllCosts();
 
@@ -100,6 +102,9 @@ namespace RTE {
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::Destroy() {
+		if (m_BackgroundRecalculation.valid()) { m_BackgroundRecalculation.wait(); }
+		destroy_bitmap(m_MaterialSnapshot);
+
 		for (unsigned int x = 0; x < m_NodeGrid.size(); ++x) {
 			for (unsigned int y = 0; y < m_NodeGrid[x].size(); ++y) {
 				delete m_NodeGrid[x][y];
@@ -112,8 +117,9 @@ namespace RTE {
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	int PathFinder::CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength) {
+	int PathFinder::CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength, int team) {
 		RTEAssert(m_Pather, "No pather exists, can't calculate the path!");
+		std::lock_guard<std::mutex> pathFinderLock(m_PathFinderMutex);
 
 		// Make sure start and end are within scene bounds
 		g_SceneMan.ForceBounds(start);
@@ -124,40 +130,49 @@ namespace RTE {
 		int startNodeY = std::floorf(start.m_Y / static_cast<float>(m_NodeDimension));
 		int endNodeX = std::floorf(end.m_X / static_cast<float>(m_NodeDimension));
 		int endNodeY = std::floorf(end.m_Y / static_cast<float>(m_NodeDimension));
-
-		// Clear out the results if it happens to contain anything
-		pathResult.clear();
+		PathNode *startNode = m_NodeGrid[startNodeX][startNodeY];
+		PathNode *endNode = m_NodeGrid[endNodeX][endNodeY];
 
 		// Actors capable of digging can use m_DigStrength to modify the node adjacency cost
 		m_DigStrength = digStrength;
+		++m_SearchCount;
+
+		// Searches with dig strengths in the same bucket and for the same team share their paths and flow fields
+		unsigned long long digStrengthBucket = static_cast<unsigned long long>(std::clamp(static_cast<int>(digStrength / c_DigStrengthBucketSize), 0, 0xFFF));
+		unsigned long long goalKey = (static_cast<unsigned long long>(endNode->Index) << 16) | (digStrengthBucket << 4) | static_cast<unsigned long long>((team + 1) & 0xF);
+		unsigned long long pathKey = (static_cast<unsigned long long>(startNode->Index) << 40) | goalKey;
+
+		std::vector<PathNode *> nodePath;
+		if (startNode != endNode) {
+			// A cached path is only used if nothing along it changed since it was found, which also keeps paths through a team's doors valid while they're opened and closed around each search
+			std::unordered_map<unsigned long long, CachedPath>::iterator cachedPathItr = m_PathCache.find(pathKey);
+			if (cachedPathItr != m_PathCache.end()) {
+				CachedPath &cachedPath = cachedPathItr->second;
+				if (!cachedPath.Age.IsPastSimMS(c_CacheMaxAge) && PathCostsUnchanged(cachedPath.Nodes, cachedPath.CostSignatures, false)) {
+					cachedPath.LastUsed = m_SearchCount;
+					totalCostResult = cachedPath.TotalCost;
+					MakePathResult(start, end, cachedPath.Nodes, pathResult);
+					return cachedPath.Result;
+				}
+				m_PathCache.erase(cachedPathItr);
+			}
+			if (GetFlowFieldPath(startNode, endNode, goalKey, digStrength, nodePath, totalCostResult)) {
+				MakePathResult(start, end, nodePath, pathResult);
+				return MicroPather::SOLVED;
+			}
+		}
 
 		// Do the actual pathfinding, fetch out the list of states that comprise the best path
 		std::vector<void *> statePath;
-		int result = m_Pather->Solve(static_cast<void *>(m_NodeGrid[startNodeX][startNodeY]), static_cast<void *>(m_NodeGrid[endNodeX][endNodeY]), &statePath, &totalCostResult);
-
-		// We got something back
-		if (!statePath.empty()) {
-			// Replace the approximate first point from the pathfound path with the exact starting point
-			pathResult.push_back(start);
-			std::vector<void *>::iterator itr = statePath.begin();
-			itr++;
+		int result = m_Pather->Solve(static_cast<void *>(startNode), static_cast<void *>(endNode), &statePath, &totalCostResult);
 
-			// Convert from a list of state void pointers to a list of scene position vectors
-			for (; itr != statePath.end(); ++itr) {
-				pathResult.push_back((static_cast<PathNode *>(*itr))->Pos);
-			}
-
-			// Adjust the last point to be exactly where the end is supposed to be (really?)
-			if (pathResult.size() > 2) {
-				pathResult.pop_back();
-				pathResult.push_back(end);
-			}
-			// Empty path, give exact start and end
-		} else {
-			pathResult.push_back(start);
-			pathResult.push_back(end);
+		nodePath.clear();
+		for (void *state : statePath) {
+			nodePath.push_back(static_cast<PathNode *>(state));
 		}
-		// TODO: Clean up the path, remove series of nodes in the same direction etc?
+		if (result == MicroPather::SOLVED) { AddCachedPath(pathKey, nodePath, totalCostResult, result); }
+
+		MakePathResult(start, end, nodePath, pathResult);
 		return result;
 	}
 
@@ -165,22 +180,53 @@ namespace RTE {
 
 	void PathFinder::RecalculateAllCosts() {
 		RTEAssert(g_SceneMan.GetScene(), "Scene doesn't exist or isn't loaded when recalculating PathFinder!");
+		std::lock_guard<std::mutex> pathFinderLock(m_PathFinderMutex);
 
-		// Update all the costs going out from each node
-		for (const std::vector<PathNode *> &nodeEntry : m_NodeGrid) {
-			for (PathNode *pathNode : nodeEntry) {
-				UpdateNodeCosts(pathNode);
-				// Should reset the changed flag since we're about to reset the pather
-				pathNode->IsChanged = false;
-			}
+		// Whatever a background recalculation comes up with would be older than this, so wait it out and throw it away
+		if (m_BackgroundRecalculation.valid()) { m_BackgroundRecalculation.get(); }
+
+		// Nothing can change the terrain while this waits for the strips, so they can read it directly
+		CalculateAllCosts(g_SceneMan.GetScene()->GetTerrain()->GetMaterialBitmap());
+		ApplyRecalculatedCosts(false);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::StartBackgroundRecalculation() {
+		RTEAssert(g_SceneMan.GetScene(), "Scene doesn't exist or isn't loaded when recalculating PathFinder!");
+		if (m_BackgroundRecalculation.valid()) {
+			return;
 		}
-		// Reset the pather when costs change, as per the docs
-		m_Pather->Reset();
+		BITMAP *materialBitmap = g_SceneMan.GetScene()->GetTerrain()->GetMaterialBitmap();
+		if (!m_MaterialSnapshot || m_MaterialSnapshot->w != materialBitmap->w || m_MaterialSnapshot->h != materialBitmap->h) {
+			destroy_bitmap(m_MaterialSnapshot);
+			m_MaterialSnapshot = create_bitmap_ex(8, materialBitmap->w, materialBitmap->h);
+		}
+		blit(materialBitmap, m_MaterialSnapshot, 0, 0, 0, 0, materialBitmap->w, materialBitmap->h);
+
+		m_UpdatedSinceSnapshot.assign(m_NodeGrid.size() * m_NodeGrid[0].size(), false);
+		m_BackgroundRecalculation = std::async(std::launch::async, [this]() { CalculateAllCosts(m_MaterialSnapshot); });
+		m_BackgroundRecalculationTimer.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::UpdateBackgroundRecalculation() {
+		if (!m_BackgroundRecalculation.valid() || !m_BackgroundRecalculationTimer.IsPastSimMS(c_BackgroundRecalculationSimMS)) {
+			return false;
+		}
+		// Blocks if the recalculation is running late, which is the price of swapping at the same sim update every run
+		m_BackgroundRecalculation.get();
+
+		std::lock_guard<std::mutex> pathFinderLock(m_PathFinderMutex);
+		ApplyRecalculatedCosts(true);
+		return true;
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::RecalculateAreaCosts(const std::list<Box> &boxList) {
+		std::lock_guard<std::mutex> pathFinderLock(m_PathFinderMutex);
 		Box box;
 		// Go through all the boxes and see if any of the node centers are inside each
 		for (const Box &boxListEntry : boxList) {
@@ -219,12 +265,22 @@ namespace RTE {
 		// Reset the pather when costs change, as per the docs
 		m_Pather->Reset();
 
-		// Reset the changed flag on all nodes
-		for (const std::vector<PathNode *> &nodeEntry : m_NodeGrid) {
-			for (PathNode *pathNode : nodeEntry) {
-				pathNode->IsChanged = false;
-			}
+		// Reset the changed flag on only the nodes that were updated, and keep track of them while a background recalculation is underway so their newer costs don't get swapped out
+		bool recalculatingInBackground = m_BackgroundRecalculation.valid();
+		for (PathNode *pathNode : m_DirtyNodes) {
+			pathNode->IsChanged = false;
+			if (recalculatingInBackground) { m_UpdatedSinceSnapshot[pathNode->Index] = true; }
 		}
+		m_DirtyNodes.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::ClearPathCache() {
+		std::lock_guard<std::mutex> pathFinderLock(m_PathFinderMutex);
+		m_PathCache.clear();
+		m_FlowFields.clear();
+		m_GoalDemand.clear();
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -237,60 +293,249 @@ namespace RTE {
 
 	void PathFinder::AdjacentCost(void *state, std::vector<micropather::StateCost> *adjacentList) {
 		const PathNode *node = static_cast<PathNode *>(state);
-		micropather::StateCost adjCost;
-		float strength = 0.0F;
-
-		// Add cost for digging upwards
-		if (node->Up) {
-			strength = node->UpCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 2000.0F : strength * 4.0F); // Four times more expensive when digging
-			adjCost.state = static_cast<void *>(node->Up);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Right) {
-			strength = node->RightCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Right);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Down) {
-			strength = node->DownCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Down);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->Left) {
-			strength = node->LeftCost;
-			adjCost.cost = 1.0F + ((strength > m_DigStrength) ? strength * 1000.0F : strength);
-			adjCost.state = static_cast<void *>(node->Left);
-			adjacentList->push_back(adjCost);
-		}
-
-		// Add cost for digging at 45 degrees and for digging upwards
-		if (node->UpRight) {
-			strength = node->UpRightCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 2828.0F : strength * 4.2F);  // Three times more expensive when digging
-			adjCost.state = static_cast<void *>(node->UpRight);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->RightDown) {
-			strength = node->RightDownCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 1414.0F : strength * 1.4F);
-			adjCost.state = static_cast<void *>(node->RightDown);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->DownLeft) {
-			strength = node->DownLeftCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 1414.0F : strength * 1.4F);
-			adjCost.state = static_cast<void *>(node->DownLeft);
-			adjacentList->push_back(adjCost);
-		}
-		if (node->LeftUp) {
-			strength = node->LeftUpCost;
-			adjCost.cost = 1.4F + ((strength > m_DigStrength) ? strength * 2828.0F : strength * 4.2F);  // Three times more expensive when digging
-			adjCost.state = static_cast<void *>(node->LeftUp);
-			adjacentList->push_back(adjCost);
+		for (int direction = NodeDirection::Up; direction < NodeDirection::DirectionCount; ++direction) {
+			if (PathNode *adjacentNode = GetAdjacentNode(node, static_cast<NodeDirection>(direction))) {
+				adjacentList->push_back({ static_cast<void *>(adjacentNode), GetAdjacentCost(node, static_cast<NodeDirection>(direction), m_DigStrength) });
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PathNode * PathFinder::GetAdjacentNode(const PathNode *node, NodeDirection direction) const {
+		switch (direction) {
+			case NodeDirection::Up: return node->Up;
+			case NodeDirection::Right: return node->Right;
+			case NodeDirection::Down: return node->Down;
+			case NodeDirection::Left: return node->Left;
+			case NodeDirection::UpRight: return node->UpRight;
+			case NodeDirection::RightDown: return node->RightDown;
+			case NodeDirection::DownLeft: return node->DownLeft;
+			case NodeDirection::LeftUp: return node->LeftUp;
+			default: return 0;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathFinder::GetAdjacentStrength(const PathNode *node, NodeDirection direction) const {
+		switch (direction) {
+			case NodeDirection::Up: return node->UpCost;
+			case NodeDirection::Right: return node->RightCost;
+			case NodeDirection::Down: return node->DownCost;
+			case NodeDirection::Left: return node->LeftCost;
+			case NodeDirection::UpRight: return node->UpRightCost;
+			case NodeDirection::RightDown: return node->RightDownCost;
+			case NodeDirection::DownLeft: return node->DownLeftCost;
+			case NodeDirection::LeftUp: return node->LeftUpCost;
+			default: return FLT_MAX;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	float PathFinder::GetAdjacentCost(const PathNode *node, NodeDirection direction, float digStrength) const {
+		float strength = GetAdjacentStrength(node, direction);
+		switch (direction) {
+			// Four times more expensive when digging upwards
+			case NodeDirection::Up:
+				return 1.0F + ((strength > digStrength) ? strength * 2000.0F : strength * 4.0F);
+			// Three times more expensive when digging upwards at 45 degrees
+			case NodeDirection::UpRight:
+			case NodeDirection::LeftUp:
+				return 1.4F + ((strength > digStrength) ? strength * 2828.0F : strength * 4.2F);
+			case NodeDirection::RightDown:
+			case NodeDirection::DownLeft:
+				return 1.4F + ((strength > digStrength) ? strength * 1414.0F : strength * 1.4F);
+			default:
+				return 1.0F + ((strength > digStrength) ? strength * 1000.0F : strength);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned int PathFinder::GetNodeCostSignature(const PathNode *node) const {
+		// FNV-1a over the bits of all the outgoing edge strengths
+		unsigned int signature = 2166136261U;
+		for (int direction = NodeDirection::Up; direction < NodeDirection::DirectionCount; ++direction) {
+			float strength = GetAdjacentStrength(node, static_cast<NodeDirection>(direction));
+			unsigned int strengthBits;
+			std::memcpy(&strengthBits, &strength, sizeof(strengthBits));
+			signature = (signature ^ strengthBits) * 16777619U;
+		}
+		return signature;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::PathCostsUnchanged(const std::vector<PathNode *> &nodes, const std::vector<unsigned int> &signatures, bool signaturesByIndex) const {
+		for (size_t i = 0; i < nodes.size(); ++i) {
+			if (GetNodeCostSignature(nodes[i]) != signatures[signaturesByIndex ? nodes[i]->Index : i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::BuildFlowField(FlowField &flowField, const PathNode *goalNode, float digStrength) {
+		size_t nodeCount = m_NodeGrid.size() * m_NodeGrid[0].size();
+		flowField.NextNode.assign(nodeCount, -1);
+		flowField.CostToGoal.assign(nodeCount, FLT_MAX);
+		flowField.CostSignatures.resize(nodeCount);
+		for (const std::vector<PathNode *> &nodeColumn : m_NodeGrid) {
+			for (const PathNode *node : nodeColumn) {
+				flowField.CostSignatures[node->Index] = GetNodeCostSignature(node);
+			}
+		}
+
+		// Search outwards from the goal along the edges leading into each node, so every node ends up with the cheapest way on towards the goal
+		using OpenNode = std::pair<float, int>;
+		std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> openNodes;
+		flowField.CostToGoal[goalNode->Index] = 0;
+		openNodes.emplace(0.0F, goalNode->Index);
+
+		while (!openNodes.empty()) {
+			float costToGoal = openNodes.top().first;
+			int nodeIndex = openNodes.top().second;
+			openNodes.pop();
+			if (costToGoal > flowField.CostToGoal[nodeIndex]) {
+				continue;
+			}
+			const PathNode *node = GetNode(nodeIndex);
+			for (int direction = NodeDirection::Up; direction < NodeDirection::DirectionCount; ++direction) {
+				const PathNode *adjacentNode = GetAdjacentNode(node, static_cast<NodeDirection>(direction));
+				if (!adjacentNode) {
+					continue;
+				}
+				// The edge leading from the adjacent node into this one goes the opposite way
+				int oppositeDirection = (direction < NodeDirection::UpRight) ? (direction + 2) % 4 : NodeDirection::UpRight + (direction - NodeDirection::UpRight + 2) % 4;
+				float adjacentCostToGoal = costToGoal + GetAdjacentCost(adjacentNode, static_cast<NodeDirection>(oppositeDirection), digStrength);
+				if (adjacentCostToGoal < flowField.CostToGoal[adjacentNode->Index]) {
+					flowField.CostToGoal[adjacentNode->Index] = adjacentCostToGoal;
+					flowField.NextNode[adjacentNode->Index] = nodeIndex;
+					openNodes.emplace(adjacentCostToGoal, adjacentNode->Index);
+				}
+			}
+		}
+		flowField.Age.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::FollowFlowField(const FlowField &flowField, const PathNode *startNode, const PathNode *goalNode, std::vector<PathNode *> &nodePath) const {
+		nodePath.clear();
+		if (flowField.CostToGoal[startNode->Index] == FLT_MAX) {
+			return false;
+		}
+		PathNode *node = GetNode(startNode->Index);
+		nodePath.push_back(node);
+		while (node != goalNode) {
+			int nextNodeIndex = flowField.NextNode[node->Index];
+			// Guard against going around in circles, which can only happen if the field is broken somehow
+			if (nextNodeIndex < 0 || nodePath.size() > flowField.NextNode.size()) {
+				nodePath.clear();
+				return false;
+			}
+			node = GetNode(nextNodeIndex);
+			nodePath.push_back(node);
+		}
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PathFinder::GetFlowFieldPath(const PathNode *startNode, const PathNode *goalNode, unsigned long long fieldKey, float digStrength, std::vector<PathNode *> &nodePath, float &totalCostResult) {
+		std::unordered_map<unsigned long long, FlowField>::iterator flowFieldItr = m_FlowFields.find(fieldKey);
+		if (flowFieldItr == m_FlowFields.end()) {
+			GoalDemand &goalDemand = m_GoalDemand[fieldKey];
+			if (goalDemand.Window.IsPastSimMS(c_FlowFieldDemandWindow)) {
+				goalDemand.Searches = 0;
+				goalDemand.Window.Reset();
+			}
+			if (++goalDemand.Searches < c_FlowFieldDemand) {
+				// Don't let goals that were only searched for a few times pile up
+				if (m_GoalDemand.size() > c_MaxCachedPaths) {
+					for (std::unordered_map<unsigned long long, GoalDemand>::iterator demandItr = m_GoalDemand.begin(); demandItr != m_GoalDemand.end();) {
+						demandItr = demandItr->second.Window.IsPastSimMS(c_FlowFieldDemandWindow) ? m_GoalDemand.erase(demandItr) : std::next(demandItr);
+					}
+				}
+				return false;
+			}
+			m_GoalDemand.erase(fieldKey);
+
+			if (m_FlowFields.size() >= c_MaxFlowFields) {
+				m_FlowFields.erase(std::min_element(m_FlowFields.begin(), m_FlowFields.end(), [](const std::pair<const unsigned long long, FlowField> &flowFieldEntry, const std::pair<const unsigned long long, FlowField> &otherFlowFieldEntry) {
+					return flowFieldEntry.second.LastUsed < otherFlowFieldEntry.second.LastUsed;
+				}));
+			}
+			flowFieldItr = m_FlowFields.try_emplace(fieldKey).first;
+			BuildFlowField(flowFieldItr->second, goalNode, digStrength);
+		} else if (flowFieldItr->second.Age.IsPastSimMS(c_CacheMaxAge)) {
+			BuildFlowField(flowFieldItr->second, goalNode, digStrength);
+		}
+
+		FlowField &flowField = flowFieldItr->second;
+		flowField.LastUsed = m_SearchCount;
+		if (!FollowFlowField(flowField, startNode, goalNode, nodePath)) {
+			return false;
+		}
+		// Something along the way changed since the field was made, so remake it once for everyone heading to this goal
+		if (!PathCostsUnchanged(nodePath, flowField.CostSignatures, true)) {
+			BuildFlowField(flowField, goalNode, digStrength);
+			if (!FollowFlowField(flowField, startNode, goalNode, nodePath)) {
+				return false;
+			}
+		}
+		totalCostResult = flowField.CostToGoal[startNode->Index];
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::AddCachedPath(unsigned long long pathKey, const std::vector<PathNode *> &nodePath, float totalCost, int result) {
+		if (m_PathCache.size() >= c_MaxCachedPaths) {
+			m_PathCache.erase(std::min_element(m_PathCache.begin(), m_PathCache.end(), [](const std::pair<const unsigned long long, CachedPath> &cachedPathEntry, const std::pair<const unsigned long long, CachedPath> &otherCachedPathEntry) {
+				return cachedPathEntry.second.LastUsed < otherCachedPathEntry.second.LastUsed;
+			}));
+		}
+		CachedPath &cachedPath = m_PathCache[pathKey];
+		cachedPath.Nodes = nodePath;
+		cachedPath.CostSignatures.clear();
+		for (const PathNode *node : nodePath) {
+			cachedPath.CostSignatures.push_back(GetNodeCostSignature(node));
+		}
+		cachedPath.TotalCost = totalCost;
+		cachedPath.Result = result;
+		cachedPath.LastUsed = m_SearchCount;
+		cachedPath.Age.Reset();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::MakePathResult(const Vector &start, const Vector &end, const std::vector<PathNode *> &nodePath, std::list<Vector> &pathResult) const {
+		// Clear out the results if it happens to contain anything
+		pathResult.clear();
+
+		// We got something back
+		if (!nodePath.empty()) {
+			// Replace the approximate first point from the pathfound path with the exact starting point
+			pathResult.push_back(start);
+			for (std::vector<PathNode *>::const_iterator itr = std::next(nodePath.begin()); itr != nodePath.end(); ++itr) {
+				pathResult.push_back((*itr)->Pos);
+			}
+			// Adjust the last point to be exactly where the end is supposed to be (really?)
+			if (pathResult.size() > 2) {
+				pathResult.pop_back();
+				pathResult.push_back(end);
+			}
+			// Empty path, give exact start and end
+		} else {
+			pathResult.push_back(start);
+			pathResult.push_back(end);
 		}
+		// TODO: Clean up the path, remove series of nodes in the same direction etc?
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -311,9 +556,87 @@ namespace RTE {
 		if (node->LeftUp) { node->LeftUpCost = std::max(node->LeftUp->RightDownCost, CostAlongLine(node->Pos + Vector(-2, 2), node->LeftUp->Pos + Vector(-2, 2))); }
 
 		// Mark this as already changed so the above expensive calculation isn't done redundantly
+		if (!node->IsChanged) { m_DirtyNodes.push_back(node); }
 		node->IsChanged = true;
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::CalculateAllCosts(BITMAP *materialBitmap) {
+		std::array<float, NodeDirection::DirectionCount> infiniteCosts;
+		infiniteCosts.fill(FLT_MAX);
+		m_RecalculatedCosts.assign(m_NodeGrid.size() * m_NodeGrid[0].size(), infiniteCosts);
+
+		// The lines are offset to the side of the straight line between the node centers to cover more terrain, the same as in UpdateNodeCosts
+		static const std::array<Vector, NodeDirection::DirectionCount> lineOffsets = { Vector(3, 0), Vector(0, 3), Vector(-3, 0), Vector(0, -3), Vector(2, 2), Vector(2, -2), Vector(-2, -2), Vector(-2, 2) };
+
+		// Each strip only writes the costs of its own nodes, so they don't need to be synchronized
+		int columnCount = static_cast<int>(m_NodeGrid.size());
+		int stripCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, columnCount);
+		int columnsPerStrip = (columnCount + stripCount - 1) / stripCount;
+		std::vector<std::future<void>> strips;
+		for (int firstColumn = 0; firstColumn < columnCount; firstColumn += columnsPerStrip) {
+			int lastColumn = std::min(firstColumn + columnsPerStrip, columnCount);
+			strips.push_back(std::async(std::launch::async, [this, firstColumn, lastColumn, materialBitmap]() {
+				for (int x = firstColumn; x < lastColumn; ++x) {
+					for (const PathNode *node : m_NodeGrid[x]) {
+						std::array<float, NodeDirection::DirectionCount> &nodeCosts = m_RecalculatedCosts[node->Index];
+						for (int direction = NodeDirection::Up; direction < NodeDirection::DirectionCount; ++direction) {
+							if (const PathNode *adjacentNode = GetAdjacentNode(node, static_cast<NodeDirection>(direction))) {
+								nodeCosts[direction] = CostAlongLine(node->Pos + lineOffsets[direction], adjacentNode->Pos + lineOffsets[direction], materialBitmap);
+							}
+						}
+					}
+				}
+			}));
+		}
+		for (std::future<void> &strip : strips) {
+			strip.get();
+		}
+
+		// Going up or left along an edge costs the most of both ways along it, same as in UpdateNodeCosts. Only the down and right costs are read here, so the order doesn't matter
+		for (const std::vector<PathNode *> &nodeColumn : m_NodeGrid) {
+			for (const PathNode *node : nodeColumn) {
+				std::array<float, NodeDirection::DirectionCount> &nodeCosts = m_RecalculatedCosts[node->Index];
+				if (node->Up) { nodeCosts[NodeDirection::Up] = std::max(m_RecalculatedCosts[node->Up->Index][NodeDirection::Down], nodeCosts[NodeDirection::Up]); }
+				if (node->Left) { nodeCosts[NodeDirection::Left] = std::max(m_RecalculatedCosts[node->Left->Index][NodeDirection::Right], nodeCosts[NodeDirection::Left]); }
+				if (node->UpRight) { nodeCosts[NodeDirection::UpRight] = std::max(m_RecalculatedCosts[node->UpRight->Index][NodeDirection::DownLeft], nodeCosts[NodeDirection::UpRight]); }
+				if (node->LeftUp) { nodeCosts[NodeDirection::LeftUp] = std::max(m_RecalculatedCosts[node->LeftUp->Index][NodeDirection::RightDown], nodeCosts[NodeDirection::LeftUp]); }
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PathFinder::ApplyRecalculatedCosts(bool skipUpdatedNodes) {
+		for (const std::vector<PathNode *> &nodeColumn : m_NodeGrid) {
+			for (PathNode *node : nodeColumn) {
+				node->IsChanged = false;
+				if (skipUpdatedNodes && m_UpdatedSinceSnapshot[node->Index]) {
+					continue;
+				}
+				const std::array<float, NodeDirection::DirectionCount> &nodeCosts = m_RecalculatedCosts[node->Index];
+				node->UpCost = nodeCosts[NodeDirection::Up];
+				node->RightCost = nodeCosts[NodeDirection::Right];
+				node->DownCost = nodeCosts[NodeDirection::Down];
+				node->LeftCost = nodeCosts[NodeDirection::Left];
+				node->UpRightCost = nodeCosts[NodeDirection::UpRight];
+				node->RightDownCost = nodeCosts[NodeDirection::RightDown];
+				node->DownLeftCost = nodeCosts[NodeDirection::DownLeft];
+				node->LeftUpCost = nodeCosts[NodeDirection::LeftUp];
+			}
+		}
+		m_DirtyNodes.clear();
+
+		// Reset the pather when costs change, as per the docs
+		m_Pather->Reset();
+
+		// Everything may have changed, so there's no point in checking each cached path on its own
+		m_PathCache.clear();
+		m_FlowFields.clear();
+		m_GoalDemand.clear();
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void PathFinder::UpdateNodeCostsInBox(Box &box) {
@@ -2,6 +2,7 @@
 #define _RTEPATHFINDER_
 
 #include "Box.h"
+#include "Timer.h"
 #include "Scene.h"
 #include "System/MicroPather/micropather.h"
 
@@ -15,6 +16,7 @@ namespace RTE {
 	struct PathNode {
 
 		Vector Pos; //!< Absolute position of the center of this node in the scene.    
+		int Index; //!< The index of this node in the node grid, counted column by column.
 		bool IsChanged; //!< Whether this has been updated since last call to Reset the pather.
 
 		/// <summary>
@@ -43,6 +45,7 @@ namespace RTE {
 
 		PathNode(Vector pos) {
 			Pos = pos;
+			Index = 0;
 			Up = Right = Down = Left = UpRight = RightDown = DownLeft = LeftUp = 0;
 			// Costs are infinite unless recalculated as otherwise
 			UpCost = RightCost = DownCost = LeftCost = UpRightCost = RightDownCost = DownLeftCost = LeftUpCost = FLT_MAX;
@@ -101,20 +104,46 @@ namespace RTE {
 		/// <param name="pathResult">A list which will be filled out with waypoints between the start and end.</param>
 		/// <param name="totalCostResult">The total minimum difficulty cost calculated between the two points on the scene.</param>
 		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <param name="team">The team the path is for. Paths are only shared between searches for the same team, since each team's doors are open to it while it searches.</param>
 		/// <returns>Success or failure, expressed as SOLVED, NO_SOLUTION, or START_END_SAME.</returns>
-		int CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength = 1);
+		int CalculatePath(Vector start, Vector end, std::list<Vector> &pathResult, float &totalCostResult, float digStrength = 1, int team = Activity::NoTeam);
 
 		/// <summary>
 		/// Recalculates all the costs between all the nodes by tracing lines in the material layer and summing all the material strengths for each encountered pixel. Also resets the pather itself.
+		/// The nodes are split into strips of columns that are worked on in parallel, but this waits for all of them to finish. Use StartBackgroundRecalculation to not wait.
 		/// </summary>
 		void RecalculateAllCosts();
 
+		/// <summary>
+		/// Starts recalculating all the costs between all the nodes in the background, against a snapshot of the material layer taken right now. Does nothing if a background recalculation is already running.
+		/// The new costs are only swapped in by UpdateBackgroundRecalculation c_BackgroundRecalculationSimMS later, so pathfinding keeps using the old ones until then.
+		/// </summary>
+		void StartBackgroundRecalculation();
+
+		/// <summary>
+		/// Swaps in the costs of a background recalculation once c_BackgroundRecalculationSimMS have passed since it was started, waiting for it to finish if it hasn't yet. Nodes whose costs were updated by RecalculateAreaCosts since the snapshot was taken keep those newer costs.
+		/// The swap happens at a fixed point in sim time rather than whenever the worker thread happens to finish, so paths and AI come out the same every run.
+		/// </summary>
+		/// <returns>Whether the costs of a background recalculation were swapped in.</returns>
+		bool UpdateBackgroundRecalculation();
+
+		/// <summary>
+		/// Tells whether a background recalculation of all the costs is running or waiting to be swapped in.
+		/// </summary>
+		/// <returns>Whether a background recalculation is underway.</returns>
+		bool IsRecalculatingInBackground() const { return m_BackgroundRecalculation.valid(); }
+
 		/// <summary>
 		/// Recalculates the costs between all the nodes touching a list of specific rectangular areas (which will be wrapped). Also resets the pather itself.
 		/// </summary>
 		/// <param name="boxList">The list of Boxes representing the updated areas.</param>
 		void RecalculateAreaCosts(const std::list<Box> &boxList);
 
+		/// <summary>
+		/// Forgets all cached paths and flow fields.
+		/// </summary>
+		void ClearPathCache();
+
 		/// <summary>
 		/// Implementation of the abstract interface of Graph.
 		/// Gets the least possible cost to get from node A to B, if it all was air.
@@ -147,14 +176,169 @@ namespace RTE {
 
 	protected:
 
+		static constexpr unsigned short c_MaxCachedPaths = 256; //!< The most paths kept in the path cache, the least recently used are dropped beyond that.
+		static constexpr unsigned short c_MaxFlowFields = 4; //!< The most flow fields kept around at once, the least recently used are dropped beyond that.
+		static constexpr unsigned short c_FlowFieldDemand = 4; //!< How many searches for the same goal have to come in within c_FlowFieldDemandWindow before a flow field is made for it.
+		static constexpr unsigned short c_FlowFieldDemandWindow = 2000; //!< The time in sim MS searches for the same goal are counted over.
+		static constexpr unsigned short c_CacheMaxAge = 10000; //!< The time in sim MS cached paths and flow fields are kept at most, so routes opened up elsewhere since get picked up eventually.
+		static constexpr float c_DigStrengthBucketSize = 10.0F; //!< The range of dig strengths that share cached paths and flow fields.
+		static constexpr unsigned short c_BackgroundRecalculationSimMS = 1000; //!< The time in sim MS after a background recalculation is started that its costs are swapped in, waiting for it if it isn't done yet.
+
+		/// <summary>
+		/// The directions from a node to its adjacent nodes, in the order they are gone through.
+		/// </summary>
+		enum NodeDirection { Up, Right, Down, Left, UpRight, RightDown, DownLeft, LeftUp, DirectionCount };
+
+		/// <summary>
+		/// A path found by the pather, kept around so other searches between the same nodes can reuse it.
+		/// </summary>
+		struct CachedPath {
+			std::vector<PathNode *> Nodes; //!< The nodes along the path, from start to end. Not owned.
+			std::vector<unsigned int> CostSignatures; //!< The cost signature of each node along the path at the time it was found.
+			float TotalCost; //!< The total cost of the path.
+			int Result; //!< What the pather returned for the search.
+			unsigned long long LastUsed; //!< The search count when this was last used.
+			Timer Age; //!< Times how long ago the path was found.
+		};
+
+		/// <summary>
+		/// The cheapest way from every node to a single goal node, found with one reverse Dijkstra search so many searches heading for the same goal can share it.
+		/// </summary>
+		struct FlowField {
+			std::vector<int> NextNode; //!< The index of the node to go to next from each node on the way to the goal, or -1 if there is none.
+			std::vector<float> CostToGoal; //!< The total cost from each node to the goal.
+			std::vector<unsigned int> CostSignatures; //!< The cost signature of each node at the time this was made.
+			unsigned long long LastUsed; //!< The search count when this was last used.
+			Timer Age; //!< Times how long ago this was made.
+		};
+
+		/// <summary>
+		/// Keeps count of the searches made for a goal recently, to tell when making a flow field for it is worth it.
+		/// </summary>
+		struct GoalDemand {
+			int Searches = 0; //!< The number of searches made for the goal within the current window.
+			Timer Window; //!< Times the current window.
+		};
+
 		MicroPather *m_Pather; //!< The actual pathing object that does the pathfinding work. Owned.
 		std::vector<std::vector<PathNode *>> m_NodeGrid;  //!< The array of PathNodes representing the grid on the scene. The nodes are owned by this.
 		unsigned int m_NodeDimension; //!< The width and height of each node, in pixels on the scene.
 
 		float m_DigStrength; //!< What material strength the search is capable of digging through.
 
+		std::unordered_map<unsigned long long, CachedPath> m_PathCache; //!< The cached paths, by start node, end node, dig strength bucket and team.
+		std::unordered_map<unsigned long long, FlowField> m_FlowFields; //!< The flow fields, by goal node, dig strength bucket and team.
+		std::unordered_map<unsigned long long, GoalDemand> m_GoalDemand; //!< The recent demand for each goal node, dig strength bucket and team.
+		unsigned long long m_SearchCount; //!< The number of searches made so far, used to tell which cached paths and flow fields were used least recently.
+		std::mutex m_PathFinderMutex; //!< Guards the pather and caches, since Lua AI can search for paths from the parallel AI workers.
+
+		std::vector<PathNode *> m_DirtyNodes; //!< The nodes whose costs were updated since the pather was last reset, so only their changed flags need clearing. Not owned.
+		BITMAP *m_MaterialSnapshot; //!< The copy of the material layer the background recalculation works against. Owned.
+		std::future<void> m_BackgroundRecalculation; //!< The background recalculation of all the costs, if one is underway.
+		Timer m_BackgroundRecalculationTimer; //!< Times how long ago the background recalculation was started, in sim time.
+		std::vector<std::array<float, NodeDirection::DirectionCount>> m_RecalculatedCosts; //!< The costs going out from each node in each direction, as worked out by the last recalculation of all the costs.
+		std::vector<bool> m_UpdatedSinceSnapshot; //!< Whether each node's costs were updated since the snapshot of the background recalculation was taken.
+
 	private:
 
+#pragma region Path Sharing
+		/// <summary>
+		/// Gets the node at an index in the node grid.
+		/// </summary>
+		/// <param name="index">The index of the node, counted column by column.</param>
+		/// <returns>The node at the index. OWNERSHIP IS NOT TRANSFERRED!</returns>
+		PathNode * GetNode(int index) const { return m_NodeGrid[index / m_NodeGrid[0].size()][index % m_NodeGrid[0].size()]; }
+
+		/// <summary>
+		/// Gets the node adjacent to a node in a direction.
+		/// </summary>
+		/// <param name="node">The node to get the adjacent node of.</param>
+		/// <param name="direction">The direction to get the adjacent node in.</param>
+		/// <returns>The adjacent node, or 0 if there is none in that direction. OWNERSHIP IS NOT TRANSFERRED!</returns>
+		PathNode * GetAdjacentNode(const PathNode *node, NodeDirection direction) const;
+
+		/// <summary>
+		/// Gets the material strength of the edge going from a node to its adjacent node in a direction.
+		/// </summary>
+		/// <param name="node">The node to go from.</param>
+		/// <param name="direction">The direction to go in.</param>
+		/// <returns>The material strength of the edge.</returns>
+		float GetAdjacentStrength(const PathNode *node, NodeDirection direction) const;
+
+		/// <summary>
+		/// Gets the cost of going from a node to its adjacent node in a direction, for a search capable of digging through a material strength.
+		/// </summary>
+		/// <param name="node">The node to go from.</param>
+		/// <param name="direction">The direction to go in.</param>
+		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <returns>The cost of going to the adjacent node.</returns>
+		float GetAdjacentCost(const PathNode *node, NodeDirection direction, float digStrength) const;
+
+		/// <summary>
+		/// Gets a signature of all the costs going out from a node, which changes whenever any of those costs do.
+		/// </summary>
+		/// <param name="node">The node to get the signature of.</param>
+		/// <returns>The cost signature of the node.</returns>
+		unsigned int GetNodeCostSignature(const PathNode *node) const;
+
+		/// <summary>
+		/// Tells whether the costs going out from all the nodes along a path are still the same as they were when the signatures were taken.
+		/// </summary>
+		/// <param name="nodes">The nodes along the path.</param>
+		/// <param name="signatures">The cost signatures to compare against, either one per node along the path or one per node in the grid.</param>
+		/// <param name="signaturesByIndex">Whether the signatures are per node in the grid rather than per node along the path.</param>
+		/// <returns>Whether none of the costs along the path have changed.</returns>
+		bool PathCostsUnchanged(const std::vector<PathNode *> &nodes, const std::vector<unsigned int> &signatures, bool signaturesByIndex) const;
+
+		/// <summary>
+		/// Makes or remakes the flow field towards a goal node, with a reverse Dijkstra search over the whole node grid.
+		/// </summary>
+		/// <param name="flowField">The flow field to fill out.</param>
+		/// <param name="goalNode">The node to find the cheapest ways to.</param>
+		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		void BuildFlowField(FlowField &flowField, const PathNode *goalNode, float digStrength);
+
+		/// <summary>
+		/// Follows a flow field from a start node down to its goal.
+		/// </summary>
+		/// <param name="flowField">The flow field to follow.</param>
+		/// <param name="startNode">The node to start from.</param>
+		/// <param name="goalNode">The goal node of the flow field.</param>
+		/// <param name="nodePath">A vector which will be filled out with the nodes along the way, from start to goal.</param>
+		/// <returns>Whether the goal could be reached from the start node.</returns>
+		bool FollowFlowField(const FlowField &flowField, const PathNode *startNode, const PathNode *goalNode, std::vector<PathNode *> &nodePath) const;
+
+		/// <summary>
+		/// Gets a path from the flow field towards a goal node, making the flow field first if there is enough demand for it. Remakes the flow field if any costs along the path changed since it was made.
+		/// </summary>
+		/// <param name="startNode">The node to start from.</param>
+		/// <param name="goalNode">The node to find the path to.</param>
+		/// <param name="fieldKey">The key of the flow field, made from the goal node, dig strength bucket and team.</param>
+		/// <param name="digStrength">What material strength the search is capable of digging through.</param>
+		/// <param name="nodePath">A vector which will be filled out with the nodes along the path, from start to goal.</param>
+		/// <param name="totalCostResult">The total cost of the path.</param>
+		/// <returns>Whether a path was found through a flow field. If false, the pather has to be used.</returns>
+		bool GetFlowFieldPath(const PathNode *startNode, const PathNode *goalNode, unsigned long long fieldKey, float digStrength, std::vector<PathNode *> &nodePath, float &totalCostResult);
+
+		/// <summary>
+		/// Adds a path found by the pather to the path cache, dropping the least recently used one if the cache is full.
+		/// </summary>
+		/// <param name="pathKey">The key of the path, made from the start node, end node, dig strength bucket and team.</param>
+		/// <param name="nodePath">The nodes along the path, from start to end.</param>
+		/// <param name="totalCost">The total cost of the path.</param>
+		/// <param name="result">What the pather returned for the search.</param>
+		void AddCachedPath(unsigned long long pathKey, const std::vector<PathNode *> &nodePath, float totalCost, int result);
+
+		/// <summary>
+		/// Converts a path of nodes into the list of scene positions handed out by CalculatePath, with the exact start and end positions at either end.
+		/// </summary>
+		/// <param name="start">The exact start position.</param>
+		/// <param name="end">The exact end position.</param>
+		/// <param name="nodePath">The nodes along the path, from start to end.</param>
+		/// <param name="pathResult">The list to fill out with the waypoints.</param>
+		void MakePathResult(const Vector &start, const Vector &end, const std::vector<PathNode *> &nodePath, std::list<Vector> &pathResult) const;
+#pragma endregion
+
 #pragma region Path Cost Updates
 		/// <summary>
 		/// Helper function for calculating the real actual cost of going in a straight line between any two points on the scene.
@@ -166,6 +350,27 @@ namespace RTE {
 		/// <returns>The cost value.</returns>
 		float CostAlongLine(const Vector &start, const Vector &end) { return g_SceneMan.CastMaxStrengthRay(start, end, 0); }
 
+		/// <summary>
+		/// Helper function for calculating the cost of going in a straight line between two points, against a specific material bitmap. Safe to use on other threads.
+		/// </summary>
+		/// <param name="start">Origin point.</param>
+		/// <param name="end">Destination point.</param>
+		/// <param name="materialBitmap">The material bitmap to trace through. OWNERSHIP IS NOT TRANSFERRED!</param>
+		/// <returns>The cost value.</returns>
+		float CostAlongLine(const Vector &start, const Vector &end, BITMAP *materialBitmap) const { return g_SceneMan.CastMaxStrengthRayInBitmap(start, end, 0, materialBitmap); }
+
+		/// <summary>
+		/// Calculates the costs going out from every node into m_RecalculatedCosts, with the nodes split into strips of columns worked on in parallel. Only reads the nodes, so it is safe to run on another thread.
+		/// </summary>
+		/// <param name="materialBitmap">The material bitmap to trace through. OWNERSHIP IS NOT TRANSFERRED!</param>
+		void CalculateAllCosts(BITMAP *materialBitmap);
+
+		/// <summary>
+		/// Copies the costs in m_RecalculatedCosts into the nodes, resets the pather and forgets all cached paths and flow fields. m_PathFinderMutex has to be locked.
+		/// </summary>
+		/// <param name="skipUpdatedNodes">Whether to leave alone nodes marked in m_UpdatedSinceSnapshot.</param>
+		void ApplyRecalculatedCosts(bool skipUpdatedNodes);
+
 		/// <summary>
 		/// Helper function for updating all the values of cost edges going out from a specific node.
 		/// This does NOT update the pather, which is required before solving more paths after calling this.
@@ -0,0 +1,210 @@
+#include "PerceptionCache.h"
+#include "Actor.h"
+#include "MovableMan.h"
+#include "SceneMan.h"
+#include "FrameMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerceptionCache::Clear() {
+		m_Frame = 0;
+		m_ActorEntries.clear();
+		for (std::deque<Sighting> &teamSightings : m_TeamSightings) {
+			teamSightings.clear();
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerceptionCache::Reset() {
+		std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void PerceptionCache::Update(unsigned int frameNumber) {
+		std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+		m_Frame = frameNumber;
+
+		for (std::deque<Sighting> &teamSightings : m_TeamSightings) {
+			// The parallel AI workers add their sightings in whatever order they get to them, so put them in a fixed one before anyone gets to see them
+			std::stable_sort(teamSightings.begin(), teamSightings.end(), [](const Sighting &lhs, const Sighting &rhs) { return lhs.Frame != rhs.Frame ? lhs.Frame < rhs.Frame : lhs.LookerID < rhs.LookerID; });
+			while (!teamSightings.empty() && (m_Frame - teamSightings.front().Frame > c_SightingMaxAge || teamSightings.size() > c_MaxSightingsPerTeam)) {
+				teamSightings.pop_front();
+			}
+		}
+		for (std::unordered_map<unsigned long int, ActorEntry>::iterator entryItr = m_ActorEntries.begin(); entryItr != m_ActorEntries.end();) {
+			entryItr = (m_Frame - entryItr->second.LastUsedFrame > c_EntryExpiryFrames) ? m_ActorEntries.erase(entryItr) : std::next(entryItr);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int PerceptionCache::GetRefreshInterval(const Actor *looker) {
+		std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+		ActorEntry &entry = GetEntry(looker);
+		IsRefreshDue(looker, entry);
+		return entry.RefreshInterval;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	MovableObject * PerceptionCache::LookForMOs(const Actor *looker, const Vector &aimPos, const Vector &lookVector, float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain) {
+		int team = looker->GetTeam();
+		bool teamValid = team >= Activity::TeamOne && team < Activity::MaxTeamCount;
+		bool refreshDue;
+		{
+			std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+			ActorEntry &entry = GetEntry(looker);
+			// What was or wasn't seen by a look through different terrain says nothing about what this one sees
+			refreshDue = IsRefreshDue(looker, entry) || entry.LookIgnoreMaterial != ignoreMaterial || entry.LookIgnoreAllTerrain != ignoreAllTerrain;
+			if (refreshDue) {
+				entry.LookIgnoreMaterial = ignoreMaterial;
+				entry.LookIgnoreAllTerrain = ignoreAllTerrain;
+			}
+		}
+
+		if (refreshDue) {
+			Vector spreadLookVector = lookVector;
+			spreadLookVector.DegRotate(FOVSpread * RandomNormalNum());
+			MovableObject *seenMO = g_MovableMan.GetMOFromID(g_SceneMan.CastMORay(aimPos, spreadLookVector, looker->GetID(), looker->IgnoresWhichTeam(), ignoreMaterial, ignoreAllTerrain, 5));
+			if (!seenMO) {
+				return nullptr;
+			}
+			seenMO = seenMO->GetRootParent();
+
+			std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+			GetEntry(looker).LastSightingFrame = m_Frame;
+			if (teamValid) { m_TeamSightings[team].push_back({ looker->GetUniqueID(), aimPos, seenMO->GetUniqueID(), seenMO->GetPos(), g_SceneMan.GetLastRayHitPos(), m_Frame, ignoreMaterial, ignoreAllTerrain }); }
+			return seenMO;
+		}
+		if (!teamValid) {
+			return nullptr;
+		}
+
+		// Not due for a ray, so go through the recent sightings of this and any teammates standing close by, newest first, for one that falls within the look cone
+		float lookDistance = lookVector.GetMagnitude();
+		float lookAngle = lookVector.GetAbsRadAngle();
+		float coneHalfAngle = std::max(FOVSpread * 2.0F, 5.0F) / 180.0F * c_PI;
+
+		std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+		const std::deque<Sighting> &teamSightings = m_TeamSightings[team];
+		for (std::deque<Sighting>::const_reverse_iterator sightingItr = teamSightings.rbegin(); sightingItr != teamSightings.rend(); ++sightingItr) {
+			const Sighting &sighting = *sightingItr;
+			if (m_Frame - sighting.Frame > c_SightingMaxAge) {
+				break;
+			}
+			// A ray that passed through terrain this one wouldn't could have seen something this one can't
+			if (sighting.IgnoreMaterial != ignoreMaterial || sighting.IgnoreAllTerrain != ignoreAllTerrain) {
+				continue;
+			}
+			// Teammates' sightings from this sim update may or may not be in yet depending on the thread timing, so they're only shared from the next one on
+			if (sighting.TargetID == looker->GetUniqueID() || (sighting.LookerID != looker->GetUniqueID() && (sighting.Frame == m_Frame || g_SceneMan.ShortestDistance(sighting.LookerPos, aimPos).GetMagnitude() > c_ShareRadius))) {
+				continue;
+			}
+			MovableObject *target = g_MovableMan.FindObjectByUniqueID(sighting.TargetID);
+			if (!target || (looker->IgnoresWhichTeam() != Activity::NoTeam && target->GetTeam() == looker->IgnoresWhichTeam())) {
+				continue;
+			}
+			// Follow the target along since it was seen, it's the line of sight to it that is assumed to not have changed
+			Vector hitPos = sighting.HitPos + (target->GetPos() - sighting.TargetPos);
+			Vector toHit = g_SceneMan.ShortestDistance(aimPos, hitPos);
+			if (toHit.GetMagnitude() > lookDistance) {
+				continue;
+			}
+			float angleDifference = std::fabs(toHit.GetAbsRadAngle() - lookAngle);
+			if (std::min(angleDifference, c_TwoPI - angleDifference) > coneHalfAngle) {
+				continue;
+			}
+			g_SceneMan.SetLastRayHitPos(hitPos);
+			return target;
+		}
+		return nullptr;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PerceptionCache::Look(const Actor *looker, const Vector &aimPos, const Vector &lookVector) {
+		{
+			std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+			if (!IsRefreshDue(looker, GetEntry(looker))) {
+				return false;
+			}
+		}
+		Vector ignored;
+		// Cast the seeing ray, adjusting the skip to match the resolution of the unseen map
+		return g_SceneMan.CastSeeRay(looker->GetTeam(), aimPos, lookVector, ignored, 25, static_cast<int>(g_SceneMan.GetUnseenResolution(looker->GetTeam()).GetSmallest()) / 2);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PerceptionCache::LookForGold(const Actor *looker, const Vector &startPos, const Vector &ray, Vector &foundLocation) {
+		{
+			std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+			ActorEntry &entry = GetEntry(looker);
+			if (!IsRefreshDue(looker, entry)) {
+				if (entry.FoundGold && g_SceneMan.GetTerrMatter(entry.GoldLocation.GetFloorIntX(), entry.GoldLocation.GetFloorIntY()) == g_MaterialGold) {
+					foundLocation = entry.GoldLocation;
+					return true;
+				}
+				return false;
+			}
+		}
+		bool foundGold = g_SceneMan.CastMaterialRay(startPos, ray, g_MaterialGold, foundLocation, 4);
+
+		std::lock_guard<std::mutex> perceptionLock(m_Mutex);
+		ActorEntry &entry = GetEntry(looker);
+		entry.FoundGold = foundGold;
+		if (foundGold) { entry.GoldLocation = foundLocation; }
+		return foundGold;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PerceptionCache::ActorEntry & PerceptionCache::GetEntry(const Actor *looker) {
+		ActorEntry &entry = m_ActorEntries[looker->GetUniqueID()];
+		entry.LastUsedFrame = m_Frame;
+		return entry;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool PerceptionCache::IsRefreshDue(const Actor *looker, ActorEntry &entry) {
+		if (entry.IntervalFrame != m_Frame) {
+			entry.RefreshInterval = CalculateRefreshInterval(looker, entry);
+			entry.IntervalFrame = m_Frame;
+		}
+		// Offset by the unique ID so the refreshes of Actors at the same interval are spread out evenly over the sim updates
+		return (m_Frame + looker->GetUniqueID()) % entry.RefreshInterval == 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int PerceptionCache::CalculateRefreshInterval(const Actor *looker, const ActorEntry &entry) const {
+		// Player controlled Actors and ones that just saw something always get their full perception
+		if (looker->IsPlayerControlled() || m_Frame - entry.LastSightingFrame < c_EngagedFrames) {
+			return 1;
+		}
+
+		float screenWidth = static_cast<float>(g_FrameMan.GetPlayerScreenWidth());
+		Vector halfScreen(screenWidth / 2.0F, static_cast<float>(g_FrameMan.GetPlayerScreenHeight()) / 2.0F);
+		float closestViewDistance = std::numeric_limits<float>::max();
+		for (int screen = 0; screen < g_FrameMan.GetScreenCount(); ++screen) {
+			closestViewDistance = std::min(closestViewDistance, g_SceneMan.ShortestDistance(g_SceneMan.GetOffset(screen) + halfScreen, looker->GetPos()).GetMagnitude());
+		}
+
+		int refreshInterval = 1;
+		if (closestViewDistance > screenWidth * 1.5F) {
+			refreshInterval = 4;
+		} else if (closestViewDistance > screenWidth * 0.75F) {
+			refreshInterval = 2;
+		}
+		// Sentries that haven't seen anything in a while are the least likely to need to react quickly
+		if (looker->GetAIMode() == Actor::AIMODE_SENTRY) { refreshInterval *= 2; }
+
+		return std::min(refreshInterval, static_cast<int>(c_MaxRefreshInterval));
+	}
+}
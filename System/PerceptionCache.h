@@ -0,0 +1,149 @@
+#ifndef _RTEPERCEPTIONCACHE_
+#define _RTEPERCEPTIONCACHE_
+
+#include "Vector.h"
+#include "Activity.h"
+
+namespace RTE {
+
+	class Actor;
+	class MovableObject;
+
+	/// <summary>
+	/// Caches what Actors see with their perception rays, so the rays of AI controlled Actors can be cast less often the further they are from the players' views, and teammates standing close to each other can share what they see.
+	/// </summary>
+	class PerceptionCache {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a PerceptionCache object in system memory.
+		/// </summary>
+		PerceptionCache() { Clear(); }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Forgets everything cached, e.g. when all MOs are purged from the scene.
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Advances this to a new sim update, dropping sightings and Actor entries that got too old to be of any use.
+		/// </summary>
+		/// <param name="frameNumber">The number of the sim update that's starting.</param>
+		void Update(unsigned int frameNumber);
+
+		/// <summary>
+		/// Gets how many sim updates apart an Actor's perception rays get cast, based on its distance to the players' views and what it's doing.
+		/// </summary>
+		/// <param name="looker">The Actor to get the refresh interval for.</param>
+		/// <returns>The number of sim updates between perception refreshes. 1 means every sim update.</returns>
+		int GetRefreshInterval(const Actor *looker);
+
+		/// <summary>
+		/// Looks for MOs along an Actor's line of sight. Casts an actual MO ray only when the Actor's perception is due for a refresh, otherwise answers with the most recent sighting by the Actor or a teammate close by that falls within the look cone and was made by a ray passing through the same terrain. Always casts a ray if the Actor's last one passed through different terrain.
+		/// Sets the last ray hit position of SceneMan either way, so callers can treat the result just like a CastMORay one.
+		/// </summary>
+		/// <param name="looker">The Actor that is looking.</param>
+		/// <param name="aimPos">The absolute position to look from.</param>
+		/// <param name="lookVector">The direction and distance to look in, without any spread applied.</param>
+		/// <param name="FOVSpread">The standard deviation in degrees of the random spread applied to the ray, and half the width of the cone cached sightings have to fall within.</param>
+		/// <param name="ignoreMaterial">A material ID the ray should pass through.</param>
+		/// <param name="ignoreAllTerrain">Whether the ray should pass through all terrain.</param>
+		/// <returns>The root parent of the seen MO, or nullptr if nothing was seen.</returns>
+		MovableObject * LookForMOs(const Actor *looker, const Vector &aimPos, const Vector &lookVector, float FOVSpread, unsigned char ignoreMaterial, bool ignoreAllTerrain);
+
+		/// <summary>
+		/// Casts a ray revealing the unseen layer of an Actor's team along its line of sight, if the Actor's perception is due for a refresh.
+		/// </summary>
+		/// <param name="looker">The Actor that is looking.</param>
+		/// <param name="aimPos">The absolute position to look from.</param>
+		/// <param name="lookVector">The direction and distance to look in, with any spread already applied.</param>
+		/// <returns>Whether any unseen pixels were revealed. False if no ray was cast.</returns>
+		bool Look(const Actor *looker, const Vector &aimPos, const Vector &lookVector);
+
+		/// <summary>
+		/// Casts a ray looking for gold for an Actor if its perception is due for a refresh, otherwise answers with the gold it last found if that is still there.
+		/// </summary>
+		/// <param name="looker">The Actor that is looking.</param>
+		/// <param name="startPos">The absolute position to look from.</param>
+		/// <param name="ray">The direction and distance to look in, with any spread already applied.</param>
+		/// <param name="foundLocation">Vector to be filled with the location of the gold found, if any.</param>
+		/// <returns>Whether gold was found.</returns>
+		bool LookForGold(const Actor *looker, const Vector &startPos, const Vector &ray, Vector &foundLocation);
+#pragma endregion
+
+	private:
+
+		static constexpr unsigned short c_MaxRefreshInterval = 8; //!< The most sim updates apart an AI controlled Actor's perception rays are ever cast.
+		static constexpr unsigned short c_SightingMaxAge = 12; //!< How many sim updates a sighting stays valid for.
+		static constexpr unsigned short c_EngagedFrames = 30; //!< How many sim updates after seeing something an Actor keeps refreshing its perception every sim update.
+		static constexpr unsigned short c_EntryExpiryFrames = 300; //!< How many sim updates an Actor's entry is kept around without being used.
+		static constexpr unsigned short c_MaxSightingsPerTeam = 512; //!< The most sightings kept per team, the oldest are dropped beyond that at the start of each sim update.
+		static constexpr float c_ShareRadius = 60.0F; //!< The furthest in pixels teammates can stand apart from each other and still share their sightings.
+
+		/// <summary>
+		/// Something an Actor saw with one of its MO rays.
+		/// </summary>
+		struct Sighting {
+			unsigned long int LookerID; //!< The unique ID of the Actor that saw it.
+			Vector LookerPos; //!< The position the Actor looked from.
+			unsigned long int TargetID; //!< The unique ID of the root parent of the MO that was seen.
+			Vector TargetPos; //!< The position of the seen MO's root parent at the time.
+			Vector HitPos; //!< The position where the ray hit the seen MO.
+			unsigned int Frame; //!< The sim update the sighting was made in.
+			unsigned char IgnoreMaterial; //!< The material ID the ray passed through.
+			bool IgnoreAllTerrain; //!< Whether the ray passed through all terrain.
+		};
+
+		/// <summary>
+		/// What is cached for each Actor that looks.
+		/// </summary>
+		struct ActorEntry {
+			unsigned int IntervalFrame = 0; //!< The sim update the refresh interval was last worked out in.
+			int RefreshInterval = 1; //!< The number of sim updates between perception refreshes.
+			unsigned int LastSightingFrame = 0; //!< The sim update this Actor last saw anything in.
+			unsigned int LastUsedFrame = 0; //!< The sim update this entry was last used in.
+			unsigned char LookIgnoreMaterial = 0; //!< The material ID the last MO ray passed through.
+			bool LookIgnoreAllTerrain = false; //!< Whether the last MO ray passed through all terrain.
+			bool FoundGold = false; //!< Whether the last gold ray found any gold.
+			Vector GoldLocation; //!< Where the last gold ray found gold.
+		};
+
+		unsigned int m_Frame; //!< The number of the current sim update.
+		std::unordered_map<unsigned long int, ActorEntry> m_ActorEntries; //!< The cached perception of each Actor, by unique ID.
+		std::deque<Sighting> m_TeamSightings[Activity::MaxTeamCount]; //!< The recent sightings of each team, oldest first. Sorted by looker within each sim update, except for the current one.
+		std::mutex m_Mutex; //!< Guards everything in this, since Actor AI can run on the parallel AI workers.
+
+		/// <summary>
+		/// Gets the entry of an Actor, creating it if it doesn't exist yet. m_Mutex has to be locked.
+		/// </summary>
+		/// <param name="looker">The Actor to get the entry of.</param>
+		/// <returns>The Actor's entry.</returns>
+		ActorEntry & GetEntry(const Actor *looker);
+
+		/// <summary>
+		/// Tells whether an Actor's perception is due for a refresh in this sim update. m_Mutex has to be locked.
+		/// </summary>
+		/// <param name="looker">The Actor to check.</param>
+		/// <param name="entry">The Actor's entry.</param>
+		/// <returns>Whether the Actor should cast its perception rays this sim update.</returns>
+		bool IsRefreshDue(const Actor *looker, ActorEntry &entry);
+
+		/// <summary>
+		/// Works out how many sim updates apart an Actor's perception rays should be cast.
+		/// </summary>
+		/// <param name="looker">The Actor to work out the refresh interval for.</param>
+		/// <param name="entry">The Actor's entry.</param>
+		/// <returns>The number of sim updates between perception refreshes.</returns>
+		int CalculateRefreshInterval(const Actor *looker, const ActorEntry &entry) const;
+
+		/// <summary>
+		/// Clears all the member variables of this PerceptionCache, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
@@ -0,0 +1,16 @@
+#include "ProfileScope.h"
+#include "PerformanceMan.h"
+#include "TimerMan.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ProfileScope::ProfileScope(const char *name) : m_Name(name), m_StartTime(g_PerformanceMan.IsRecordingScopes() ? g_TimerMan.GetAbsoluteTime() : -1) {}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ProfileScope::~ProfileScope() {
+		if (m_StartTime >= 0) { g_PerformanceMan.RecordScope(m_Name, m_StartTime, g_TimerMan.GetAbsoluteTime() - m_StartTime); }
+	}
+}
@@ -0,0 +1,39 @@
+#ifndef _RTEPROFILESCOPE_
+#define _RTEPROFILESCOPE_
+
+namespace RTE {
+
+	/// <summary>
+	/// Times the block it's declared in and records it into PerformanceMan under a name, while the performance graphs are showing or a profile capture is running.
+	/// Scopes can be nested and used from any thread. Each thread records into its own buffer, so nothing is locked while recording.
+	/// </summary>
+	class ProfileScope {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a ProfileScope object in system memory, starting the timing if scopes are being recorded.
+		/// </summary>
+		/// <param name="name">The name to record the scope under. Has to stay valid for as long as the game runs, like a string literal.</param>
+		explicit ProfileScope(const char *name);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to record the ProfileScope's timing when it goes out of scope.
+		/// </summary>
+		~ProfileScope();
+#pragma endregion
+
+	private:
+
+		const char *m_Name; //!< The name to record the scope under.
+		long long m_StartTime; //!< When the scope started, in absolute microseconds, or -1 if scopes weren't being recorded then.
+
+		// Disallow the use of some implicit methods.
+		ProfileScope(const ProfileScope &reference) {}
+		ProfileScope & operator=(const ProfileScope &rhs) {}
+	};
+}
+#endif
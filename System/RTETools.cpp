@@ -4,6 +4,8 @@
 namespace RTE {
 
 	std::mt19937 g_RNG;
+	thread_local RandomStream *g_ThreadRNG = nullptr;
+	RandomStream g_DrawRNG;
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -31,12 +33,17 @@ namespace RTE {
 
 		std::seed_seq sequence(std::begin(seedData), std::end(seedData));
 		g_RNG.seed(sequence);
+
+		unsigned long long streamSeed = g_RNG();
+		streamSeed = (streamSeed << 32) | g_RNG();
+		RandomStream::SetSeed(streamSeed);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	void SeedRNG(unsigned int seed) {
 		g_RNG.seed(seed);
+		RandomStream::SetSeed(seed);
 	}
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +137,17 @@ namespace RTE {
 		return point.m_X >= boxPos.m_X && point.m_X < (boxPos.m_X + width) && point.m_Y >= boxPos.m_Y && point.m_Y < (boxPos.m_Y + height);
 	}
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned long long HashBytes(const void *data, size_t byteCount, unsigned long long hash) {
+		const unsigned char *bytes = static_cast<const unsigned char *>(data);
+		for (size_t byte = 0; byte < byteCount; ++byte) {
+			hash ^= bytes[byte];
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	float GetAllegroAngle(float angleDegrees) { return (angleDegrees / 360) * 256; }
@@ -5,12 +5,15 @@
 
 #include "RTEError.h"
 #include "Constants.h"
+#include "RandomStream.h"
 
 namespace RTE {
 
 	class Vector;
 
 	extern std::mt19937 g_RNG; //!< The random number generator used for all random functions.
+	extern thread_local RandomStream *g_ThreadRNG; //!< When set, the random number functions below draw from this stream instead of g_RNG, only on the thread that set it. The parallel AI workers set it to the stream of the Actor they're running the AI of, so they never touch g_RNG.
+	extern RandomStream g_DrawRNG; //!< The random number generator for purely cosmetic randomness while drawing, like flickering glows. Kept apart from g_RNG so drawing more or fewer frames never changes the simulation.
 
 #pragma region Physics Constants Getters
 	/// <summary>
@@ -40,12 +43,12 @@ namespace RTE {
 
 #pragma region Random Numbers
 	/// <summary>
-	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine.
+	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine. Also seeds the RandomStreams keyed after this.
 	/// </summary>
 	void SeedRNG();
 
 	/// <summary>
-	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine.
+	/// Seed the mt19937 random number generator. mt19937 is the standard mersenne_twister_engine. Also seeds the RandomStreams keyed after this.
 	/// </summary>
 	/// <param name="seed">Seed for the random number generator.</param>
 	void SeedRNG(unsigned int seed);
@@ -56,6 +59,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [-1, 1].</returns>
 	template <typename floatType = float>
 	typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNormalNum() {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNormalNum<floatType>(); }
 		return std::uniform_real_distribution<floatType>(floatType(-1.0), std::nextafter(floatType(1.0), std::numeric_limits<floatType>::max()))(g_RNG);
 	}
 
@@ -65,6 +69,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [-1, 1].</returns>
 	template <typename intType>
 	typename std::enable_if<std::is_integral<intType>::value, intType>::type RandomNormalNum() {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNum<intType>(intType(-1), intType(1)); }
 		return std::uniform_int_distribution<intType>(intType(-1), intType(1))(g_RNG);
 	}
 
@@ -74,6 +79,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [0, 1].</returns>
 	template <typename floatType = float>
 	typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNum() {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNum<floatType>(); }
 		return std::uniform_real_distribution<floatType>(floatType(0.0), std::nextafter(floatType(1.0), std::numeric_limits<floatType>::max()))(g_RNG);
 	}
 
@@ -83,6 +89,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [0, 1].</returns>
 	template <typename intType>
 	typename std::enable_if<std::is_integral<intType>::value, intType>::type RandomNum() {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNum<intType>(intType(0), intType(1)); }
 		return std::uniform_int_distribution<intType>(intType(0), intType(1))(g_RNG);
 	}
 
@@ -94,6 +101,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [min, max].</returns>
 	template <typename floatType = float>
 	typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNum(floatType min, floatType max) {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNum<floatType>(min, max); }
 		if (max < min) { std::swap(min, max); }
 		return (std::uniform_real_distribution<floatType>(floatType(0.0), std::nextafter(max - min, std::numeric_limits<floatType>::max()))(g_RNG) + min);
 	}
@@ -106,6 +114,7 @@ namespace RTE {
 	/// <returns>Uniformly distributed random number in the range [min, max].</returns>
 	template <typename intType>
 	typename std::enable_if<std::is_integral<intType>::value, intType>::type RandomNum(intType min, intType max) {
+		if (g_ThreadRNG) { return g_ThreadRNG->RandomNum<intType>(min, max); }
 		if (max < min) { std::swap(min, max); }
 		return (std::uniform_int_distribution<intType>(intType(0), max - min)(g_RNG) + min);
 	}
@@ -195,6 +204,17 @@ namespace RTE {
 	bool WithinBox(Vector &point, float left, float top, float right, float bottom);
 #pragma endregion
 
+#pragma region Checksums
+	/// <summary>
+	/// Folds a block of bytes into a 64 bit FNV-1a hash. Meant for telling whether two runs of the simulation ended up in the same state, not for anything that has to be secure.
+	/// </summary>
+	/// <param name="data">The bytes to fold into the hash.</param>
+	/// <param name="byteCount">How many bytes to fold into the hash.</param>
+	/// <param name="hash">The hash to continue from. Leave at the default to start a new hash.</param>
+	/// <returns>The hash with the bytes folded in.</returns>
+	unsigned long long HashBytes(const void *data, size_t byteCount, unsigned long long hash = 14695981039346656037ULL);
+#pragma endregion
+
 #pragma region Conversion
 	/// <summary>
 	/// Returns a corrected angle value that can be used with Allegro fixed point math routines where 256 equals 360 degrees.
@@ -0,0 +1,6 @@
+#include "RandomStream.h"
+
+namespace RTE {
+
+	unsigned long long RandomStream::s_Seed = 0;
+}
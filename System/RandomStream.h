@@ -0,0 +1,117 @@
+#ifndef _RTERANDOMSTREAM_
+#define _RTERANDOMSTREAM_
+
+namespace RTE {
+
+	/// <summary>
+	/// A counter-based random number generator. Each number is a hash of the stream's key and how many numbers were drawn from the stream before it, so there's no shared state between streams.
+	/// Streams with different keys are independent of each other, so objects that each draw from their own stream get the same numbers no matter what else drew numbers or which thread they're updated on.
+	/// All streams are also keyed by a global seed, which SeedRNG sets along with g_RNG.
+	/// </summary>
+	class RandomStream {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a RandomStream object in system memory, keyed by 0.
+		/// </summary>
+		RandomStream() { Create(0); }
+
+		/// <summary>
+		/// Constructor method used to instantiate a RandomStream object in system memory and key it.
+		/// </summary>
+		/// <param name="streamKey">The key of the stream, e.g. the unique ID of the object drawing from it.</param>
+		explicit RandomStream(unsigned long long streamKey) { Create(streamKey); }
+
+		/// <summary>
+		/// Keys this RandomStream and starts it over from the first number.
+		/// </summary>
+		/// <param name="streamKey">The key of the stream, e.g. the unique ID of the object drawing from it.</param>
+		void Create(unsigned long long streamKey) { m_Key = Mix(s_Seed + Mix(streamKey)); m_Counter = 0; }
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Sets the global seed all streams are keyed by. Only affects streams keyed after this.
+		/// </summary>
+		/// <param name="seed">The new global seed.</param>
+		static void SetSeed(unsigned long long seed) { s_Seed = seed; }
+#pragma endregion
+
+#pragma region Random Numbers
+		/// <summary>
+		/// Draws the next 64 random bits from this stream.
+		/// </summary>
+		/// <returns>64 uniformly distributed random bits.</returns>
+		unsigned long long NextBits() { return Mix(m_Key + (++m_Counter) * c_Increment); }
+
+		/// <summary>
+		/// Function template which returns a uniformly distributed random number in the range [0, 1).
+		/// </summary>
+		/// <returns>Uniformly distributed random number in the range [0, 1).</returns>
+		template <typename floatType = float>
+		typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNum() {
+			// Only as many bits as the type has mantissa digits are used, so every result is exactly representable and below 1
+			constexpr int mantissaDigits = std::numeric_limits<floatType>::digits;
+			return static_cast<floatType>(NextBits() >> (64 - mantissaDigits)) * (floatType(1.0) / static_cast<floatType>(1ULL << mantissaDigits));
+		}
+
+		/// <summary>
+		/// Function template which returns a uniformly distributed random number in the range [-1, 1).
+		/// </summary>
+		/// <returns>Uniformly distributed random number in the range [-1, 1).</returns>
+		template <typename floatType = float>
+		typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNormalNum() {
+			return RandomNum<floatType>() * floatType(2.0) - floatType(1.0);
+		}
+
+		/// <summary>
+		/// Function template which returns a uniformly distributed random number in the range [min, max).
+		/// </summary>
+		/// <param name="min">Lower boundary of the range to pick a number from.</param>
+		/// <param name="max">Upper boundary of the range to pick a number from.</param>
+		/// <returns>Uniformly distributed random number in the range [min, max).</returns>
+		template <typename floatType = float>
+		typename std::enable_if<std::is_floating_point<floatType>::value, floatType>::type RandomNum(floatType min, floatType max) {
+			if (max < min) { std::swap(min, max); }
+			return min + (max - min) * RandomNum<floatType>();
+		}
+
+		/// <summary>
+		/// Function template specialization for int types which returns a uniformly distributed random number in the range [min, max]. The range can't span more than 2^32 numbers.
+		/// </summary>
+		/// <param name="min">Lower boundary of the range to pick a number from.</param>
+		/// <param name="max">Upper boundary of the range to pick a number from.</param>
+		/// <returns>Uniformly distributed random number in the range [min, max].</returns>
+		template <typename intType>
+		typename std::enable_if<std::is_integral<intType>::value, intType>::type RandomNum(intType min, intType max) {
+			if (max < min) { std::swap(min, max); }
+			// Scaling the top 32 bits by the range avoids the division a modulo would need
+			unsigned long long rangeSize = static_cast<unsigned long long>(max - min) + 1;
+			return min + static_cast<intType>(((NextBits() >> 32) * rangeSize) >> 32);
+		}
+#pragma endregion
+
+	private:
+
+		static constexpr unsigned long long c_Increment = 0x9E3779B97F4A7C15ULL; //!< The golden ratio in 64 bits, which the counter is scaled by so consecutive numbers hash from inputs far apart.
+
+		static unsigned long long s_Seed; //!< The global seed all streams are keyed by.
+
+		unsigned long long m_Key; //!< The key of this stream, mixed with the global seed.
+		unsigned long long m_Counter; //!< How many numbers were drawn from this stream since it was keyed.
+
+		/// <summary>
+		/// Hashes 64 bits into 64 well distributed bits, using the SplitMix64 finalizer.
+		/// </summary>
+		/// <param name="value">The value to hash.</param>
+		/// <returns>The hashed value.</returns>
+		static unsigned long long Mix(unsigned long long value) {
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+			return value ^ (value >> 31);
+		}
+	};
+}
+#endif
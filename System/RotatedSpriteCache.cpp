@@ -0,0 +1,124 @@
+#include "RotatedSpriteCache.h"
+#include "Constants.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void RotatedSpriteCache::Clear() {
+		m_Entries.clear();
+		m_EntryLookup.clear();
+		m_MemoryUsage = 0;
+		m_MaxMemoryUsage = c_DefaultMaxMemoryUsage;
+		m_HitCount = 0;
+		m_MissCount = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void RotatedSpriteCache::Destroy() {
+		for (const RotatedSprite &entry : m_Entries) {
+			if (entry.Bitmap) { destroy_bitmap(entry.Bitmap); }
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t RotatedSpriteCache::RotatedSpriteKeyHash::operator()(const RotatedSpriteKey &key) const {
+		size_t hash = std::hash<const BITMAP *>()(key.Sprite);
+		hash = hash * 31 + std::hash<int>()(key.PivotX);
+		hash = hash * 31 + std::hash<int>()(key.PivotY);
+		hash = hash * 31 + std::hash<int>()(key.AngleStep);
+		hash = hash * 31 + std::hash<float>()(key.Scale);
+		return hash * 2 + (key.HFlipped ? 1 : 0);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	BITMAP * RotatedSpriteCache::GetRotatedSprite(BITMAP *sprite, bool hFlipped, int pivotX, int pivotY, float allegroAngle, float scale, int &rotatedPivotX, int &rotatedPivotY) {
+		// Allegro angles are 256 per turn, so each step is a quarter of one. Masking wraps negative angles around too, and a step in fixed point is 1 << 14
+		int angleStep = static_cast<int>(std::lround(allegroAngle * static_cast<float>(c_AngleSteps / 256))) & (c_AngleSteps - 1);
+		RotatedSpriteKey key = { sprite, pivotX, pivotY, angleStep, scale, hFlipped };
+
+		std::unordered_map<RotatedSpriteKey, std::list<RotatedSprite>::iterator, RotatedSpriteKeyHash>::iterator lookupItr = m_EntryLookup.find(key);
+		if (lookupItr != m_EntryLookup.end()) {
+			m_HitCount++;
+			m_Entries.splice(m_Entries.begin(), m_Entries, lookupItr->second);
+			rotatedPivotX = lookupItr->second->PivotX;
+			rotatedPivotY = lookupItr->second->PivotY;
+			return lookupItr->second->Bitmap;
+		}
+		m_MissCount++;
+
+		// The rotated frame has to fit the frame's farthest corner from the pivot at any angle, plus a margin for Allegro's rounding
+		float maxCornerDistance = 0;
+		for (int cornerX : { 0, sprite->w }) {
+			for (int cornerY : { 0, sprite->h }) {
+				maxCornerDistance = std::max(maxCornerDistance, std::hypot(static_cast<float>(cornerX - pivotX), static_cast<float>(cornerY - pivotY)));
+			}
+		}
+		int pivot = static_cast<int>(std::ceil(maxCornerDistance * scale)) + 2;
+		int rotatedSize = pivot * 2 + 1;
+
+		BITMAP *sourceBitmap = sprite;
+		if (hFlipped) {
+			sourceBitmap = create_bitmap_ex(8, sprite->w, sprite->h);
+			clear_to_color(sourceBitmap, g_MaskColor);
+			draw_sprite_h_flip(sourceBitmap, sprite, 0, 0);
+		}
+		BITMAP *rotatedBitmap = create_bitmap_ex(8, rotatedSize, rotatedSize);
+		clear_to_color(rotatedBitmap, g_MaskColor);
+		pivot_scaled_sprite(rotatedBitmap, sourceBitmap, pivot, pivot, pivotX, pivotY, angleStep << 14, ftofix(scale));
+		if (hFlipped) { destroy_bitmap(sourceBitmap); }
+
+		// Crop the rotated frame to its opaque pixels, so it takes less memory and so drawing it and clearing it off the MOID layer only touches the pixels that matter
+		int left = rotatedSize;
+		int top = rotatedSize;
+		int right = -1;
+		int bottom = -1;
+		for (int y = 0; y < rotatedSize; ++y) {
+			const unsigned char *row = rotatedBitmap->line[y];
+			for (int x = 0; x < rotatedSize; ++x) {
+				if (row[x] != g_MaskColor) {
+					left = std::min(left, x);
+					right = std::max(right, x);
+					top = std::min(top, y);
+					bottom = y;
+				}
+			}
+		}
+		// Frames with nothing to draw are cached too, so they aren't rotated again. They only cost their bookkeeping
+		BITMAP *croppedBitmap = nullptr;
+		m_MemoryUsage += sizeof(RotatedSprite);
+		if (right >= 0) {
+			croppedBitmap = create_bitmap_ex(8, right - left + 1, bottom - top + 1);
+			blit(rotatedBitmap, croppedBitmap, left, top, 0, 0, croppedBitmap->w, croppedBitmap->h);
+			m_MemoryUsage += static_cast<size_t>(croppedBitmap->w * croppedBitmap->h);
+		}
+		destroy_bitmap(rotatedBitmap);
+
+		m_Entries.push_front({ key, croppedBitmap, pivot - left, pivot - top });
+		m_EntryLookup.insert({ key, m_Entries.begin() });
+		EvictToBudget();
+
+		rotatedPivotX = pivot - left;
+		rotatedPivotY = pivot - top;
+		return croppedBitmap;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void RotatedSpriteCache::EvictToBudget() {
+		while (m_MemoryUsage > m_MaxMemoryUsage && m_Entries.size() > 1) {
+			const RotatedSprite &leastRecentlyUsed = m_Entries.back();
+			m_MemoryUsage -= sizeof(RotatedSprite);
+			if (leastRecentlyUsed.Bitmap) {
+				m_MemoryUsage -= static_cast<size_t>(leastRecentlyUsed.Bitmap->w * leastRecentlyUsed.Bitmap->h);
+				destroy_bitmap(leastRecentlyUsed.Bitmap);
+			}
+			m_EntryLookup.erase(leastRecentlyUsed.Key);
+			m_Entries.pop_back();
+		}
+	}
+}
@@ -0,0 +1,150 @@
+#ifndef _RTEROTATEDSPRITECACHE_
+#define _RTEROTATEDSPRITECACHE_
+
+#include "allegro.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// A bounded cache of rotated and scaled sprite frames, shared by every MOSRotating. Instances of the same preset share their frame BITMAPs, so a crowd of the same unit standing at the same angles rotates each frame once instead of once per instance, draw mode and frame.
+	/// Rotations are snapped to c_AngleSteps steps per turn, whether the frame is already cached or not, so what gets drawn never depends on what happens to be in the cache.
+	/// The frames are cached as 8bpp so the same one can be drawn as is for color, or as a silhouette of any color onto the material or MOID layers. They're cropped to their opaque pixels, which also makes them the tight bounds of what gets drawn.
+	/// The least recently used ones are dropped once the cache grows past its memory budget.
+	/// </summary>
+	class RotatedSpriteCache {
+
+	public:
+
+		static constexpr int c_AngleSteps = 1024; //!< How many steps a full turn is split into. Must be a power of 2.
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a RotatedSpriteCache object in system memory.
+		/// </summary>
+		RotatedSpriteCache() { Clear(); }
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Destructor method used to clean up a RotatedSpriteCache object before deletion from system memory.
+		/// </summary>
+		~RotatedSpriteCache() { Destroy(); }
+
+		/// <summary>
+		/// Destroys all the cached frames and resets the statistics. Must be done before the sprite BITMAPs the frames were made from are destroyed.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Gets how many rotated frames are currently cached.
+		/// </summary>
+		/// <returns>The number of cached frames.</returns>
+		size_t GetEntryCount() const { return m_Entries.size(); }
+
+		/// <summary>
+		/// Gets how much memory the cached frames take up.
+		/// </summary>
+		/// <returns>The size of all the cached frames' pixels and bookkeeping, in bytes.</returns>
+		size_t GetMemoryUsage() const { return m_MemoryUsage; }
+
+		/// <summary>
+		/// Gets how much memory the cached frames may take up before the least recently used ones are dropped.
+		/// </summary>
+		/// <returns>The memory budget of this cache, in bytes.</returns>
+		size_t GetMaxMemoryUsage() const { return m_MaxMemoryUsage; }
+
+		/// <summary>
+		/// Sets how much memory the cached frames may take up before the least recently used ones are dropped.
+		/// </summary>
+		/// <param name="maxMemoryUsage">The new memory budget of this cache, in bytes.</param>
+		void SetMaxMemoryUsage(size_t maxMemoryUsage) { m_MaxMemoryUsage = maxMemoryUsage; EvictToBudget(); }
+
+		/// <summary>
+		/// Gets the share of frame requests that were already cached, since the statistics were last reset.
+		/// </summary>
+		/// <returns>The hit rate, from 0 to 1.</returns>
+		float GetHitRate() const { return (m_HitCount + m_MissCount > 0) ? static_cast<float>(m_HitCount) / static_cast<float>(m_HitCount + m_MissCount) : 0.0F; }
+
+		/// <summary>
+		/// Resets the hit and miss counts the hit rate is based on.
+		/// </summary>
+		void ResetStatistics() { m_HitCount = 0; m_MissCount = 0; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Gets a sprite frame rotated and scaled around a pivot point, rotating it and caching the result first if it isn't cached yet.
+		/// Drawing the returned BITMAP with its pivot point at a position gives the same pixels as pivot_scaled_sprite would with the snapped angle, and the BITMAP is cropped to the pixels that get drawn.
+		/// </summary>
+		/// <param name="sprite">The 8bpp sprite frame to rotate. Must outlive the cached frame, see Destroy.</param>
+		/// <param name="hFlipped">Whether the frame is flipped horizontally before being rotated.</param>
+		/// <param name="pivotX">The X position of the pivot point on the frame, after flipping.</param>
+		/// <param name="pivotY">The Y position of the pivot point on the frame.</param>
+		/// <param name="allegroAngle">The rotation, in Allegro angle units of 256 per turn.</param>
+		/// <param name="scale">The scale to draw the frame at.</param>
+		/// <param name="rotatedPivotX">Set to the X position of the pivot point on the returned BITMAP. May be outside of it.</param>
+		/// <param name="rotatedPivotY">Set to the Y position of the pivot point on the returned BITMAP. May be outside of it.</param>
+		/// <returns>The rotated and scaled frame, or nullptr if it has no pixels to draw at all. Ownership is NOT transferred, and it's only valid until the next call.</returns>
+		BITMAP * GetRotatedSprite(BITMAP *sprite, bool hFlipped, int pivotX, int pivotY, float allegroAngle, float scale, int &rotatedPivotX, int &rotatedPivotY);
+#pragma endregion
+
+	private:
+
+		static constexpr size_t c_DefaultMaxMemoryUsage = 32 * 1024 * 1024; //!< The default memory budget of the cache, in bytes.
+
+		/// <summary>
+		/// Everything that makes a rotated frame different from another.
+		/// </summary>
+		struct RotatedSpriteKey {
+			const BITMAP *Sprite; //!< The sprite frame that was rotated.
+			int PivotX; //!< The X position of the pivot point on the frame.
+			int PivotY; //!< The Y position of the pivot point on the frame.
+			int AngleStep; //!< The snapped rotation, in steps of a turn.
+			float Scale; //!< The scale the frame was drawn at.
+			bool HFlipped; //!< Whether the frame was flipped horizontally.
+
+			bool operator==(const RotatedSpriteKey &other) const { return Sprite == other.Sprite && PivotX == other.PivotX && PivotY == other.PivotY && AngleStep == other.AngleStep && Scale == other.Scale && HFlipped == other.HFlipped; }
+		};
+
+		/// <summary>
+		/// Hashes RotatedSpriteKeys for the lookup map.
+		/// </summary>
+		struct RotatedSpriteKeyHash {
+			size_t operator()(const RotatedSpriteKey &key) const;
+		};
+
+		/// <summary>
+		/// A cached rotated frame.
+		/// </summary>
+		struct RotatedSprite {
+			RotatedSpriteKey Key; //!< What this frame was rotated from and how.
+			BITMAP *Bitmap; //!< The rotated frame, cropped to its opaque pixels, or nullptr if it has none. Owned.
+			int PivotX; //!< The X position of the pivot point on the rotated frame.
+			int PivotY; //!< The Y position of the pivot point on the rotated frame.
+		};
+
+		std::list<RotatedSprite> m_Entries; //!< The cached frames, most recently used first.
+		std::unordered_map<RotatedSpriteKey, std::list<RotatedSprite>::iterator, RotatedSpriteKeyHash> m_EntryLookup; //!< Where each cached frame is in m_Entries.
+		size_t m_MemoryUsage; //!< The size of all the cached frames' pixels and bookkeeping, in bytes.
+		size_t m_MaxMemoryUsage; //!< How big m_MemoryUsage may get before the least recently used frames are dropped, in bytes.
+		unsigned long long m_HitCount; //!< How many requested frames were already cached.
+		unsigned long long m_MissCount; //!< How many requested frames had to be rotated.
+
+		/// <summary>
+		/// Drops the least recently used frames until the cache is within its memory budget, always keeping the most recently used one.
+		/// </summary>
+		void EvictToBudget();
+
+		/// <summary>
+		/// Clears all the member variables of this RotatedSpriteCache, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+
+		// Disallow the use of some implicit methods.
+		RotatedSpriteCache(const RotatedSpriteCache &reference) {}
+		RotatedSpriteCache & operator=(const RotatedSpriteCache &rhs) {}
+	};
+}
+#endif
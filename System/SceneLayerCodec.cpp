@@ -0,0 +1,257 @@
+#include "SceneLayerCodec.h"
+#include "ContentFile.h"
+#include "ConsoleMan.h"
+
+#include "LZ4/lz4.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool SceneLayerCodec::IsLayerFile(const std::string &filePath) {
+		return std::filesystem::path(filePath).extension() == c_FileExtension;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SceneLayerCodec::SaveLayer(const std::string &filePath, BITMAP *bitmap, const std::string &basePath) {
+		if (!bitmap || bitmap_color_depth(bitmap) != 8) {
+			return -1;
+		}
+		BITMAP *baseBitmap = basePath.empty() ? nullptr : ContentFile(basePath.c_str()).LoadAndReleaseBitmap();
+		if (baseBitmap && (bitmap_color_depth(baseBitmap) != 8 || baseBitmap->w != bitmap->w || baseBitmap->h != bitmap->h)) {
+			destroy_bitmap(baseBitmap);
+			baseBitmap = nullptr;
+		}
+
+		int chunkCount = ((bitmap->w + c_ChunkSize - 1) / c_ChunkSize) * ((bitmap->h + c_ChunkSize - 1) / c_ChunkSize);
+		std::vector<Chunk> chunks(chunkCount);
+		ForEachChunkInParallel(chunkCount, [&chunks, bitmap, baseBitmap](int chunkIndex) {
+			chunks[chunkIndex].Index = chunkIndex;
+			EncodeChunk(bitmap, baseBitmap, chunks[chunkIndex]);
+		});
+		// Without a matching base bitmap every chunk got stored, so there's no point in referring to it
+		std::string storedBasePath = baseBitmap ? basePath : "";
+		destroy_bitmap(baseBitmap);
+
+		std::ofstream layerFile(filePath, std::ios::binary | std::ios::trunc);
+		if (!layerFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not open " + filePath + " for writing!");
+			return -1;
+		}
+		unsigned int basePathLength = storedBasePath.length();
+		unsigned int storedChunkCount = std::count_if(chunks.begin(), chunks.end(), [](const Chunk &chunk) { return chunk.Type != ChunkType::Unchanged; });
+		int width = bitmap->w;
+		int height = bitmap->h;
+		int chunkSize = c_ChunkSize;
+
+		layerFile.write(c_FileSignature, sizeof(c_FileSignature));
+		layerFile.write(reinterpret_cast<const char *>(&c_FormatVersion), sizeof(c_FormatVersion));
+		layerFile.write(reinterpret_cast<const char *>(&width), sizeof(width));
+		layerFile.write(reinterpret_cast<const char *>(&height), sizeof(height));
+		layerFile.write(reinterpret_cast<const char *>(&chunkSize), sizeof(chunkSize));
+		layerFile.write(reinterpret_cast<const char *>(&basePathLength), sizeof(basePathLength));
+		layerFile.write(storedBasePath.data(), basePathLength);
+		layerFile.write(reinterpret_cast<const char *>(&storedChunkCount), sizeof(storedChunkCount));
+		for (const Chunk &chunk : chunks) {
+			if (chunk.Type == ChunkType::Unchanged) {
+				continue;
+			}
+			unsigned int dataSize = chunk.Data.size();
+			layerFile.write(reinterpret_cast<const char *>(&chunk.Index), sizeof(chunk.Index));
+			layerFile.write(reinterpret_cast<const char *>(&chunk.Type), sizeof(chunk.Type));
+			layerFile.write(reinterpret_cast<const char *>(&dataSize), sizeof(dataSize));
+			layerFile.write(chunk.Data.data(), dataSize);
+		}
+		if (!layerFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Failed to write scene layer file " + filePath + "!");
+			return -1;
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	BITMAP * SceneLayerCodec::LoadLayer(const std::string &filePath, std::string &basePath) {
+		std::ifstream layerFile(filePath, std::ios::binary);
+		if (!layerFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not open scene layer file " + filePath + "!");
+			return nullptr;
+		}
+		char signature[sizeof(c_FileSignature)];
+		unsigned int formatVersion = 0;
+		layerFile.read(signature, sizeof(signature));
+		layerFile.read(reinterpret_cast<char *>(&formatVersion), sizeof(formatVersion));
+		if (!layerFile.good() || std::memcmp(signature, c_FileSignature, sizeof(c_FileSignature)) != 0 || formatVersion != c_FormatVersion) {
+			g_ConsoleMan.PrintString("ERROR: " + filePath + " is not a scene layer file of a supported version!");
+			return nullptr;
+		}
+		int width = 0;
+		int height = 0;
+		int chunkSize = 0;
+		unsigned int basePathLength = 0;
+		layerFile.read(reinterpret_cast<char *>(&width), sizeof(width));
+		layerFile.read(reinterpret_cast<char *>(&height), sizeof(height));
+		layerFile.read(reinterpret_cast<char *>(&chunkSize), sizeof(chunkSize));
+		layerFile.read(reinterpret_cast<char *>(&basePathLength), sizeof(basePathLength));
+		if (!layerFile.good() || width <= 0 || height <= 0 || chunkSize <= 0 || static_cast<long long>(width) * static_cast<long long>(height) > std::numeric_limits<int>::max()) {
+			g_ConsoleMan.PrintString("ERROR: Scene layer file " + filePath + " is corrupt!");
+			return nullptr;
+		}
+		int chunkCount = ((width + chunkSize - 1) / chunkSize) * ((height + chunkSize - 1) / chunkSize);
+		// No chunk's data can be bigger than its pixels compressed as badly as LZ4 can, which also keeps a corrupt size from allocating more than that
+		unsigned int maxChunkDataSize = static_cast<unsigned int>(LZ4_compressBound(std::min(chunkSize, width) * std::min(chunkSize, height)));
+
+		// Sizes read from the file are checked against what's left of it before allocating anything for them, so corrupt or truncated files can't make huge allocations
+		std::streamoff headerEnd = layerFile.tellg();
+		layerFile.seekg(0, std::ios::end);
+		std::streamoff fileSize = layerFile.tellg();
+		layerFile.seekg(headerEnd);
+		const auto remainingFileSize = [&layerFile, fileSize]() { return static_cast<unsigned long long>(std::max<std::streamoff>(fileSize - layerFile.tellg(), 0)); };
+
+		bool sizesValid = basePathLength <= remainingFileSize();
+		if (sizesValid) {
+			basePath.assign(basePathLength, '\0');
+			layerFile.read(&basePath[0], basePathLength);
+		}
+		unsigned int storedChunkCount = 0;
+		layerFile.read(reinterpret_cast<char *>(&storedChunkCount), sizeof(storedChunkCount));
+		const unsigned long long chunkHeaderSize = sizeof(Chunk::Index) + sizeof(Chunk::Type) + sizeof(unsigned int);
+		sizesValid = sizesValid && layerFile.good() && storedChunkCount <= static_cast<unsigned int>(chunkCount) && storedChunkCount <= remainingFileSize() / chunkHeaderSize;
+
+		std::vector<Chunk> chunks(sizesValid ? storedChunkCount : 0);
+		for (Chunk &chunk : chunks) {
+			unsigned int dataSize = 0;
+			layerFile.read(reinterpret_cast<char *>(&chunk.Index), sizeof(chunk.Index));
+			layerFile.read(reinterpret_cast<char *>(&chunk.Type), sizeof(chunk.Type));
+			layerFile.read(reinterpret_cast<char *>(&dataSize), sizeof(dataSize));
+			if (!layerFile.good() || dataSize > maxChunkDataSize || dataSize > remainingFileSize()) {
+				sizesValid = false;
+				break;
+			}
+			chunk.Data.resize(dataSize);
+			layerFile.read(chunk.Data.data(), dataSize);
+		}
+		if (!sizesValid || !layerFile.good()) {
+			g_ConsoleMan.PrintString("ERROR: Scene layer file " + filePath + " is corrupt!");
+			return nullptr;
+		}
+
+		BITMAP *bitmap = create_bitmap_ex(8, width, height);
+		// Every chunk that wasn't stored is the same as in the base bitmap, so start off with that
+		if (chunks.size() < static_cast<size_t>(chunkCount)) {
+			BITMAP *baseBitmap = basePath.empty() ? nullptr : ContentFile(basePath.c_str()).LoadAndReleaseBitmap();
+			if (!baseBitmap || bitmap_color_depth(baseBitmap) != 8 || baseBitmap->w != width || baseBitmap->h != height) {
+				g_ConsoleMan.PrintString("ERROR: The base bitmap " + basePath + " of scene layer file " + filePath + " is missing or doesn't match it!");
+				destroy_bitmap(baseBitmap);
+				destroy_bitmap(bitmap);
+				return nullptr;
+			}
+			blit(baseBitmap, bitmap, 0, 0, 0, 0, width, height);
+			destroy_bitmap(baseBitmap);
+		}
+
+		std::atomic<bool> decodeFailed = false;
+		ForEachChunkInParallel(static_cast<int>(chunks.size()), [&chunks, &decodeFailed, chunkSize, chunkCount, bitmap](int chunkIndex) {
+			if (chunks[chunkIndex].Index >= static_cast<unsigned int>(chunkCount) || !DecodeChunk(chunks[chunkIndex], chunkSize, bitmap)) { decodeFailed = true; }
+		});
+		if (decodeFailed) {
+			g_ConsoleMan.PrintString("ERROR: Scene layer file " + filePath + " has corrupt chunks!");
+			destroy_bitmap(bitmap);
+			return nullptr;
+		}
+		return bitmap;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SceneLayerCodec::ForEachChunkInParallel(int chunkCount, const std::function<void(int)> &chunkFunction) {
+		if (chunkCount <= 0) {
+			return;
+		}
+		int taskCount = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, chunkCount);
+		int chunksPerTask = (chunkCount + taskCount - 1) / taskCount;
+		std::vector<std::future<void>> tasks;
+		for (int firstChunk = 0; firstChunk < chunkCount; firstChunk += chunksPerTask) {
+			int lastChunk = std::min(firstChunk + chunksPerTask, chunkCount);
+			tasks.push_back(std::async(std::launch::async, [&chunkFunction, firstChunk, lastChunk]() {
+				for (int chunkIndex = firstChunk; chunkIndex < lastChunk; ++chunkIndex) {
+					chunkFunction(chunkIndex);
+				}
+			}));
+		}
+		for (std::future<void> &task : tasks) {
+			task.get();
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SceneLayerCodec::GetChunkArea(const BITMAP *bitmap, int chunkSize, unsigned int chunkIndex, int &left, int &top, int &width, int &height) {
+		int chunksPerRow = (bitmap->w + chunkSize - 1) / chunkSize;
+		left = (chunkIndex % chunksPerRow) * chunkSize;
+		top = (chunkIndex / chunksPerRow) * chunkSize;
+		width = std::min(chunkSize, bitmap->w - left);
+		height = std::min(chunkSize, bitmap->h - top);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SceneLayerCodec::EncodeChunk(const BITMAP *bitmap, const BITMAP *baseBitmap, Chunk &chunk) {
+		int left;
+		int top;
+		int width;
+		int height;
+		GetChunkArea(bitmap, c_ChunkSize, chunk.Index, left, top, width, height);
+
+		bool sameAsBase = baseBitmap != nullptr;
+		bool singleColor = true;
+		unsigned char firstColor = bitmap->line[top][left];
+		std::vector<char> pixels(width * height);
+		for (int row = 0; row < height; ++row) {
+			const unsigned char *rowPixels = bitmap->line[top + row] + left;
+			if (sameAsBase && std::memcmp(rowPixels, baseBitmap->line[top + row] + left, width) != 0) { sameAsBase = false; }
+			if (singleColor && std::any_of(rowPixels, rowPixels + width, [firstColor](unsigned char color) { return color != firstColor; })) { singleColor = false; }
+			std::memcpy(pixels.data() + row * width, rowPixels, width);
+		}
+
+		if (sameAsBase) {
+			chunk.Type = ChunkType::Unchanged;
+		} else if (singleColor) {
+			chunk.Type = ChunkType::Filled;
+			chunk.Data.assign(1, static_cast<char>(firstColor));
+		} else {
+			chunk.Type = ChunkType::Compressed;
+			chunk.Data.resize(LZ4_compressBound(pixels.size()));
+			chunk.Data.resize(LZ4_compress_default(pixels.data(), chunk.Data.data(), pixels.size(), chunk.Data.size()));
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool SceneLayerCodec::DecodeChunk(const Chunk &chunk, int chunkSize, BITMAP *bitmap) {
+		int left;
+		int top;
+		int width;
+		int height;
+		GetChunkArea(bitmap, chunkSize, chunk.Index, left, top, width, height);
+
+		if (chunk.Type == ChunkType::Filled && chunk.Data.size() == 1) {
+			for (int row = 0; row < height; ++row) {
+				std::memset(bitmap->line[top + row] + left, static_cast<unsigned char>(chunk.Data[0]), width);
+			}
+			return true;
+		}
+		if (chunk.Type == ChunkType::Compressed) {
+			std::vector<char> pixels(width * height);
+			if (LZ4_decompress_safe(chunk.Data.data(), pixels.data(), chunk.Data.size(), pixels.size()) != static_cast<int>(pixels.size())) {
+				return false;
+			}
+			for (int row = 0; row < height; ++row) {
+				std::memcpy(bitmap->line[top + row] + left, pixels.data() + row * width, width);
+			}
+			return true;
+		}
+		return false;
+	}
+}
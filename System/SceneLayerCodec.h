@@ -0,0 +1,101 @@
+#ifndef _RTESCENELAYERCODEC_
+#define _RTESCENELAYERCODEC_
+
+#include "allegro.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// Saves and loads the 8 bit bitmaps of SceneLayers in a chunked, LZ4 compressed format. Only the chunks that differ from a base bitmap, usually the one of the Scene preset the layer was copied from, are stored.
+	/// Chunks are encoded and decoded in parallel.
+	/// </summary>
+	class SceneLayerCodec {
+
+	public:
+
+		static constexpr const char *c_FileExtension = ".lyr"; //!< The file extension of scene layer files.
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Tells whether a file path points to a scene layer file, going by its extension.
+		/// </summary>
+		/// <param name="filePath">The file path to check.</param>
+		/// <returns>Whether the path is that of a scene layer file.</returns>
+		static bool IsLayerFile(const std::string &filePath);
+
+		/// <summary>
+		/// Saves a bitmap to a scene layer file.
+		/// </summary>
+		/// <param name="filePath">The path of the file to save to.</param>
+		/// <param name="bitmap">The 8 bit bitmap to save. Ownership is NOT transferred!</param>
+		/// <param name="basePath">The path of the bitmap only the differences from are stored. If empty, or the bitmap there doesn't match in size and depth, everything is stored.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		static int SaveLayer(const std::string &filePath, BITMAP *bitmap, const std::string &basePath);
+
+		/// <summary>
+		/// Loads a bitmap from a scene layer file, on top of the base bitmap it was saved against if any.
+		/// </summary>
+		/// <param name="filePath">The path of the file to load from.</param>
+		/// <param name="basePath">String to be filled with the path of the base bitmap the file was saved against, or empty if it has none.</param>
+		/// <returns>The loaded 8 bit bitmap, or nullptr if loading failed. Ownership IS transferred!</returns>
+		static BITMAP * LoadLayer(const std::string &filePath, std::string &basePath);
+#pragma endregion
+
+	private:
+
+		static constexpr char c_FileSignature[4] = { 'R', 'T', 'E', 'L' }; //!< The signature at the start of every scene layer file.
+		static constexpr unsigned int c_FormatVersion = 1; //!< The version of the scene layer file format.
+		static constexpr int c_ChunkSize = 64; //!< The width and height in pixels of the chunks bitmaps are split into.
+
+		/// <summary>
+		/// How a chunk is stored.
+		/// </summary>
+		enum ChunkType : unsigned char { Unchanged, Filled, Compressed };
+
+		/// <summary>
+		/// A square area of a bitmap, as stored in a scene layer file.
+		/// </summary>
+		struct Chunk {
+			unsigned int Index = 0; //!< The index of the chunk in the bitmap, counted row by row.
+			ChunkType Type = ChunkType::Unchanged; //!< How the chunk is stored.
+			std::vector<char> Data; //!< The single color index of a filled chunk, or the LZ4 compressed pixels of a compressed one.
+		};
+
+		/// <summary>
+		/// Runs a function for each chunk index, with the indices split evenly between as many threads as the hardware can run at once. Waits for all of them to finish.
+		/// </summary>
+		/// <param name="chunkCount">The number of chunks.</param>
+		/// <param name="chunkFunction">The function to run with each chunk index. Has to be safe to run on different chunks at once.</param>
+		static void ForEachChunkInParallel(int chunkCount, const std::function<void(int)> &chunkFunction);
+
+		/// <summary>
+		/// Gets the area of a bitmap a chunk covers. The chunks at the right and bottom edges can be smaller than c_ChunkSize.
+		/// </summary>
+		/// <param name="bitmap">The bitmap the chunk is in.</param>
+		/// <param name="chunkSize">The width and height of the chunks.</param>
+		/// <param name="chunkIndex">The index of the chunk.</param>
+		/// <param name="left">Filled with the left edge of the chunk.</param>
+		/// <param name="top">Filled with the top edge of the chunk.</param>
+		/// <param name="width">Filled with the width of the chunk.</param>
+		/// <param name="height">Filled with the height of the chunk.</param>
+		static void GetChunkArea(const BITMAP *bitmap, int chunkSize, unsigned int chunkIndex, int &left, int &top, int &width, int &height);
+
+		/// <summary>
+		/// Encodes a chunk of a bitmap, leaving it unchanged if it's the same as in the base bitmap, filled if it's all a single color index, and compressed otherwise.
+		/// </summary>
+		/// <param name="bitmap">The bitmap to encode the chunk of.</param>
+		/// <param name="baseBitmap">The bitmap to compare against. Can be nullptr.</param>
+		/// <param name="chunk">The chunk to encode, with its Index already set.</param>
+		static void EncodeChunk(const BITMAP *bitmap, const BITMAP *baseBitmap, Chunk &chunk);
+
+		/// <summary>
+		/// Decodes a stored chunk into a bitmap.
+		/// </summary>
+		/// <param name="chunk">The chunk to decode.</param>
+		/// <param name="chunkSize">The width and height of the chunks in the file.</param>
+		/// <param name="bitmap">The bitmap to decode the chunk into.</param>
+		/// <returns>Whether the chunk was decoded successfully.</returns>
+		static bool DecodeChunk(const Chunk &chunk, int chunkSize, BITMAP *bitmap);
+	};
+}
+#endif
@@ -0,0 +1,393 @@
+#include "SimBenchmark.h"
+#include "ActivityMan.h"
+#include "ConsoleMan.h"
+#include "FrameMan.h"
+#include "LuaMan.h"
+#include "MovableMan.h"
+#include "NetworkServer.h"
+#include "PerformanceMan.h"
+#include "PostProcessMan.h"
+#include "PresetMan.h"
+#include "SceneMan.h"
+#include "TimerMan.h"
+#include "Scene.h"
+#include "SLTerrain.h"
+#include "AEmitter.h"
+#include "AHuman.h"
+#include "Atom.h"
+#include "MOPixel.h"
+
+#include <psapi.h>
+
+namespace RTE {
+
+	const std::array<std::string, SimBenchmark::ScenarioCount> SimBenchmark::c_ScenarioNames = { "none", "explosions", "crowd", "particles", "terrain", "network" };
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::Clear() {
+		m_SimUpdateCount = 0;
+		m_SceneName.clear();
+		m_ActivityType.clear();
+		m_ActivityName.clear();
+		m_Seed = 0;
+		m_ScenarioName.clear();
+		m_Scenario = NoScenario;
+		m_SimUpdateTimes.clear();
+		m_PeakActorCount = 0;
+		m_PeakItemCount = 0;
+		m_PeakParticleCount = 0;
+		m_PeakMOIDCount = 0;
+		m_NetworkEncodeTime = 0;
+		m_NetworkBytesSent = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SimBenchmark::Run() {
+		const std::array<std::string, ScenarioCount>::const_iterator scenarioName = std::find(c_ScenarioNames.begin(), c_ScenarioNames.end(), m_ScenarioName.empty() ? c_ScenarioNames[NoScenario] : m_ScenarioName);
+		if (scenarioName == c_ScenarioNames.end()) {
+			std::string scenarioList;
+			for (const std::string &name : c_ScenarioNames) {
+				scenarioList += (scenarioList.empty() ? "" : ", ") + name;
+			}
+			g_ConsoleMan.PrintString("ERROR: There is no stress scenario named " + m_ScenarioName + "! The scenarios are: " + scenarioList);
+			return -1;
+		}
+		m_Scenario = static_cast<StressScenario>(std::distance(c_ScenarioNames.begin(), scenarioName));
+
+		std::string sceneName = m_SceneName;
+		std::string activityType = m_ActivityType;
+		std::string activityName = m_ActivityName;
+		if (StartSeededActivity(sceneName, activityType, activityName, m_Seed) < 0 || SetUpScenario() < 0) {
+			return -1;
+		}
+		g_ConsoleMan.PrintString("BENCHMARK: Running " + activityName + " on " + sceneName + " for " + std::to_string(m_SimUpdateCount) + " sim updates with seed " + std::to_string(m_Seed) + " and the " + c_ScenarioNames[m_Scenario] + " stress scenario");
+
+		g_PerformanceMan.ResetPerformanceCounterTotals();
+		m_SimUpdateTimes.clear();
+		m_SimUpdateTimes.reserve(m_SimUpdateCount);
+		long long runStartTime = g_TimerMan.GetAbsoluteTime();
+		for (int simUpdate = 0; simUpdate < m_SimUpdateCount; ++simUpdate) {
+			long long simUpdateStartTime = g_TimerMan.GetAbsoluteTime();
+			UpdateScenario(simUpdate);
+			UpdateSimFixedStep(m_Scenario == NetworkHost);
+			if (m_Scenario == NetworkHost) {
+				long long encodeStartTime = g_TimerMan.GetAbsoluteTime();
+				m_NetworkBytesSent += g_NetworkServer.SendNullSinkFrames();
+				m_NetworkEncodeTime += g_TimerMan.GetAbsoluteTime() - encodeStartTime;
+			}
+			m_SimUpdateTimes.push_back(g_TimerMan.GetAbsoluteTime() - simUpdateStartTime);
+			UpdatePeakCounts();
+		}
+		ReportResults(g_TimerMan.GetAbsoluteTime() - runStartTime);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SimBenchmark::StartSeededActivity(std::string &sceneName, std::string &activityType, std::string &activityName, unsigned int seed) {
+		if (sceneName.empty()) { sceneName = g_SceneMan.GetDefaultSceneName(); }
+		if (activityType.empty()) { activityType = g_ActivityMan.GetDefaultActivityType(); }
+		if (activityName.empty()) { activityName = g_ActivityMan.GetDefaultActivityName(); }
+
+		if (g_SceneMan.SetSceneToLoad(sceneName) < 0) {
+			g_ConsoleMan.PrintString("ERROR: Couldn't find the Scene named " + sceneName + " to run!");
+			return -1;
+		}
+		// Seed before starting the Activity, since placing the Scene's objects and the Activity's setup draw random numbers too
+		SeedRNG(seed);
+		g_TimerMan.ResetTime();
+		if (g_ActivityMan.StartActivity(activityType, activityName) < 0) {
+			g_ConsoleMan.PrintString("ERROR: Couldn't start the " + activityType + " named " + activityName + " to run!");
+			return -1;
+		}
+		g_TimerMan.PauseSim(false);
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::UpdateSimFixedStep(bool drawFrame) {
+		g_PerformanceMan.NewPerformanceSample();
+		g_TimerMan.UpdateSimFixedStep();
+
+		// Same order as the game loop, minus input, audio and the network, which are up to the caller
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+		g_FrameMan.Update();
+		g_PerformanceMan.StartPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+		g_ActivityMan.Update();
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_ACTIVITY);
+		g_MovableMan.Update();
+		g_ActivityMan.LateUpdateGlobalScripts();
+		g_LuaMan.Update();
+		g_PerformanceMan.StopPerformanceMeasurement(PerformanceMan::PERF_SIM_TOTAL);
+
+		if (drawFrame) {
+			g_FrameMan.Draw();
+			return;
+		}
+		// Every fixed step counts as a drawn one, so do what FrameMan::Draw would to the sim state, like updating the Scene and cleaning up the unseen layers
+		g_PostProcessMan.ClearScreenPostEffects();
+		for (int screen = 0; screen < g_FrameMan.GetScreenCount(); ++screen) {
+			g_SceneMan.Update(screen);
+		}
+		g_SceneMan.ClearSeenPixels();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SimBenchmark::SetUpScenario() {
+		switch (m_Scenario) {
+			case Crowd:
+				return SpawnCrowd();
+			case NetworkHost:
+				return SetUpNetworkHost();
+			default:
+				break;
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::UpdateScenario(int simUpdate) {
+		switch (m_Scenario) {
+			case Explosions:
+				if (simUpdate % c_ScenarioBurstInterval == 0) { SpawnExplosions(); }
+				break;
+			case Particles:
+				if (simUpdate % c_ScenarioBurstInterval == 0 && simUpdate / c_ScenarioBurstInterval < c_MaxParticleBursts) { SpawnParticles(); }
+				break;
+			case TerrainDestruction:
+				BlastCrater();
+				break;
+			default:
+				break;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::SpawnExplosions() const {
+		for (int i = 0; i < c_ExplosionActorCount; ++i) {
+			if (const Actor *actorPreset = dynamic_cast<const Actor *>(GetRandomPreset("AHuman"))) {
+				Actor *actor = dynamic_cast<Actor *>(actorPreset->Clone());
+				actor->SetPos(GetRandomPosAboveGround(20));
+				g_MovableMan.AddActor(actor);
+				actor->GibThis(Vector(), 50.0F);
+			}
+		}
+		for (int i = 0; i < c_ExplosionEmitterCount; ++i) {
+			if (const AEmitter *emitterPreset = dynamic_cast<const AEmitter *>(GetRandomPreset("AEmitter"))) {
+				AEmitter *emitter = dynamic_cast<AEmitter *>(emitterPreset->Clone());
+				emitter->SetPos(GetRandomPosAboveGround(50));
+				emitter->SetLifetime(1000);
+				emitter->EnableEmission(true);
+				g_MovableMan.AddParticle(emitter);
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SimBenchmark::SpawnCrowd() const {
+		const AHuman *humanPreset = dynamic_cast<const AHuman *>(GetRandomPreset("AHuman"));
+		if (!humanPreset) {
+			g_ConsoleMan.PrintString("ERROR: There are no AHumans loaded to run the crowd stress scenario with!");
+			return -1;
+		}
+		int sceneWidth = g_SceneMan.GetSceneWidth();
+		int sceneHeight = g_SceneMan.GetSceneHeight();
+		int tunnelHeight = 40;
+		int shaftWidth = 30;
+		int shaftSpacing = 300;
+
+		// Tunnels run across the lower half of the Scene, with shafts leading down into them from the top
+		int bottomTunnelTop = 0;
+		for (int tunnel = 0; tunnel < c_CrowdTunnelCount; ++tunnel) {
+			bottomTunnelTop = sceneHeight / 2 + (sceneHeight / 2 - tunnelHeight * 2) * tunnel / c_CrowdTunnelCount;
+			DigBox(0, bottomTunnelTop, sceneWidth, tunnelHeight);
+		}
+		for (int shaftLeft = shaftSpacing / 2; shaftLeft + shaftWidth < sceneWidth; shaftLeft += shaftSpacing) {
+			DigBox(shaftLeft, 0, shaftWidth, bottomTunnelTop + tunnelHeight);
+		}
+		g_SceneMan.GetScene()->UpdatePathFinding();
+
+		for (int i = 0; i < c_CrowdActorCount; ++i) {
+			// Every other AHuman is of the other team and starts off on the other side, so the two teams have to path through each other
+			int team = i % 2;
+			float spawnX = static_cast<float>(sceneWidth) * (team == 0 ? RandomNum(0.0F, 0.25F) : RandomNum(0.75F, 1.0F));
+			AHuman *human = dynamic_cast<AHuman *>(humanPreset->Clone());
+			human->SetPos(g_SceneMan.MovePointToGround(Vector(spawnX, 0), 20, 5));
+			human->SetTeam(team);
+			human->SetControllerMode(Controller::CIM_AI);
+			human->SetAIMode(Actor::AIMODE_GOTO);
+			human->AddAISceneWaypoint(Vector(static_cast<float>(sceneWidth) - spawnX, static_cast<float>(bottomTunnelTop + tunnelHeight / 2)));
+			g_MovableMan.AddActor(human);
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::SpawnParticles() const {
+		// Use whatever the ground in the middle of the Scene is made of, so the particles have a material that settles like the terrain does
+		Vector groundPos = g_SceneMan.MovePointToGround(Vector(static_cast<float>(g_SceneMan.GetSceneWidth() / 2), 0), 0, 1) + Vector(0, 2);
+		unsigned char materialID = g_SceneMan.GetTerrMatter(groundPos.GetFloorIntX(), groundPos.GetFloorIntY());
+		const Material *material = g_SceneMan.GetMaterialFromID(materialID == g_MaterialAir ? static_cast<unsigned char>(c_GoldMaterialID) : materialID);
+		Color color;
+		color.SetRGBWithIndex(material->UsesOwnColor() ? material->GetColor().GetIndex() : g_SceneMan.GetScene()->GetTerrain()->GetFGColorPixel(groundPos.GetFloorIntX(), groundPos.GetFloorIntY()));
+		if (color.GetIndex() == g_MaskColor) { color.SetRGBWithIndex(g_WhiteColor); }
+
+		for (int i = 0; i < c_ParticleBurstCount; ++i) {
+			Vector vel(RandomNormalNum() * 5.0F, RandomNum(-5.0F, 0.0F));
+			MOPixel *pixel = new MOPixel(color, material->GetPixelDensity(), GetRandomPosAboveGround(100), vel, new Atom(Vector(), material->GetIndex(), 0, color, 2), 0);
+			pixel->SetToGetHitByMOs(false);
+			g_MovableMan.AddParticle(pixel);
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::BlastCrater() const {
+		Vector center = g_SceneMan.MovePointToGround(GetRandomPosAboveGround(c_CraterRadius), 0, 1);
+		int centerX = center.GetFloorIntX();
+		int centerY = center.GetFloorIntY();
+		float retardation;
+
+		g_SceneMan.LockScene();
+		for (int offsetY = -c_CraterRadius; offsetY <= c_CraterRadius; ++offsetY) {
+			for (int offsetX = -c_CraterRadius; offsetX <= c_CraterRadius; ++offsetX) {
+				if (offsetX * offsetX + offsetY * offsetY <= c_CraterRadius * c_CraterRadius) {
+					Vector blastVel(static_cast<float>(offsetX), static_cast<float>(offsetY));
+					blastVel.SetMagnitude(50.0F);
+					g_SceneMan.TryPenetrate(centerX + offsetX, centerY + offsetY, blastVel * 1000.0F, blastVel, retardation, 1.0F);
+				}
+			}
+		}
+		// Check all around the rim for bits of terrain the crater cut off
+		for (int rimPoint = 0; rimPoint < 16; ++rimPoint) {
+			Vector rimOffset(static_cast<float>(c_CraterRadius + 2), 0);
+			rimOffset.RadRotate(c_TwoPI * static_cast<float>(rimPoint) / 16.0F);
+			g_SceneMan.RemoveOrphans(centerX + rimOffset.GetFloorIntX(), centerY + rimOffset.GetFloorIntY(), c_CraterRadius * 2, c_CraterRadius * c_CraterRadius, true);
+		}
+		g_SceneMan.UnlockScene();
+		g_SceneMan.GetScene()->GetTerrain()->AddUpdatedMaterialArea(Box(Vector(static_cast<float>(centerX - c_CraterRadius * 2), static_cast<float>(centerY - c_CraterRadius * 2)), static_cast<float>(c_CraterRadius * 4), static_cast<float>(c_CraterRadius * 4)));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int SimBenchmark::SetUpNetworkHost() const {
+		g_FrameMan.SetMultiplayerMode(true);
+		for (short player = 0; player < c_NetworkPlayerCount; ++player) {
+			g_FrameMan.CreateNewNetworkPlayerBackBuffer(player, 960, 540);
+		}
+		g_FrameMan.ResetSplitScreens(true, true);
+		if (g_NetworkServer.StartNullSink(c_NetworkPlayerCount) < 0) {
+			g_ConsoleMan.PrintString("ERROR: Couldn't set up the NetworkServer to encode frames for the network stress scenario!");
+			return -1;
+		}
+		return 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::DigBox(int left, int top, int width, int height) {
+		SLTerrain *terrain = g_SceneMan.GetScene()->GetTerrain();
+		rectfill(terrain->GetMaterialBitmap(), left, top, left + width - 1, top + height - 1, g_MaterialAir);
+		rectfill(terrain->GetFGColorBitmap(), left, top, left + width - 1, top + height - 1, g_MaskColor);
+		g_SceneMan.RegisterTerrainChange(left, top, width, height, g_MaskColor, false);
+		terrain->AddUpdatedMaterialArea(Box(Vector(static_cast<float>(left), static_cast<float>(top)), static_cast<float>(width), static_cast<float>(height)));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	const Entity * SimBenchmark::GetRandomPreset(const std::string &type) {
+		std::list<Entity *> presets;
+		g_PresetMan.GetAllOfType(presets, type);
+		presets.remove_if([](Entity *preset) { return preset->IsInGroup("Brains"); });
+		return presets.empty() ? nullptr : *std::next(presets.begin(), RandomNum<int>(0, presets.size() - 1));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Vector SimBenchmark::GetRandomPosAboveGround(int altitude) {
+		return g_SceneMan.MovePointToGround(Vector(RandomNum(0.0F, static_cast<float>(g_SceneMan.GetSceneWidth() - 1)), 0), altitude, 2);
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t SimBenchmark::GetPeakMemoryUsage() {
+		PROCESS_MEMORY_COUNTERS memoryCounters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)) ? memoryCounters.PeakWorkingSetSize : 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::UpdatePeakCounts() {
+		m_PeakActorCount = std::max(m_PeakActorCount, g_MovableMan.GetActorCount());
+		m_PeakItemCount = std::max(m_PeakItemCount, g_MovableMan.GetItemCount());
+		m_PeakParticleCount = std::max(m_PeakParticleCount, g_MovableMan.GetParticleCount());
+		m_PeakMOIDCount = std::max(m_PeakMOIDCount, g_MovableMan.GetMOIDCount());
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	unsigned long long SimBenchmark::CalculateStateChecksum() {
+		unsigned long long checksum = g_MovableMan.GetStateChecksum();
+		const BITMAP *materialBitmap = g_SceneMan.GetScene() ? g_SceneMan.GetScene()->GetTerrain()->GetMaterialBitmap() : nullptr;
+		if (materialBitmap) {
+			for (int row = 0; row < materialBitmap->h; ++row) {
+				checksum = HashBytes(materialBitmap->line[row], materialBitmap->w, checksum);
+			}
+		}
+		return checksum;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void SimBenchmark::ReportResults(long long runTime) const {
+		char buf[256];
+		double runTimeMS = static_cast<double>(runTime) / 1000.0;
+		std::snprintf(buf, sizeof(buf), "BENCHMARK: Ran %i sim updates in %.2f ms (%.3f ms per update, %.1f updates per second)", m_SimUpdateCount, runTimeMS, runTimeMS / static_cast<double>(m_SimUpdateCount), static_cast<double>(m_SimUpdateCount) / (runTimeMS / 1000.0));
+		g_ConsoleMan.PrintString(buf);
+
+		if (!m_SimUpdateTimes.empty()) {
+			std::vector<long long> sortedSimUpdateTimes = m_SimUpdateTimes;
+			std::sort(sortedSimUpdateTimes.begin(), sortedSimUpdateTimes.end());
+			auto percentileMS = [&sortedSimUpdateTimes](double percentile) {
+				size_t index = std::min(static_cast<size_t>(percentile * static_cast<double>(sortedSimUpdateTimes.size())), sortedSimUpdateTimes.size() - 1);
+				return static_cast<double>(sortedSimUpdateTimes[index]) / 1000.0;
+			};
+			std::snprintf(buf, sizeof(buf), "BENCHMARK: Sim update time p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms", percentileMS(0.5), percentileMS(0.95), percentileMS(0.99), static_cast<double>(sortedSimUpdateTimes.back()) / 1000.0);
+			g_ConsoleMan.PrintString(buf);
+		}
+
+		for (int counter = 0; counter < PerformanceMan::PERF_COUNT; ++counter) {
+			PerformanceMan::PerformanceCounters performanceCounter = static_cast<PerformanceMan::PerformanceCounters>(counter);
+			double counterTotalMS = static_cast<double>(g_PerformanceMan.GetPerformanceCounterTotal(performanceCounter)) / 1000.0;
+			std::snprintf(buf, sizeof(buf), "BENCHMARK: %-12s %10.2f ms total, %8.3f ms per update", g_PerformanceMan.GetPerformanceCounterName(performanceCounter).c_str(), counterTotalMS, counterTotalMS / static_cast<double>(m_SimUpdateCount));
+			g_ConsoleMan.PrintString(buf);
+		}
+
+		if (m_Scenario == NetworkHost) {
+			double encodeTimeMS = static_cast<double>(m_NetworkEncodeTime) / 1000.0;
+			double compressionRatio = 0;
+			for (short player = 0; player < c_NetworkPlayerCount; ++player) {
+				compressionRatio += g_NetworkServer.GetCompressionRatio(player) / static_cast<double>(c_NetworkPlayerCount);
+			}
+			std::snprintf(buf, sizeof(buf), "BENCHMARK: Network frames %10.2f ms total, %8.3f ms per update, %lli bytes total, %lli per player frame, compression ratio %.3f", encodeTimeMS, encodeTimeMS / static_cast<double>(m_SimUpdateCount), m_NetworkBytesSent, m_NetworkBytesSent / (static_cast<long long>(m_SimUpdateCount) * c_NetworkPlayerCount), compressionRatio);
+			g_ConsoleMan.PrintString(buf);
+		}
+
+		std::snprintf(buf, sizeof(buf), "BENCHMARK: %li actors, %li items and %li particles left, at most %li, %li and %li", g_MovableMan.GetActorCount(), g_MovableMan.GetItemCount(), g_MovableMan.GetParticleCount(), m_PeakActorCount, m_PeakItemCount, m_PeakParticleCount);
+		g_ConsoleMan.PrintString(buf);
+		std::snprintf(buf, sizeof(buf), "BENCHMARK: At most %i of %i MOIDs in use", m_PeakMOIDCount, static_cast<int>(g_NoMOID));
+		g_ConsoleMan.PrintString(buf);
+		std::snprintf(buf, sizeof(buf), "BENCHMARK: Peak memory usage %.1f MiB", static_cast<double>(GetPeakMemoryUsage()) / (1024.0 * 1024.0));
+		g_ConsoleMan.PrintString(buf);
+		std::snprintf(buf, sizeof(buf), "BENCHMARK: State checksum %016llx", CalculateStateChecksum());
+		g_ConsoleMan.PrintString(buf);
+	}
+}
@@ -0,0 +1,222 @@
+#ifndef _RTESIMBENCHMARK_
+#define _RTESIMBENCHMARK_
+
+namespace RTE {
+
+	class Entity;
+	class Vector;
+
+	/// <summary>
+	/// Runs a Scene and Activity for a fixed number of sim updates as fast as possible, with nothing drawn and no audio, and reports how long the PerformanceMan counters took along with a checksum of the resulting state.
+	/// The RNG is seeded with a fixed seed and every sim update advances the sim time by exactly one DeltaTime, so runs with the same arguments on the same build should end up with the same checksum.
+	/// A built-in stress scenario can be run on top of the Activity, to load up a particular part of the sim the same way across releases.
+	/// </summary>
+	class SimBenchmark {
+
+	public:
+
+		/// <summary>
+		/// The built-in stress scenarios that can be run on top of the Activity.
+		/// </summary>
+		enum StressScenario {
+			NoScenario = 0,
+			Explosions, //!< Bursts of Actors gibbed into MOPixels and other gibs, along with emitting AEmitters.
+			Crowd, //!< Hundreds of AI controlled AHumans pathing towards the other side of a Scene dug through with tunnels.
+			Particles, //!< Thousands of MOPixels raining down and settling into the terrain.
+			TerrainDestruction, //!< Craters blasted into the terrain one after another, knocking loose pixels and removing the orphaned terrain around them.
+			NetworkHost, //!< Every sim update drawn for four network players, with their frames encoded and compressed by the NetworkServer and then dropped, the way a multiplayer host does without the sending.
+			ScenarioCount
+		};
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a SimBenchmark object in system memory.
+		/// </summary>
+		SimBenchmark() { Clear(); }
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Tells whether a benchmark was asked for, i.e. the number of sim updates to run has been set.
+		/// </summary>
+		/// <returns>Whether this should be run instead of the game.</returns>
+		bool IsEnabled() const { return m_SimUpdateCount > 0; }
+
+		/// <summary>
+		/// Sets how many sim updates to run.
+		/// </summary>
+		/// <param name="simUpdateCount">The number of sim updates to run.</param>
+		void SetSimUpdateCount(int simUpdateCount) { m_SimUpdateCount = simUpdateCount; }
+
+		/// <summary>
+		/// Sets the Scene to run. If not set, the default Scene set in SceneMan is used.
+		/// </summary>
+		/// <param name="sceneName">The preset name of the Scene.</param>
+		void SetSceneName(const std::string &sceneName) { m_SceneName = sceneName; }
+
+		/// <summary>
+		/// Sets the Activity to run. If not set, the default Activity set in ActivityMan is used.
+		/// </summary>
+		/// <param name="activityType">The class name of the Activity.</param>
+		/// <param name="activityName">The preset name of the Activity.</param>
+		void SetActivity(const std::string &activityType, const std::string &activityName) { m_ActivityType = activityType; m_ActivityName = activityName; }
+
+		/// <summary>
+		/// Sets the seed the RNG is seeded with before the Activity is started.
+		/// </summary>
+		/// <param name="seed">The seed to use.</param>
+		void SetSeed(unsigned int seed) { m_Seed = seed; }
+
+		/// <summary>
+		/// Sets the stress scenario to run on top of the Activity. The name is checked when the benchmark is run.
+		/// </summary>
+		/// <param name="scenarioName">The name of the stress scenario, as listed in c_ScenarioNames.</param>
+		void SetScenarioName(const std::string &scenarioName) { m_ScenarioName = scenarioName; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Starts the Activity on the Scene, runs the sim updates and prints the results to the console.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int Run();
+
+		/// <summary>
+		/// Seeds the RNG, resets the time and starts an Activity on a Scene, so that running it with UpdateSimFixedStep gives the same results every time.
+		/// </summary>
+		/// <param name="sceneName">The preset name of the Scene. If empty, it's set to the default Scene set in SceneMan.</param>
+		/// <param name="activityType">The class name of the Activity. If empty, it's set to the default Activity type set in ActivityMan.</param>
+		/// <param name="activityName">The preset name of the Activity. If empty, it's set to the default Activity set in ActivityMan.</param>
+		/// <param name="seed">The seed to seed the RNG with.</param>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		static int StartSeededActivity(std::string &sceneName, std::string &activityType, std::string &activityName, unsigned int seed);
+
+		/// <summary>
+		/// Runs a single sim update, advancing the sim time by exactly one DeltaTime. Does what drawing a frame would to the sim state, like updating the Scene, without drawing anything.
+		/// Input, audio and the NetworkServer aren't updated, that's up to the caller.
+		/// </summary>
+		/// <param name="drawFrame">Whether to actually draw the frame instead, for every screen or network player.</param>
+		static void UpdateSimFixedStep(bool drawFrame = false);
+
+		/// <summary>
+		/// Calculates a checksum of the state of the simulation, covering all the MOs held by MovableMan and the material layer of the terrain.
+		/// </summary>
+		/// <returns>The checksum of the simulation state.</returns>
+		static unsigned long long CalculateStateChecksum();
+#pragma endregion
+
+	private:
+
+		static const std::array<std::string, ScenarioCount> c_ScenarioNames; //!< The names the stress scenarios are picked by from the command line, in StressScenario order.
+		static constexpr int c_ScenarioBurstInterval = 30; //!< How many sim updates apart the Explosions and Particles scenarios spawn their bursts.
+		static constexpr int c_ExplosionActorCount = 8; //!< How many Actors are gibbed in each burst of the Explosions scenario.
+		static constexpr int c_ExplosionEmitterCount = 4; //!< How many AEmitters are spawned in each burst of the Explosions scenario.
+		static constexpr int c_CrowdActorCount = 200; //!< How many AHumans the Crowd scenario spawns.
+		static constexpr int c_CrowdTunnelCount = 3; //!< How many horizontal tunnels the Crowd scenario digs across the Scene.
+		static constexpr int c_ParticleBurstCount = 500; //!< How many MOPixels are spawned in each burst of the Particles scenario.
+		static constexpr int c_MaxParticleBursts = 8; //!< How many bursts the Particles scenario spawns in total, so the particles get to settle afterwards.
+		static constexpr int c_CraterRadius = 16; //!< The radius of each crater of the TerrainDestruction scenario, in pixels.
+		static constexpr int c_NetworkPlayerCount = 4; //!< How many network players the NetworkHost scenario draws frames for.
+
+		int m_SimUpdateCount; //!< How many sim updates to run. 0 means no benchmark was asked for.
+		std::string m_SceneName; //!< The preset name of the Scene to run, or empty for the default one.
+		std::string m_ActivityType; //!< The class name of the Activity to run, or empty for the default one.
+		std::string m_ActivityName; //!< The preset name of the Activity to run, or empty for the default one.
+		unsigned int m_Seed; //!< The seed the RNG is seeded with before the Activity is started.
+		std::string m_ScenarioName; //!< The name of the stress scenario to run, or empty for none.
+		StressScenario m_Scenario; //!< The stress scenario being run.
+
+		std::vector<long long> m_SimUpdateTimes; //!< How long each sim update took, including the stress scenario's own work, in microseconds.
+		long m_PeakActorCount; //!< The most Actors MovableMan held after any sim update.
+		long m_PeakItemCount; //!< The most items MovableMan held after any sim update.
+		long m_PeakParticleCount; //!< The most particles MovableMan held after any sim update.
+		int m_PeakMOIDCount; //!< The most MOIDs in use after any sim update.
+		long long m_NetworkEncodeTime; //!< How long the NetworkServer took to encode and compress the NetworkHost scenario's frames, in microseconds.
+		long long m_NetworkBytesSent; //!< How many bytes the NetworkServer would have sent for the NetworkHost scenario's frames.
+
+		/// <summary>
+		/// Sets up the stress scenario after the Activity was started, e.g. by digging up the Scene or spawning whatever it needs at the start.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int SetUpScenario();
+
+		/// <summary>
+		/// Does the stress scenario's work before a sim update, like spawning the next burst of MOs.
+		/// </summary>
+		/// <param name="simUpdate">The index of the sim update about to run.</param>
+		void UpdateScenario(int simUpdate);
+
+		/// <summary>
+		/// Spawns a burst of Actors and gibs them right away, along with some AEmitters that emit until their lifetime runs out.
+		/// </summary>
+		void SpawnExplosions() const;
+
+		/// <summary>
+		/// Digs tunnels and shafts through the Scene and spawns AI controlled AHumans of two teams, each heading to the far end of the bottom tunnel on the other side.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int SpawnCrowd() const;
+
+		/// <summary>
+		/// Spawns a burst of MOPixels of the terrain's own material above the ground, which settle into the terrain once they come to rest.
+		/// </summary>
+		void SpawnParticles() const;
+
+		/// <summary>
+		/// Blasts a crater into the terrain at a random spot on the ground, knocking each pixel loose like a hit would, and removes the orphaned terrain around its rim.
+		/// </summary>
+		void BlastCrater() const;
+
+		/// <summary>
+		/// Puts FrameMan into multiplayer mode with a network back buffer and split screen for each network player, and makes the NetworkServer encode frames for them without sending them anywhere.
+		/// </summary>
+		/// <returns>An error return value signaling success or any particular failure. Anything below 0 is an error signal.</returns>
+		int SetUpNetworkHost() const;
+
+		/// <summary>
+		/// Clears a box of the terrain to air and marks it for the pathfinding to update.
+		/// </summary>
+		/// <param name="left">The left edge of the box.</param>
+		/// <param name="top">The top edge of the box.</param>
+		/// <param name="width">The width of the box.</param>
+		/// <param name="height">The height of the box.</param>
+		static void DigBox(int left, int top, int width, int height);
+
+		/// <summary>
+		/// Picks a random preset of a type from all loaded modules, skipping brains since those can't be gibbed and Activities treat them specially.
+		/// </summary>
+		/// <param name="type">The class name of the presets to pick from.</param>
+		/// <returns>The picked preset, or nullptr if none of that type are loaded. Ownership is NOT transferred!</returns>
+		static const Entity * GetRandomPreset(const std::string &type);
+
+		/// <summary>
+		/// Gets a random point above the ground of the Scene.
+		/// </summary>
+		/// <param name="altitude">How high above the ground the point should be, in pixels.</param>
+		/// <returns>The random point.</returns>
+		static Vector GetRandomPosAboveGround(int altitude);
+
+		/// <summary>
+		/// Gets the peak amount of memory the process had in use since it was started.
+		/// </summary>
+		/// <returns>The peak working set of the process, in bytes.</returns>
+		static size_t GetPeakMemoryUsage();
+
+		/// <summary>
+		/// Updates the peak MO counts and MOID usage with the current ones.
+		/// </summary>
+		void UpdatePeakCounts();
+
+		/// <summary>
+		/// Prints how long the run took, the p50, p95 and p99 sim update times, the totals and per sim update averages of each PerformanceMan counter, the network frame encoding time and bytes if any, the peak memory, MO counts and MOID usage, and the state checksum to the console.
+		/// </summary>
+		/// <param name="runTime">How long running the sim updates took, in microseconds.</param>
+		void ReportResults(long long runTime) const;
+
+		/// <summary>
+		/// Clears all the member variables of this SimBenchmark, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
@@ -10,7 +10,10 @@
 #include <cstddef>
 #include <functional>
 #include <thread>
+#include <future>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <cctype>
 #include <string>
 #include <cstring>
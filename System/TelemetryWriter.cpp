@@ -0,0 +1,204 @@
+#include "TelemetryWriter.h"
+#include "ConsoleMan.h"
+#include "FrameMan.h"
+#include "LuaMan.h"
+#include "MovableMan.h"
+#include "NetworkServer.h"
+#include "PerformanceMan.h"
+#include "TimerMan.h"
+
+#include <psapi.h>
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TelemetryWriter::Clear() {
+		m_FilePath.clear();
+		m_RecordInterval = 10;
+		m_FileSize = 0;
+		m_StartTime = -1;
+		m_LastFrameTime = -1;
+		m_LastRecordTime = -1;
+		m_LastRecordSampleCount = 0;
+		m_FrameTimes.clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TelemetryWriter::Destroy() {
+		if (m_File.is_open()) {
+			if (!m_FrameTimes.empty()) { WriteRecord(g_TimerMan.GetAbsoluteTime()); }
+			m_File.close();
+		}
+		Clear();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TelemetryWriter::Update() {
+		if (!IsEnabled()) {
+			return;
+		}
+		long long currentTime = g_TimerMan.GetAbsoluteTime();
+		if (m_StartTime < 0) {
+			if (!OpenFile()) {
+				return;
+			}
+			m_StartTime = currentTime;
+			m_LastFrameTime = currentTime;
+			m_LastRecordTime = currentTime;
+			m_LastRecordSampleCount = g_PerformanceMan.GetTotalSampleCount();
+			m_FrameTimes.reserve(static_cast<size_t>(m_RecordInterval) * 120);
+			return;
+		}
+		m_FrameTimes.push_back(static_cast<float>(currentTime - m_LastFrameTime) / 1000.0F);
+		m_LastFrameTime = currentTime;
+
+		if (currentTime - m_LastRecordTime >= static_cast<long long>(m_RecordInterval) * 1000000) { WriteRecord(currentTime); }
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool TelemetryWriter::OpenFile() {
+		std::error_code fileSizeError;
+		m_FileSize = std::filesystem::exists(m_FilePath) ? std::filesystem::file_size(m_FilePath, fileSizeError) : 0;
+		if (fileSizeError) { m_FileSize = 0; }
+
+		m_File.open(m_FilePath, std::ios::out | std::ios::app);
+		if (!m_File.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not open telemetry file " + m_FilePath + " for writing! Telemetry is disabled.");
+			m_FilePath.clear();
+			return false;
+		}
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TelemetryWriter::RotateFiles() {
+		m_File.close();
+
+		// Errors are ignored on purpose, a rotated file that can't be moved just gets overwritten or left behind
+		std::error_code rotateError;
+		std::filesystem::remove(m_FilePath + "." + std::to_string(c_RotatedFileCount), rotateError);
+		for (int rotatedFile = c_RotatedFileCount - 1; rotatedFile > 0; --rotatedFile) {
+			std::string rotatedFilePath = m_FilePath + "." + std::to_string(rotatedFile);
+			if (std::filesystem::exists(rotatedFilePath)) { std::filesystem::rename(rotatedFilePath, m_FilePath + "." + std::to_string(rotatedFile + 1), rotateError); }
+		}
+		std::filesystem::rename(m_FilePath, m_FilePath + ".1", rotateError);
+
+		m_File.open(m_FilePath, std::ios::out | std::ios::trunc);
+		m_FileSize = 0;
+		if (!m_File.good()) {
+			g_ConsoleMan.PrintString("ERROR: Could not reopen telemetry file " + m_FilePath + " after rotating it! Telemetry is disabled.");
+			m_FilePath.clear();
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void TelemetryWriter::WriteRecord(long long currentTime) {
+		char buf[512];
+		std::string record;
+
+		double recordTime = static_cast<double>(currentTime - m_LastRecordTime) / 1000000.0;
+		// If the totals were reset since the last record, only what ran since then can be counted
+		unsigned long long totalSampleCount = g_PerformanceMan.GetTotalSampleCount();
+		unsigned long long simUpdateCount = (totalSampleCount >= m_LastRecordSampleCount) ? totalSampleCount - m_LastRecordSampleCount : totalSampleCount;
+		std::snprintf(buf, sizeof(buf), "{\"unixTime\":%lld,\"uptime\":%.1f,\"interval\":%.2f,\"frames\":%zu,\"simUpdates\":%llu,\"simSpeed\":%.3f", static_cast<long long>(std::time(nullptr)), static_cast<double>(currentTime - m_StartTime) / 1000000.0, recordTime, m_FrameTimes.size(), simUpdateCount, g_PerformanceMan.GetSimSpeed());
+		record += buf;
+
+		if (!m_FrameTimes.empty()) {
+			std::sort(m_FrameTimes.begin(), m_FrameTimes.end());
+			auto percentileMS = [this](double percentile) {
+				return m_FrameTimes[std::min(static_cast<size_t>(percentile * static_cast<double>(m_FrameTimes.size())), m_FrameTimes.size() - 1)];
+			};
+			std::snprintf(buf, sizeof(buf), ",\"mspf\":{\"p50\":%.2f,\"p95\":%.2f,\"p99\":%.2f,\"max\":%.2f}", percentileMS(0.5), percentileMS(0.95), percentileMS(0.99), m_FrameTimes.back());
+			record += buf;
+		}
+
+		std::snprintf(buf, sizeof(buf), ",\"mos\":{\"actors\":%li,\"items\":%li,\"particles\":%li,\"moids\":%i,\"moidLimit\":%i}", g_MovableMan.GetActorCount(), g_MovableMan.GetItemCount(), g_MovableMan.GetParticleCount(), g_MovableMan.GetMOIDCount(), static_cast<int>(g_NoMOID));
+		record += buf;
+
+		PROCESS_MEMORY_COUNTERS_EX memoryCounters;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&memoryCounters), sizeof(memoryCounters))) {
+			std::snprintf(buf, sizeof(buf), ",\"memory\":{\"workingSet\":%zu,\"peakWorkingSet\":%zu,\"private\":%zu}", static_cast<size_t>(memoryCounters.WorkingSetSize), static_cast<size_t>(memoryCounters.PeakWorkingSetSize), static_cast<size_t>(memoryCounters.PrivateUsage));
+			record += buf;
+		}
+
+		std::snprintf(buf, sizeof(buf), ",\"lua\":{\"heap\":%zu,\"gcCycles\":%lu,\"gcPauseAvg\":%u,\"gcPausePeak\":%u}", g_LuaMan.GetHeapSize(), g_LuaMan.GetGCCycleCount(), g_LuaMan.GetAverageGCPauseTime(), g_LuaMan.GetPeakGCPauseTime());
+		record += buf;
+
+		const RotatedSpriteCache &rotatedSpriteCache = g_FrameMan.GetRotatedSpriteCache();
+		std::snprintf(buf, sizeof(buf), ",\"rotationCache\":{\"entries\":%zu,\"memory\":%zu,\"hitRate\":%.3f}", rotatedSpriteCache.GetEntryCount(), rotatedSpriteCache.GetMemoryUsage(), rotatedSpriteCache.GetHitRate());
+		record += buf;
+
+		// Totals over all pools, plus the classes with the most instances in use, which is where a leak would show up first
+		long long totalInUse = 0;
+		long long totalPooled = 0;
+		std::vector<const Entity::ClassInfo *> poolClasses;
+		for (const std::string &className : Entity::ClassInfo::GetClassNames()) {
+			const Entity::ClassInfo *classInfo = Entity::ClassInfo::GetClass(className);
+			if (classInfo && classInfo->IsConcrete()) {
+				totalInUse += classInfo->GetInstancesInUse();
+				totalPooled += classInfo->GetPooledInstanceCount();
+				if (classInfo->GetInstancesInUse() > 0) { poolClasses.push_back(classInfo); }
+			}
+		}
+		size_t listedClassCount = std::min(poolClasses.size(), static_cast<size_t>(c_MaxPoolClasses));
+		std::partial_sort(poolClasses.begin(), poolClasses.begin() + listedClassCount, poolClasses.end(), [](const Entity::ClassInfo *classInfo, const Entity::ClassInfo *otherClassInfo) { return classInfo->GetInstancesInUse() > otherClassInfo->GetInstancesInUse(); });
+		std::snprintf(buf, sizeof(buf), ",\"pools\":{\"inUse\":%lld,\"pooled\":%lld,\"top\":{", totalInUse, totalPooled);
+		record += buf;
+		for (size_t classIndex = 0; classIndex < listedClassCount; ++classIndex) {
+			std::snprintf(buf, sizeof(buf), "%s\"%s\":%i", (classIndex > 0) ? "," : "", EscapeJSONString(poolClasses[classIndex]->GetName()).c_str(), poolClasses[classIndex]->GetInstancesInUse());
+			record += buf;
+		}
+		record += "}}";
+
+		if (g_NetworkServer.IsServerModeEnabled()) {
+			record += ",\"clients\":[";
+			bool firstClient = true;
+			for (short player = 0; player < c_MaxClients; ++player) {
+				if (!g_NetworkServer.IsPlayerConnected(player)) {
+					continue;
+				}
+				std::snprintf(buf, sizeof(buf), "%s{\"player\":%i,\"name\":\"%s\",\"ping\":%u,\"sentPerSec\":%lu,\"uncompressedPerSec\":%lu,\"ratio\":%.3f,\"framesSent\":%u,\"framesSkipped\":%u}", firstClient ? "" : ",", player, EscapeJSONString(g_NetworkServer.GetPlayerName(player).substr(0, 32)).c_str(), g_NetworkServer.GetPing(player), g_NetworkServer.GetDataSentPerSecond(player), g_NetworkServer.GetDataUncompressedPerSecond(player), g_NetworkServer.GetCompressionRatio(player), g_NetworkServer.GetFramesSent(player), g_NetworkServer.GetFramesSkipped(player));
+				record += buf;
+				firstClient = false;
+			}
+			record += "]";
+		}
+		record += "}\n";
+
+		if (m_FileSize > 0 && m_FileSize + record.size() > c_MaxFileSize) { RotateFiles(); }
+		if (m_File.is_open()) {
+			// Flushed right away so the records can be followed live and nothing is lost if the server goes down
+			m_File << record << std::flush;
+			m_FileSize += record.size();
+		}
+
+		m_FrameTimes.clear();
+		m_LastRecordTime = currentTime;
+		m_LastRecordSampleCount = g_PerformanceMan.GetTotalSampleCount();
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	std::string TelemetryWriter::EscapeJSONString(const std::string &text) {
+		std::string escapedText;
+		escapedText.reserve(text.size());
+		for (char character : text) {
+			if (character == '"' || character == '\\') {
+				escapedText += '\\';
+				escapedText += character;
+			} else if (static_cast<unsigned char>(character) < 0x20) {
+				// Control characters have no business in names, so they're just dropped
+				continue;
+			} else {
+				escapedText += character;
+			}
+		}
+		return escapedText;
+	}
+}
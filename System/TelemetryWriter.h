@@ -0,0 +1,102 @@
+#ifndef _RTETELEMETRYWRITER_
+#define _RTETELEMETRYWRITER_
+
+namespace RTE {
+
+	/// <summary>
+	/// Periodically appends a compact record of how the game is doing to a local file, so servers that run for days can have their frame times, MO counts, memory and bandwidth charted and checked for leaks without a display attached.
+	/// Each record is a single line of JSON covering the frames drawn since the previous one. The file is rotated once it grows past c_MaxFileSize, keeping the last c_RotatedFileCount files around.
+	/// </summary>
+	class TelemetryWriter {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a TelemetryWriter object in system memory.
+		/// </summary>
+		TelemetryWriter() { Clear(); }
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Writes a last record covering the frames drawn since the previous one and closes the file.
+		/// </summary>
+		void Destroy();
+#pragma endregion
+
+#pragma region Getters and Setters
+		/// <summary>
+		/// Tells whether telemetry was asked for, i.e. the file to write it to has been set.
+		/// </summary>
+		/// <returns>Whether records are being written.</returns>
+		bool IsEnabled() const { return !m_FilePath.empty(); }
+
+		/// <summary>
+		/// Sets the file to append the records to. The rotated files get a number appended to this name.
+		/// </summary>
+		/// <param name="filePath">The path of the file to write to.</param>
+		void SetFilePath(const std::string &filePath) { m_FilePath = filePath; }
+
+		/// <summary>
+		/// Sets how often a record is written.
+		/// </summary>
+		/// <param name="recordInterval">The time between records in seconds. Values below 1 are clamped to 1.</param>
+		void SetRecordInterval(int recordInterval) { m_RecordInterval = std::max(recordInterval, 1); }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Measures the time since the last call as the time the last frame took, and writes a record if the record interval has passed. Should be called once per drawn frame.
+		/// </summary>
+		void Update();
+#pragma endregion
+
+	private:
+
+		static constexpr unsigned long long c_MaxFileSize = 16 * 1024 * 1024; //!< How big the file may grow before it's rotated, in bytes.
+		static constexpr int c_RotatedFileCount = 3; //!< How many rotated files are kept besides the one being written to.
+		static constexpr int c_MaxPoolClasses = 8; //!< How many of the Entity classes with the most instances in use are listed in each record.
+
+		std::string m_FilePath; //!< The path of the file the records are appended to. Empty if telemetry wasn't asked for.
+		int m_RecordInterval; //!< The time between records in seconds.
+		std::ofstream m_File; //!< The file the records are appended to.
+		unsigned long long m_FileSize; //!< How many bytes the file currently holds.
+
+		long long m_StartTime; //!< The absolute time of the first Update, in microseconds.
+		long long m_LastFrameTime; //!< The absolute time of the last Update, in microseconds.
+		long long m_LastRecordTime; //!< The absolute time the last record was written at, in microseconds.
+		unsigned long long m_LastRecordSampleCount; //!< The total PerformanceMan sample count when the last record was written, for telling how many sim updates ran since.
+		std::vector<float> m_FrameTimes; //!< How long each frame drawn since the last record took, in milliseconds.
+
+		/// <summary>
+		/// Opens the file for appending, picking up its current size so rotation still works across restarts. Disables telemetry if the file can't be opened.
+		/// </summary>
+		/// <returns>Whether the file is open.</returns>
+		bool OpenFile();
+
+		/// <summary>
+		/// Closes the file, shifts the rotated files up by one, dropping the oldest, and starts a new file.
+		/// </summary>
+		void RotateFiles();
+
+		/// <summary>
+		/// Writes a record covering the frames drawn since the last one, and clears the frame times.
+		/// </summary>
+		/// <param name="currentTime">The current absolute time, in microseconds.</param>
+		void WriteRecord(long long currentTime);
+
+		/// <summary>
+		/// Makes a string safe to be written inside a quoted JSON string.
+		/// </summary>
+		/// <param name="text">The string to escape.</param>
+		/// <returns>The escaped string, without the surrounding quotes.</returns>
+		static std::string EscapeJSONString(const std::string &text);
+
+		/// <summary>
+		/// Clears all the member variables of this TelemetryWriter, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif
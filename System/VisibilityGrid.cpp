@@ -0,0 +1,299 @@
+#include "VisibilityGrid.h"
+#include "Constants.h"
+
+namespace RTE {
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::Clear() {
+		m_Width = 0;
+		m_Height = 0;
+		m_WordsPerRow = 0;
+		m_WrapX = false;
+		m_WrapY = false;
+		m_Revealed.clear();
+		m_Changed.clear();
+		m_RecentlyRevealed.clear();
+		m_ChangedRows.clear();
+		m_RecentlyRevealedCount = 0;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::Create(const BITMAP *unseenBitmap, bool wrapX, bool wrapY) {
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		Clear();
+		if (!unseenBitmap) {
+			return;
+		}
+		m_Width = unseenBitmap->w;
+		m_Height = unseenBitmap->h;
+		m_WordsPerRow = (m_Width + c_BitsPerWord - 1) / c_BitsPerWord;
+		m_WrapX = wrapX;
+		m_WrapY = wrapY;
+		m_Revealed.assign(m_WordsPerRow * m_Height, 0);
+		m_Changed.assign(m_WordsPerRow * m_Height, 0);
+		m_RecentlyRevealed.assign(m_WordsPerRow * m_Height, 0);
+		m_ChangedRows.assign(m_Height, false);
+
+		bool eightBit = bitmap_color_depth(const_cast<BITMAP *>(unseenBitmap)) == 8;
+		for (int y = 0; y < m_Height; ++y) {
+			unsigned long long *rowWords = &m_Revealed[y * m_WordsPerRow];
+			for (int x = 0; x < m_Width; ++x) {
+				int pixel = eightBit ? unseenBitmap->line[y][x] : getpixel(const_cast<BITMAP *>(unseenBitmap), x, y);
+				if (pixel == g_MaskColor) { rowWords[x / c_BitsPerWord] |= 1ULL << (x % c_BitsPerWord); }
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::Create(const VisibilityGrid &reference) {
+		std::scoped_lock gridLocks(m_Mutex, reference.m_Mutex);
+		m_Width = reference.m_Width;
+		m_Height = reference.m_Height;
+		m_WordsPerRow = reference.m_WordsPerRow;
+		m_WrapX = reference.m_WrapX;
+		m_WrapY = reference.m_WrapY;
+		m_Revealed = reference.m_Revealed;
+		m_Changed = reference.m_Changed;
+		m_RecentlyRevealed = reference.m_RecentlyRevealed;
+		m_ChangedRows = reference.m_ChangedRows;
+		m_RecentlyRevealedCount = reference.m_RecentlyRevealedCount;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool VisibilityGrid::IsRevealed(int posX, int posY) const {
+		if (!WrapPosition(posX, posY)) {
+			return false;
+		}
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		return m_Revealed[posY * m_WordsPerRow + posX / c_BitsPerWord] & (1ULL << (posX % c_BitsPerWord));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool VisibilityGrid::Reveal(int posX, int posY) {
+		if (!WrapPosition(posX, posY)) {
+			return false;
+		}
+		int wordIndex = posY * m_WordsPerRow + posX / c_BitsPerWord;
+		unsigned long long bit = 1ULL << (posX % c_BitsPerWord);
+
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		if (m_Revealed[wordIndex] & bit) {
+			return false;
+		}
+		m_Revealed[wordIndex] |= bit;
+		m_Changed[wordIndex] |= bit;
+		m_RecentlyRevealed[wordIndex] |= bit;
+		m_ChangedRows[posY] = true;
+		m_RecentlyRevealedCount++;
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	int VisibilityGrid::Reveal(const std::vector<std::pair<int, int>> &pixels, std::vector<int> &newlyRevealed) {
+		newlyRevealed.clear();
+
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		for (int pixelIndex = 0; pixelIndex < static_cast<int>(pixels.size()); ++pixelIndex) {
+			int posX = pixels[pixelIndex].first;
+			int posY = pixels[pixelIndex].second;
+			if (!WrapPosition(posX, posY)) {
+				continue;
+			}
+			int wordIndex = posY * m_WordsPerRow + posX / c_BitsPerWord;
+			unsigned long long bit = 1ULL << (posX % c_BitsPerWord);
+			if (m_Revealed[wordIndex] & bit) {
+				continue;
+			}
+			m_Revealed[wordIndex] |= bit;
+			m_Changed[wordIndex] |= bit;
+			m_RecentlyRevealed[wordIndex] |= bit;
+			m_ChangedRows[posY] = true;
+			m_RecentlyRevealedCount++;
+			newlyRevealed.push_back(pixelIndex);
+		}
+		return m_RecentlyRevealedCount;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool VisibilityGrid::Restore(int posX, int posY) {
+		if (!WrapPosition(posX, posY)) {
+			return false;
+		}
+		int wordIndex = posY * m_WordsPerRow + posX / c_BitsPerWord;
+		unsigned long long bit = 1ULL << (posX % c_BitsPerWord);
+
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		if (!(m_Revealed[wordIndex] & bit)) {
+			return false;
+		}
+		m_Revealed[wordIndex] &= ~bit;
+		m_Changed[wordIndex] |= bit;
+		if (m_RecentlyRevealed[wordIndex] & bit) {
+			m_RecentlyRevealed[wordIndex] &= ~bit;
+			m_RecentlyRevealedCount--;
+		}
+		m_ChangedRows[posY] = true;
+		return true;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::SetBox(int left, int top, int right, int bottom, bool reveal) {
+		left = std::max(left, 0);
+		top = std::max(top, 0);
+		right = std::min(right, m_Width - 1);
+		bottom = std::min(bottom, m_Height - 1);
+		if (left > right || top > bottom) {
+			return;
+		}
+		int firstWord = left / c_BitsPerWord;
+		int lastWord = right / c_BitsPerWord;
+
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		for (int y = top; y <= bottom; ++y) {
+			for (int word = firstWord; word <= lastWord; ++word) {
+				// Mask out the bits of the first and last words that are outside the box
+				unsigned long long boxBits = ~0ULL;
+				if (word == firstWord) { boxBits &= ~0ULL << (left % c_BitsPerWord); }
+				if (word == lastWord && right % c_BitsPerWord != c_BitsPerWord - 1) { boxBits &= (1ULL << (right % c_BitsPerWord + 1)) - 1; }
+
+				unsigned long long &revealedWord = m_Revealed[y * m_WordsPerRow + word];
+				unsigned long long newWord = reveal ? (revealedWord | boxBits) : (revealedWord & ~boxBits);
+				if (newWord != revealedWord) {
+					m_Changed[y * m_WordsPerRow + word] |= newWord ^ revealedWord;
+					m_ChangedRows[y] = true;
+					revealedWord = newWord;
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::CleanOrphans() {
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		if (m_RecentlyRevealedCount == 0) {
+			return;
+		}
+		std::vector<unsigned long long> previouslyRevealed(m_RecentlyRevealed.size(), 0);
+		previouslyRevealed.swap(m_RecentlyRevealed);
+		m_RecentlyRevealedCount = 0;
+
+		for (int y = 0; y < m_Height; ++y) {
+			for (int word = 0; word < m_WordsPerRow; ++word) {
+				unsigned long long revealedBits = previouslyRevealed[y * m_WordsPerRow + word];
+				for (int bit = 0; revealedBits != 0; ++bit, revealedBits >>= 1) {
+					if (revealedBits & 1) {
+						int x = word * c_BitsPerWord + bit;
+						CleanOrphan(x + 1, y);
+						CleanOrphan(x - 1, y);
+						CleanOrphan(x, y + 1);
+						CleanOrphan(x, y - 1);
+						CleanOrphan(x + 1, y + 1);
+						CleanOrphan(x - 1, y + 1);
+						CleanOrphan(x - 1, y - 1);
+						CleanOrphan(x + 1, y - 1);
+					}
+				}
+			}
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::DrawChanges(BITMAP *unseenBitmap, bool highlightRecent) {
+		std::lock_guard<std::mutex> gridLock(m_Mutex);
+		if (!unseenBitmap || unseenBitmap->w != m_Width || unseenBitmap->h != m_Height) {
+			return;
+		}
+		bool eightBit = bitmap_color_depth(unseenBitmap) == 8;
+		for (int y = 0; y < m_Height; ++y) {
+			if (!m_ChangedRows[y]) {
+				continue;
+			}
+			bool rowStillChanged = false;
+			for (int word = 0; word < m_WordsPerRow; ++word) {
+				int wordIndex = y * m_WordsPerRow + word;
+				unsigned long long changedBits = m_Changed[wordIndex];
+				if (changedBits == 0) {
+					continue;
+				}
+				unsigned long long revealedBits = m_Revealed[wordIndex];
+				unsigned long long highlightedBits = highlightRecent ? (m_RecentlyRevealed[wordIndex] & revealedBits) : 0;
+				for (int bit = 0; changedBits != 0; ++bit, changedBits >>= 1) {
+					if (changedBits & 1) {
+						int color = !(revealedBits & (1ULL << bit)) ? g_BlackColor : ((highlightedBits & (1ULL << bit)) ? g_WhiteColor : g_MaskColor);
+						int x = word * c_BitsPerWord + bit;
+						if (eightBit) {
+							unseenBitmap->line[y][x] = static_cast<unsigned char>(color);
+						} else {
+							putpixel(unseenBitmap, x, y, color);
+						}
+					}
+				}
+				// Highlighted pixels have to be drawn again as revealed once they're no longer recent
+				m_Changed[wordIndex] = highlightedBits;
+				if (highlightedBits) { rowStillChanged = true; }
+			}
+			m_ChangedRows[y] = rowStillChanged;
+		}
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool VisibilityGrid::WrapPosition(int &posX, int &posY) const {
+		if (m_WrapX && m_Width > 0) {
+			posX %= m_Width;
+			if (posX < 0) { posX += m_Width; }
+		}
+		if (m_WrapY && m_Height > 0) {
+			posY %= m_Height;
+			if (posY < 0) { posY += m_Height; }
+		}
+		return posX >= 0 && posX < m_Width && posY >= 0 && posY < m_Height;
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool VisibilityGrid::IsUnseenOrOutside(int posX, int posY) const {
+		if (!WrapPosition(posX, posY)) {
+			return true;
+		}
+		return !(m_Revealed[posY * m_WordsPerRow + posX / c_BitsPerWord] & (1ULL << (posX % c_BitsPerWord)));
+	}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void VisibilityGrid::CleanOrphan(int posX, int posY) {
+		if (!WrapPosition(posX, posY) || !IsUnseenOrOutside(posX, posY)) {
+			return;
+		}
+		// Unseen neighbors directly next to this hold it up fully, diagonal ones only by half
+		float support = 0;
+		support += IsUnseenOrOutside(posX + 1, posY) ? 1.0F : 0;
+		support += IsUnseenOrOutside(posX - 1, posY) ? 1.0F : 0;
+		support += IsUnseenOrOutside(posX, posY + 1) ? 1.0F : 0;
+		support += IsUnseenOrOutside(posX, posY - 1) ? 1.0F : 0;
+		support += IsUnseenOrOutside(posX + 1, posY + 1) ? 0.5F : 0;
+		support += IsUnseenOrOutside(posX - 1, posY + 1) ? 0.5F : 0;
+		support += IsUnseenOrOutside(posX - 1, posY - 1) ? 0.5F : 0;
+		support += IsUnseenOrOutside(posX + 1, posY - 1) ? 0.5F : 0;
+
+		if (support <= 2.5F) {
+			int wordIndex = posY * m_WordsPerRow + posX / c_BitsPerWord;
+			unsigned long long bit = 1ULL << (posX % c_BitsPerWord);
+			m_Revealed[wordIndex] |= bit;
+			m_Changed[wordIndex] |= bit;
+			m_RecentlyRevealed[wordIndex] |= bit;
+			m_ChangedRows[posY] = true;
+			m_RecentlyRevealedCount++;
+		}
+	}
+}
@@ -0,0 +1,161 @@
+#ifndef _RTEVISIBILITYGRID_
+#define _RTEVISIBILITYGRID_
+
+#include "allegro.h"
+
+namespace RTE {
+
+	/// <summary>
+	/// What a team has seen of the Scene, packed into one bit per pixel of the team's unseen layer, so reveals and restores only touch the words they cover.
+	/// Keeps track of which pixels changed, so only those get drawn back onto the unseen layer's bitmap, and which were just revealed, so they can be highlighted and have the unseen pixels left orphaned around them cleaned up.
+	/// </summary>
+	class VisibilityGrid {
+
+	public:
+
+#pragma region Creation
+		/// <summary>
+		/// Constructor method used to instantiate a VisibilityGrid object in system memory. Create() should be called before using the object.
+		/// </summary>
+		VisibilityGrid() { Clear(); }
+
+		/// <summary>
+		/// Makes the VisibilityGrid object ready for use, reading which pixels are revealed from an unseen layer's bitmap.
+		/// </summary>
+		/// <param name="unseenBitmap">The bitmap of the unseen layer. Pixels of the mask color are revealed, all others are unseen. Ownership is NOT transferred!</param>
+		/// <param name="wrapX">Whether the unseen layer wraps around horizontally.</param>
+		/// <param name="wrapY">Whether the unseen layer wraps around vertically.</param>
+		void Create(const BITMAP *unseenBitmap, bool wrapX, bool wrapY);
+
+		/// <summary>
+		/// Creates a VisibilityGrid to be identical to another, by deep copy.
+		/// </summary>
+		/// <param name="reference">A reference to the VisibilityGrid to deep copy.</param>
+		void Create(const VisibilityGrid &reference);
+#pragma endregion
+
+#pragma region Destruction
+		/// <summary>
+		/// Resets the entire VisibilityGrid, including its inherited members, to their default settings or values.
+		/// </summary>
+		void Reset() { std::lock_guard<std::mutex> gridLock(m_Mutex); Clear(); }
+#pragma endregion
+
+#pragma region Getters
+		/// <summary>
+		/// Tells whether this VisibilityGrid has been created from an unseen layer.
+		/// </summary>
+		/// <returns>Whether this has no pixels at all.</returns>
+		bool IsEmpty() const { return m_Width == 0 || m_Height == 0; }
+
+		/// <summary>
+		/// Gets how many pixels were revealed one by one since the last CleanOrphans.
+		/// </summary>
+		/// <returns>The number of pixels revealed recently.</returns>
+		int GetRecentlyRevealedCount() const { std::lock_guard<std::mutex> gridLock(m_Mutex); return m_RecentlyRevealedCount; }
+#pragma endregion
+
+#pragma region Concrete Methods
+		/// <summary>
+		/// Tells whether a pixel has been revealed. Pixels outside the grid count as unseen.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel, in the unseen layer's coordinates.</param>
+		/// <param name="posY">The Y position of the pixel, in the unseen layer's coordinates.</param>
+		/// <returns>Whether the pixel has been revealed.</returns>
+		bool IsRevealed(int posX, int posY) const;
+
+		/// <summary>
+		/// Reveals a pixel, marking it as recently revealed.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel, in the unseen layer's coordinates.</param>
+		/// <param name="posY">The Y position of the pixel, in the unseen layer's coordinates.</param>
+		/// <returns>Whether the pixel was unseen before.</returns>
+		bool Reveal(int posX, int posY);
+
+		/// <summary>
+		/// Reveals a batch of pixels under a single lock, like a whole sight ray's worth, marking the ones that were unseen as recently revealed.
+		/// </summary>
+		/// <param name="pixels">The X and Y positions of the pixels, in the unseen layer's coordinates.</param>
+		/// <param name="newlyRevealed">Cleared, then filled with the indices into pixels of the ones that were unseen before, in order.</param>
+		/// <returns>The number of pixels revealed recently, including this batch.</returns>
+		int Reveal(const std::vector<std::pair<int, int>> &pixels, std::vector<int> &newlyRevealed);
+
+		/// <summary>
+		/// Makes a pixel unseen again.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel, in the unseen layer's coordinates.</param>
+		/// <param name="posY">The Y position of the pixel, in the unseen layer's coordinates.</param>
+		/// <returns>Whether the pixel was revealed before.</returns>
+		bool Restore(int posX, int posY);
+
+		/// <summary>
+		/// Reveals or hides all the pixels of a box, a whole word at a time. The right and bottom edges are included, and the box is clipped to the grid without wrapping.
+		/// </summary>
+		/// <param name="left">The left edge of the box, in the unseen layer's coordinates.</param>
+		/// <param name="top">The top edge of the box, in the unseen layer's coordinates.</param>
+		/// <param name="right">The right edge of the box, in the unseen layer's coordinates.</param>
+		/// <param name="bottom">The bottom edge of the box, in the unseen layer's coordinates.</param>
+		/// <param name="reveal">Whether to reveal the box, or make it unseen.</param>
+		void SetBox(int left, int top, int right, int bottom, bool reveal);
+
+		/// <summary>
+		/// Reveals the unseen pixels around the recently revealed ones that have too few unseen neighbors left to hold them up. The cleaned up pixels become the recently revealed ones, so the cleanup spreads a little every frame.
+		/// </summary>
+		void CleanOrphans();
+
+		/// <summary>
+		/// Draws the pixels that changed since the last call onto the unseen layer's bitmap, going only through the rows that have any changes.
+		/// </summary>
+		/// <param name="unseenBitmap">The bitmap of the unseen layer this was created from. Ownership is NOT transferred!</param>
+		/// <param name="highlightRecent">Whether to draw the recently revealed pixels in white, to be drawn revealed on the next call after CleanOrphans.</param>
+		void DrawChanges(BITMAP *unseenBitmap, bool highlightRecent);
+#pragma endregion
+
+	private:
+
+		static constexpr int c_BitsPerWord = 64; //!< The number of pixels packed into each word.
+
+		int m_Width; //!< The width of the grid in pixels.
+		int m_Height; //!< The height of the grid in pixels.
+		int m_WordsPerRow; //!< The number of words each row of pixels is packed into.
+		bool m_WrapX; //!< Whether the grid wraps around horizontally.
+		bool m_WrapY; //!< Whether the grid wraps around vertically.
+
+		std::vector<unsigned long long> m_Revealed; //!< One bit per pixel, set if the pixel has been revealed.
+		std::vector<unsigned long long> m_Changed; //!< One bit per pixel, set if the pixel needs to be drawn onto the unseen layer's bitmap again.
+		std::vector<unsigned long long> m_RecentlyRevealed; //!< One bit per pixel, set if the pixel was revealed one by one or cleaned up since the last CleanOrphans.
+		std::vector<bool> m_ChangedRows; //!< Whether each row has any bits set in m_Changed.
+		int m_RecentlyRevealedCount; //!< The number of bits set in m_RecentlyRevealed.
+
+		mutable std::mutex m_Mutex; //!< Guards the bits, since Actors can look around from the parallel AI workers.
+
+		/// <summary>
+		/// Wraps a position around the grid if it wraps, and tells whether it ended up within the grid. m_Mutex doesn't have to be locked.
+		/// </summary>
+		/// <param name="posX">The X position to wrap.</param>
+		/// <param name="posY">The Y position to wrap.</param>
+		/// <returns>Whether the position is within the grid.</returns>
+		bool WrapPosition(int &posX, int &posY) const;
+
+		/// <summary>
+		/// Tells whether a pixel is unseen, counting pixels outside the grid as unseen. m_Mutex has to be locked.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel.</param>
+		/// <param name="posY">The Y position of the pixel.</param>
+		/// <returns>Whether the pixel is unseen.</returns>
+		bool IsUnseenOrOutside(int posX, int posY) const;
+
+		/// <summary>
+		/// Reveals an unseen pixel if it has too few unseen neighbors left to hold it up. m_Mutex has to be locked.
+		/// </summary>
+		/// <param name="posX">The X position of the pixel.</param>
+		/// <param name="posY">The Y position of the pixel.</param>
+		void CleanOrphan(int posX, int posY);
+
+		/// <summary>
+		/// Clears all the member variables of this VisibilityGrid, effectively resetting the members of this abstraction level only.
+		/// </summary>
+		void Clear();
+	};
+}
+#endif